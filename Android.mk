@@ -7,10 +7,19 @@ LOCAL_CPPFLAGS+=-D__STDC_LIMIT_MACROS -std=c++11
 LOCAL_C_INCLUDES:= $(LOCAL_PATH)
 LOCAL_EXPORT_C_INCLUDES:= $(LOCAL_PATH)
 
-LOCAL_SRC_FILES:= common/file_util.cc \
+LOCAL_SRC_FILES:= common/aes_ctr.cc \
+                  common/file_util.cc \
                   common/hdr_util.cc \
+                  common/io_stats.cc \
+                  common/trace.cc \
+                  mkvparser/mkvdecompress.cc \
+                  mkvparser/mkvdecrypt.cc \
                   mkvparser/mkvparser.cc \
+                  mkvparser/mkvrange.cc \
                   mkvparser/mkvreader.cc \
+                  mkvparser/mkvresync.cc \
+                  mkvmuxer/mkvbatchmuxer.cc \
+                  mkvmuxer/mkvencrypt.cc \
                   mkvmuxer/mkvmuxer.cc \
                   mkvmuxer/mkvmuxerutil.cc \
                   mkvmuxer/mkvwriter.cc
@@ -0,0 +1,326 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/aes_ctr.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define LIBWEBM_AES_NI
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LIBWEBM_AES_NI_TARGET
+#else
+#include <cpuid.h>
+#define LIBWEBM_AES_NI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#endif
+
+namespace libwebm {
+
+namespace {
+
+// Counter blocks encrypted together.
+const size_t kBatchBlocks = 8;
+
+const uint8_t kSbox[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b,
+    0xfe, 0xd7, 0xab, 0x76, 0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+    0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0, 0xb7, 0xfd, 0x93, 0x26,
+    0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2,
+    0xeb, 0x27, 0xb2, 0x75, 0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+    0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84, 0x53, 0xd1, 0x00, 0xed,
+    0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f,
+    0x50, 0x3c, 0x9f, 0xa8, 0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+    0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2, 0xcd, 0x0c, 0x13, 0xec,
+    0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14,
+    0xde, 0x5e, 0x0b, 0xdb, 0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+    0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79, 0xe7, 0xc8, 0x37, 0x6d,
+    0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f,
+    0x4b, 0xbd, 0x8b, 0x8a, 0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+    0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e, 0xe1, 0xf8, 0x98, 0x11,
+    0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f,
+    0xb0, 0x54, 0xbb, 0x16,
+};
+
+const uint32_t kRcon[10] = {0x01000000, 0x02000000, 0x04000000, 0x08000000,
+                            0x10000000, 0x20000000, 0x40000000, 0x80000000,
+                            0x1b000000, 0x36000000};
+
+uint32_t LoadBigEndian32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void StoreBigEndian32(uint32_t value, uint8_t* p) {
+  p[0] = static_cast<uint8_t>(value >> 24);
+  p[1] = static_cast<uint8_t>(value >> 16);
+  p[2] = static_cast<uint8_t>(value >> 8);
+  p[3] = static_cast<uint8_t>(value);
+}
+
+uint64_t LoadBigEndian64(const uint8_t* p) {
+  return (static_cast<uint64_t>(LoadBigEndian32(p)) << 32) |
+         LoadBigEndian32(p + 4);
+}
+
+void StoreBigEndian64(uint64_t value, uint8_t* p) {
+  StoreBigEndian32(static_cast<uint32_t>(value >> 32), p);
+  StoreBigEndian32(static_cast<uint32_t>(value), p + 4);
+}
+
+uint32_t SubWord(uint32_t word) {
+  return (static_cast<uint32_t>(kSbox[word >> 24]) << 24) |
+         (static_cast<uint32_t>(kSbox[(word >> 16) & 0xff]) << 16) |
+         (static_cast<uint32_t>(kSbox[(word >> 8) & 0xff]) << 8) |
+         kSbox[word & 0xff];
+}
+
+uint32_t RotateRight(uint32_t word, int bits) {
+  return (word >> bits) | (word << (32 - bits));
+}
+
+// Combined SubBytes and MixColumns table for one byte of a column; the
+// tables for the other rows are rotations of it.
+struct EncryptTable {
+  EncryptTable() {
+    for (int i = 0; i < 256; ++i) {
+      const uint32_t s = kSbox[i];
+      const uint32_t s2 = ((s << 1) ^ ((s & 0x80) ? 0x1b : 0)) & 0xff;
+      const uint32_t s3 = s2 ^ s;
+      te[i] = (s2 << 24) | (s << 16) | (s << 8) | s3;
+    }
+  }
+
+  uint32_t te[256];
+};
+
+const EncryptTable& GetEncryptTable() {
+  static const EncryptTable table;
+  return table;
+}
+
+void XorKeyStream(const uint8_t* stream, size_t skip, uint8_t* data,
+                  size_t size) {
+  if (skip == 0 && size == AesCtr::kBlockSize) {
+    uint64_t a[2], b[2];
+    memcpy(a, stream, sizeof(a));
+    memcpy(b, data, sizeof(b));
+    b[0] ^= a[0];
+    b[1] ^= a[1];
+    memcpy(data, b, sizeof(b));
+    return;
+  }
+
+  for (size_t i = 0; i < size; ++i)
+    data[i] ^= stream[skip + i];
+}
+
+}  // namespace
+
+bool AesCtr::Init(const uint8_t* key, size_t key_size,
+                  Implementation implementation) {
+  if (key == nullptr || (key_size != 16 && key_size != 24 && key_size != 32))
+    return false;
+
+  const int nk = static_cast<int>(key_size / 4);
+  rounds_ = nk + 6;
+
+  const int words = 4 * (rounds_ + 1);
+  for (int i = 0; i < nk; ++i)
+    round_words_[i] = LoadBigEndian32(key + 4 * i);
+
+  for (int i = nk; i < words; ++i) {
+    uint32_t temp = round_words_[i - 1];
+    if (i % nk == 0)
+      temp = SubWord(RotateRight(temp, 24)) ^ kRcon[i / nk - 1];
+    else if (nk > 6 && i % nk == 4)
+      temp = SubWord(temp);
+    round_words_[i] = round_words_[i - nk] ^ temp;
+  }
+
+  for (int i = 0; i < words; ++i)
+    StoreBigEndian32(round_words_[i], round_keys_ + 4 * i);
+
+  use_hardware_ = implementation == kAuto && HasHardwareSupport();
+  return true;
+}
+
+void AesCtr::Apply(const Range* ranges, size_t count) const {
+  uint8_t stream[kBatchBlocks * kBlockSize];
+  uint8_t* targets[kBatchBlocks];
+  size_t sizes[kBatchBlocks];
+  size_t skips[kBatchBlocks];
+  size_t blocks = 0;
+
+  for (size_t r = 0; r < count; ++r) {
+    const Range& range = ranges[r];
+    uint64_t counter = LoadBigEndian64(range.counter_block + 8) +
+                       range.offset / kBlockSize;
+    size_t skip = static_cast<size_t>(range.offset % kBlockSize);
+
+    for (size_t pos = 0; pos < range.size;) {
+      size_t size = kBlockSize - skip;
+      if (size > range.size - pos)
+        size = range.size - pos;
+
+      uint8_t* const block = stream + blocks * kBlockSize;
+      memcpy(block, range.counter_block, 8);
+      StoreBigEndian64(counter, block + 8);
+      targets[blocks] = range.data + pos;
+      sizes[blocks] = size;
+      skips[blocks] = skip;
+
+      if (++blocks == kBatchBlocks) {
+        EncryptBlocks(stream, blocks);
+        for (size_t i = 0; i < blocks; ++i) {
+          XorKeyStream(stream + i * kBlockSize, skips[i], targets[i],
+                       sizes[i]);
+        }
+        blocks = 0;
+      }
+
+      pos += size;
+      skip = 0;
+      ++counter;
+    }
+  }
+
+  EncryptBlocks(stream, blocks);
+  for (size_t i = 0; i < blocks; ++i)
+    XorKeyStream(stream + i * kBlockSize, skips[i], targets[i], sizes[i]);
+}
+
+void AesCtr::Apply(const uint8_t* counter_block, uint8_t* data,
+                   size_t size) const {
+  const Range range = {counter_block, 0, data, size};
+  Apply(&range, 1);
+}
+
+void AesCtr::EncryptBlocks(uint8_t* blocks, size_t count) const {
+  if (count == 0)
+    return;
+
+  if (use_hardware_)
+    EncryptBlocksHardware(blocks, count);
+  else
+    EncryptBlocksPortable(blocks, count);
+}
+
+void AesCtr::EncryptBlocksPortable(uint8_t* blocks, size_t count) const {
+  const uint32_t* const te = GetEncryptTable().te;
+  const uint32_t* const rk_end = round_words_ + 4 * rounds_;
+
+  for (size_t b = 0; b < count; ++b) {
+    uint8_t* const block = blocks + b * kBlockSize;
+    const uint32_t* rk = round_words_;
+
+    uint32_t s0 = LoadBigEndian32(block) ^ rk[0];
+    uint32_t s1 = LoadBigEndian32(block + 4) ^ rk[1];
+    uint32_t s2 = LoadBigEndian32(block + 8) ^ rk[2];
+    uint32_t s3 = LoadBigEndian32(block + 12) ^ rk[3];
+
+    for (rk += 4; rk < rk_end; rk += 4) {
+      const uint32_t t0 = te[s0 >> 24] ^ RotateRight(te[(s1 >> 16) & 0xff], 8) ^
+                          RotateRight(te[(s2 >> 8) & 0xff], 16) ^
+                          RotateRight(te[s3 & 0xff], 24) ^ rk[0];
+      const uint32_t t1 = te[s1 >> 24] ^ RotateRight(te[(s2 >> 16) & 0xff], 8) ^
+                          RotateRight(te[(s3 >> 8) & 0xff], 16) ^
+                          RotateRight(te[s0 & 0xff], 24) ^ rk[1];
+      const uint32_t t2 = te[s2 >> 24] ^ RotateRight(te[(s3 >> 16) & 0xff], 8) ^
+                          RotateRight(te[(s0 >> 8) & 0xff], 16) ^
+                          RotateRight(te[s1 & 0xff], 24) ^ rk[2];
+      const uint32_t t3 = te[s3 >> 24] ^ RotateRight(te[(s0 >> 16) & 0xff], 8) ^
+                          RotateRight(te[(s1 >> 8) & 0xff], 16) ^
+                          RotateRight(te[s2 & 0xff], 24) ^ rk[3];
+      s0 = t0;
+      s1 = t1;
+      s2 = t2;
+      s3 = t3;
+    }
+
+    // The last round has no MixColumns.
+    const uint32_t state[4] = {s0, s1, s2, s3};
+    for (int i = 0; i < 4; ++i) {
+      const uint32_t word =
+          (static_cast<uint32_t>(kSbox[state[i] >> 24]) << 24) |
+          (static_cast<uint32_t>(kSbox[(state[(i + 1) % 4] >> 16) & 0xff])
+           << 16) |
+          (static_cast<uint32_t>(kSbox[(state[(i + 2) % 4] >> 8) & 0xff])
+           << 8) |
+          kSbox[state[(i + 3) % 4] & 0xff];
+      StoreBigEndian32(word ^ rk[i], block + 4 * i);
+    }
+  }
+}
+
+#ifdef LIBWEBM_AES_NI
+
+LIBWEBM_AES_NI_TARGET
+void AesCtr::EncryptBlocksHardware(uint8_t* blocks, size_t count) const {
+  __m128i keys[kMaxRounds + 1];
+  for (int i = 0; i <= rounds_; ++i) {
+    keys[i] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(round_keys_ + i * kBlockSize));
+  }
+
+  // Up to kBatchBlocks blocks go through the rounds together, which keeps
+  // the AES unit's pipeline full.
+  while (count > 0) {
+    const size_t n = count < kBatchBlocks ? count : kBatchBlocks;
+    __m128i* const p = reinterpret_cast<__m128i*>(blocks);
+    __m128i state[kBatchBlocks];
+
+    for (size_t i = 0; i < n; ++i)
+      state[i] = _mm_xor_si128(_mm_loadu_si128(p + i), keys[0]);
+
+    for (int round = 1; round < rounds_; ++round) {
+      for (size_t i = 0; i < n; ++i)
+        state[i] = _mm_aesenc_si128(state[i], keys[round]);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+      _mm_storeu_si128(p + i, _mm_aesenclast_si128(state[i], keys[rounds_]));
+
+    blocks += n * kBlockSize;
+    count -= n;
+  }
+}
+
+bool AesCtr::HasHardwareSupport() {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 1);
+  return (info[2] & (1 << 25)) != 0;
+#else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  return (ecx & bit_AES) != 0;
+#endif
+}
+
+#else  // LIBWEBM_AES_NI
+
+void AesCtr::EncryptBlocksHardware(uint8_t* blocks, size_t count) const {
+  EncryptBlocksPortable(blocks, count);
+}
+
+bool AesCtr::HasHardwareSupport() { return false; }
+
+#endif  // LIBWEBM_AES_NI
+
+}  // namespace libwebm
@@ -0,0 +1,85 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_COMMON_AES_CTR_H_
+#define LIBWEBM_COMMON_AES_CTR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace libwebm {
+
+// AES in counter mode, as used by WebM encryption. Encryption and decryption
+// are the same operation: the data is XORed with the key stream.
+//
+// The key stream of a range is generated from a 16 byte initial counter
+// block whose last 8 bytes are a big-endian block counter, incremented
+// modulo 2^64 for each 16 byte block. For WebM the first 8 bytes are the
+// frame's IV and the counter starts at 0.
+//
+// Counter blocks of all the ranges given to one Apply() call are encrypted
+// together, several blocks at a time, so that many small frames are handled
+// as efficiently as a large one. AES-NI is used when the CPU supports it,
+// otherwise a portable implementation.
+class AesCtr {
+ public:
+  enum Implementation {
+    kAuto,      // AES-NI when available, otherwise portable.
+    kPortable,  // Portable implementation only.
+  };
+
+  static const int kBlockSize = 16;
+  static const int kMaxRounds = 14;
+
+  // Part of a key stream applied to |data|: |offset| is the position of
+  // |data[0]| in the key stream that starts with |counter_block|.
+  struct Range {
+    const uint8_t* counter_block;
+    uint64_t offset;
+    uint8_t* data;
+    size_t size;
+  };
+
+  AesCtr() = default;
+  ~AesCtr() = default;
+
+  // Expands |key|, which must be 16, 24 or 32 bytes long. Returns false for
+  // other sizes.
+  bool Init(const uint8_t* key, size_t key_size,
+            Implementation implementation = kAuto);
+
+  // XORs the key stream into every range, in place.
+  void Apply(const Range* ranges, size_t count) const;
+
+  // XORs the key stream that starts with |counter_block| into |size| bytes
+  // of |data|, in place.
+  void Apply(const uint8_t* counter_block, uint8_t* data, size_t size) const;
+
+  // Encrypts |count| 16 byte blocks of |blocks| in place with the block
+  // cipher itself.
+  void EncryptBlocks(uint8_t* blocks, size_t count) const;
+
+  // Returns true when the CPU supports AES-NI.
+  static bool HasHardwareSupport();
+
+  bool uses_hardware() const { return use_hardware_; }
+
+ private:
+  void EncryptBlocksPortable(uint8_t* blocks, size_t count) const;
+  void EncryptBlocksHardware(uint8_t* blocks, size_t count) const;
+
+  // Round keys as consecutive 16 byte blocks, and as big-endian words for
+  // the portable implementation.
+  uint8_t round_keys_[(kMaxRounds + 1) * kBlockSize] = {};
+  uint32_t round_words_[(kMaxRounds + 1) * 4] = {};
+  int rounds_ = 0;
+  bool use_hardware_ = false;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_COMMON_AES_CTR_H_
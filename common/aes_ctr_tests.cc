@@ -0,0 +1,163 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/aes_ctr.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using libwebm::AesCtr;
+
+std::vector<std::uint8_t> FromHex(const std::string& hex) {
+  std::vector<std::uint8_t> bytes;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    bytes.push_back(
+        static_cast<std::uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  return bytes;
+}
+
+const AesCtr::Implementation kImplementations[] = {AesCtr::kPortable,
+                                                   AesCtr::kAuto};
+
+// FIPS-197, appendix C.
+TEST(AesCtrTests, BlockCipherVectors) {
+  struct {
+    const char* key;
+    const char* ciphertext;
+  } const kVectors[] = {
+      {"000102030405060708090a0b0c0d0e0f", "69c4e0d86a7b0430d8cdb78070b4c55a"},
+      {"000102030405060708090a0b0c0d0e0f1011121314151617",
+       "dda97ca4864cdfe06eaf70a0ec0d7191"},
+      {"000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+       "8ea2b7ca516745bfeafc49904b496089"},
+  };
+
+  for (const AesCtr::Implementation implementation : kImplementations) {
+    for (const auto& vector : kVectors) {
+      const std::vector<std::uint8_t> key = FromHex(vector.key);
+      AesCtr aes;
+      ASSERT_TRUE(aes.Init(key.data(), key.size(), implementation));
+
+      std::vector<std::uint8_t> block =
+          FromHex("00112233445566778899aabbccddeeff");
+      aes.EncryptBlocks(block.data(), 1);
+      EXPECT_EQ(FromHex(vector.ciphertext), block)
+          << "key: " << vector.key << " hardware: " << aes.uses_hardware();
+    }
+  }
+}
+
+TEST(AesCtrTests, InvalidKeySize) {
+  const std::uint8_t key[32] = {};
+  AesCtr aes;
+  EXPECT_FALSE(aes.Init(key, 15));
+  EXPECT_FALSE(aes.Init(key, 20));
+  EXPECT_FALSE(aes.Init(nullptr, 16));
+  EXPECT_TRUE(aes.Init(key, 16));
+}
+
+// NIST SP 800-38A, F.5.1 and F.5.5.
+TEST(AesCtrTests, CounterModeVectors) {
+  struct {
+    const char* key;
+    const char* ciphertext;
+  } const kVectors[] = {
+      {"2b7e151628aed2a6abf7158809cf4f3c",
+       "874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+       "5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee"},
+      {"603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+       "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+       "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"},
+  };
+  const std::vector<std::uint8_t> counter =
+      FromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+  const std::vector<std::uint8_t> plaintext = FromHex(
+      "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+      "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710");
+
+  for (const AesCtr::Implementation implementation : kImplementations) {
+    for (const auto& vector : kVectors) {
+      const std::vector<std::uint8_t> key = FromHex(vector.key);
+      const std::vector<std::uint8_t> ciphertext = FromHex(vector.ciphertext);
+      AesCtr aes;
+      ASSERT_TRUE(aes.Init(key.data(), key.size(), implementation));
+
+      std::vector<std::uint8_t> data = plaintext;
+      aes.Apply(counter.data(), data.data(), data.size());
+      EXPECT_EQ(ciphertext, data) << "key: " << vector.key;
+
+      // The same key stream applied in unaligned pieces, out of order.
+      data = plaintext;
+      const AesCtr::Range ranges[] = {
+          {counter.data(), 37, data.data() + 37, 27},
+          {counter.data(), 0, data.data(), 5},
+          {counter.data(), 5, data.data() + 5, 32},
+      };
+      aes.Apply(ranges, 3);
+      EXPECT_EQ(ciphertext, data) << "key: " << vector.key;
+
+      // Decryption is the same operation.
+      aes.Apply(counter.data(), data.data(), data.size());
+      EXPECT_EQ(plaintext, data);
+    }
+  }
+}
+
+TEST(AesCtrTests, HardwareMatchesPortable) {
+  if (!AesCtr::HasHardwareSupport())
+    return;
+
+  const std::vector<std::uint8_t> key =
+      FromHex("000102030405060708090a0b0c0d0e0f");
+  AesCtr portable, hardware;
+  ASSERT_TRUE(portable.Init(key.data(), key.size(), AesCtr::kPortable));
+  ASSERT_TRUE(hardware.Init(key.data(), key.size(), AesCtr::kAuto));
+  ASSERT_FALSE(portable.uses_hardware());
+  ASSERT_TRUE(hardware.uses_hardware());
+
+  // Many frames of assorted sizes, each with its own counter block.
+  std::vector<std::uint8_t> counters(100 * AesCtr::kBlockSize);
+  std::vector<std::uint8_t> data;
+  std::vector<AesCtr::Range> ranges;
+  for (int i = 0; i < 100; ++i) {
+    for (int j = 0; j < AesCtr::kBlockSize; ++j)
+      counters[i * AesCtr::kBlockSize + j] = static_cast<std::uint8_t>(i * j);
+    const size_t size = (i * 37) % 300;
+    ranges.push_back({&counters[i * AesCtr::kBlockSize],
+                      static_cast<std::uint64_t>(i % 3), nullptr, size});
+    data.resize(data.size() + size, static_cast<std::uint8_t>(i));
+  }
+
+  std::vector<std::uint8_t> expected = data;
+  size_t offset = 0;
+  for (AesCtr::Range& range : ranges) {
+    range.data = &expected[offset];
+    offset += range.size;
+  }
+  portable.Apply(ranges.data(), ranges.size());
+
+  offset = 0;
+  for (AesCtr::Range& range : ranges) {
+    range.data = &data[offset];
+    offset += range.size;
+  }
+  hardware.Apply(ranges.data(), ranges.size());
+
+  EXPECT_EQ(expected, data);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
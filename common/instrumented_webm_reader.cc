@@ -0,0 +1,44 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/instrumented_webm_reader.h"
+
+namespace libwebm {
+
+namespace {
+
+bool IsError(const webm::Status& status) {
+  // kWouldBlock and kEndOfFile are not failures of the source.
+  return !status.ok() && status.code != webm::Status::kWouldBlock &&
+         status.code != webm::Status::kEndOfFile;
+}
+
+}  // namespace
+
+webm::Status InstrumentedWebmReader::Read(std::size_t num_to_read,
+                                          std::uint8_t* buffer,
+                                          std::uint64_t* num_actually_read) {
+  const webm::Status status =
+      reader_->Read(num_to_read, buffer, num_actually_read);
+  if (*num_actually_read > 0)
+    stats_.RecordRead(static_cast<int64_t>(*num_actually_read));
+  else if (IsError(status))
+    ++stats_.errors;
+  return status;
+}
+
+webm::Status InstrumentedWebmReader::Skip(
+    std::uint64_t num_to_skip, std::uint64_t* num_actually_skipped) {
+  const webm::Status status = reader_->Skip(num_to_skip, num_actually_skipped);
+  if (*num_actually_skipped > 0)
+    stats_.RecordSeek(0, static_cast<int64_t>(*num_actually_skipped));
+  else if (IsError(status))
+    ++stats_.errors;
+  return status;
+}
+
+}  // namespace libwebm
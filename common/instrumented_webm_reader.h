@@ -0,0 +1,44 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_COMMON_INSTRUMENTED_WEBM_READER_H_
+#define LIBWEBM_COMMON_INSTRUMENTED_WEBM_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/io_stats.h"
+#include "webm/reader.h"
+#include "webm/status.h"
+
+namespace libwebm {
+
+// A webm::Reader that passes every call to another reader and records it in
+// an IoStats. Reads are recorded with the number of bytes actually read, and
+// each Skip() is a forward seek.
+class InstrumentedWebmReader : public webm::Reader {
+ public:
+  // |reader| is not owned and must outlive this reader.
+  explicit InstrumentedWebmReader(webm::Reader* reader) : reader_(reader) {}
+
+  webm::Status Read(std::size_t num_to_read, std::uint8_t* buffer,
+                    std::uint64_t* num_actually_read) override;
+  webm::Status Skip(std::uint64_t num_to_skip,
+                    std::uint64_t* num_actually_skipped) override;
+  std::uint64_t Position() const override { return reader_->Position(); }
+
+  const IoStats& stats() const { return stats_; }
+  IoStats* mutable_stats() { return &stats_; }
+
+ private:
+  webm::Reader* const reader_;
+  IoStats stats_;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_COMMON_INSTRUMENTED_WEBM_READER_H_
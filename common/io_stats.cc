@@ -0,0 +1,163 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/io_stats.h"
+
+#include <inttypes.h>
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace libwebm {
+
+namespace {
+
+void AppendLine(std::string* out, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+void AppendLine(std::string* out, const char* format, ...) {
+  char line[256];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  out->append(line);
+  out->push_back('\n');
+}
+
+void AppendHistogram(const char* name, const int64_t* histogram,
+                     std::string* out) {
+  AppendLine(out, "  %s:", name);
+  for (int i = 0; i < IoStats::kHistogramBuckets; ++i) {
+    if (histogram[i] == 0)
+      continue;
+    char range[48];
+    const uint64_t low = i == 0 ? 0 : uint64_t{1} << (i - 1);
+    if (low <= 1) {
+      snprintf(range, sizeof(range), "%" PRIu64, low);
+    } else {
+      snprintf(range, sizeof(range), "%" PRIu64 "-%" PRIu64, low,
+               low * 2 - 1);
+    }
+    AppendLine(out, "    %20s: %" PRId64, range, histogram[i]);
+  }
+}
+
+}  // namespace
+
+int IoStats::Bucket(int64_t value) {
+  uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value)
+                                 : static_cast<uint64_t>(value);
+  int bucket = 0;
+  while (magnitude != 0 && bucket < kHistogramBuckets - 1) {
+    magnitude >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void IoStats::RecordRead(int64_t size) {
+  ++reads;
+  bytes_read += size;
+  ++read_sizes[Bucket(size)];
+}
+
+void IoStats::RecordWrite(int64_t size) {
+  ++writes;
+  bytes_written += size;
+  ++write_sizes[Bucket(size)];
+}
+
+void IoStats::RecordSeek(int64_t from, int64_t to) {
+  if (from == to)
+    return;
+  const int64_t distance = to > from ? to - from : from - to;
+  ++seeks;
+  if (to < from)
+    ++back_seeks;
+  seek_bytes += distance;
+  if (distance > max_seek)
+    max_seek = distance;
+  ++seek_distances[Bucket(distance)];
+}
+
+std::string IoStats::Report() const {
+  std::string out;
+  if (reads > 0) {
+    AppendLine(&out, "reads: %" PRId64 " bytes: %" PRId64 " mean: %.1f",
+               reads, bytes_read, static_cast<double>(bytes_read) / reads);
+    AppendHistogram("read sizes", read_sizes, &out);
+  }
+  if (length_calls > 0)
+    AppendLine(&out, "length calls: %" PRId64, length_calls);
+  if (writes > 0) {
+    AppendLine(&out, "writes: %" PRId64 " bytes: %" PRId64 " mean: %.1f",
+               writes, bytes_written,
+               static_cast<double>(bytes_written) / writes);
+    AppendHistogram("write sizes", write_sizes, &out);
+  }
+  if (seeks > 0) {
+    AppendLine(&out,
+               "seeks: %" PRId64 " back: %" PRId64 " bytes: %" PRId64
+               " mean: %.1f max: %" PRId64,
+               seeks, back_seeks, seek_bytes,
+               static_cast<double>(seek_bytes) / seeks, max_seek);
+    AppendHistogram("seek distances", seek_distances, &out);
+  }
+  if (errors > 0)
+    AppendLine(&out, "errors: %" PRId64, errors);
+  if (out.empty())
+    out = "no I/O\n";
+  return out;
+}
+
+int InstrumentedMkvReader::Read(long long pos, long len, unsigned char* buf) {
+  stats_.RecordSeek(position_, pos);
+  const int status = reader_->Read(pos, len, buf);
+  if (status != 0) {
+    ++stats_.errors;
+    return status;
+  }
+  stats_.RecordRead(len);
+  position_ = pos + len;
+  return status;
+}
+
+int InstrumentedMkvReader::Length(long long* total, long long* available) {
+  ++stats_.length_calls;
+  const int status = reader_->Length(total, available);
+  if (status < 0)
+    ++stats_.errors;
+  return status;
+}
+
+mkvmuxer::int32 InstrumentedMkvWriter::Write(const void* buf,
+                                             mkvmuxer::uint32 len) {
+  const mkvmuxer::int32 status = writer_->Write(buf, len);
+  if (status != 0) {
+    ++stats_.errors;
+    return status;
+  }
+  stats_.RecordWrite(len);
+  return status;
+}
+
+mkvmuxer::int32 InstrumentedMkvWriter::Position(mkvmuxer::int64 position) {
+  const mkvmuxer::int64 from = writer_->Position();
+  const mkvmuxer::int32 status = writer_->Position(position);
+  if (status != 0) {
+    ++stats_.errors;
+    return status;
+  }
+  stats_.RecordSeek(from, position);
+  return status;
+}
+
+}  // namespace libwebm
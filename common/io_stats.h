@@ -0,0 +1,115 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_COMMON_IO_STATS_H_
+#define LIBWEBM_COMMON_IO_STATS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvparser/mkvparser.h"
+
+namespace libwebm {
+
+// Counts the I/O calls made through one of the instrumented readers or
+// writers. Sizes and seek distances are also kept as histograms with
+// power-of-two buckets: bucket 0 counts zeros, and bucket i > 0 counts values
+// in [2^(i-1), 2^i).
+//
+// A seek is any access that does not start where the previous one ended:
+// an explicit Position() call on a writer, a read at another offset, or a
+// skip. Recording is a few additions per call; it is not thread-safe.
+struct IoStats {
+  static const int kHistogramBuckets = 64;
+
+  void RecordRead(int64_t size);
+  void RecordWrite(int64_t size);
+  // A move of the current position from |from| to |to|; nothing is recorded
+  // when they are equal.
+  void RecordSeek(int64_t from, int64_t to);
+
+  // Clears every counter, for example to measure only Segment::Finalize().
+  void Reset() { *this = IoStats(); }
+
+  // Returns a multi-line, human-readable report of the non-zero counters.
+  std::string Report() const;
+
+  // Returns the bucket of |value| in the histograms.
+  static int Bucket(int64_t value);
+
+  int64_t reads = 0;
+  int64_t bytes_read = 0;
+  int64_t read_sizes[kHistogramBuckets] = {};
+
+  int64_t writes = 0;
+  int64_t bytes_written = 0;
+  int64_t write_sizes[kHistogramBuckets] = {};
+
+  int64_t seeks = 0;
+  int64_t back_seeks = 0;
+  int64_t seek_bytes = 0;  // Sum of the absolute seek distances.
+  int64_t max_seek = 0;
+  int64_t seek_distances[kHistogramBuckets] = {};
+
+  int64_t length_calls = 0;  // IMkvReader::Length().
+  int64_t errors = 0;        // Calls that returned an error.
+};
+
+// An IMkvReader that passes every call to another reader and records it in
+// an IoStats.
+class InstrumentedMkvReader : public mkvparser::IMkvReader {
+ public:
+  // |reader| is not owned and must outlive this reader.
+  explicit InstrumentedMkvReader(mkvparser::IMkvReader* reader)
+      : reader_(reader) {}
+  virtual ~InstrumentedMkvReader() {}
+
+  int Read(long long pos, long len, unsigned char* buf) override;
+  int Length(long long* total, long long* available) override;
+
+  const IoStats& stats() const { return stats_; }
+  IoStats* mutable_stats() { return &stats_; }
+
+ private:
+  mkvparser::IMkvReader* const reader_;
+  IoStats stats_;
+  // Where the previous read ended.
+  int64_t position_ = 0;
+};
+
+// An IMkvWriter that passes every call to another writer and records it in
+// an IoStats. The writer's seeks are its Position(int64) calls; the
+// back-seeks of Segment::Finalize() updating sizes and the SeekHead show up
+// there.
+class InstrumentedMkvWriter : public mkvmuxer::IMkvWriter {
+ public:
+  // |writer| is not owned and must outlive this writer.
+  explicit InstrumentedMkvWriter(mkvmuxer::IMkvWriter* writer)
+      : writer_(writer) {}
+  virtual ~InstrumentedMkvWriter() {}
+
+  mkvmuxer::int32 Write(const void* buf, mkvmuxer::uint32 len) override;
+  mkvmuxer::int64 Position() const override { return writer_->Position(); }
+  mkvmuxer::int32 Position(mkvmuxer::int64 position) override;
+  bool Seekable() const override { return writer_->Seekable(); }
+  void ElementStartNotify(mkvmuxer::uint64 element_id,
+                          mkvmuxer::int64 position) override {
+    writer_->ElementStartNotify(element_id, position);
+  }
+
+  const IoStats& stats() const { return stats_; }
+  IoStats* mutable_stats() { return &stats_; }
+
+ private:
+  mkvmuxer::IMkvWriter* const writer_;
+  IoStats stats_;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_COMMON_IO_STATS_H_
@@ -0,0 +1,175 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/trace.h"
+
+#include <inttypes.h>
+
+#include <chrono>
+#include <cstdio>
+
+namespace libwebm {
+
+namespace {
+
+// Small, stable thread ids for the "tid" of events, in order of first use.
+int CurrentThreadId() {
+  static std::atomic<int> next_thread_id{1};
+  thread_local const int thread_id = next_thread_id.fetch_add(1);
+  return thread_id;
+}
+
+// Appends |str| to |json| as a JSON string.
+void AppendJsonString(const char* str, std::string* json) {
+  json->push_back('"');
+  for (; *str != '\0'; ++str) {
+    const unsigned char c = static_cast<unsigned char>(*str);
+    if (c == '"' || c == '\\') {
+      json->push_back('\\');
+      json->push_back(static_cast<char>(c));
+    } else if (c < 0x20) {
+      char escape[8];
+      snprintf(escape, sizeof(escape), "\\u%04x", c);
+      json->append(escape);
+    } else {
+      json->push_back(static_cast<char>(c));
+    }
+  }
+  json->push_back('"');
+}
+
+// Returns |id| with a hash of |owner| in its high 24 bits, leaving the low 40
+// bits, which hold any file offset below 1 TiB, unchanged. A NULL |owner|
+// leaves |id| unchanged.
+uint64_t OwnedId(const void* owner, uint64_t id) {
+  const uint64_t hash = static_cast<uint64_t>(
+                            reinterpret_cast<uintptr_t>(owner)) *
+                        0x9e3779b97f4a7c15ULL;
+  return id ^ (hash & 0xffffff0000000000ULL);
+}
+
+}  // namespace
+
+Tracer* Tracer::Get() {
+  static Tracer* const tracer = new Tracer();  // Never destroyed.
+  return tracer;
+}
+
+bool Tracer::CompiledIn() {
+#if defined(LIBWEBM_ENABLE_TRACING)
+  return true;
+#else
+  return false;
+#endif
+}
+
+int64_t Tracer::NowMicroseconds() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Tracer::set_max_events(std::size_t max_events) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_events_ = max_events;
+}
+
+std::size_t Tracer::event_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_.size();
+}
+
+int64_t Tracer::dropped_events() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_events_;
+}
+
+void Tracer::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  dropped_events_ = 0;
+}
+
+void Tracer::AddComplete(const char* category, const char* name,
+                         int64_t start_us, int64_t duration_us,
+                         const char* arg_name, int64_t arg) {
+  Add(Event{category, name, 'X', CurrentThreadId(), start_us, duration_us, 0,
+            arg_name, arg});
+}
+
+void Tracer::AddAsyncBegin(const char* category, const char* name,
+                           const void* owner, uint64_t id) {
+  Add(Event{category, name, 'b', CurrentThreadId(), NowMicroseconds(), 0,
+            OwnedId(owner, id), "id", static_cast<int64_t>(id)});
+}
+
+void Tracer::AddAsyncEnd(const char* category, const char* name,
+                         const void* owner, uint64_t id) {
+  Add(Event{category, name, 'e', CurrentThreadId(), NowMicroseconds(), 0,
+            OwnedId(owner, id), NULL, 0});
+}
+
+void Tracer::Add(const Event& event) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (events_.size() >= max_events_) {
+    ++dropped_events_;
+    return;
+  }
+  events_.push_back(event);
+}
+
+std::string Tracer::ToChromeTraceJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string json = "{\"traceEvents\":[\n";
+  char buffer[128];
+  for (std::size_t i = 0; i < events_.size(); ++i) {
+    const Event& event = events_[i];
+    if (i > 0)
+      json.append(",\n");
+    json.append("{\"cat\":");
+    AppendJsonString(event.category, &json);
+    json.append(",\"name\":");
+    AppendJsonString(event.name, &json);
+    snprintf(buffer, sizeof(buffer),
+             ",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%" PRId64,
+             event.phase, event.tid, event.timestamp_us);
+    json.append(buffer);
+    if (event.phase == 'X') {
+      snprintf(buffer, sizeof(buffer), ",\"dur\":%" PRId64,
+               event.duration_us);
+      json.append(buffer);
+    } else {
+      snprintf(buffer, sizeof(buffer), ",\"id\":\"0x%" PRIx64 "\"",
+               event.id);
+      json.append(buffer);
+    }
+    if (event.arg_name != NULL) {
+      json.append(",\"args\":{");
+      AppendJsonString(event.arg_name, &json);
+      snprintf(buffer, sizeof(buffer), ":%" PRId64 "}", event.arg);
+      json.append(buffer);
+    }
+    json.push_back('}');
+  }
+  snprintf(buffer, sizeof(buffer),
+           "\n],\"displayTimeUnit\":\"ms\","
+           "\"otherData\":{\"dropped_events\":%" PRId64 "}}\n",
+           dropped_events_);
+  json.append(buffer);
+  return json;
+}
+
+bool Tracer::WriteChromeTrace(const char* path) const {
+  FILE* const file = fopen(path, "wb");
+  if (file == NULL)
+    return false;
+  const std::string json = ToChromeTraceJson();
+  const bool ok = fwrite(json.data(), 1, json.size(), file) == json.size();
+  return fclose(file) == 0 && ok;
+}
+
+}  // namespace libwebm
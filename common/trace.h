@@ -0,0 +1,185 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_COMMON_TRACE_H_
+#define LIBWEBM_COMMON_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Trace points for the parsers and the muxer. They are compiled in only when
+// LIBWEBM_ENABLE_TRACING is defined (the ENABLE_TRACING CMake option);
+// otherwise the LIBWEBM_TRACE_* macros expand to nothing and their arguments
+// are not evaluated. Compiled-in trace points record nothing until
+// Tracer::Get()->Start() is called.
+//
+// Categories, names and argument names are kept as pointers, so they must be
+// string literals; they are escaped when the trace is written.
+//
+//   LIBWEBM_TRACE_SCOPE(category, name)
+//     Records the time until the end of the enclosing scope.
+//   LIBWEBM_TRACE_SCOPE_ARG(category, name, arg_name, arg)
+//     The same, with an integer argument shown with the event.
+//   LIBWEBM_TRACE_ASYNC_BEGIN(category, name, owner, id)
+//   LIBWEBM_TRACE_ASYNC_END(category, name, owner, id)
+//     Record a span that is not tied to a scope, such as the life of a
+//     Cluster; begin and end are matched by category, name, |owner| and
+//     |id|. |owner| is the object the id is unique within, such as the
+//     Segment whose cluster offset is the id, so that spans of files
+//     processed at the same time do not collide.
+
+namespace libwebm {
+
+// Collects trace events from all threads and writes them in the Chrome trace
+// event format, which chrome://tracing and Perfetto load.
+class Tracer {
+ public:
+  static const std::size_t kDefaultMaxEvents = 1 << 22;
+
+  // Returns the process-wide tracer.
+  static Tracer* Get();
+
+  // Returns true when the library was built with LIBWEBM_ENABLE_TRACING.
+  static bool CompiledIn();
+
+  // Returns a monotonic time in microseconds.
+  static int64_t NowMicroseconds();
+
+  // Starts and stops recording. Events recorded before are kept.
+  void Start() { enabled_.store(true, std::memory_order_relaxed); }
+  void Stop() { enabled_.store(false, std::memory_order_relaxed); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Events past |max_events| are dropped and counted.
+  void set_max_events(std::size_t max_events);
+  std::size_t event_count() const;
+  int64_t dropped_events() const;
+  void Clear();
+
+  // Records an event that lasted |duration_us| from |start_us|. |arg_name|
+  // may be NULL.
+  void AddComplete(const char* category, const char* name, int64_t start_us,
+                   int64_t duration_us, const char* arg_name, int64_t arg);
+  // Records the begin and end of an async span. The event id mixes a hash
+  // of |owner| into the high bits of |id|, and the begin event shows |id| as
+  // its "id" argument.
+  void AddAsyncBegin(const char* category, const char* name,
+                     const void* owner, uint64_t id);
+  void AddAsyncEnd(const char* category, const char* name, const void* owner,
+                   uint64_t id);
+
+  // Returns the recorded events as a Chrome trace JSON object.
+  std::string ToChromeTraceJson() const;
+
+  // Writes ToChromeTraceJson() to |path|. Returns false on error.
+  bool WriteChromeTrace(const char* path) const;
+
+ private:
+  struct Event {
+    const char* category;
+    const char* name;
+    char phase;  // 'X' complete, 'b' async begin, 'e' async end.
+    int tid;
+    int64_t timestamp_us;
+    int64_t duration_us;
+    uint64_t id;
+    const char* arg_name;
+    int64_t arg;
+  };
+
+  Tracer() = default;
+  void Add(const Event& event);
+
+  std::atomic<bool> enabled_{false};
+  mutable std::mutex mutex_;
+  std::vector<Event> events_;
+  std::size_t max_events_ = kDefaultMaxEvents;
+  int64_t dropped_events_ = 0;
+};
+
+// Records the lifetime of the scope as a complete event when the tracer is
+// enabled at construction.
+class TraceScope {
+ public:
+  TraceScope(const char* category, const char* name)
+      : TraceScope(category, name, NULL, 0) {}
+  TraceScope(const char* category, const char* name, const char* arg_name,
+             int64_t arg)
+      : category_(category),
+        name_(name),
+        arg_name_(arg_name),
+        arg_(arg),
+        start_us_(Tracer::Get()->enabled() ? Tracer::NowMicroseconds() : -1) {}
+  ~TraceScope() {
+    if (start_us_ >= 0) {
+      Tracer::Get()->AddComplete(category_, name_, start_us_,
+                                 Tracer::NowMicroseconds() - start_us_,
+                                 arg_name_, arg_);
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* const category_;
+  const char* const name_;
+  const char* const arg_name_;
+  const int64_t arg_;
+  const int64_t start_us_;
+};
+
+}  // namespace libwebm
+
+#if defined(LIBWEBM_ENABLE_TRACING)
+
+#define LIBWEBM_TRACE_CONCAT_INNER(a, b) a##b
+#define LIBWEBM_TRACE_CONCAT(a, b) LIBWEBM_TRACE_CONCAT_INNER(a, b)
+#define LIBWEBM_TRACE_SCOPE(category, name)                               \
+  const ::libwebm::TraceScope LIBWEBM_TRACE_CONCAT(libwebm_trace_scope_, \
+                                                   __LINE__)(category, name)
+#define LIBWEBM_TRACE_SCOPE_ARG(category, name, arg_name, arg)            \
+  const ::libwebm::TraceScope LIBWEBM_TRACE_CONCAT(libwebm_trace_scope_, \
+                                                   __LINE__)(            \
+      category, name, arg_name, static_cast<int64_t>(arg))
+#define LIBWEBM_TRACE_ASYNC_BEGIN(category, name, owner, id)                 \
+  do {                                                                       \
+    if (::libwebm::Tracer::Get()->enabled()) {                               \
+      ::libwebm::Tracer::Get()->AddAsyncBegin(category, name, owner,         \
+                                              static_cast<uint64_t>(id));    \
+    }                                                                        \
+  } while (0)
+#define LIBWEBM_TRACE_ASYNC_END(category, name, owner, id)                   \
+  do {                                                                       \
+    if (::libwebm::Tracer::Get()->enabled()) {                               \
+      ::libwebm::Tracer::Get()->AddAsyncEnd(category, name, owner,           \
+                                            static_cast<uint64_t>(id));      \
+    }                                                                        \
+  } while (0)
+
+#else  // LIBWEBM_ENABLE_TRACING
+
+#define LIBWEBM_TRACE_SCOPE(category, name) \
+  do {                                      \
+  } while (0)
+#define LIBWEBM_TRACE_SCOPE_ARG(category, name, arg_name, arg) \
+  do {                                                         \
+  } while (0)
+#define LIBWEBM_TRACE_ASYNC_BEGIN(category, name, owner, id) \
+  do {                                                       \
+  } while (0)
+#define LIBWEBM_TRACE_ASYNC_END(category, name, owner, id) \
+  do {                                                     \
+  } while (0)
+
+#endif  // LIBWEBM_ENABLE_TRACING
+
+#endif  // LIBWEBM_COMMON_TRACE_H_
@@ -0,0 +1,218 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "common/trace.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using libwebm::TraceScope;
+using libwebm::Tracer;
+
+const char kHeader[] = "{\"traceEvents\":[\n";
+
+// Splits the events of a Chrome trace, written one per line, into lines
+// without the separating commas.
+std::vector<std::string> EventLines(const std::string& json) {
+  std::vector<std::string> lines;
+  if (json.compare(0, sizeof(kHeader) - 1, kHeader) != 0)
+    return lines;
+  const size_t end = json.find("\n]");
+  size_t pos = sizeof(kHeader) - 1;
+  while (pos < end) {
+    size_t stop = json.find('\n', pos);
+    if (stop > end)
+      stop = end;
+    std::string line = json.substr(pos, stop - pos);
+    if (!line.empty() && line[line.size() - 1] == ',')
+      line.erase(line.size() - 1);
+    lines.push_back(line);
+    pos = stop + 1;
+  }
+  return lines;
+}
+
+// Returns the integer member |name| of the event in |line|, or -1.
+int64_t Member(const std::string& line, const std::string& name) {
+  const std::string key = "\"" + name + "\":";
+  const size_t pos = line.find(key);
+  if (pos == std::string::npos)
+    return -1;
+  return std::strtoll(line.c_str() + pos + key.size(), NULL, 10);
+}
+
+class TraceTests : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    tracer_->Stop();
+    tracer_->Clear();
+    tracer_->set_max_events(Tracer::kDefaultMaxEvents);
+  }
+  void TearDown() override {
+    tracer_->Stop();
+    tracer_->Clear();
+    tracer_->set_max_events(Tracer::kDefaultMaxEvents);
+  }
+
+  Tracer* const tracer_ = Tracer::Get();
+};
+
+TEST_F(TraceTests, NestedScopes) {
+  {
+    // Not recorded: the tracer is stopped.
+    TraceScope ignored("test", "ignored");
+  }
+  tracer_->Start();
+  {
+    TraceScope outer("test", "outer");
+    TraceScope inner("test", "inner", "bytes", 42);
+  }
+  tracer_->Stop();
+  ASSERT_EQ(2u, tracer_->event_count());
+
+  // Scopes are recorded as they end, so the inner one comes first.
+  const std::vector<std::string> lines =
+      EventLines(tracer_->ToChromeTraceJson());
+  ASSERT_EQ(2u, lines.size());
+  const std::string& inner = lines[0];
+  const std::string& outer = lines[1];
+  EXPECT_EQ(0u, inner.find("{\"cat\":\"test\",\"name\":\"inner\","
+                           "\"ph\":\"X\",\"pid\":1,"));
+  EXPECT_EQ(0u, outer.find("{\"cat\":\"test\",\"name\":\"outer\","
+                           "\"ph\":\"X\",\"pid\":1,"));
+  EXPECT_NE(std::string::npos, inner.find(",\"args\":{\"bytes\":42}}"));
+  EXPECT_EQ(std::string::npos, outer.find("\"args\""));
+  EXPECT_EQ(Member(outer, "tid"), Member(inner, "tid"));
+
+  // The inner span lies within the outer one.
+  EXPECT_GE(Member(inner, "ts"), Member(outer, "ts"));
+  EXPECT_GE(Member(inner, "dur"), 0);
+  EXPECT_LE(Member(inner, "ts") + Member(inner, "dur"),
+            Member(outer, "ts") + Member(outer, "dur"));
+}
+
+TEST_F(TraceTests, AsyncSpans) {
+  tracer_->Start();
+  tracer_->AddAsyncBegin("test", "cluster", NULL, 0x2a);
+  tracer_->AddAsyncBegin("test", "cluster", NULL, 0x2b);
+  // An async span may end on another thread.
+  std::thread([this]() {
+    tracer_->AddAsyncEnd("test", "cluster", NULL, 0x2a);
+  }).join();
+  tracer_->AddAsyncEnd("test", "cluster", NULL, 0x2b);
+  tracer_->Stop();
+
+  const std::vector<std::string> lines =
+      EventLines(tracer_->ToChromeTraceJson());
+  ASSERT_EQ(4u, lines.size());
+
+  // Each begin is paired with the end of the same category, name and id.
+  const char* const kIds[] = {"\"id\":\"0x2a\"", "\"id\":\"0x2b\""};
+  const int64_t kArgs[] = {0x2a, 0x2b};
+  const std::string prefix = "{\"cat\":\"test\",\"name\":\"cluster\",";
+  for (int i = 0; i < 2; ++i) {
+    const std::string& begin = lines[i];
+    const std::string& end = lines[i + 2];
+    EXPECT_EQ(0u, begin.find(prefix + "\"ph\":\"b\",")) << begin;
+    EXPECT_EQ(0u, end.find(prefix + "\"ph\":\"e\",")) << end;
+    EXPECT_NE(std::string::npos, begin.find(kIds[i])) << begin;
+    EXPECT_NE(std::string::npos, end.find(std::string(kIds[i]) + "}")) << end;
+    EXPECT_EQ(std::string::npos, begin.find("\"dur\"")) << begin;
+    EXPECT_NE(std::string::npos,
+              begin.find(",\"args\":{\"id\":" + std::to_string(kArgs[i]) +
+                         "}}"))
+        << begin;
+    EXPECT_LE(Member(begin, "ts"), Member(end, "ts"));
+  }
+  EXPECT_EQ(Member(lines[0], "tid"), Member(lines[3], "tid"));
+  EXPECT_NE(Member(lines[0], "tid"), Member(lines[2], "tid"));
+}
+
+// Returns the "id" of the async event in |line|.
+std::string AsyncId(const std::string& line) {
+  const std::string key = "\"id\":\"";
+  const size_t pos = line.find(key);
+  if (pos == std::string::npos)
+    return std::string();
+  const size_t start = pos + key.size();
+  return line.substr(start, line.find('"', start) - start);
+}
+
+// Spans with the same id but different owners, such as clusters at the same
+// offset of two files parsed at once, get different event ids.
+TEST_F(TraceTests, AsyncSpansOfDifferentOwners) {
+  const int first_owner = 0;
+  const int second_owner = 0;
+  tracer_->Start();
+  tracer_->AddAsyncBegin("test", "cluster", &first_owner, 0x2a);
+  tracer_->AddAsyncBegin("test", "cluster", &second_owner, 0x2a);
+  tracer_->AddAsyncEnd("test", "cluster", &second_owner, 0x2a);
+  tracer_->AddAsyncEnd("test", "cluster", &first_owner, 0x2a);
+  tracer_->Stop();
+
+  const std::vector<std::string> lines =
+      EventLines(tracer_->ToChromeTraceJson());
+  ASSERT_EQ(4u, lines.size());
+  EXPECT_NE(AsyncId(lines[0]), AsyncId(lines[1]));
+  EXPECT_EQ(AsyncId(lines[0]), AsyncId(lines[3]));
+  EXPECT_EQ(AsyncId(lines[1]), AsyncId(lines[2]));
+
+  // The owner only changes the high bits, so the id stays readable.
+  for (const std::string& line : lines) {
+    const std::string id = AsyncId(line);
+    ASSERT_GT(id.size(), 10u) << line;
+    EXPECT_EQ("000002a", id.substr(id.size() - 7)) << line;
+  }
+  EXPECT_NE(std::string::npos, lines[0].find("\"args\":{\"id\":42}"));
+  EXPECT_NE(std::string::npos, lines[1].find("\"args\":{\"id\":42}"));
+}
+
+TEST_F(TraceTests, EscapesStrings) {
+  tracer_->Start();
+  tracer_->AddComplete("a\\b", "say \"hi\"\n\t", 10, 5, "x\x01", 7);
+  tracer_->Stop();
+
+  const std::vector<std::string> lines =
+      EventLines(tracer_->ToChromeTraceJson());
+  ASSERT_EQ(1u, lines.size());
+  const std::string expected =
+      "{\"cat\":\"a\\\\b\",\"name\":\"say \\\"hi\\\"\\u000a\\u0009\","
+      "\"ph\":\"X\",\"pid\":1,\"tid\":" +
+      std::to_string(Member(lines[0], "tid")) +
+      ",\"ts\":10,\"dur\":5,\"args\":{\"x\\u0001\":7}}";
+  EXPECT_EQ(expected, lines[0]);
+}
+
+TEST_F(TraceTests, DropsEventsPastLimit) {
+  tracer_->set_max_events(2);
+  tracer_->Start();
+  for (int i = 0; i < 5; ++i)
+    tracer_->AddComplete("test", "event", i, 1, NULL, 0);
+  tracer_->Stop();
+
+  EXPECT_EQ(2u, tracer_->event_count());
+  EXPECT_EQ(3, tracer_->dropped_events());
+  const std::string json = tracer_->ToChromeTraceJson();
+  EXPECT_EQ(2u, EventLines(json).size());
+  EXPECT_NE(std::string::npos,
+            json.find("\n],\"displayTimeUnit\":\"ms\","
+                      "\"otherData\":{\"dropped_events\":3}}\n"));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
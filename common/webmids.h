@@ -21,6 +21,7 @@ enum MkvId {
   kMkvDocTypeVersion = 0x4287,
   kMkvDocTypeReadVersion = 0x4285,
   kMkvVoid = 0xEC,
+  kMkvCRC32 = 0xBF,
   kMkvSignatureSlot = 0x1B538667,
   kMkvSignatureAlgo = 0x7E8A,
   kMkvSignatureHash = 0x7E9A,
@@ -47,6 +48,7 @@ enum MkvId {
   // Cluster
   kMkvCluster = 0x1F43B675,
   kMkvTimecode = 0xE7,
+  kMkvPosition = 0xA7,
   kMkvPrevSize = 0xAB,
   kMkvBlockGroup = 0xA0,
   kMkvBlock = 0xA1,
@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_concat.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "common/file_util.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+#include "testing/test_util.h"
+
+namespace {
+
+const std::int64_t kMillisecond = 1000000;
+const std::int64_t kFrameDuration = 40 * kMillisecond;
+const int kFrameCount = 25;
+
+class WebmConcatTests : public ::testing::Test {
+ public:
+  WebmConcatTests() = default;
+  ~WebmConcatTests() = default;
+
+  // Frame payloads identify the input and the frame.
+  static std::vector<std::uint8_t> FrameData(int input, int frame) {
+    std::vector<std::uint8_t> data(12 + frame % 5);
+    for (std::size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<std::uint8_t>(input * 101 + frame * 7 + i);
+    return data;
+  }
+
+  // Writes |kFrameCount| video frames with a default duration, and a
+  // keyframe and a cluster every 10 frames.
+  void WriteInput(const std::string& file_name, int input, int width) {
+    mkvmuxer::MkvWriter writer;
+    ASSERT_TRUE(writer.Open(file_name.c_str()));
+    mkvmuxer::Segment segment;
+    ASSERT_TRUE(segment.Init(&writer));
+    segment.set_mode(mkvmuxer::Segment::kFile);
+    ASSERT_EQ(static_cast<std::uint64_t>(test::kVideoTrackNumber),
+              segment.AddVideoTrack(width, test::kHeight,
+                                    test::kVideoTrackNumber));
+    mkvmuxer::Track* const track =
+        segment.GetTrackByNumber(test::kVideoTrackNumber);
+    ASSERT_TRUE(track != nullptr);
+    track->set_default_duration(kFrameDuration);
+
+    for (int frame = 0; frame < kFrameCount; ++frame) {
+      const std::vector<std::uint8_t> data = FrameData(input, frame);
+      ASSERT_TRUE(segment.AddFrame(&data[0], data.size(),
+                                   test::kVideoTrackNumber,
+                                   frame * kFrameDuration, frame % 10 == 0));
+    }
+    ASSERT_TRUE(segment.Finalize());
+    writer.Close();
+  }
+
+  const libwebm::TempFileDeleter input1_;
+  const libwebm::TempFileDeleter input2_;
+  const libwebm::TempFileDeleter output_;
+};
+
+TEST_F(WebmConcatTests, ConcatCopiesClusters) {
+  WriteInput(input1_.name(), 1, test::kWidth);
+  WriteInput(input2_.name(), 2, test::kWidth);
+
+  std::vector<std::string> inputs;
+  inputs.push_back(input1_.name());
+  inputs.push_back(input2_.name());
+
+  libwebm::WebmConcat concat(output_.name());
+  ASSERT_TRUE(concat.Concat(inputs));
+  EXPECT_EQ(0, concat.stats().clusters_rewritten);
+  EXPECT_EQ(6, concat.stats().clusters_copied);
+  EXPECT_EQ(2 * kFrameCount, concat.stats().blocks_written);
+
+  test::MkvParser parser;
+  ASSERT_TRUE(test::ParseMkvFileReleaseParser(output_.name(), &parser));
+  ASSERT_TRUE(test::ValidateCues(parser.segment, parser.reader));
+  ASSERT_TRUE(parser.segment->GetCues() != nullptr);
+
+  // The second input follows the last frame of the first.
+  int index = 0;
+  const mkvparser::Cluster* cluster = parser.segment->GetFirst();
+  while (cluster != nullptr && !cluster->EOS()) {
+    const mkvparser::BlockEntry* entry = nullptr;
+    ASSERT_EQ(0, cluster->GetFirst(entry));
+    while (entry != nullptr && !entry->EOS()) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      const int input = index < kFrameCount ? 1 : 2;
+      const int frame = index % kFrameCount;
+      EXPECT_EQ(index * kFrameDuration, block->GetTime(cluster));
+      EXPECT_EQ(frame % 10 == 0, block->IsKey());
+
+      const mkvparser::Block::Frame& block_frame = block->GetFrame(0);
+      std::vector<std::uint8_t> data(block_frame.len);
+      ASSERT_EQ(0, block_frame.Read(parser.reader, &data[0]));
+      EXPECT_TRUE(data == FrameData(input, frame));
+
+      ++index;
+      ASSERT_EQ(0, cluster->GetNext(entry, entry));
+    }
+    cluster = parser.segment->GetNext(cluster);
+  }
+  EXPECT_EQ(2 * kFrameCount, index);
+  EXPECT_EQ(2 * kFrameCount * kFrameDuration,
+            parser.segment->GetInfo()->GetDuration());
+}
+
+TEST_F(WebmConcatTests, IncompatibleTracks) {
+  WriteInput(input1_.name(), 1, test::kWidth);
+  WriteInput(input2_.name(), 2, test::kWidth * 2);
+
+  std::vector<std::string> inputs;
+  inputs.push_back(input1_.name());
+  inputs.push_back(input2_.name());
+
+  libwebm::WebmConcat concat(output_.name());
+  EXPECT_FALSE(concat.Concat(inputs));
+}
+
+}  // namespace
@@ -0,0 +1,140 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_index.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "common/file_util.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+#include "testing/test_util.h"
+
+namespace {
+
+const std::int64_t kMillisecond = 1000000;
+const std::int64_t kFrameDuration = 40 * kMillisecond;
+const int kFrameCount = 50;
+const int kKeyframeInterval = 10;
+const std::size_t kFrameSize = 4000;
+
+class WebmIndexTests : public ::testing::Test {
+ public:
+  WebmIndexTests() = default;
+  ~WebmIndexTests() = default;
+
+  // Writes video frames with a keyframe and a cluster every
+  // |kKeyframeInterval| frames, with or without Cues.
+  void WriteInput(mkvmuxer::Segment::Mode mode, bool output_cues) {
+    mkvmuxer::MkvWriter writer;
+    ASSERT_TRUE(writer.Open(file_.name().c_str()));
+    mkvmuxer::Segment segment;
+    ASSERT_TRUE(segment.Init(&writer));
+    segment.set_mode(mode);
+    segment.OutputCues(output_cues);
+    ASSERT_EQ(static_cast<std::uint64_t>(test::kVideoTrackNumber),
+              segment.AddVideoTrack(test::kWidth, test::kHeight,
+                                    test::kVideoTrackNumber));
+
+    const std::vector<std::uint8_t> data(kFrameSize, 0x5A);
+    for (int frame = 0; frame < kFrameCount; ++frame) {
+      ASSERT_TRUE(segment.AddFrame(&data[0], data.size(),
+                                   test::kVideoTrackNumber,
+                                   frame * kFrameDuration,
+                                   frame % kKeyframeInterval == 0));
+    }
+    ASSERT_TRUE(segment.Finalize());
+    writer.Close();
+  }
+
+  std::vector<std::uint8_t> ReadFile() const {
+    std::vector<std::uint8_t> data;
+    FILE* const file = std::fopen(file_.name().c_str(), "rb");
+    if (file == nullptr)
+      return data;
+    int c;
+    while ((c = std::fgetc(file)) != EOF)
+      data.push_back(static_cast<std::uint8_t>(c));
+    std::fclose(file);
+    return data;
+  }
+
+  const std::string& file_name() const { return file_.name(); }
+
+ private:
+  const libwebm::TempFileDeleter file_;
+};
+
+TEST_F(WebmIndexTests, AddsCues) {
+  WriteInput(mkvmuxer::Segment::kFile, false);
+  std::int64_t duration = 0;
+  {
+    test::MkvParser parser;
+    ASSERT_TRUE(test::ParseMkvFileReleaseParser(file_name(), &parser));
+    ASSERT_TRUE(parser.segment->GetCues() == nullptr);
+    duration = parser.segment->GetInfo()->GetDuration();
+  }
+  const std::vector<std::uint8_t> original = ReadFile();
+
+  libwebm::WebmIndex index(file_name());
+  ASSERT_TRUE(index.Index());
+  const libwebm::WebmIndex::Stats& stats = index.stats();
+  EXPECT_FALSE(stats.already_indexed);
+  EXPECT_EQ(kFrameCount / kKeyframeInterval, stats.clusters);
+  EXPECT_EQ(kFrameCount / kKeyframeInterval, stats.cue_points);
+  EXPECT_EQ(static_cast<std::int64_t>(original.size()), stats.file_size);
+  EXPECT_LT(stats.bytes_read * 20, stats.file_size);
+
+  // The clusters are untouched and the Cues follow them.
+  const std::vector<std::uint8_t> indexed = ReadFile();
+  ASSERT_GT(indexed.size(), original.size());
+
+  test::MkvParser parser;
+  ASSERT_TRUE(test::ParseMkvFileReleaseParser(file_name(), &parser));
+  const mkvparser::Segment* const segment = parser.segment;
+  ASSERT_TRUE(segment->GetCues() != nullptr);
+  EXPECT_TRUE(test::ValidateCues(parser.segment, parser.reader));
+  EXPECT_EQ(duration, segment->GetInfo()->GetDuration());
+  EXPECT_EQ(static_cast<long long>(indexed.size()),  // NOLINT
+            segment->m_start + segment->m_size);
+
+  const mkvparser::Cluster* const first = segment->GetFirst();
+  ASSERT_TRUE(first != nullptr && !first->EOS());
+  const std::size_t clusters_start =
+      static_cast<std::size_t>(first->m_element_start);
+  EXPECT_TRUE(std::equal(original.begin() + clusters_start, original.end(),
+                         indexed.begin() + clusters_start));
+
+  const mkvparser::Cues* const cues = segment->GetCues();
+  while (cues->LoadCuePoint()) {
+  }
+  EXPECT_EQ(kFrameCount / kKeyframeInterval, cues->GetCount());
+
+  // A second run finds the Cues.
+  libwebm::WebmIndex again(file_name());
+  ASSERT_TRUE(again.Index());
+  EXPECT_TRUE(again.stats().already_indexed);
+}
+
+TEST_F(WebmIndexTests, NoRoomInHeader) {
+  // Live mode reserves no space for a SeekHead.
+  WriteInput(mkvmuxer::Segment::kLive, false);
+  const std::vector<std::uint8_t> original = ReadFile();
+
+  libwebm::WebmIndex index(file_name());
+  EXPECT_FALSE(index.Index());
+  EXPECT_TRUE(ReadFile() == original);
+}
+
+}  // namespace
@@ -0,0 +1,224 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_trim.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "common/file_util.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+#include "testing/test_util.h"
+
+namespace {
+
+const std::int64_t kMillisecond = 1000000;
+const std::int64_t kVideoFrameDuration = 33 * kMillisecond;
+const std::int64_t kAudioFrameDuration = 20 * kMillisecond;
+const int kKeyframeInterval = 10;
+
+// A block read back from a parsed file.
+struct ParsedBlock {
+  std::int64_t track;
+  std::int64_t time_ns;
+  bool is_key;
+  std::vector<std::uint8_t> data;
+};
+
+class WebmTrimTests : public ::testing::Test {
+ public:
+  WebmTrimTests() = default;
+  ~WebmTrimTests() = default;
+
+  // Frame payloads identify their track and timestamp.
+  static std::vector<std::uint8_t> FrameData(std::int64_t track,
+                                             std::int64_t time_ns) {
+    const std::int64_t ms = time_ns / kMillisecond;
+    std::vector<std::uint8_t> data(16 + ms % 7);
+    for (std::size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<std::uint8_t>(track * 31 + ms + i);
+    return data;
+  }
+
+  // Writes |duration_ns| of interleaved video and audio frames, with a
+  // cluster per video keyframe, or audio only with short clusters.
+  void WriteInput(std::int64_t duration_ns, bool with_video) {
+    mkvmuxer::MkvWriter writer;
+    ASSERT_TRUE(writer.Open(input_.name().c_str()));
+    mkvmuxer::Segment segment;
+    ASSERT_TRUE(segment.Init(&writer));
+    segment.set_mode(mkvmuxer::Segment::kFile);
+
+    if (with_video) {
+      ASSERT_EQ(static_cast<std::uint64_t>(test::kVideoTrackNumber),
+                segment.AddVideoTrack(test::kWidth, test::kHeight,
+                                      test::kVideoTrackNumber));
+    } else {
+      segment.set_max_cluster_duration(100 * kMillisecond);
+    }
+    ASSERT_EQ(static_cast<std::uint64_t>(test::kAudioTrackNumber),
+              segment.AddAudioTrack(test::kSampleRate, test::kChannels,
+                                    test::kAudioTrackNumber));
+    if (!with_video) {
+      ASSERT_TRUE(segment.CuesTrack(test::kAudioTrackNumber));
+    }
+
+    std::int64_t video_time = with_video ? 0 : duration_ns;
+    std::int64_t audio_time = 0;
+    int video_frame = 0;
+    while (video_time < duration_ns || audio_time < duration_ns) {
+      if (video_time <= audio_time) {
+        const std::vector<std::uint8_t> data =
+            FrameData(test::kVideoTrackNumber, video_time);
+        ASSERT_TRUE(segment.AddFrame(&data[0], data.size(),
+                                     test::kVideoTrackNumber, video_time,
+                                     video_frame % kKeyframeInterval == 0));
+        ++video_frame;
+        video_time += kVideoFrameDuration;
+      } else {
+        const std::vector<std::uint8_t> data =
+            FrameData(test::kAudioTrackNumber, audio_time);
+        ASSERT_TRUE(segment.AddFrame(&data[0], data.size(),
+                                     test::kAudioTrackNumber, audio_time,
+                                     true));
+        audio_time += kAudioFrameDuration;
+      }
+    }
+    ASSERT_TRUE(segment.Finalize());
+    writer.Close();
+  }
+
+  void ReadBlocks(const std::string& file_name,
+                  std::vector<ParsedBlock>* blocks) {
+    test::MkvParser parser;
+    ASSERT_TRUE(test::ParseMkvFileReleaseParser(file_name, &parser));
+    ASSERT_TRUE(test::ValidateCues(parser.segment, parser.reader));
+
+    const mkvparser::Cluster* cluster = parser.segment->GetFirst();
+    while (cluster != nullptr && !cluster->EOS()) {
+      const mkvparser::BlockEntry* entry = nullptr;
+      ASSERT_EQ(0, cluster->GetFirst(entry));
+      while (entry != nullptr && !entry->EOS()) {
+        const mkvparser::Block* const block = entry->GetBlock();
+        ParsedBlock parsed;
+        parsed.track = block->GetTrackNumber();
+        parsed.time_ns = block->GetTime(cluster);
+        parsed.is_key = block->IsKey();
+        const mkvparser::Block::Frame& frame = block->GetFrame(0);
+        parsed.data.resize(frame.len);
+        ASSERT_EQ(0, frame.Read(parser.reader, &parsed.data[0]));
+        blocks->push_back(parsed);
+        ASSERT_EQ(0, cluster->GetNext(entry, entry));
+      }
+      cluster = parser.segment->GetNext(cluster);
+    }
+  }
+
+  const std::string& input_name() const { return input_.name(); }
+  const std::string& output_name() const { return output_.name(); }
+
+ private:
+  const libwebm::TempFileDeleter input_;
+  const libwebm::TempFileDeleter output_;
+};
+
+TEST_F(WebmTrimTests, TrimStartsAtKeyframe) {
+  WriteInput(3000 * kMillisecond, true);
+
+  libwebm::WebmTrim trim(input_name(), output_name());
+  ASSERT_TRUE(trim.Trim(1000 * kMillisecond, 2000 * kMillisecond));
+
+  std::vector<ParsedBlock> blocks;
+  ReadBlocks(output_name(), &blocks);
+  ASSERT_FALSE(blocks.empty());
+
+  // The keyframe at or before 1000 ms becomes time 0.
+  const std::int64_t base = kKeyframeInterval * 3 * kVideoFrameDuration;
+  EXPECT_EQ(test::kVideoTrackNumber, blocks[0].track);
+  EXPECT_TRUE(blocks[0].is_key);
+  EXPECT_EQ(0, blocks[0].time_ns);
+
+  int video_count = 0;
+  int audio_count = 0;
+  for (const ParsedBlock& block : blocks) {
+    const std::int64_t input_time = block.time_ns + base;
+    EXPECT_GE(input_time, base);
+    EXPECT_LT(input_time, 2000 * kMillisecond);
+    EXPECT_TRUE(block.data == FrameData(block.track, input_time));
+    if (block.track == test::kVideoTrackNumber)
+      ++video_count;
+    else
+      ++audio_count;
+  }
+
+  // Video frames 30 to 60 and audio frames from 1000 ms to 1980 ms.
+  EXPECT_EQ(31, video_count);
+  EXPECT_EQ(50, audio_count);
+
+  const libwebm::WebmTrim::Stats& stats = trim.stats();
+  EXPECT_GT(stats.clusters_copied, 0);
+  EXPECT_GT(stats.clusters_rewritten, 0);
+  EXPECT_EQ(static_cast<std::int64_t>(blocks.size()), stats.blocks_written);
+}
+
+TEST_F(WebmTrimTests, TrimSkipsLeadingClusters) {
+  WriteInput(3000 * kMillisecond, true);
+
+  libwebm::WebmTrim trim(input_name(), output_name());
+  ASSERT_TRUE(trim.Trim(2000 * kMillisecond, 3000 * kMillisecond));
+
+  std::vector<ParsedBlock> blocks;
+  ReadBlocks(output_name(), &blocks);
+  ASSERT_FALSE(blocks.empty());
+  EXPECT_TRUE(blocks[0].is_key);
+
+  // Reading starts at the cluster of the keyframe at 1980 ms, so the blocks
+  // of the clusters before it are never visited, let alone dropped.
+  const libwebm::WebmTrim::Stats& stats = trim.stats();
+  EXPECT_EQ(static_cast<std::int64_t>(blocks.size()), stats.blocks_written);
+  EXPECT_LT(stats.blocks_dropped, 5);
+}
+
+TEST_F(WebmTrimTests, TrimInsideCluster) {
+  WriteInput(1000 * kMillisecond, false);
+
+  libwebm::WebmTrim trim(input_name(), output_name());
+  ASSERT_TRUE(trim.Trim(250 * kMillisecond, 500 * kMillisecond));
+
+  std::vector<ParsedBlock> blocks;
+  ReadBlocks(output_name(), &blocks);
+
+  // Audio frames from 240 ms to 480 ms, with times rebased to 240 ms.
+  ASSERT_EQ(13u, blocks.size());
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    EXPECT_EQ(static_cast<std::int64_t>(i) * kAudioFrameDuration,
+              blocks[i].time_ns);
+    EXPECT_TRUE(blocks[i].data ==
+                FrameData(test::kAudioTrackNumber,
+                          blocks[i].time_ns + 240 * kMillisecond));
+  }
+  EXPECT_GT(trim.stats().clusters_rewritten, 0);
+}
+
+TEST_F(WebmTrimTests, InvalidRange) {
+  WriteInput(1000 * kMillisecond, true);
+  libwebm::WebmTrim trim(input_name(), output_name());
+  EXPECT_FALSE(trim.Trim(500 * kMillisecond, 500 * kMillisecond));
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,283 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_concat.h"
+
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace libwebm {
+
+namespace {
+
+bool SameString(const char* a, const char* b) {
+  if (a == nullptr || b == nullptr)
+    return a == b;
+  return std::strcmp(a, b) == 0;
+}
+
+}  // namespace
+
+bool WebmConcat::Concat(const std::vector<std::string>& input_file_names) {
+  if (input_file_names.empty()) {
+    std::fprintf(stderr, "WebmConcat: no inputs.\n");
+    return false;
+  }
+
+  // Validate the headers of every input before writing anything. The first
+  // input stays open to provide the Tracks element; the others are closed
+  // again.
+  std::unique_ptr<Input> first(new Input());
+  if (!OpenInput(input_file_names[0], first.get())) {
+    std::fprintf(stderr, "WebmConcat: cannot parse %s.\n",
+                 input_file_names[0].c_str());
+    return false;
+  }
+
+  std::int64_t doc_type_version = first->doc_type_version;
+  for (std::size_t i = 1; i < input_file_names.size(); ++i) {
+    Input input;
+    if (!OpenInput(input_file_names[i], &input)) {
+      std::fprintf(stderr, "WebmConcat: cannot parse %s.\n",
+                   input_file_names[i].c_str());
+      return false;
+    }
+
+    if (!IsCompatible(first->segment.get(), input.segment.get())) {
+      std::fprintf(stderr, "WebmConcat: %s is not compatible with %s.\n",
+                   input_file_names[i].c_str(), input_file_names[0].c_str());
+      return false;
+    }
+
+    if (input.doc_type_version > doc_type_version)
+      doc_type_version = input.doc_type_version;
+  }
+
+  // Cue points go to the first video track, or to the first track.
+  const mkvparser::Tracks* const tracks = first->segment->GetTracks();
+  std::int64_t cue_track = 0;
+  for (unsigned long i = 0; i < tracks->GetTracksCount(); ++i) {  // NOLINT
+    const mkvparser::Track* const track = tracks->GetTrackByIndex(i);
+    if (track == nullptr)
+      continue;
+
+    if (cue_track == 0)
+      cue_track = track->GetNumber();
+
+    if (track->GetType() == mkvparser::Track::kVideo) {
+      cue_track = track->GetNumber();
+      break;
+    }
+  }
+
+  // The duration is known once every input has been read. Open() reserves
+  // its element and Close() fills it in.
+  const double kDurationPlaceholder = 1.0;
+  if (!writer_.Open(output_file_name_, first->doc_type, doc_type_version,
+                    "webm_concat", &first->reader, first->segment.get(),
+                    kDurationPlaceholder, cue_track)) {
+    std::fprintf(stderr, "WebmConcat: cannot write output file.\n");
+    return false;
+  }
+
+  std::int64_t offset = 0;
+  for (std::size_t i = 0; i < input_file_names.size(); ++i) {
+    std::unique_ptr<Input> input(std::move(first));
+    if (i > 0) {
+      input.reset(new Input());
+      if (!OpenInput(input_file_names[i], input.get())) {
+        std::fprintf(stderr, "WebmConcat: cannot parse %s.\n",
+                     input_file_names[i].c_str());
+        return false;
+      }
+    }
+
+    if (!WriteInput(offset, input.get())) {
+      std::fprintf(stderr, "WebmConcat: cannot copy %s.\n",
+                   input_file_names[i].c_str());
+      return false;
+    }
+
+    offset += input->duration;
+  }
+
+  writer_.set_duration(static_cast<double>(offset));
+  return writer_.Close();
+}
+
+bool WebmConcat::OpenInput(const std::string& file_name, Input* input) {
+  if (input->reader.Open(file_name.c_str()) != 0)
+    return false;
+
+  long long pos = 0;  // NOLINT
+  mkvparser::EBMLHeader ebml_header;
+  if (ebml_header.Parse(&input->reader, pos) != 0)
+    return false;
+
+  input->doc_type = ebml_header.m_docType ? ebml_header.m_docType : "webm";
+  input->doc_type_version = ebml_header.m_docTypeVersion;
+
+  mkvparser::Segment* segment = nullptr;
+  if (mkvparser::Segment::CreateInstance(&input->reader, pos, segment) != 0)
+    return false;
+  input->segment.reset(segment);
+
+  return segment->ParseHeaders() == 0 && segment->GetInfo() != nullptr &&
+         segment->GetTracks() != nullptr;
+}
+
+bool WebmConcat::WriteInput(std::int64_t offset, Input* input) {
+  mkvparser::Segment* const segment = input->segment.get();
+  const mkvparser::Cluster* written = nullptr;
+  std::int64_t timecode_offset = 0;
+
+  for (;;) {
+    const long status = segment->LoadCluster();  // NOLINT
+    if (status < 0)
+      return false;
+
+    // Write the clusters loaded so far.
+    const mkvparser::Cluster* const last = segment->GetLast();
+    while (last != nullptr && !last->EOS() && written != last) {
+      const mkvparser::Cluster* const cluster =
+          written == nullptr ? segment->GetFirst() : segment->GetNext(written);
+      if (cluster == nullptr || cluster->EOS())
+        return false;
+
+      if (written == nullptr) {
+        input->start_timecode = cluster->GetTimeCode();
+        if (input->start_timecode < 0)
+          return false;
+        timecode_offset = offset - input->start_timecode;
+      }
+
+      if (!writer_.WriteCluster(&input->reader, cluster, timecode_offset,
+                                input->start_timecode, LLONG_MAX)) {
+        return false;
+      }
+      written = cluster;
+    }
+
+    if (status > 0)  // no more clusters
+      break;
+  }
+
+  return GetExtent(input);
+}
+
+bool WebmConcat::GetExtent(Input* input) {
+  mkvparser::Segment* const segment = input->segment.get();
+  const mkvparser::Cluster* const first = segment->GetFirst();
+  const mkvparser::Cluster* const last = segment->GetLast();
+  if (first == nullptr || first->EOS() || last == nullptr || last->EOS())
+    return false;
+
+  const std::int64_t scale = segment->GetInfo()->GetTimeCodeScale();
+  const std::int64_t duration_ns = segment->GetInfo()->GetDuration();
+
+  // Without a duration the input ends after its last block.
+  std::int64_t stop_timecode = 0;
+  const mkvparser::BlockEntry* entry = nullptr;
+  if (last->GetFirst(entry) < 0)
+    return false;
+
+  while (entry != nullptr && !entry->EOS()) {
+    const mkvparser::Block* const block = entry->GetBlock();
+    std::int64_t block_duration = 0;
+
+    if (entry->GetKind() == mkvparser::BlockEntry::kBlockGroup) {
+      const mkvparser::BlockGroup* const group =
+          static_cast<const mkvparser::BlockGroup*>(entry);
+      block_duration = group->GetDurationTimeCode();
+    }
+
+    if (block_duration <= 0) {
+      const mkvparser::Track* const track =
+          segment->GetTracks()->GetTrackByNumber(block->GetTrackNumber());
+      if (track != nullptr)
+        block_duration = track->GetDefaultDuration() / scale;
+    }
+
+    const std::int64_t block_stop =
+        block->GetTimeCode(last) + (block_duration > 0 ? block_duration : 1);
+    if (block_stop > stop_timecode)
+      stop_timecode = block_stop;
+
+    if (last->GetNext(entry, entry) < 0)
+      return false;
+  }
+
+  if (duration_ns > 0 && (duration_ns + scale - 1) / scale > stop_timecode)
+    stop_timecode = (duration_ns + scale - 1) / scale;
+
+  input->duration = stop_timecode - input->start_timecode;
+  return input->duration > 0;
+}
+
+bool WebmConcat::IsCompatible(const mkvparser::Segment* first,
+                              const mkvparser::Segment* other) {
+  if (first->GetInfo()->GetTimeCodeScale() !=
+      other->GetInfo()->GetTimeCodeScale()) {
+    return false;
+  }
+
+  const mkvparser::Tracks* const a = first->GetTracks();
+  const mkvparser::Tracks* const b = other->GetTracks();
+  if (a->GetTracksCount() != b->GetTracksCount())
+    return false;
+
+  for (unsigned long i = 0; i < a->GetTracksCount(); ++i) {  // NOLINT
+    const mkvparser::Track* const ta = a->GetTrackByIndex(i);
+    const mkvparser::Track* const tb = b->GetTrackByIndex(i);
+    if (ta == nullptr || tb == nullptr) {
+      if (ta != tb)
+        return false;
+      continue;
+    }
+
+    if (ta->GetNumber() != tb->GetNumber() || ta->GetType() != tb->GetType() ||
+        !SameString(ta->GetCodecId(), tb->GetCodecId())) {
+      return false;
+    }
+
+    size_t private_size_a = 0;
+    size_t private_size_b = 0;
+    const unsigned char* const private_a = ta->GetCodecPrivate(private_size_a);
+    const unsigned char* const private_b = tb->GetCodecPrivate(private_size_b);
+    if (private_size_a != private_size_b ||
+        (private_size_a > 0 &&
+         std::memcmp(private_a, private_b, private_size_a) != 0)) {
+      return false;
+    }
+
+    if (ta->GetType() == mkvparser::Track::kVideo) {
+      const mkvparser::VideoTrack* const va =
+          static_cast<const mkvparser::VideoTrack*>(ta);
+      const mkvparser::VideoTrack* const vb =
+          static_cast<const mkvparser::VideoTrack*>(tb);
+      if (va->GetWidth() != vb->GetWidth() ||
+          va->GetHeight() != vb->GetHeight()) {
+        return false;
+      }
+    } else if (ta->GetType() == mkvparser::Track::kAudio) {
+      const mkvparser::AudioTrack* const aa =
+          static_cast<const mkvparser::AudioTrack*>(ta);
+      const mkvparser::AudioTrack* const ab =
+          static_cast<const mkvparser::AudioTrack*>(tb);
+      if (aa->GetSamplingRate() != ab->GetSamplingRate() ||
+          aa->GetChannels() != ab->GetChannels()) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace libwebm
@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_EDIT_WEBM_CONCAT_H_
+#define LIBWEBM_EDIT_WEBM_CONCAT_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "edit/webm_edit_writer.h"
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+
+// WebmConcat
+//
+// WebmConcat joins WebM files with identical track layouts into one file
+// without touching frame payloads. Each input's clusters are copied with a
+// timecode offset applied to their Timecode element, so that every input
+// starts where the previous one ended. An input ends at its SegmentInfo
+// duration, or after its last block when it has none.
+//
+// Inputs are compatible when they have the same timecode scale and the same
+// tracks: number, type, codec id and private data, and for video and audio
+// tracks the frame size and the sampling rate and channel count. The Tracks
+// element of the first input is written to the output, with one Cues element
+// covering all inputs.
+//
+// Compatibility is checked from the headers of every input before anything
+// is written. The inputs are then opened and streamed one at a time, and
+// each is released before the next is opened, so memory use is bounded by
+// the largest input rather than growing with all of them. Only the cue
+// points of the output are kept across inputs. An input whose clusters
+// cannot be parsed still stops the concatenation part way through.
+
+namespace libwebm {
+
+class WebmConcat {
+ public:
+  typedef WebmEditWriter::Stats Stats;
+
+  explicit WebmConcat(const std::string& output_file_name)
+      : output_file_name_(output_file_name) {}
+  ~WebmConcat() = default;
+
+  WebmConcat() = delete;
+  WebmConcat(const WebmConcat&) = delete;
+  WebmConcat(WebmConcat&&) = delete;
+
+  // Writes the concatenation of |input_file_names| to the output file.
+  // Returns false when an input cannot be parsed, when the inputs are not
+  // compatible, or when writing fails.
+  bool Concat(const std::vector<std::string>& input_file_names);
+
+  const Stats& stats() const { return writer_.stats(); }
+
+ private:
+  struct Input {
+    mkvparser::MkvReader reader;
+    std::unique_ptr<mkvparser::Segment> segment;
+    std::string doc_type;
+    std::int64_t doc_type_version = 0;
+
+    // Unscaled time of the first cluster and length of the input.
+    std::int64_t start_timecode = 0;
+    std::int64_t duration = 0;
+  };
+
+  // Opens |file_name| and parses its headers, but none of its clusters.
+  static bool OpenInput(const std::string& file_name, Input* input);
+
+  // Copies the clusters of |input| to the output with the input starting at
+  // |offset|, loading them one at a time, and sets its extent.
+  bool WriteInput(std::int64_t offset, Input* input);
+
+  static bool GetExtent(Input* input);
+  static bool IsCompatible(const mkvparser::Segment* first,
+                           const mkvparser::Segment* other);
+
+  const std::string output_file_name_;
+  WebmEditWriter writer_;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_EDIT_WEBM_CONCAT_H_
@@ -0,0 +1,46 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_concat.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+void Usage(const char* argv[]) {
+  printf("Usage: %s <output file> <WebM file> [<WebM file> ...]\n", argv[0]);
+  printf("\n");
+  printf("Joins WebM files with identical tracks without re-encoding.\n");
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc < 3) {
+    Usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::string output_path = argv[1];
+  std::vector<std::string> input_paths;
+  for (int i = 2; i < argc; ++i)
+    input_paths.push_back(argv[i]);
+
+  libwebm::WebmConcat concat(output_path);
+  if (!concat.Concat(input_paths))
+    return EXIT_FAILURE;
+
+  const libwebm::WebmConcat::Stats& stats = concat.stats();
+  printf("clusters copied: %d rewritten: %d\n", stats.clusters_copied,
+         stats.clusters_rewritten);
+  printf("bytes copied: %lld\n",
+         static_cast<long long>(stats.bytes_copied));  // NOLINT
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,324 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_edit_writer.h"
+
+#include <new>
+
+#include "common/webmids.h"
+#include "mkvmuxer/mkvmuxerutil.h"
+
+namespace libwebm {
+
+namespace {
+
+// Cue point for a keyframe written to the output cluster being built.
+struct PendingCue {
+  std::uint64_t time;
+  std::uint64_t block_number;
+};
+
+}  // namespace
+
+bool WebmEditWriter::Open(const std::string& file_name,
+                          const std::string& doc_type,
+                          std::int64_t doc_type_version,
+                          const char* writing_app,
+                          mkvparser::IMkvReader* reader,
+                          const mkvparser::Segment* segment, double duration,
+                          std::int64_t cue_track) {
+  if (reader == nullptr || segment == nullptr ||
+      segment->GetInfo() == nullptr || segment->GetTracks() == nullptr) {
+    return false;
+  }
+
+  cue_track_ = cue_track;
+
+  if (!writer_.Open(file_name.c_str()))
+    return false;
+
+  if (!mkvmuxer::WriteEbmlHeader(&writer_, doc_type_version,
+                                 doc_type.c_str())) {
+    return false;
+  }
+
+  // The segment size is unknown until all clusters are written.
+  if (mkvmuxer::WriteID(&writer_, libwebm::kMkvSegment) != 0)
+    return false;
+  segment_size_pos_ = writer_.Position();
+  if (mkvmuxer::SerializeInt(&writer_, mkvmuxer::kEbmlUnknownValue, 8) != 0)
+    return false;
+  payload_pos_ = writer_.Position();
+
+  if (!seek_head_.Write(&writer_))
+    return false;
+
+  if (!info_.Init())
+    return false;
+  info_.set_timecode_scale(segment->GetInfo()->GetTimeCodeScale());
+  if (duration > 0.0)
+    info_.set_duration(duration);
+  if (writing_app != nullptr)
+    info_.set_writing_app(writing_app);
+
+  if (!seek_head_.AddSeekEntry(libwebm::kMkvInfo,
+                               writer_.Position() - payload_pos_) ||
+      !info_.Write(&writer_)) {
+    return false;
+  }
+
+  const mkvparser::Tracks* const tracks = segment->GetTracks();
+  if (!seek_head_.AddSeekEntry(libwebm::kMkvTracks,
+                               writer_.Position() - payload_pos_)) {
+    return false;
+  }
+
+  ElementSpan tracks_span;
+  tracks_span.start = tracks->m_element_start;
+  tracks_span.stop = tracks->m_element_start + tracks->m_element_size;
+  return CopySpans(reader, std::vector<ElementSpan>(1, tracks_span),
+                   std::vector<const mkvparser::Block*>(), 0);
+}
+
+bool WebmEditWriter::WriteCluster(mkvparser::IMkvReader* reader,
+                                  const mkvparser::Cluster* cluster,
+                                  std::int64_t timecode_offset,
+                                  std::int64_t min_timecode,
+                                  std::int64_t stop_timecode) {
+  // Parse the whole cluster so that its size and entries are known.
+  const mkvparser::BlockEntry* entry = nullptr;
+  if (cluster->GetLast(entry) < 0 || cluster->GetElementSize() <= 0)
+    return false;
+
+  long long pos = cluster->m_element_start;  // NOLINT
+  const long long stop = pos + cluster->GetElementSize();  // NOLINT
+  long len;  // NOLINT
+
+  // Skip the cluster's ID and size fields.
+  if (mkvparser::ReadID(reader, pos, len) != libwebm::kMkvCluster)
+    return false;
+  pos += len;
+  if (mkvparser::ReadUInt(reader, pos, len) < 0)
+    return false;
+  pos += len;
+
+  if (cluster->GetFirst(entry) < 0)
+    return false;
+
+  const std::int64_t timecode = cluster->GetTimeCode();
+  std::vector<ElementSpan> spans;
+  std::vector<const mkvparser::Block*> blocks;
+  std::vector<PendingCue> cues;
+  bool all_kept = true;
+
+  while (pos < stop) {
+    ElementSpan span;
+    span.start = pos;
+
+    long long id, size;  // NOLINT
+    if (mkvparser::ParseElementHeader(reader, pos, stop, id, size) != 0)
+      return false;
+
+    span.stop = pos + size;
+    pos = span.stop;
+
+    switch (id) {
+      case libwebm::kMkvTimecode:
+      case libwebm::kMkvPosition:
+      case libwebm::kMkvPrevSize:
+      case libwebm::kMkvCRC32:
+      case libwebm::kMkvVoid:
+        // Regenerated, no longer valid, or not needed.
+        continue;
+
+      case libwebm::kMkvSimpleBlock:
+      case libwebm::kMkvBlockGroup:
+        break;
+
+      default:
+        spans.push_back(span);
+        continue;
+    }
+
+    // The parser's entries are in element order.
+    if (entry == nullptr)
+      return false;
+
+    const mkvparser::Block* const block = entry->GetBlock();
+    if (block->m_start < span.start || block->m_start >= span.stop)
+      return false;
+
+    if (cluster->GetNext(entry, entry) < 0)
+      return false;
+
+    const std::int64_t block_timecode = block->GetTimeCode(cluster);
+    if (block_timecode < min_timecode || block_timecode >= stop_timecode) {
+      all_kept = false;
+      ++stats_.blocks_dropped;
+      continue;
+    }
+
+    spans.push_back(span);
+    blocks.push_back(block);
+
+    if (block->IsKey() && block->GetTrackNumber() == cue_track_) {
+      PendingCue cue;
+      cue.time = block_timecode + timecode_offset;
+      cue.block_number = blocks.size();
+      cues.push_back(cue);
+    }
+  }
+
+  if (blocks.empty())
+    return true;
+
+  // Clusters that would start before time 0 start at 0 instead, and their
+  // blocks' relative timecodes are adjusted.
+  std::int64_t new_timecode = timecode + timecode_offset;
+  std::int64_t timecode_delta = 0;
+  if (new_timecode < 0) {
+    timecode_delta = new_timecode;
+    new_timecode = 0;
+  }
+
+  std::uint64_t payload_size = mkvmuxer::EbmlElementSize(
+      libwebm::kMkvTimecode, static_cast<mkvmuxer::uint64>(new_timecode));
+  std::int64_t copy_size = 0;
+  for (const ElementSpan& span : spans)
+    copy_size += span.stop - span.start;
+  payload_size += copy_size;
+
+  const std::int64_t cluster_pos = writer_.Position();
+  if (first_cluster_pos_ < 0)
+    first_cluster_pos_ = cluster_pos;
+
+  if (!mkvmuxer::WriteEbmlMasterElement(&writer_, libwebm::kMkvCluster,
+                                        payload_size) ||
+      !mkvmuxer::WriteEbmlElement(
+          &writer_, libwebm::kMkvTimecode,
+          static_cast<mkvmuxer::uint64>(new_timecode)) ||
+      !CopySpans(reader, spans, blocks, timecode_delta)) {
+    return false;
+  }
+
+  for (const PendingCue& pending : cues) {
+    mkvmuxer::CuePoint* const cue = new (std::nothrow) mkvmuxer::CuePoint();
+    if (cue == nullptr)
+      return false;
+
+    cue->set_time(pending.time);
+    cue->set_track(cue_track_);
+    cue->set_cluster_pos(cluster_pos - payload_pos_);
+    cue->set_block_number(pending.block_number);
+
+    if (!cues_.AddCue(cue)) {
+      delete cue;
+      return false;
+    }
+  }
+
+  if (all_kept && timecode_delta == 0)
+    ++stats_.clusters_copied;
+  else
+    ++stats_.clusters_rewritten;
+
+  stats_.blocks_written += blocks.size();
+  stats_.bytes_copied += copy_size;
+  return true;
+}
+
+bool WebmEditWriter::CopySpans(
+    mkvparser::IMkvReader* reader, const std::vector<ElementSpan>& spans,
+    const std::vector<const mkvparser::Block*>& blocks,
+    std::int64_t timecode_delta) {
+  std::size_t block_index = 0;
+  std::size_t i = 0;
+
+  while (i < spans.size()) {
+    // Merge contiguous spans into one read and one write.
+    const std::int64_t start = spans[i].start;
+    std::int64_t stop = spans[i].stop;
+
+    for (++i; i < spans.size() && spans[i].start == stop; ++i)
+      stop = spans[i].stop;
+
+    const std::int64_t size = stop - start;
+    if (size <= 0 || size > 0x7FFFFFFF)
+      return false;
+
+    if (buffer_.size() < static_cast<std::size_t>(size))
+      buffer_.resize(static_cast<std::size_t>(size));
+
+    if (reader->Read(start, static_cast<long>(size), &buffer_[0]) != 0)
+      return false;
+
+    // Patch the relative timecodes of the blocks inside this run.
+    for (; timecode_delta != 0 && block_index < blocks.size() &&
+           blocks[block_index]->m_start < stop;
+         ++block_index) {
+      const std::int64_t offset = blocks[block_index]->m_start - start;
+
+      // Skip the track number, a variable size integer.
+      int track_len = 1;
+      std::uint8_t mask = 0x80;
+      while (track_len <= 8 && (buffer_[offset] & mask) == 0) {
+        ++track_len;
+        mask >>= 1;
+      }
+
+      if (track_len > 8 || offset + track_len + 2 > size)
+        return false;
+
+      std::uint8_t* const timecode_bytes = &buffer_[offset + track_len];
+      const std::int16_t old_timecode = static_cast<std::int16_t>(
+          (timecode_bytes[0] << 8) | timecode_bytes[1]);
+      const std::int64_t new_timecode = old_timecode + timecode_delta;
+
+      if (new_timecode < -32768 || new_timecode > 32767)
+        return false;
+
+      timecode_bytes[0] = static_cast<std::uint8_t>((new_timecode >> 8) & 0xFF);
+      timecode_bytes[1] = static_cast<std::uint8_t>(new_timecode & 0xFF);
+    }
+
+    if (writer_.Write(&buffer_[0], static_cast<mkvmuxer::uint32>(size)) != 0)
+      return false;
+  }
+
+  return true;
+}
+
+bool WebmEditWriter::Close() {
+  if (cues_.cue_entries_size() > 0) {
+    if (!seek_head_.AddSeekEntry(libwebm::kMkvCues,
+                                 writer_.Position() - payload_pos_) ||
+        !cues_.Write(&writer_)) {
+      return false;
+    }
+  }
+
+  if (first_cluster_pos_ >= 0 &&
+      !seek_head_.AddSeekEntry(libwebm::kMkvCluster,
+                               first_cluster_pos_ - payload_pos_)) {
+    return false;
+  }
+
+  if (!seek_head_.Finalize(&writer_) || !info_.Finalize(&writer_))
+    return false;
+
+  const std::int64_t end = writer_.Position();
+  if (writer_.Position(segment_size_pos_) != 0 ||
+      mkvmuxer::WriteUIntSize(&writer_, end - payload_pos_, 8) != 0 ||
+      writer_.Position(end) != 0) {
+    return false;
+  }
+
+  writer_.Close();
+  return true;
+}
+
+}  // namespace libwebm
@@ -0,0 +1,116 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_EDIT_WEBM_EDIT_WRITER_H_
+#define LIBWEBM_EDIT_WEBM_EDIT_WRITER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvparser.h"
+
+// WebmEditWriter
+//
+// WebmEditWriter writes a WebM file assembled from clusters of parsed input
+// files without touching frame payloads. It is shared by the editing tools.
+//
+// The output consists of the EBML header, a SeekHead, a new SegmentInfo, the
+// Tracks element copied unchanged from an input, the copied clusters and a
+// Cues element generated for the keyframes of one track.
+//
+// Clusters are written by copying their child elements as raw byte ranges;
+// contiguous elements are copied with a single read and a single write. Only
+// the cluster Timecode element is rewritten. When a cluster would start
+// before time 0 it starts at 0 instead and the relative timecodes of its
+// blocks are patched in place.
+
+namespace libwebm {
+
+class WebmEditWriter {
+ public:
+  struct Stats {
+    // Clusters copied byte-for-byte apart from their timecode.
+    int clusters_copied = 0;
+
+    // Clusters rebuilt from a subset of their blocks, or with patched block
+    // timecodes.
+    int clusters_rewritten = 0;
+
+    // Blocks written to and dropped from the output.
+    std::int64_t blocks_written = 0;
+    std::int64_t blocks_dropped = 0;
+
+    // Bytes of cluster data copied from the inputs.
+    std::int64_t bytes_copied = 0;
+  };
+
+  WebmEditWriter() = default;
+  ~WebmEditWriter() = default;
+
+  WebmEditWriter(const WebmEditWriter&) = delete;
+  WebmEditWriter(WebmEditWriter&&) = delete;
+
+  // Creates |file_name| and writes the headers. The Tracks element of
+  // |segment| is copied from |reader|. |duration| is in units of the
+  // segment's timecode scale and is omitted when not positive. Cue points are
+  // written for the keyframes of |cue_track|. Returns true on success.
+  bool Open(const std::string& file_name, const std::string& doc_type,
+            std::int64_t doc_type_version, const char* writing_app,
+            mkvparser::IMkvReader* reader, const mkvparser::Segment* segment,
+            double duration, std::int64_t cue_track);
+
+  // Appends the blocks of |cluster| whose unscaled time lies in
+  // [|min_timecode|, |stop_timecode|), with all times shifted by
+  // |timecode_offset|. The cluster is read from |reader|. Nothing is written
+  // when no block is kept. Returns true on success.
+  bool WriteCluster(mkvparser::IMkvReader* reader,
+                    const mkvparser::Cluster* cluster,
+                    std::int64_t timecode_offset, std::int64_t min_timecode,
+                    std::int64_t stop_timecode);
+
+  // Sets the duration that Close() writes over the one given to Open(),
+  // for writers that only know it once every cluster has been written.
+  // Open() must have been given a positive duration to reserve the element.
+  void set_duration(double duration) { info_.set_duration(duration); }
+
+  // Writes Cues, finalizes SeekHead, the duration and the segment size, and
+  // closes the file. Returns true on success.
+  bool Close();
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // Position and size of one element in an input file.
+  struct ElementSpan {
+    std::int64_t start = 0;
+    std::int64_t stop = 0;
+  };
+
+  bool CopySpans(mkvparser::IMkvReader* reader,
+                 const std::vector<ElementSpan>& spans,
+                 const std::vector<const mkvparser::Block*>& blocks,
+                 std::int64_t timecode_delta);
+
+  mkvmuxer::MkvWriter writer_;
+  mkvmuxer::SegmentInfo info_;
+  mkvmuxer::SeekHead seek_head_;
+  mkvmuxer::Cues cues_;
+  std::int64_t segment_size_pos_ = 0;
+  std::int64_t payload_pos_ = 0;
+  std::int64_t first_cluster_pos_ = -1;
+  std::int64_t cue_track_ = 0;
+
+  std::vector<std::uint8_t> buffer_;
+  Stats stats_;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_EDIT_WEBM_EDIT_WRITER_H_
@@ -0,0 +1,613 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_index.h"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/webmids.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvmuxerutil.h"
+#include "mkvmuxer/mkvwriter.h"
+
+namespace libwebm {
+
+namespace {
+
+// Elements that end a cluster of unknown size.
+bool IsTopLevelId(std::int64_t id) {
+  return id == libwebm::kMkvCluster || id == libwebm::kMkvCues ||
+         id == libwebm::kMkvTags || id == libwebm::kMkvChapters ||
+         id == libwebm::kMkvSeekHead || id == libwebm::kMkvInfo ||
+         id == libwebm::kMkvTracks;
+}
+
+// Reads the ID and size of the element header at |pos|.
+bool ReadHeader(mkvparser::IMkvReader* reader, std::int64_t pos,
+                std::int64_t* id, std::int64_t* size, bool* unknown_size,
+                std::int64_t* header_size) {
+  long id_len;  // NOLINT
+  *id = mkvparser::ReadID(reader, pos, id_len);
+  if (*id < 0)
+    return false;
+
+  long size_len;  // NOLINT
+  *size = mkvparser::ReadUInt(reader, pos + id_len, size_len);
+  if (*size < 0)
+    return false;
+
+  *unknown_size = *size == (1LL << (7 * size_len)) - 1;
+  *header_size = id_len + size_len;
+  return true;
+}
+
+// Reads the track number, relative timecode and flags of the Block or
+// SimpleBlock whose payload starts at |pos|.
+bool ReadBlockHeader(mkvparser::IMkvReader* reader, std::int64_t pos,
+                     std::int64_t stop, std::int64_t* track,
+                     std::int64_t* timecode, int* flags) {
+  long len;  // NOLINT
+  *track = mkvparser::ReadUInt(reader, pos, len);
+  if (*track <= 0 || pos + len + 3 > stop)
+    return false;
+
+  unsigned char buf[3];
+  if (reader->Read(pos + len, 3, buf) != 0)
+    return false;
+
+  *timecode = static_cast<std::int16_t>((buf[0] << 8) | buf[1]);
+  *flags = buf[2];
+  return true;
+}
+
+// Writes a Void element of exactly |size| bytes, which must be at least 2.
+bool WriteVoid(mkvmuxer::IMkvWriter* writer, std::int64_t size) {
+  for (int width = 1; width <= 8; ++width) {
+    const std::int64_t payload_size = size - 1 - width;
+    if (payload_size < 0)
+      break;
+
+    if (mkvmuxer::GetCodedUIntSize(payload_size) > width)
+      continue;
+
+    if (mkvmuxer::WriteID(writer, libwebm::kMkvVoid) != 0 ||
+        mkvmuxer::WriteUIntSize(writer, payload_size, width) != 0) {
+      return false;
+    }
+
+    const std::vector<std::uint8_t> zeros(
+        static_cast<std::size_t>(payload_size));
+    return payload_size == 0 ||
+           writer->Write(&zeros[0], static_cast<mkvmuxer::uint32>(
+                                        payload_size)) == 0;
+  }
+
+  return false;
+}
+
+}  // namespace
+
+int WebmIndex::CountingReader::Read(long long pos, long len,  // NOLINT
+                                    unsigned char* buf) {
+  bytes_read_ += len;
+  return reader_->Read(pos, len, buf);
+}
+
+int WebmIndex::CountingReader::Length(long long* total,  // NOLINT
+                                      long long* available) {  // NOLINT
+  return reader_->Length(total, available);
+}
+
+bool WebmIndex::Index() {
+  if (!OpenFile())
+    return false;
+
+  // Cues found before the clusters, or referenced by the SeekHead.
+  bool has_cues = segment_->GetCues() != nullptr;
+  const mkvparser::SeekHead* const seek_head = segment_->GetSeekHead();
+  for (int i = 0; seek_head != nullptr && i < seek_head->GetCount(); ++i)
+    has_cues = has_cues || seek_head->GetEntry(i)->id == libwebm::kMkvCues;
+
+  if (has_cues) {
+    stats_.already_indexed = true;
+    return true;
+  }
+
+  if (!ScanSegment() || !ReadInfo())
+    return false;
+
+  if (cues_.empty() && existing_cues_pos_ < 0) {
+    std::fprintf(stderr, "WebmIndex: no keyframes to index.\n");
+    return false;
+  }
+
+  stats_.bytes_read = reader_.bytes_read();
+  return WriteIndex();
+}
+
+bool WebmIndex::OpenFile() {
+  if (file_reader_.Open(file_name_.c_str()) != 0) {
+    std::fprintf(stderr, "WebmIndex: cannot open file.\n");
+    return false;
+  }
+
+  long long pos = 0;  // NOLINT
+  mkvparser::EBMLHeader ebml_header;
+  if (ebml_header.Parse(&reader_, pos) != 0) {
+    std::fprintf(stderr, "WebmIndex: invalid EBML header.\n");
+    return false;
+  }
+
+  mkvparser::Segment* segment = nullptr;
+  if (mkvparser::Segment::CreateInstance(&reader_, pos, segment) != 0) {
+    std::fprintf(stderr, "WebmIndex: cannot create segment.\n");
+    return false;
+  }
+  segment_.reset(segment);
+
+  if (segment_->ParseHeaders() != 0 || segment_->GetInfo() == nullptr ||
+      segment_->GetTracks() == nullptr) {
+    std::fprintf(stderr, "WebmIndex: cannot parse segment headers.\n");
+    return false;
+  }
+
+  long long total, available;  // NOLINT
+  if (reader_.Length(&total, &available) != 0 || total < 0)
+    return false;
+  stats_.file_size = total;
+
+  // The Cues are appended to the file, so the segment must end there.
+  segment_stop_ = total;
+  if (segment_->m_size >= 0 &&
+      segment_->m_start + segment_->m_size != segment_stop_) {
+    std::fprintf(stderr, "WebmIndex: segment does not end the file.\n");
+    return false;
+  }
+
+  const mkvparser::Tracks* const tracks = segment_->GetTracks();
+  for (unsigned long i = 0; i < tracks->GetTracksCount(); ++i) {  // NOLINT
+    const mkvparser::Track* const track = tracks->GetTrackByIndex(i);
+    if (track == nullptr)
+      continue;
+
+    if (cue_track_ == 0)
+      cue_track_ = track->GetNumber();
+
+    if (track->GetType() == mkvparser::Track::kVideo) {
+      cue_track_ = track->GetNumber();
+      break;
+    }
+  }
+
+  if (cue_track_ == 0) {
+    std::fprintf(stderr, "WebmIndex: no tracks.\n");
+    return false;
+  }
+
+  return true;
+}
+
+bool WebmIndex::ScanSegment() {
+  std::int64_t pos = segment_->m_start;
+  bool in_header = true;
+  header_stop_ = pos;
+
+  while (pos < segment_stop_) {
+    std::int64_t id, size, header_size;
+    bool unknown_size;
+    if (!ReadHeader(&reader_, pos, &id, &size, &unknown_size, &header_size)) {
+      std::fprintf(stderr, "WebmIndex: invalid element at %lld.\n",
+                   static_cast<long long>(pos));  // NOLINT
+      return false;
+    }
+
+    const std::int64_t payload = pos + header_size;
+
+    if (id == libwebm::kMkvCluster) {
+      in_header = false;
+
+      const std::int64_t stop = unknown_size ? -1 : payload + size;
+      if (stop > segment_stop_ || !ScanCluster(pos, stop, &pos)) {
+        std::fprintf(stderr, "WebmIndex: truncated or invalid cluster.\n");
+        return false;
+      }
+
+      ++stats_.clusters;
+      continue;
+    }
+
+    if (unknown_size || payload + size > segment_stop_) {
+      std::fprintf(stderr, "WebmIndex: truncated or invalid element.\n");
+      return false;
+    }
+
+    if (in_header) {
+      if (id == libwebm::kMkvSeekHead || id == libwebm::kMkvVoid ||
+          id == libwebm::kMkvInfo) {
+        header_stop_ = payload + size;
+        if (id == libwebm::kMkvInfo)
+          info_in_header_ = true;
+      } else {
+        in_header = false;
+      }
+    }
+
+    if (id == libwebm::kMkvCues)
+      existing_cues_pos_ = pos - segment_->m_start;
+
+    pos = payload + size;
+  }
+
+  return true;
+}
+
+bool WebmIndex::ScanCluster(std::int64_t pos, std::int64_t stop,
+                            std::int64_t* cluster_stop) {
+  std::int64_t id, size, header_size;
+  bool unknown_size;
+  if (!ReadHeader(&reader_, pos, &id, &size, &unknown_size, &header_size))
+    return false;
+
+  CueEntry cue;
+  cue.time = 0;
+  cue.cluster_pos = pos - segment_->m_start;
+  cue.block_number = 0;
+
+  // A cluster of unknown size ends at the next top-level element.
+  const std::int64_t limit = stop >= 0 ? stop : segment_stop_;
+  std::int64_t timecode = -1;
+  bool found_key = false;
+
+  pos += header_size;
+
+  while (pos < limit) {
+    if (!ReadHeader(&reader_, pos, &id, &size, &unknown_size, &header_size))
+      return false;
+
+    if (stop < 0 && IsTopLevelId(id))
+      break;
+
+    const std::int64_t payload = pos + header_size;
+    if (unknown_size || payload + size > limit)
+      return false;
+
+    if (id == libwebm::kMkvTimecode) {
+      timecode = mkvparser::UnserializeUInt(&reader_, payload, size);
+      if (timecode < 0)
+        return false;
+    } else if (id == libwebm::kMkvSimpleBlock) {
+      ++cue.block_number;
+
+      std::int64_t track, block_timecode;
+      int flags;
+      if (timecode < 0 ||
+          !ReadBlockHeader(&reader_, payload, payload + size, &track,
+                           &block_timecode, &flags)) {
+        return false;
+      }
+
+      AddBlock(track, timecode + block_timecode, 0, (flags & 0x80) != 0, cue,
+               &found_key);
+    } else if (id == libwebm::kMkvBlockGroup) {
+      ++cue.block_number;
+
+      if (timecode < 0 ||
+          !ScanBlockGroup(payload, payload + size, timecode, cue,
+                          &found_key)) {
+        return false;
+      }
+    }
+
+    pos = payload + size;
+  }
+
+  *cluster_stop = pos;
+  return true;
+}
+
+bool WebmIndex::ScanBlockGroup(std::int64_t pos, std::int64_t stop,
+                               std::int64_t cluster_timecode,
+                               const CueEntry& cue, bool* found_key) {
+  std::int64_t block_pos = -1;
+  std::int64_t block_stop = -1;
+  std::int64_t duration = 0;
+  bool is_key = true;
+
+  while (pos < stop) {
+    long long child_pos = pos;  // NOLINT
+    long long id, size;  // NOLINT
+    if (mkvparser::ParseElementHeader(&reader_, child_pos, stop, id, size) !=
+        0) {
+      return false;
+    }
+
+    if (id == libwebm::kMkvBlock) {
+      block_pos = child_pos;
+      block_stop = child_pos + size;
+    } else if (id == libwebm::kMkvReferenceBlock) {
+      is_key = false;
+    } else if (id == libwebm::kMkvBlockDuration) {
+      duration = mkvparser::UnserializeUInt(&reader_, child_pos, size);
+      if (duration < 0)
+        return false;
+    }
+
+    pos = child_pos + size;
+  }
+
+  std::int64_t track, block_timecode;
+  int flags;
+  if (block_pos < 0 ||
+      !ReadBlockHeader(&reader_, block_pos, block_stop, &track,
+                       &block_timecode, &flags)) {
+    return false;
+  }
+
+  AddBlock(track, cluster_timecode + block_timecode, duration, is_key, cue,
+           found_key);
+  return true;
+}
+
+void WebmIndex::AddBlock(std::int64_t track, std::int64_t time,
+                         std::int64_t duration, bool is_key,
+                         const CueEntry& cue, bool* found_key) {
+  if (duration <= 0) {
+    const mkvparser::Track* const pTrack =
+        segment_->GetTracks()->GetTrackByNumber(static_cast<long>(track));
+    if (pTrack != nullptr) {
+      duration = static_cast<std::int64_t>(pTrack->GetDefaultDuration()) /
+                 segment_->GetInfo()->GetTimeCodeScale();
+    }
+  }
+
+  if (time + duration > end_timecode_)
+    end_timecode_ = time + duration;
+
+  if (!*found_key && is_key && track == cue_track_) {
+    CueEntry entry = cue;
+    entry.time = time;
+    cues_.push_back(entry);
+    *found_key = true;
+  }
+}
+
+bool WebmIndex::ReadInfo() {
+  const mkvparser::SegmentInfo* const info = segment_->GetInfo();
+  const long long stop = info->m_start + info->m_size;  // NOLINT
+  long long pos = info->m_start;  // NOLINT
+
+  while (pos < stop) {
+    const long long child_start = pos;  // NOLINT
+    long long id, size;  // NOLINT
+    if (mkvparser::ParseElementHeader(&reader_, pos, stop, id, size) != 0)
+      return false;
+
+    if (id == libwebm::kMkvDuration) {
+      duration_pos_ = pos;
+      duration_size_ = size;
+    } else {
+      const std::size_t offset = info_payload_.size();
+      const long len = static_cast<long>(pos + size - child_start);  // NOLINT
+      info_payload_.resize(offset + len);
+      if (reader_.Read(child_start, len, &info_payload_[offset]) != 0)
+        return false;
+    }
+
+    pos += size;
+  }
+
+  // Keep a longer duration than the scanned one, which may include the
+  // duration of the last frames.
+  const std::int64_t scale = info->GetTimeCodeScale();
+  const std::int64_t duration = info->GetDuration();
+  if (duration > 0 && (duration + scale - 1) / scale > end_timecode_)
+    end_timecode_ = (duration + scale - 1) / scale;
+
+  return true;
+}
+
+bool WebmIndex::WriteIndex() {
+  const std::int64_t segment_start = segment_->m_start;
+
+  // Cues, unless they already follow the clusters.
+  mkvmuxer::Cues cues;
+  std::int64_t cues_pos = existing_cues_pos_;
+  std::int64_t cues_size = 0;
+
+  if (cues_pos < 0) {
+    for (const CueEntry& entry : cues_) {
+      mkvmuxer::CuePoint* const cue_point =
+          new (std::nothrow) mkvmuxer::CuePoint();  // NOLINT
+      if (cue_point == nullptr)
+        return false;
+
+      cue_point->set_time(entry.time);
+      cue_point->set_track(cue_track_);
+      cue_point->set_cluster_pos(entry.cluster_pos);
+      cue_point->set_block_number(entry.block_number);
+      if (!cues.AddCue(cue_point)) {
+        delete cue_point;
+        return false;
+      }
+    }
+
+    cues_pos = segment_stop_ - segment_start;
+    cues_size = cues.Size();
+    stats_.cue_points = static_cast<int>(cues_.size());
+  }
+
+  // SeekHead entries: those of a SeekHead in the rewritten header, apart
+  // from SegmentInfo and Cues, then the elements it is missing.
+  std::vector<std::pair<mkvmuxer::uint64, mkvmuxer::uint64>> entries;
+  const mkvparser::SeekHead* const seek_head = segment_->GetSeekHead();
+
+  if (seek_head != nullptr && seek_head->m_element_start < header_stop_) {
+    for (int i = 0; i < seek_head->GetCount(); ++i) {
+      const mkvparser::SeekHead::Entry* const entry = seek_head->GetEntry(i);
+      if (entry->id != libwebm::kMkvInfo && entry->id != libwebm::kMkvCues)
+        entries.push_back(std::make_pair(entry->id, entry->pos));
+    }
+  }
+
+  const mkvparser::Tracks* const tracks = segment_->GetTracks();
+  const mkvparser::Chapters* const chapters = segment_->GetChapters();
+  const mkvparser::Tags* const tags = segment_->GetTags();
+  const std::int64_t element_starts[][2] = {
+      {libwebm::kMkvTracks, tracks->m_element_start},
+      {libwebm::kMkvChapters, chapters ? chapters->m_element_start : -1},
+      {libwebm::kMkvTags, tags ? tags->m_element_start : -1}};
+
+  for (const auto& element : element_starts) {
+    bool found = element[1] < 0;
+    for (const auto& entry : entries)
+      found = found || entry.first == static_cast<mkvmuxer::uint64>(element[0]);
+
+    if (!found) {
+      entries.push_back(
+          std::make_pair(element[0], element[1] - segment_start));
+    }
+  }
+
+  // The new header is the SeekHead, padding, then SegmentInfo with the
+  // scanned duration, ending where the old header ended.
+  std::uint64_t info_payload_size = 0;
+  std::int64_t info_size = 0;
+  std::int64_t info_pos = segment_->GetInfo()->m_element_start;
+  const float duration = static_cast<float>(end_timecode_);
+
+  if (info_in_header_) {
+    info_payload_size = info_payload_.size() +
+                        mkvmuxer::EbmlElementSize(libwebm::kMkvDuration,
+                                                  duration);
+    info_size = mkvmuxer::EbmlMasterElementSize(libwebm::kMkvInfo,
+                                                info_payload_size) +
+                info_payload_size;
+    info_pos = header_stop_ - info_size;
+  }
+
+  entries.push_back(
+      std::make_pair(libwebm::kMkvInfo, info_pos - segment_start));
+  entries.push_back(std::make_pair(libwebm::kMkvCues, cues_pos));
+
+  std::vector<mkvmuxer::uint64> entry_sizes;
+  std::uint64_t seek_payload_size = 0;
+  for (const auto& entry : entries) {
+    const mkvmuxer::uint64 size =
+        mkvmuxer::EbmlElementSize(libwebm::kMkvSeekID, entry.first) +
+        mkvmuxer::EbmlElementSize(libwebm::kMkvSeekPosition, entry.second);
+    entry_sizes.push_back(size);
+    seek_payload_size +=
+        mkvmuxer::EbmlMasterElementSize(libwebm::kMkvSeek, size) + size;
+  }
+
+  int seek_size_width = mkvmuxer::GetCodedUIntSize(seek_payload_size);
+  const std::int64_t seek_head_size =
+      mkvmuxer::EbmlMasterElementSize(libwebm::kMkvSeekHead,
+                                      seek_payload_size) +
+      seek_payload_size;
+  std::int64_t padding =
+      header_stop_ - segment_start - seek_head_size - info_size;
+
+  if (padding < 0) {
+    std::fprintf(stderr,
+                 "WebmIndex: no room for the SeekHead; remux the file.\n");
+    return false;
+  }
+
+  // A Void takes at least 2 bytes; a single spare byte widens the size
+  // field of the SeekHead instead.
+  if (padding == 1) {
+    ++seek_size_width;
+    padding = 0;
+  }
+
+  // The Segment size is written when it fits in its size field. An unknown
+  // size is left alone otherwise, but a known size has to be updated.
+  const std::int64_t size_pos = segment_->m_element_start + 4;
+  const int size_width = static_cast<int>(segment_start - size_pos);
+  const std::int64_t segment_size = segment_stop_ + cues_size - segment_start;
+  const bool write_size =
+      size_width < 8 ? segment_size < (1LL << (7 * size_width)) - 1 : true;
+
+  if (segment_->m_size >= 0 && !write_size) {
+    std::fprintf(stderr, "WebmIndex: Segment size field is too small.\n");
+    return false;
+  }
+
+  FILE* const file = std::fopen(file_name_.c_str(), "r+b");
+  if (file == nullptr) {
+    std::fprintf(stderr, "WebmIndex: cannot open file for writing.\n");
+    return false;
+  }
+
+  mkvmuxer::MkvWriter writer(file);
+  bool ok = true;
+
+  if (cues_size > 0) {
+    ok = writer.Position(segment_stop_) == 0 && cues.Write(&writer);
+  }
+
+  ok = ok && writer.Position(segment_start) == 0 &&
+       mkvmuxer::WriteID(&writer, libwebm::kMkvSeekHead) == 0 &&
+       mkvmuxer::WriteUIntSize(&writer, seek_payload_size, seek_size_width) ==
+           0;
+
+  for (std::size_t i = 0; ok && i < entries.size(); ++i) {
+    ok = mkvmuxer::WriteEbmlMasterElement(&writer, libwebm::kMkvSeek,
+                                          entry_sizes[i]) &&
+         mkvmuxer::WriteEbmlElement(&writer, libwebm::kMkvSeekID,
+                                    entries[i].first) &&
+         mkvmuxer::WriteEbmlElement(&writer, libwebm::kMkvSeekPosition,
+                                    entries[i].second);
+  }
+
+  if (ok && padding > 0)
+    ok = WriteVoid(&writer, padding);
+
+  if (ok && info_in_header_) {
+    ok = mkvmuxer::WriteEbmlMasterElement(&writer, libwebm::kMkvInfo,
+                                          info_payload_size) &&
+         (info_payload_.empty() ||
+          writer.Write(&info_payload_[0], static_cast<mkvmuxer::uint32>(
+                                              info_payload_.size())) == 0) &&
+         mkvmuxer::WriteEbmlElement(&writer, libwebm::kMkvDuration, duration);
+  } else if (ok && duration_pos_ >= 0) {
+    // SegmentInfo stays in place; only its Duration value is updated.
+    ok = writer.Position(duration_pos_) == 0;
+    if (ok && duration_size_ == 4) {
+      ok = mkvmuxer::SerializeFloat(&writer, duration) == 0;
+    } else if (ok && duration_size_ == 8) {
+      const double value = end_timecode_;
+      std::int64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      ok = mkvmuxer::SerializeInt(&writer, bits, 8) == 0;
+    }
+  }
+
+  if (ok && info_in_header_)
+    ok = writer.Position() == header_stop_;
+
+  if (ok && write_size) {
+    ok = writer.Position(size_pos) == 0 &&
+         mkvmuxer::WriteUIntSize(&writer, segment_size, size_width) == 0;
+  }
+
+  writer.Close();
+  if (std::fclose(file) != 0)
+    ok = false;
+
+  if (!ok)
+    std::fprintf(stderr, "WebmIndex: write failed.\n");
+
+  return ok;
+}
+
+}  // namespace libwebm
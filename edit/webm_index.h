@@ -0,0 +1,134 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_EDIT_WEBM_INDEX_H_
+#define LIBWEBM_EDIT_WEBM_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+
+// WebmIndex
+//
+// WebmIndex adds Cues to a WebM file that has none, in place. Clusters are
+// scanned at the element header level: only element IDs and sizes, cluster
+// timecodes and the first bytes of each block (track number, timecode and
+// flags) are read, never frame payloads. One cue point is created per
+// cluster, for the first keyframe of the first video track (or of the first
+// track when there is no video).
+//
+// The Cues element is appended at the end of the file. The SeekHead and the
+// SegmentInfo are then rewritten into the space they share with the Void
+// elements at the start of the segment, such as the space mkvmuxer reserves
+// for its SeekHead. The new SeekHead references the Cues, and SegmentInfo
+// gets the duration of the scanned clusters. Finally the Segment size is
+// written when its size field is wide enough. When the header has no room,
+// the file is left unchanged and the file has to be remuxed instead.
+
+namespace libwebm {
+
+class WebmIndex {
+ public:
+  struct Stats {
+    int clusters = 0;
+    int cue_points = 0;
+
+    // Bytes read from the file, against its total size.
+    std::int64_t bytes_read = 0;
+    std::int64_t file_size = 0;
+
+    // True when the file already had Cues and was left unchanged.
+    bool already_indexed = false;
+  };
+
+  explicit WebmIndex(const std::string& file_name) : file_name_(file_name) {}
+  ~WebmIndex() = default;
+
+  WebmIndex() = delete;
+  WebmIndex(const WebmIndex&) = delete;
+  WebmIndex(WebmIndex&&) = delete;
+
+  // Indexes the file. Returns true on success, or when the file already has
+  // Cues. Returns false without modifying the file when it cannot be parsed,
+  // is truncated, has no keyframes to index or has no room for the SeekHead.
+  bool Index();
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  // IMkvReader that counts the bytes read through it.
+  class CountingReader : public mkvparser::IMkvReader {
+   public:
+    explicit CountingReader(mkvparser::IMkvReader* reader)
+        : reader_(reader) {}
+    virtual ~CountingReader() {}
+
+    virtual int Read(long long pos, long len, unsigned char* buf);  // NOLINT
+    virtual int Length(long long* total, long long* available);  // NOLINT
+
+    std::int64_t bytes_read() const { return bytes_read_; }
+
+   private:
+    mkvparser::IMkvReader* const reader_;
+    std::int64_t bytes_read_ = 0;
+  };
+
+  struct CueEntry {
+    std::int64_t time;
+    std::int64_t cluster_pos;  // relative to the segment payload
+    std::int64_t block_number;
+  };
+
+  bool OpenFile();
+  bool ScanSegment();
+  bool ScanCluster(std::int64_t pos, std::int64_t stop,
+                   std::int64_t* cluster_stop);
+  bool ScanBlockGroup(std::int64_t pos, std::int64_t stop,
+                      std::int64_t cluster_timecode, const CueEntry& cue,
+                      bool* found_key);
+  void AddBlock(std::int64_t track, std::int64_t time, std::int64_t duration,
+                bool is_key, const CueEntry& cue, bool* found_key);
+  bool ReadInfo();
+  bool WriteIndex();
+
+  const std::string file_name_;
+
+  mkvparser::MkvReader file_reader_;
+  CountingReader reader_{&file_reader_};
+  std::unique_ptr<mkvparser::Segment> segment_;
+  std::int64_t cue_track_ = 0;
+
+  // End of the segment, which is also the end of the file.
+  std::int64_t segment_stop_ = 0;
+
+  // The run of SeekHead, Void and SegmentInfo elements at the start of the
+  // segment that is rewritten.
+  std::int64_t header_stop_ = 0;
+  bool info_in_header_ = false;
+
+  // SegmentInfo children other than Duration, and the position and size of
+  // the Duration value when SegmentInfo lies outside the rewritten header.
+  std::vector<std::uint8_t> info_payload_;
+  std::int64_t duration_pos_ = -1;
+  std::int64_t duration_size_ = 0;
+
+  // Cues already present after the clusters but not referenced by a
+  // SeekHead, relative to the segment payload.
+  std::int64_t existing_cues_pos_ = -1;
+
+  std::vector<CueEntry> cues_;
+  std::int64_t end_timecode_ = 0;
+  Stats stats_;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_EDIT_WEBM_INDEX_H_
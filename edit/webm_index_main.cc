@@ -0,0 +1,48 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_index.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+void Usage(const char* argv[]) {
+  printf("Usage: %s <WebM file>\n", argv[0]);
+  printf("\n");
+  printf("Adds Cues to a WebM file that has none, in place. Only element\n");
+  printf("headers are read; frame payloads are not touched.\n");
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc < 2) {
+    Usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::string path = argv[1];
+
+  libwebm::WebmIndex index(path);
+  if (!index.Index())
+    return EXIT_FAILURE;
+
+  const libwebm::WebmIndex::Stats& stats = index.stats();
+  if (stats.already_indexed) {
+    printf("%s already has Cues.\n", path.c_str());
+    return EXIT_SUCCESS;
+  }
+
+  printf("clusters: %d cue points: %d\n", stats.clusters, stats.cue_points);
+  printf("bytes read: %lld of %lld\n",
+         static_cast<long long>(stats.bytes_read),  // NOLINT
+         static_cast<long long>(stats.file_size));  // NOLINT
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_trim.h"
+
+#include <cstdio>
+
+namespace libwebm {
+
+bool WebmTrim::Trim(std::int64_t start_ns, std::int64_t stop_ns) {
+  if (start_ns < 0 || stop_ns <= start_ns) {
+    std::fprintf(stderr, "WebmTrim: invalid range.\n");
+    return false;
+  }
+
+  if (!OpenInput() || !FindBase(start_ns))
+    return false;
+
+  const mkvparser::SegmentInfo* const info = segment_->GetInfo();
+  const std::int64_t scale = info->GetTimeCodeScale();
+
+  // Blocks with an unscaled time at or after |stop_timecode| are dropped.
+  const std::int64_t stop_timecode = (stop_ns + scale - 1) / scale;
+
+  std::int64_t end_ns = stop_ns;
+  if (info->GetDuration() > 0 && info->GetDuration() < end_ns)
+    end_ns = info->GetDuration();
+  const double duration =
+      static_cast<double>(end_ns - base_timecode_ * scale) / scale;
+
+  if (!writer_.Open(output_file_name_, doc_type_, doc_type_version_,
+                    "webm_trim", &reader_, segment_.get(), duration,
+                    cue_track_->GetNumber())) {
+    std::fprintf(stderr, "WebmTrim: cannot write output file.\n");
+    return false;
+  }
+
+  for (const mkvparser::Cluster* cluster = base_cluster_;
+       cluster != nullptr && !cluster->EOS();
+       cluster = segment_->GetNext(cluster)) {
+    const std::int64_t timecode = cluster->GetTimeCode();
+    if (timecode < 0)
+      return false;
+
+    if (timecode >= stop_timecode)
+      break;
+
+    if (!writer_.WriteCluster(&reader_, cluster, -base_timecode_,
+                              base_timecode_, stop_timecode)) {
+      std::fprintf(stderr, "WebmTrim: cannot write cluster.\n");
+      return false;
+    }
+  }
+
+  return writer_.Close();
+}
+
+bool WebmTrim::OpenInput() {
+  if (reader_.Open(input_file_name_.c_str()) != 0) {
+    std::fprintf(stderr, "WebmTrim: cannot open input file.\n");
+    return false;
+  }
+
+  long long pos = 0;  // NOLINT
+  mkvparser::EBMLHeader ebml_header;
+  if (ebml_header.Parse(&reader_, pos) != 0) {
+    std::fprintf(stderr, "WebmTrim: invalid EBML header.\n");
+    return false;
+  }
+
+  doc_type_ = ebml_header.m_docType ? ebml_header.m_docType : "webm";
+  doc_type_version_ = ebml_header.m_docTypeVersion;
+
+  mkvparser::Segment* segment = nullptr;
+  if (mkvparser::Segment::CreateInstance(&reader_, pos, segment) != 0) {
+    std::fprintf(stderr, "WebmTrim: cannot create segment.\n");
+    return false;
+  }
+  segment_.reset(segment);
+
+  if (segment_->Load() < 0 || segment_->GetInfo() == nullptr ||
+      segment_->GetTracks() == nullptr) {
+    std::fprintf(stderr, "WebmTrim: cannot load segment.\n");
+    return false;
+  }
+
+  return true;
+}
+
+bool WebmTrim::FindBase(std::int64_t start_ns) {
+  const mkvparser::Tracks* const tracks = segment_->GetTracks();
+
+  for (unsigned long i = 0; i < tracks->GetTracksCount(); ++i) {  // NOLINT
+    const mkvparser::Track* const track = tracks->GetTrackByIndex(i);
+    if (track == nullptr)
+      continue;
+
+    if (cue_track_ == nullptr)
+      cue_track_ = track;
+
+    if (track->GetType() == mkvparser::Track::kVideo) {
+      cue_track_ = track;
+      break;
+    }
+  }
+
+  if (cue_track_ == nullptr) {
+    std::fprintf(stderr, "WebmTrim: no tracks.\n");
+    return false;
+  }
+
+  mkvparser::KeyframeIterator keyframes(segment_.get(), cue_track_);
+  const mkvparser::BlockEntry* entry = nullptr;
+  if (keyframes.Seek(start_ns, entry) != 0 || entry == nullptr) {
+    std::fprintf(stderr, "WebmTrim: no keyframe to start from.\n");
+    return false;
+  }
+
+  // Cues may not list every keyframe, so move on to the last keyframe at or
+  // before |start_ns|.
+  const mkvparser::Cluster* cluster = entry->GetCluster();
+  long index = entry->GetIndex() + 1;  // NOLINT
+  while (cluster != nullptr && !cluster->EOS() &&
+         cluster->GetTime() <= start_ns) {
+    const mkvparser::BlockEntry* next = nullptr;
+    if (cluster->GetNextKeyEntry(cue_track_->GetNumber(), index, next) < 0)
+      return false;
+
+    if (next == nullptr) {
+      cluster = segment_->GetNext(cluster);
+      index = 0;
+      continue;
+    }
+
+    if (next->GetBlock()->GetTime(cluster) > start_ns)
+      break;
+
+    entry = next;
+    index = next->GetIndex() + 1;
+  }
+
+  base_cluster_ = entry->GetCluster();
+  base_timecode_ = entry->GetBlock()->GetTimeCode(base_cluster_);
+  return base_timecode_ >= 0;
+}
+
+}  // namespace libwebm
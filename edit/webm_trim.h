@@ -0,0 +1,80 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_EDIT_WEBM_TRIM_H_
+#define LIBWEBM_EDIT_WEBM_TRIM_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "edit/webm_edit_writer.h"
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+
+// WebmTrim
+//
+// WebmTrim cuts the time range [start, stop) out of a WebM file without
+// touching frame payloads. The output starts at the last keyframe at or before
+// |start| of the first video track (or of the first track when there is no
+// video), and timestamps are shifted so that this keyframe is at time 0.
+//
+// Clusters that lie entirely inside the range are copied byte-for-byte, with
+// only their Timecode element rewritten. Clusters at the boundaries are
+// rewritten by copying the block elements that fall inside the range. The
+// Tracks element is copied unchanged, while SegmentInfo, Cues and SeekHead are
+// regenerated. Cues are written for the keyframes of the video track (or the
+// first track). Chapters, Tags and Attachments are not carried over.
+
+namespace libwebm {
+
+class WebmTrim {
+ public:
+  typedef WebmEditWriter::Stats Stats;
+
+  WebmTrim(const std::string& input_file_name,
+           const std::string& output_file_name)
+      : input_file_name_(input_file_name),
+        output_file_name_(output_file_name) {}
+  ~WebmTrim() = default;
+
+  WebmTrim() = delete;
+  WebmTrim(const WebmTrim&) = delete;
+  WebmTrim(WebmTrim&&) = delete;
+
+  // Writes the range [|start_ns|, |stop_ns|) of the input to the output file.
+  // Returns true on success.
+  bool Trim(std::int64_t start_ns, std::int64_t stop_ns);
+
+  const Stats& stats() const { return writer_.stats(); }
+
+ private:
+  bool OpenInput();
+  bool FindBase(std::int64_t start_ns);
+
+  const std::string input_file_name_;
+  const std::string output_file_name_;
+
+  mkvparser::MkvReader reader_;
+  std::unique_ptr<mkvparser::Segment> segment_;
+  std::string doc_type_;
+  std::int64_t doc_type_version_ = 0;
+
+  WebmEditWriter writer_;
+
+  // Track whose keyframes anchor the start of the output and get cue points.
+  const mkvparser::Track* cue_track_ = nullptr;
+
+  // Cluster holding the first output keyframe, and the keyframe's unscaled
+  // time. Clusters before |base_cluster_| hold nothing to output.
+  const mkvparser::Cluster* base_cluster_ = nullptr;
+  std::int64_t base_timecode_ = 0;
+};
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_EDIT_WEBM_TRIM_H_
@@ -0,0 +1,64 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "edit/webm_trim.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace {
+
+void Usage(const char* argv[]) {
+  printf("Usage: %s <WebM file> <output file> <start ms> <stop ms>\n",
+         argv[0]);
+  printf("\n");
+  printf("Copies [start, stop) of the input without re-encoding. The output\n");
+  printf("starts at the last keyframe at or before |start|.\n");
+}
+
+bool ParseMilliseconds(const char* arg, std::int64_t* ns) {
+  char* end = nullptr;
+  const double ms = strtod(arg, &end);
+  if (end == arg || *end != '\0' || ms < 0)
+    return false;
+  *ns = static_cast<std::int64_t>(ms * 1000000.0);
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  if (argc < 5) {
+    Usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  std::int64_t start_ns = 0;
+  std::int64_t stop_ns = 0;
+  if (!ParseMilliseconds(argv[3], &start_ns) ||
+      !ParseMilliseconds(argv[4], &stop_ns)) {
+    Usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  const std::string input_path = argv[1];
+  const std::string output_path = argv[2];
+
+  libwebm::WebmTrim trim(input_path, output_path);
+  if (!trim.Trim(start_ns, stop_ns))
+    return EXIT_FAILURE;
+
+  const libwebm::WebmTrim::Stats& stats = trim.stats();
+  printf("clusters copied: %d rewritten: %d\n", stats.clusters_copied,
+         stats.clusters_rewritten);
+  printf("blocks written: %lld dropped: %lld\n",
+         static_cast<long long>(stats.blocks_written),  // NOLINT
+         static_cast<long long>(stats.blocks_dropped));  // NOLINT
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,586 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+#include "mkvmuxer/mkvbatchmuxer.h"
+
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "common/trace.h"
+#include "mkvmuxer/mkvencrypt.h"
+#include "mkvmuxer/mkvmuxerutil.h"
+
+namespace mkvmuxer {
+
+namespace {
+
+// Clusters buffered per thread ahead of the one being written.
+const int32_t kClustersPerThread = 4;
+
+// Writer that only tracks its position. Used to measure the clusters while
+// they are planned; frame data is never copied.
+class NullWriter : public IMkvWriter {
+ public:
+  NullWriter() : position_(0), size_(0) {}
+  virtual ~NullWriter() {}
+
+  virtual int64 Position() const { return position_; }
+  virtual int32 Position(int64 position) {
+    if (position < 0 || position > size_)
+      return -1;
+    position_ = position;
+    return 0;
+  }
+  virtual bool Seekable() const { return true; }
+  virtual int32 Write(const void*, uint32 length) {
+    position_ += length;
+    if (position_ > size_)
+      size_ = position_;
+    return 0;
+  }
+  virtual void ElementStartNotify(uint64, int64) {}
+
+ private:
+  int64 position_;
+  int64 size_;
+
+  LIBWEBM_DISALLOW_COPY_AND_ASSIGN(NullWriter);
+};
+
+// Seekable writer into a memory buffer.
+class BufferWriter : public IMkvWriter {
+ public:
+  explicit BufferWriter(std::vector<uint8_t>* buffer)
+      : buffer_(buffer), position_(0) {}
+  virtual ~BufferWriter() {}
+
+  virtual int64 Position() const { return position_; }
+  virtual int32 Position(int64 position) {
+    if (position < 0 || position > static_cast<int64>(buffer_->size()))
+      return -1;
+    position_ = position;
+    return 0;
+  }
+  virtual bool Seekable() const { return true; }
+  virtual int32 Write(const void* buffer, uint32 length) {
+    if (length == 0)
+      return 0;
+    const size_t stop = static_cast<size_t>(position_) + length;
+    if (stop > buffer_->size())
+      buffer_->resize(stop);
+    memcpy(&(*buffer_)[static_cast<size_t>(position_)], buffer, length);
+    position_ = stop;
+    return 0;
+  }
+  virtual void ElementStartNotify(uint64, int64) {}
+
+ private:
+  std::vector<uint8_t>* const buffer_;
+  int64 position_;
+
+  LIBWEBM_DISALLOW_COPY_AND_ASSIGN(BufferWriter);
+};
+
+}  // namespace
+
+struct BatchMuxer::WorkerState {
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  // Next cluster to serialize, and number of clusters written.
+  int32_t next;
+  int32_t written;
+
+  // Maximum number of clusters serialized ahead of |written|.
+  int32_t window;
+  bool failed;
+
+  std::vector<std::vector<uint8_t> > buffers;
+  std::vector<int32_t> cue_blocks;
+  std::vector<char> done;
+};
+
+BatchMuxer::BatchMuxer(Segment* segment)
+    : segment_(segment),
+      plan_cluster_(NULL),
+      plan_writer_(NULL),
+      force_new_cluster_(false),
+      new_cuepoint_(false),
+      num_threads_(0),
+      clusters_written_(0),
+      state_(NULL) {}
+
+BatchMuxer::~BatchMuxer() {
+  for (size_t i = 0; i < frames_.size(); ++i)
+    delete frames_[i];
+  delete plan_cluster_;
+  delete static_cast<NullWriter*>(plan_writer_);
+  delete state_;
+}
+
+bool BatchMuxer::AddGenericFrame(const Frame* frame) {
+  if (!segment_ || !frame)
+    return false;
+
+  // Frames of encrypted tracks are copied behind their encryption header,
+  // and encrypted when their cluster is serialized.
+  FrameEncryptor* const encryptor = segment_->frame_encryptor_;
+  Frame* const new_frame = new (std::nothrow) Frame();
+  if (!new_frame ||
+      !(encryptor && encryptor->IsEncrypted(frame->track_number())
+            ? encryptor->PrepareFrame(*frame, new_frame)
+            : new_frame->CopyFrom(*frame))) {
+    delete new_frame;
+    return false;
+  }
+
+  return AddNewFrame(new_frame);
+}
+
+bool BatchMuxer::AddFrame(const uint8_t* data, uint64_t length,
+                          uint64_t track_number, uint64_t timestamp,
+                          bool is_key) {
+  if (!segment_ || !data)
+    return false;
+
+  FrameEncryptor* const encryptor = segment_->frame_encryptor_;
+  Frame* const frame = new (std::nothrow) Frame();
+  if (!frame ||
+      !(encryptor && encryptor->IsEncrypted(track_number)
+            ? encryptor->PrepareFrame(data, length, track_number, frame)
+            : frame->Init(data, length))) {
+    delete frame;
+    return false;
+  }
+  frame->set_track_number(track_number);
+  frame->set_timestamp(timestamp);
+  frame->set_is_key(is_key);
+  return AddNewFrame(frame);
+}
+
+bool BatchMuxer::AddNewFrame(Frame* frame) {
+  // Check for non-monotonically increasing timestamps.
+  if (!frame->IsValid() ||
+      (!frames_.empty() && frame->timestamp() < frames_.back()->timestamp()) ||
+      !segment_->GetTrackByNumber(frame->track_number())) {
+    delete frame;
+    return false;
+  }
+
+  frames_.push_back(frame);
+  return true;
+}
+
+bool BatchMuxer::Finalize() {
+  if (!segment_ || segment_->mode_ != Segment::kFile || segment_->chunking_ ||
+      segment_->cluster_list_size_ > 0 || segment_->frames_size_ > 0) {
+    return false;
+  }
+
+  // Laces are built by Segment as frames arrive, which the cluster plan does
+  // not mirror.
+  const Tracks& tracks = segment_->tracks_;
+  for (uint32_t i = 0; i < tracks.track_entries_size(); ++i) {
+    if (tracks.GetTrackByIndex(i)->lacing() != kNoLacing)
+      return false;
+  }
+
+  // Writes the headers and selects the cues track.
+  if (!segment_->CheckHeaderInfo())
+    return false;
+
+  if (!PlanClusters() || !WriteClusters())
+    return false;
+
+  return segment_->Finalize();
+}
+
+bool BatchMuxer::PlanClusters() {
+  LIBWEBM_TRACE_SCOPE("mkvmuxer", "BatchMuxer::PlanClusters");
+  Segment* const segment = segment_;
+  const uint64_t timecode_scale = segment->segment_info_.timecode_scale();
+
+  NullWriter* const plan_writer = new (std::nothrow) NullWriter();  // NOLINT
+  if (!plan_writer)
+    return false;
+  delete static_cast<NullWriter*>(plan_writer_);
+  plan_writer_ = plan_writer;
+
+  force_new_cluster_ = segment->force_new_cluster_;
+
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    Frame* const frame = frames_[i];
+    const uint64_t track_index = frame->track_number() - 1;
+
+    if (frame->discard_padding() != 0)
+      segment->doc_type_version_ = 4;
+
+    if (!clusters_.empty()) {
+      const uint64_t frame_timecode = frame->timestamp() / timecode_scale;
+      const uint64_t rel_timecode = frame_timecode - clusters_.back().timecode;
+      if (rel_timecode > kMaxBlockTimecode)
+        force_new_cluster_ = true;
+    }
+
+    // Audio is held back to be muxed with the next video key frame.
+    if (segment->has_video_ &&
+        segment->tracks_.TrackIsAudio(frame->track_number()) &&
+        !force_new_cluster_) {
+      queued_frames_.push_back(static_cast<int32_t>(i));
+      segment->track_frames_written_[track_index]++;
+      continue;
+    }
+
+    for (;;) {
+      const int result = TestFrame(frame);
+      if (result < 0)
+        return false;
+
+      force_new_cluster_ = false;
+
+      if (result > 0 && !MakeNewCluster(frame->timestamp()))
+        return false;
+
+      WriteFramesAll();
+
+      if (result <= 1)
+        break;
+    }
+
+    if (!frame->CanBeSimpleBlock() && !frame->is_key() &&
+        !frame->reference_block_timestamp_set()) {
+      frame->set_reference_block_timestamp(
+          segment->last_track_timestamp_[track_index]);
+    }
+
+    if (!AddToCluster(static_cast<int32_t>(i)))
+      return false;
+
+    segment->last_timestamp_ = frame->timestamp();
+    segment->last_track_timestamp_[track_index] = frame->timestamp();
+    segment->last_block_duration_ = frame->duration();
+    segment->track_frames_written_[track_index]++;
+  }
+
+  // Segment::Finalize() writes the audio still held back.
+  if (!queued_frames_.empty() && clusters_.empty())
+    return false;
+  WriteFramesAll();
+
+  delete plan_cluster_;
+  plan_cluster_ = NULL;
+  return true;
+}
+
+int BatchMuxer::TestFrame(const Frame* frame) const {
+  if (force_new_cluster_ || clusters_.empty())
+    return 1;
+
+  const Segment* const segment = segment_;
+  const uint64_t timecode_scale = segment->segment_info_.timecode_scale();
+  const uint64_t frame_timecode = frame->timestamp() / timecode_scale;
+  const uint64_t cluster_timecode = clusters_.back().timecode;
+
+  if (frame_timecode < cluster_timecode)
+    return -1;
+
+  const int64_t delta_timecode = frame_timecode - cluster_timecode;
+  if (delta_timecode > kMaxBlockTimecode)
+    return 2;
+
+  if (frame->is_key() && segment->tracks_.TrackIsVideo(frame->track_number()))
+    return 1;
+
+  const uint64_t delta_ns = delta_timecode * timecode_scale;
+  if (segment->max_cluster_duration_ > 0 &&
+      delta_ns >= segment->max_cluster_duration_) {
+    return 1;
+  }
+
+  if (segment->max_cluster_size_ > 0 &&
+      plan_cluster_->payload_size() >= segment->max_cluster_size_) {
+    return 1;
+  }
+
+  return 0;
+}
+
+bool BatchMuxer::MakeNewCluster(uint64_t timestamp) {
+  Segment* const segment = segment_;
+  const uint64_t timecode_scale = segment->segment_info_.timecode_scale();
+
+  WriteFramesLessThan(timestamp);
+
+  if (!clusters_.empty())
+    clusters_.back().stop_timestamp = timestamp;
+
+  if (segment->output_cues_)
+    new_cuepoint_ = true;
+
+  uint64_t cluster_timecode = timestamp / timecode_scale;
+  if (!queued_frames_.empty()) {
+    const uint64_t timecode =
+        frames_[queued_frames_[0]]->timestamp() / timecode_scale;
+    if (timecode < cluster_timecode)
+      cluster_timecode = timecode;
+  }
+
+  delete plan_cluster_;
+  plan_cluster_ = new (std::nothrow)
+      Cluster(cluster_timecode, 0, timecode_scale,
+              segment->accurate_cluster_duration_,
+              segment->fixed_size_cluster_timecode_);  // NOLINT
+  if (!plan_cluster_ || !plan_cluster_->Init(plan_writer_))
+    return false;
+
+  ClusterPlan plan;
+  plan.timecode = cluster_timecode;
+  plan.stop_timestamp = 0;
+  plan.cue_frame = -1;
+  clusters_.push_back(plan);
+  return true;
+}
+
+void BatchMuxer::WriteFramesLessThan(uint64_t timestamp) {
+  // Before the first cluster the queued frames go to the new cluster.
+  if (queued_frames_.empty() || clusters_.empty())
+    return;
+
+  Segment* const segment = segment_;
+  size_t shift_left = 0;
+
+  for (size_t i = 1; i < queued_frames_.size(); ++i) {
+    if (frames_[queued_frames_[i]]->timestamp() > timestamp)
+      break;
+
+    const Frame* const frame = frames_[queued_frames_[i - 1]];
+    if (AddToCluster(queued_frames_[i - 1]) &&
+        frame->timestamp() > segment->last_timestamp_) {
+      segment->last_timestamp_ = frame->timestamp();
+      segment->last_track_timestamp_[frame->track_number() - 1] =
+          frame->timestamp();
+    }
+    ++shift_left;
+  }
+
+  queued_frames_.erase(queued_frames_.begin(),
+                       queued_frames_.begin() + shift_left);
+}
+
+void BatchMuxer::WriteFramesAll() {
+  if (clusters_.empty())
+    return;
+
+  Segment* const segment = segment_;
+
+  for (size_t i = 0; i < queued_frames_.size(); ++i) {
+    const Frame* const frame = frames_[queued_frames_[i]];
+    if (AddToCluster(queued_frames_[i]) &&
+        frame->timestamp() > segment->last_timestamp_) {
+      segment->last_timestamp_ = frame->timestamp();
+      segment->last_track_timestamp_[frame->track_number() - 1] =
+          frame->timestamp();
+    }
+  }
+
+  queued_frames_.clear();
+}
+
+bool BatchMuxer::AddToCluster(int32_t index) {
+  const Frame* const frame = frames_[index];
+
+  // Measures the block; the frame data is not copied.
+  if (!plan_cluster_->AddFrame(frame))
+    return false;
+
+  ClusterPlan& plan = clusters_.back();
+  plan.frames.push_back(index);
+
+  if (new_cuepoint_ && segment_->cues_track_ == frame->track_number()) {
+    plan.cue_frame = static_cast<int32_t>(plan.frames.size()) - 1;
+    new_cuepoint_ = false;
+  }
+
+  return true;
+}
+
+bool BatchMuxer::WriteClusters() {
+  if (clusters_.empty())
+    return true;
+
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "BatchMuxer::WriteClusters", "clusters",
+                          clusters_.size());
+
+  int32_t num_threads = num_threads_;
+  if (num_threads <= 0)
+    num_threads = static_cast<int32_t>(std::thread::hardware_concurrency());
+  if (num_threads <= 0)
+    num_threads = 1;
+
+  const int32_t count = static_cast<int32_t>(clusters_.size());
+  if (num_threads > count)
+    num_threads = count;
+
+  delete state_;
+  state_ = new (std::nothrow) WorkerState();  // NOLINT
+  if (!state_)
+    return false;
+
+  WorkerState& state = *state_;
+  state.next = 0;
+  state.written = 0;
+  state.window = num_threads * kClustersPerThread;
+  state.failed = false;
+  state.buffers.resize(count);
+  state.cue_blocks.resize(count, 0);
+  state.done.resize(count, 0);
+
+  std::vector<std::thread> workers;
+  for (int32_t i = 0; i < num_threads; ++i)
+    workers.push_back(std::thread(&BatchMuxer::ClusterWorker, this));
+
+  Segment* const segment = segment_;
+  IMkvWriter* const writer = segment->writer_cluster_;
+  const uint64_t timecode_scale = segment->segment_info_.timecode_scale();
+  bool ok = true;
+
+  for (int32_t i = 0; i < count && ok; ++i) {
+    std::vector<uint8_t> buffer;
+    int32_t cue_block = 0;
+    {
+      std::unique_lock<std::mutex> lock(state.mutex);
+      while (!state.done[i] && !state.failed)
+        state.condition.wait(lock);
+      if (state.failed) {
+        ok = false;
+        break;
+      }
+      buffer.swap(state.buffers[i]);
+      cue_block = state.cue_blocks[i];
+    }
+
+    // Cluster positions follow from the sizes of the clusters before them.
+    const int64_t cluster_pos = segment->MaxOffset();
+    if (cluster_pos < 0 ||
+        writer->Write(&buffer[0], static_cast<uint32>(buffer.size()))) {
+      ok = false;
+    }
+
+    const ClusterPlan& plan = clusters_[i];
+    if (ok && plan.cue_frame >= 0) {
+      const Frame* const frame = frames_[plan.frames[plan.cue_frame]];
+      CuePoint* const cue = new (std::nothrow) CuePoint();  // NOLINT
+      if (!cue) {
+        ok = false;
+      } else {
+        cue->set_time(frame->timestamp() / timecode_scale);
+        cue->set_block_number(cue_block);
+        cue->set_cluster_pos(cluster_pos);
+        cue->set_track(segment->cues_track_);
+        if (!segment->cues_.AddCue(cue)) {
+          delete cue;
+          ok = false;
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      ++state.written;
+      if (!ok)
+        state.failed = true;
+    }
+    state.condition.notify_all();
+
+    if (ok)
+      ++clusters_written_;
+  }
+
+  for (size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+
+  return ok;
+}
+
+void BatchMuxer::ClusterWorker() {
+  WorkerState& state = *state_;
+  const int32_t count = static_cast<int32_t>(clusters_.size());
+
+  for (;;) {
+    int32_t index;
+    {
+      std::unique_lock<std::mutex> lock(state.mutex);
+      while (!state.failed && state.next < count &&
+             state.next >= state.written + state.window) {
+        state.condition.wait(lock);
+      }
+      if (state.failed || state.next >= count)
+        return;
+      index = state.next++;
+    }
+
+    std::vector<uint8_t> buffer;
+    int32_t cue_block = 0;
+    const bool ok = SerializeCluster(index, &buffer, &cue_block);
+
+    {
+      std::lock_guard<std::mutex> lock(state.mutex);
+      if (ok) {
+        state.buffers[index].swap(buffer);
+        state.cue_blocks[index] = cue_block;
+        state.done[index] = 1;
+      } else {
+        state.failed = true;
+      }
+    }
+    state.condition.notify_all();
+  }
+}
+
+bool BatchMuxer::SerializeCluster(int32_t index, std::vector<uint8_t>* buffer,
+                                  int32_t* cue_block) const {
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "BatchMuxer::SerializeCluster", "index",
+                          index);
+  const Segment* const segment = segment_;
+  const ClusterPlan& plan = clusters_[index];
+
+  BufferWriter writer(buffer);
+  Cluster cluster(plan.timecode, 0, segment->segment_info_.timecode_scale(),
+                  segment->accurate_cluster_duration_,
+                  segment->fixed_size_cluster_timecode_);
+  if (!cluster.Init(&writer))
+    return false;
+
+  if (segment->frame_encryptor_) {
+    std::vector<Frame*> frames(plan.frames.size());
+    for (size_t i = 0; i < plan.frames.size(); ++i)
+      frames[i] = frames_[plan.frames[i]];
+    if (!segment->frame_encryptor_->EncryptFrames(frames.data(),
+                                                  frames.size())) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < plan.frames.size(); ++i) {
+    if (!cluster.AddFrame(frames_[plan.frames[i]]))
+      return false;
+    if (static_cast<int32_t>(i) == plan.cue_frame)
+      *cue_block = cluster.blocks_added();
+  }
+
+  // As in Segment, only clusters followed by another one get the duration of
+  // their last frames.
+  const bool last = index + 1 == static_cast<int32_t>(clusters_.size());
+  return last ? cluster.Finalize(false, 0)
+              : cluster.Finalize(true, plan.stop_timestamp);
+}
+
+}  // namespace mkvmuxer
@@ -0,0 +1,128 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+#ifndef MKVMUXER_MKVBATCHMUXER_H_
+#define MKVMUXER_MKVBATCHMUXER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvmuxertypes.h"
+
+namespace mkvmuxer {
+
+// Muxes frames that are all known up front, such as when repackaging a file,
+// using several threads.
+//
+// The Segment is set up as usual (Init(), tracks, SegmentInfo, cluster
+// limits and cues options), but the frames are given to the BatchMuxer
+// instead of the Segment. Finalize() then:
+//   1. groups the frames into clusters by the same rules Segment::AddFrame()
+//      applies (video key frames, cluster duration and size limits, block
+//      timecode range, audio held back to join the next video key frame),
+//      without copying frame data;
+//   2. serializes the clusters into memory buffers on a pool of threads;
+//   3. writes the buffers in order, adding cue points from the buffer
+//      positions, and finalizes the Segment, which writes the Cues, the
+//      SeekHead and the duration.
+// The output is identical to what the Segment writes for the same frames.
+// Laced tracks are not supported: Finalize() fails when any track has a
+// lacing other than kNoLacing.
+//
+// Frames of tracks encrypted by the Segment's frame encryptor are encrypted
+// on the worker threads, one batched cipher pass per cluster.
+//
+// Only Segment::kFile mode without chunking is supported, and no frames may
+// have been added to the Segment directly. All frames are copied and kept in
+// memory until Finalize() returns; at most a few clusters per thread are
+// buffered at any time.
+class BatchMuxer {
+ public:
+  explicit BatchMuxer(Segment* segment);
+  ~BatchMuxer();
+
+  // Adds a copy of |frame|. Frames must be added in increasing timestamp
+  // order. Returns true on success.
+  bool AddGenericFrame(const Frame* frame);
+
+  // Adds a frame with the given data. |timestamp| is in nanoseconds. Returns
+  // true on success.
+  bool AddFrame(const uint8_t* data, uint64_t length, uint64_t track_number,
+                uint64_t timestamp, bool is_key);
+
+  // Muxes all frames added and finalizes the Segment. Returns true on
+  // success, and false without writing any frames when a track is laced.
+  bool Finalize();
+
+  // Number of threads serializing clusters. 0, the default, uses one thread
+  // per hardware thread.
+  void set_num_threads(int32_t num_threads) { num_threads_ = num_threads; }
+  int32_t num_threads() const { return num_threads_; }
+
+  // Number of clusters written by Finalize().
+  int32_t clusters_written() const { return clusters_written_; }
+
+ private:
+  // Frames of a cluster, as indexes into |frames_|.
+  struct ClusterPlan {
+    uint64_t timecode;
+
+    // Timestamp of the frame that started the next cluster, used to finalize
+    // the cluster when |accurate_cluster_duration_| is set.
+    uint64_t stop_timestamp;
+    std::vector<int32_t> frames;
+
+    // Index into |frames| of the frame with a cue point, or -1.
+    int32_t cue_frame;
+  };
+
+  // Appends |frame|, which is owned by this class from then on, or deletes
+  // it when it is invalid. Returns true on success.
+  bool AddNewFrame(Frame* frame);
+
+  // Groups the frames into |clusters_|. Mirrors Segment::AddGenericFrame()
+  // and the functions it calls.
+  bool PlanClusters();
+  int TestFrame(const Frame* frame) const;
+  bool MakeNewCluster(uint64_t timestamp);
+  void WriteFramesLessThan(uint64_t timestamp);
+  void WriteFramesAll();
+  bool AddToCluster(int32_t index);
+
+  // Serializes and writes the planned clusters.
+  bool WriteClusters();
+  bool SerializeCluster(int32_t index, std::vector<uint8_t>* buffer,
+                        int32_t* cue_block) const;
+  void ClusterWorker();
+
+  Segment* const segment_;
+  std::vector<Frame*> frames_;
+  std::vector<ClusterPlan> clusters_;
+
+  // Planning state, as in Segment.
+  std::vector<int32_t> queued_frames_;
+  Cluster* plan_cluster_;
+  IMkvWriter* plan_writer_;
+  bool force_new_cluster_;
+  bool new_cuepoint_;
+
+  int32_t num_threads_;
+  int32_t clusters_written_;
+
+  // Shared with the worker threads.
+  struct WorkerState;
+  WorkerState* state_;
+
+  LIBWEBM_DISALLOW_COPY_AND_ASSIGN(BatchMuxer);
+};
+
+}  // namespace mkvmuxer
+
+#endif  // MKVMUXER_MKVBATCHMUXER_H_
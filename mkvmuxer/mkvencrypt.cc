@@ -0,0 +1,255 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+#include "mkvmuxer/mkvencrypt.h"
+
+#include <cstring>
+#include <new>
+#include <random>
+
+namespace mkvmuxer {
+
+namespace {
+
+const uint8_t kEncryptedBit = 0x01;
+const uint8_t kPartitionedBit = 0x02;
+const uint64_t kSignalByteSize = 1;
+const uint64_t kIvSize = 8;
+const uint64_t kPartitionCountSize = 1;
+const uint64_t kPartitionOffsetSize = 4;
+const uint64_t kMaxPartitions = 255;
+
+void WriteBigEndian(uint64_t value, int size, uint8_t* p) {
+  for (int i = size - 1; i >= 0; --i) {
+    p[i] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+}
+
+uint32_t ReadBigEndian32(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |
+         (static_cast<uint32_t>(p[1]) << 16) |
+         (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+FrameEncryptor::FrameEncryptor() : next_iv_(0) {
+  std::random_device random;
+  next_iv_ = (static_cast<uint64_t>(random()) << 32) | random();
+}
+
+FrameEncryptor::~FrameEncryptor() {}
+
+bool FrameEncryptor::AddTrack(Track* track, const uint8_t* key_id,
+                              uint64_t key_id_length, const uint8_t* key,
+                              uint64_t key_length) {
+  if (!track || !key || FindTrack(track->number()))
+    return false;
+
+  TrackKey track_key;
+  track_key.track_number = track->number();
+  if (!track_key.aes.Init(key, static_cast<size_t>(key_length)))
+    return false;
+
+  if (track->content_encoding_entries_size() == 0) {
+    if (!key_id || key_id_length == 0 || !track->AddContentEncoding())
+      return false;
+    ContentEncoding* const encoding = track->GetContentEncodingByIndex(0);
+    if (!encoding || !encoding->SetEncryptionID(key_id, key_id_length))
+      return false;
+  }
+
+  tracks_.push_back(track_key);
+  return true;
+}
+
+bool FrameEncryptor::IsEncrypted(uint64_t track_number) const {
+  return FindTrack(track_number) != NULL;
+}
+
+bool FrameEncryptor::PrepareFrame(const Frame& frame, Frame* out) {
+  if (!out || out == &frame || !FindTrack(frame.track_number()))
+    return false;
+
+  if (!Prepare(frame.frame(), frame.length(), frame.encryption_partitions(),
+               frame.encryption_partition_count(), out)) {
+    return false;
+  }
+
+  if (!out->SetEncryptionPartitions(NULL, 0))
+    return false;
+
+  delete[] out->additional_;
+  out->additional_ = NULL;
+  out->additional_length_ = 0;
+  out->add_id_ = 0;
+  if (frame.additional_length() > 0 && frame.additional() != NULL &&
+      !out->AddAdditionalData(frame.additional(), frame.additional_length(),
+                              frame.add_id())) {
+    return false;
+  }
+
+  out->duration_ = frame.duration();
+  out->duration_set_ = frame.duration_set();
+  out->is_key_ = frame.is_key();
+  out->track_number_ = frame.track_number();
+  out->timestamp_ = frame.timestamp();
+  out->discard_padding_ = frame.discard_padding();
+  out->reference_block_timestamp_ = frame.reference_block_timestamp();
+  out->reference_block_timestamp_set_ = frame.reference_block_timestamp_set();
+  return true;
+}
+
+bool FrameEncryptor::PrepareFrame(const uint8_t* data, uint64_t length,
+                                  uint64_t track_number, Frame* out) {
+  if (!out || !FindTrack(track_number))
+    return false;
+
+  if (!Prepare(data, length, NULL, 0, out))
+    return false;
+
+  out->track_number_ = track_number;
+  return true;
+}
+
+bool FrameEncryptor::Prepare(const uint8_t* data, uint64_t length,
+                             const uint32_t* partitions,
+                             uint64_t partition_count, Frame* out) {
+  if ((!data && length > 0) || partition_count > kMaxPartitions)
+    return false;
+
+  for (uint64_t i = 0; i < partition_count; ++i) {
+    if (partitions[i] > length || (i > 0 && partitions[i] < partitions[i - 1]))
+      return false;
+  }
+
+  uint64_t header_size = kSignalByteSize + kIvSize;
+  if (partition_count > 0)
+    header_size += kPartitionCountSize + partition_count * kPartitionOffsetSize;
+
+  uint8_t* const buffer = new (std::nothrow)
+      uint8_t[static_cast<size_t>(header_size + length)];  // NOLINT
+  if (!buffer)
+    return false;
+
+  uint8_t* p = buffer;
+  *p++ = partition_count > 0 ? kEncryptedBit | kPartitionedBit : kEncryptedBit;
+  WriteBigEndian(next_iv_++, kIvSize, p);
+  p += kIvSize;
+  if (partition_count > 0) {
+    *p++ = static_cast<uint8_t>(partition_count);
+    for (uint64_t i = 0; i < partition_count; ++i) {
+      WriteBigEndian(partitions[i], kPartitionOffsetSize, p);
+      p += kPartitionOffsetSize;
+    }
+  }
+  if (length > 0)
+    memcpy(p, data, static_cast<size_t>(length));
+
+  delete[] out->frame_;
+  out->frame_ = buffer;
+  out->length_ = header_size + length;
+  return true;
+}
+
+bool FrameEncryptor::EncryptFrames(Frame* const* frames, size_t count) const {
+  if (!frames)
+    return count == 0;
+
+  std::vector<libwebm::AesCtr::Range> ranges;
+  std::vector<uint8_t> counters(count * libwebm::AesCtr::kBlockSize);
+
+  for (size_t k = 0; k < tracks_.size(); ++k) {
+    const TrackKey& track_key = tracks_[k];
+    ranges.clear();
+
+    for (size_t i = 0; i < count; ++i) {
+      Frame* const frame = frames[i];
+      if (!frame || frame->track_number() != track_key.track_number)
+        continue;
+
+      uint8_t* const buffer = frame->frame_;
+      const uint64_t length = frame->length();
+      if (!buffer || length < kSignalByteSize + kIvSize ||
+          (buffer[0] & kEncryptedBit) == 0) {
+        return false;
+      }
+
+      // The counter block is the IV followed by a block counter starting at
+      // 0.
+      uint8_t* const counter = &counters[i * libwebm::AesCtr::kBlockSize];
+      memcpy(counter, buffer + kSignalByteSize, kIvSize);
+      memset(counter + kIvSize, 0, libwebm::AesCtr::kBlockSize - kIvSize);
+      uint64_t pos = kSignalByteSize + kIvSize;
+
+      uint64_t partition_count = 0;
+      const uint8_t* partitions = NULL;
+      if (buffer[0] & kPartitionedBit) {
+        if (length < pos + kPartitionCountSize)
+          return false;
+        partition_count = buffer[pos];
+        pos += kPartitionCountSize;
+        if (length - pos < partition_count * kPartitionOffsetSize)
+          return false;
+        partitions = buffer + pos;
+        pos += partition_count * kPartitionOffsetSize;
+      }
+
+      uint8_t* const data = buffer + pos;
+      const uint64_t data_length = length - pos;
+
+      // As in the parser: partitions alternate between clear and encrypted
+      // data, starting with clear data.
+      uint64_t stream_offset = 0;
+      uint64_t start = 0;
+      bool encrypted = partitions == NULL;
+      for (uint64_t j = 0; j <= partition_count; ++j) {
+        uint64_t stop = data_length;
+        if (j < partition_count) {
+          stop = ReadBigEndian32(partitions + j * kPartitionOffsetSize);
+          if (stop < start || stop > data_length)
+            return false;
+        }
+
+        if (encrypted && stop > start) {
+          libwebm::AesCtr::Range range;
+          range.counter_block = counter;
+          range.offset = stream_offset;
+          range.data = data + start;
+          range.size = static_cast<size_t>(stop - start);
+          ranges.push_back(range);
+          stream_offset += stop - start;
+        }
+
+        start = stop;
+        encrypted = !encrypted;
+      }
+    }
+
+    if (!ranges.empty())
+      track_key.aes.Apply(ranges.data(), ranges.size());
+  }
+
+  return true;
+}
+
+bool FrameEncryptor::EncryptFrame(const Frame& frame, Frame* out) {
+  return PrepareFrame(frame, out) && EncryptFrames(&out, 1);
+}
+
+const FrameEncryptor::TrackKey* FrameEncryptor::FindTrack(
+    uint64_t track_number) const {
+  for (size_t i = 0; i < tracks_.size(); ++i) {
+    if (tracks_[i].track_number == track_number)
+      return &tracks_[i];
+  }
+  return NULL;
+}
+
+}  // namespace mkvmuxer
@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+
+#ifndef MKVMUXER_MKVENCRYPT_H_
+#define MKVMUXER_MKVENCRYPT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "common/aes_ctr.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvmuxertypes.h"
+
+namespace mkvmuxer {
+
+// Encrypts frames with WebM encryption (AES-CTR) as they are muxed.
+//
+// Once set with Segment::set_frame_encryptor(), the Segment encrypts the
+// frames of the tracks added here: the frame data is copied once, behind
+// the encryption header, into the buffer the muxer writes from and
+// encrypted there. BatchMuxer does the same, and encrypts all the frames of
+// a cluster with one batched cipher pass on its worker threads.
+//
+// Every frame starts with a signal byte and an 8 byte IV. The IV of each
+// frame is the next value of a 64-bit counter, so it is unique for as long
+// as one FrameEncryptor is used with a key. Frames with encryption
+// partitions (see Frame::SetEncryptionPartitions()) also carry the
+// partition count and offsets; only their encrypted partitions go through
+// the cipher, as one continuous key stream.
+class FrameEncryptor {
+ public:
+  FrameEncryptor();
+  ~FrameEncryptor();
+
+  // Encrypts the frames of |track| with |key|, which must be 16, 24 or 32
+  // bytes long. When the track has no ContentEncoding one is added, with
+  // |key_id| as its ContentEncKeyID. Returns true on success.
+  bool AddTrack(Track* track, const uint8_t* key_id, uint64_t key_id_length,
+                const uint8_t* key, uint64_t key_length);
+
+  // Returns true when the frames of track |track_number| are encrypted.
+  bool IsEncrypted(uint64_t track_number) const;
+
+  // Sets |out| to a copy of |frame| whose data is preceded by the encryption
+  // header. The data itself is left plain for EncryptFrames(). Uses the next
+  // IV. Returns false when the track is not encrypted or the partitions of
+  // |frame| are invalid.
+  bool PrepareFrame(const Frame& frame, Frame* out);
+
+  // As above, for |length| bytes of |data| without partitions. Only the data
+  // of |out| is set.
+  bool PrepareFrame(const uint8_t* data, uint64_t length,
+                    uint64_t track_number, Frame* out);
+
+  // Encrypts, in place, the data of the frames among |frames| that belong to
+  // encrypted tracks; those must have been set by PrepareFrame(). The frames
+  // of each key go through the cipher together. Safe to call from several
+  // threads on different frames. Returns true on success.
+  bool EncryptFrames(Frame* const* frames, size_t count) const;
+
+  // PrepareFrame() and EncryptFrames() for a single frame.
+  bool EncryptFrame(const Frame& frame, Frame* out);
+
+  // The IV of the next frame. Defaults to a random value.
+  void set_next_iv(uint64_t next_iv) { next_iv_ = next_iv; }
+  uint64_t next_iv() const { return next_iv_; }
+
+ private:
+  struct TrackKey {
+    uint64_t track_number;
+    libwebm::AesCtr aes;
+  };
+
+  const TrackKey* FindTrack(uint64_t track_number) const;
+
+  // Writes the encryption header and copies |data| into |out|.
+  bool Prepare(const uint8_t* data, uint64_t length,
+               const uint32_t* partitions, uint64_t partition_count,
+               Frame* out);
+
+  std::vector<TrackKey> tracks_;
+  uint64_t next_iv_;
+
+  LIBWEBM_DISALLOW_COPY_AND_ASSIGN(FrameEncryptor);
+};
+
+}  // namespace mkvmuxer
+
+#endif  // MKVMUXER_MKVENCRYPT_H_
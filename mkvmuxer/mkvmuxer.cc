@@ -21,7 +21,9 @@
 #include <string>
 #include <vector>
 
+#include "common/trace.h"
 #include "common/webmids.h"
+#include "mkvmuxer/mkvencrypt.h"
 #include "mkvmuxer/mkvmuxerutil.h"
 #include "mkvmuxer/mkvwriter.h"
 #include "mkvparser/mkvparser.h"
@@ -82,6 +84,31 @@ bool CopyChromaticity(const PrimaryChromaticity* src,
   return true;
 }
 
+// Stores |value| in |buf| as an EBML variable size integer of |size| bytes.
+// Returns |size|.
+int StoreVint(uint64_t value, int size, uint8_t* buf) {
+  value |= uint64_t{1} << (7 * size);
+  for (int i = size - 1; i >= 0; --i) {
+    buf[i] = static_cast<uint8_t>(value & 0xff);
+    value >>= 8;
+  }
+  return size;
+}
+
+// Stores the signed EBML lace size difference |value| in |buf|. Returns the
+// number of bytes stored.
+int StoreSignedVint(int64_t value, uint8_t* buf) {
+  int size = 1;
+  while (size < 8) {
+    const int64_t bias = (int64_t{1} << (7 * size - 1)) - 1;
+    if (value >= -bias && value <= bias)
+      break;
+    ++size;
+  }
+  const int64_t bias = (int64_t{1} << (7 * size - 1)) - 1;
+  return StoreVint(static_cast<uint64_t>(value + bias), size, buf);
+}
+
 }  // namespace
 
 ///////////////////////////////////////////////////////////////
@@ -182,11 +209,15 @@ Frame::Frame()
       timestamp_(0),
       discard_padding_(0),
       reference_block_timestamp_(0),
-      reference_block_timestamp_set_(false) {}
+      reference_block_timestamp_set_(false),
+      encryption_partitions_(NULL),
+      encryption_partition_count_(0),
+      lacing_(kNoLacing) {}
 
 Frame::~Frame() {
   delete[] frame_;
   delete[] additional_;
+  delete[] encryption_partitions_;
 }
 
 bool Frame::CopyFrom(const Frame& frame) {
@@ -214,7 +245,9 @@ bool Frame::CopyFrom(const Frame& frame) {
   discard_padding_ = frame.discard_padding();
   reference_block_timestamp_ = frame.reference_block_timestamp();
   reference_block_timestamp_set_ = frame.reference_block_timestamp_set();
-  return true;
+  lacing_ = frame.lacing();
+  return SetEncryptionPartitions(frame.encryption_partitions(),
+                                 frame.encryption_partition_count());
 }
 
 bool Frame::Init(const uint8_t* frame, uint64_t length) {
@@ -247,6 +280,25 @@ bool Frame::AddAdditionalData(const uint8_t* additional, uint64_t length,
   return true;
 }
 
+bool Frame::SetEncryptionPartitions(const uint32_t* offsets, uint64_t count) {
+  if (count > 0 && (!offsets || count > 255))
+    return false;
+
+  uint32_t* partitions = NULL;
+  if (count > 0) {
+    partitions =
+        new (std::nothrow) uint32_t[static_cast<size_t>(count)];  // NOLINT
+    if (!partitions)
+      return false;
+    memcpy(partitions, offsets, static_cast<size_t>(count) * sizeof(*offsets));
+  }
+
+  delete[] encryption_partitions_;
+  encryption_partitions_ = partitions;
+  encryption_partition_count_ = count;
+  return true;
+}
+
 bool Frame::IsValid() const {
   if (length_ == 0 || !frame_) {
     return false;
@@ -442,6 +494,9 @@ bool Cues::Write(IMkvWriter* writer) const {
   if (!writer)
     return false;
 
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "Cues::Write", "cue_points",
+                          cue_entries_size_);
+
   uint64_t size = 0;
   for (int32_t i = 0; i < cue_entries_size_; ++i) {
     const CuePoint* const cue = GetCueByIndex(i);
@@ -657,6 +712,9 @@ Track::Track(unsigned int* seed)
       codec_delay_(0),
       seek_pre_roll_(0),
       default_duration_(0),
+      lacing_(kNoLacing),
+      max_lace_frames_(8),
+      max_lace_duration_(0),
       codec_private_length_(0),
       content_encoding_entries_(NULL),
       content_encoding_entries_size_(0) {}
@@ -743,6 +801,8 @@ uint64_t Track::PayloadSize() const {
     size += EbmlElementSize(libwebm::kMkvDefaultDuration,
                             static_cast<uint64>(default_duration_));
   }
+  if (lacing_ != kNoLacing)
+    size += EbmlElementSize(libwebm::kMkvFlagLacing, static_cast<uint64>(1));
 
   if (content_encoding_entries_size_ > 0) {
     uint64_t content_encodings_size = 0;
@@ -813,6 +873,8 @@ bool Track::Write(IMkvWriter* writer) const {
   if (default_duration_)
     size += EbmlElementSize(libwebm::kMkvDefaultDuration,
                             static_cast<uint64>(default_duration_));
+  if (lacing_ != kNoLacing)
+    size += EbmlElementSize(libwebm::kMkvFlagLacing, static_cast<uint64>(1));
 
   const int64_t payload_position = writer->Position();
   if (payload_position < 0)
@@ -848,6 +910,11 @@ bool Track::Write(IMkvWriter* writer) const {
                           static_cast<uint64>(default_duration_)))
       return false;
   }
+  if (lacing_ != kNoLacing) {
+    if (!WriteEbmlElement(writer, libwebm::kMkvFlagLacing,
+                          static_cast<uint64>(1)))
+      return false;
+  }
   if (codec_id_) {
     if (!WriteEbmlElement(writer, libwebm::kMkvCodecID, codec_id_))
       return false;
@@ -2561,6 +2628,9 @@ bool Cluster::Finalize(bool set_last_frame_duration, uint64_t duration) {
   if (!writer_ || finalized_)
     return false;
 
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "Cluster::Finalize", "position",
+                          position_for_cues_);
+
   if (write_last_frame_with_duration_) {
     // Write out held back Frames. This essentially performs a k-way merge
     // across all tracks in the increasing order of timestamps.
@@ -3073,6 +3143,13 @@ Segment::Segment()
       frames_(NULL),
       frames_capacity_(0),
       frames_size_(0),
+      lace_data_(NULL),
+      lace_data_length_(0),
+      lace_data_capacity_(0),
+      lace_frame_count_(0),
+      lace_track_(0),
+      lace_timestamp_(0),
+      lace_last_timestamp_(0),
       has_video_(false),
       header_written_(false),
       last_block_duration_(0),
@@ -3092,7 +3169,8 @@ Segment::Segment()
       duration_(0.0),
       writer_cluster_(NULL),
       writer_cues_(NULL),
-      writer_header_(NULL) {
+      writer_header_(NULL),
+      frame_encryptor_(NULL) {
   const time_t curr_time = time(NULL);
   seed_ = static_cast<unsigned int>(curr_time);
 #ifdef _WIN32
@@ -3116,6 +3194,7 @@ Segment::~Segment() {
     }
     delete[] frames_;
   }
+  delete[] lace_data_;
 
   delete[] chunk_name_;
   delete[] chunking_base_name_;
@@ -3205,6 +3284,7 @@ bool Segment::CopyAndMoveCuesBeforeClusters(mkvparser::IMkvReader* reader,
                                             IMkvWriter* writer) {
   if (!writer->Seekable() || chunking_)
     return false;
+  LIBWEBM_TRACE_SCOPE("mkvmuxer", "Segment::CopyAndMoveCuesBeforeClusters");
   const int64_t cluster_offset =
       cluster_list_[0]->size_position() - GetUIntSize(libwebm::kMkvCluster);
 
@@ -3238,7 +3318,9 @@ bool Segment::CopyAndMoveCuesBeforeClusters(mkvparser::IMkvReader* reader,
 }
 
 bool Segment::Finalize() {
-  if (WriteFramesAll() < 0)
+  LIBWEBM_TRACE_SCOPE("mkvmuxer", "Segment::Finalize");
+
+  if (!FlushLace() || WriteFramesAll() < 0)
     return false;
 
   // In kLive mode, call Cluster::Finalize only if |accurate_cluster_duration_|
@@ -3253,6 +3335,11 @@ bool Segment::Finalize() {
     if (!old_cluster || !old_cluster->Finalize(false, 0))
       return false;
   }
+  if (cluster_list_size_ > 0 && cluster_list_[cluster_list_size_ - 1]) {
+    LIBWEBM_TRACE_ASYNC_END(
+        "mkvmuxer", "Cluster", this,
+        cluster_list_[cluster_list_size_ - 1]->position_for_cues());
+  }
 
   if (mode_ == kFile) {
     if (chunking_ && chunk_writer_cluster_) {
@@ -3451,12 +3538,12 @@ bool Segment::AddFrame(const uint8_t* data, uint64_t length,
     return false;
 
   Frame frame;
-  if (!frame.Init(data, length))
+  if (!InitFrame(data, length, track_number, &frame))
     return false;
   frame.set_track_number(track_number);
   frame.set_timestamp(timestamp);
   frame.set_is_key(is_key);
-  return AddGenericFrame(&frame);
+  return AddEncodedFrame(&frame);
 }
 
 bool Segment::AddFrameWithAdditional(const uint8_t* data, uint64_t length,
@@ -3468,14 +3555,14 @@ bool Segment::AddFrameWithAdditional(const uint8_t* data, uint64_t length,
     return false;
 
   Frame frame;
-  if (!frame.Init(data, length) ||
+  if (!InitFrame(data, length, track_number, &frame) ||
       !frame.AddAdditionalData(additional, additional_length, add_id)) {
     return false;
   }
   frame.set_track_number(track_number);
   frame.set_timestamp(timestamp);
   frame.set_is_key(is_key);
-  return AddGenericFrame(&frame);
+  return AddEncodedFrame(&frame);
 }
 
 bool Segment::AddFrameWithDiscardPadding(const uint8_t* data, uint64_t length,
@@ -3486,13 +3573,13 @@ bool Segment::AddFrameWithDiscardPadding(const uint8_t* data, uint64_t length,
     return false;
 
   Frame frame;
-  if (!frame.Init(data, length))
+  if (!InitFrame(data, length, track_number, &frame))
     return false;
   frame.set_discard_padding(discard_padding);
   frame.set_track_number(track_number);
   frame.set_timestamp(timestamp);
   frame.set_is_key(is_key);
-  return AddGenericFrame(&frame);
+  return AddEncodedFrame(&frame);
 }
 
 bool Segment::AddMetadata(const uint8_t* data, uint64_t length,
@@ -3502,19 +3589,37 @@ bool Segment::AddMetadata(const uint8_t* data, uint64_t length,
     return false;
 
   Frame frame;
-  if (!frame.Init(data, length))
+  if (!InitFrame(data, length, track_number, &frame))
     return false;
   frame.set_track_number(track_number);
   frame.set_timestamp(timestamp_ns);
   frame.set_duration(duration_ns);
   frame.set_is_key(true);  // All metadata blocks are keyframes.
-  return AddGenericFrame(&frame);
+  return AddEncodedFrame(&frame);
 }
 
 bool Segment::AddGenericFrame(const Frame* frame) {
   if (!frame)
     return false;
 
+  if (!frame_encryptor_ ||
+      !frame_encryptor_->IsEncrypted(frame->track_number())) {
+    return AddEncodedFrame(frame);
+  }
+
+  // Encrypt into a copy, as AddFrame() would have made.
+  Frame encrypted_frame;
+  return frame_encryptor_->EncryptFrame(*frame, &encrypted_frame) &&
+         AddEncodedFrame(&encrypted_frame);
+}
+
+bool Segment::AddEncodedFrame(const Frame* frame) {
+  if (!frame)
+    return false;
+
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "Segment::AddFrame", "size",
+                          frame->length());
+
   if (!CheckHeaderInfo())
     return false;
 
@@ -3526,6 +3631,21 @@ bool Segment::AddGenericFrame(const Frame* frame) {
   if (!tracks_.GetTrackByNumber(frame->track_number()))
     return false;
 
+  if (lace_frame_count_ > 0) {
+    if (frame->timestamp() < lace_last_timestamp_)
+      return false;
+    if (FitsInLace(*frame))
+      return AppendToLace(*frame);
+    if (!FlushLace())
+      return false;
+  }
+  if (CanLaceFrame(*frame))
+    return AppendToLace(*frame);
+
+  return WriteEncodedFrame(frame);
+}
+
+bool Segment::WriteEncodedFrame(const Frame* frame) {
   if (frame->discard_padding() != 0)
     doc_type_version_ = 4;
 
@@ -3606,6 +3726,151 @@ bool Segment::AddGenericFrame(const Frame* frame) {
   return true;
 }
 
+bool Segment::CanLaceFrame(const Frame& frame) const {
+  const Track* const track = tracks_.GetTrackByNumber(frame.track_number());
+  if (!track || track->lacing() == kNoLacing || track->max_lace_frames() < 2)
+    return false;
+  if (frame_encryptor_ && frame_encryptor_->IsEncrypted(frame.track_number()))
+    return false;
+  return frame.is_key() && frame.CanBeSimpleBlock() &&
+         frame.lacing() == kNoLacing;
+}
+
+bool Segment::FitsInLace(const Frame& frame) const {
+  if (lace_frame_count_ == 0 || frame.track_number() != lace_track_ ||
+      !CanLaceFrame(frame)) {
+    return false;
+  }
+  const Track* const track = tracks_.GetTrackByNumber(lace_track_);
+  const int max_frames = track->max_lace_frames() < kMaxLaceFrames
+                             ? track->max_lace_frames()
+                             : kMaxLaceFrames;
+  if (lace_frame_count_ >= max_frames)
+    return false;
+  if (track->max_lace_duration() > 0 &&
+      frame.timestamp() - lace_timestamp_ > track->max_lace_duration()) {
+    return false;
+  }
+  // Keep the Block size well within what WriteSimpleBlock() can write.
+  if (lace_data_length_ + frame.length() > 0xFFFFFFF)
+    return false;
+  return track->lacing() != kFixedSizeLacing ||
+         frame.length() == lace_frame_sizes_[0];
+}
+
+bool Segment::AppendToLace(const Frame& frame) {
+  if (lace_frame_count_ == 0) {
+    lace_track_ = frame.track_number();
+    lace_timestamp_ = frame.timestamp();
+    lace_data_length_ = 0;
+  }
+
+  const uint64_t length = lace_data_length_ + frame.length();
+  if (length > lace_data_capacity_) {
+    uint64_t capacity = lace_data_capacity_ * 2;
+    if (capacity < length)
+      capacity = length < 4096 ? 4096 : length;
+    uint8_t* const data =
+        new (std::nothrow) uint8_t[static_cast<size_t>(capacity)];  // NOLINT
+    if (!data)
+      return false;
+    if (lace_data_length_ > 0)
+      memcpy(data, lace_data_, static_cast<size_t>(lace_data_length_));
+    delete[] lace_data_;
+    lace_data_ = data;
+    lace_data_capacity_ = capacity;
+  }
+
+  memcpy(lace_data_ + lace_data_length_, frame.frame(),
+         static_cast<size_t>(frame.length()));
+  lace_data_length_ = length;
+  lace_frame_sizes_[lace_frame_count_++] = frame.length();
+  lace_last_timestamp_ = frame.timestamp();
+  return true;
+}
+
+bool Segment::FlushLace() {
+  if (lace_frame_count_ == 0)
+    return true;
+
+  const int count = lace_frame_count_;
+  lace_frame_count_ = 0;
+
+  Frame frame;
+  frame.set_track_number(lace_track_);
+  frame.set_timestamp(lace_timestamp_);
+  frame.set_is_key(true);
+  if (count == 1) {
+    return frame.Init(lace_data_, lace_data_length_) &&
+           WriteEncodedFrame(&frame);
+  }
+
+  const Track* const track = tracks_.GetTrackByNumber(lace_track_);
+  if (!track)
+    return false;
+  const Lacing lacing = track->lacing();
+
+  // The lace header is the number of frames minus one followed by the sizes
+  // of all frames but the last, which the Block size implies.
+  uint64_t header_size = 1;
+  if (lacing == kXiphLacing) {
+    for (int i = 0; i < count - 1; ++i)
+      header_size += lace_frame_sizes_[i] / 255 + 1;
+  } else if (lacing == kEbmlLacing) {
+    header_size += 8 * (count - 1);  // Upper bound.
+  }
+
+  const uint64_t capacity = header_size + lace_data_length_;
+  std::unique_ptr<uint8_t[]> data(
+      new (std::nothrow) uint8_t[static_cast<size_t>(capacity)]);  // NOLINT
+  if (!data)
+    return false;
+
+  uint8_t* out = data.get();
+  *out++ = static_cast<uint8_t>(count - 1);
+  if (lacing == kXiphLacing) {
+    for (int i = 0; i < count - 1; ++i) {
+      uint64_t size = lace_frame_sizes_[i];
+      for (; size >= 255; size -= 255)
+        *out++ = 255;
+      *out++ = static_cast<uint8_t>(size);
+    }
+  } else if (lacing == kEbmlLacing) {
+    const uint64_t first_size = lace_frame_sizes_[0];
+    out += StoreVint(first_size, GetCodedUIntSize(first_size), out);
+    for (int i = 1; i < count - 1; ++i) {
+      out += StoreSignedVint(static_cast<int64_t>(lace_frame_sizes_[i]) -
+                                 static_cast<int64_t>(lace_frame_sizes_[i - 1]),
+                             out);
+    }
+  }
+  memcpy(out, lace_data_, static_cast<size_t>(lace_data_length_));
+  out += lace_data_length_;
+
+  frame.set_lacing(lacing);
+  if (!frame.Init(data.get(), out - data.get()) || !WriteEncodedFrame(&frame))
+    return false;
+
+  // The Block holds |count| frames. Account for all of them so the Segment
+  // duration and its per-frame estimate match the unlaced output.
+  const uint64_t index = lace_track_ - 1;
+  track_frames_written_[index] += count - 1;
+  if (lace_last_timestamp_ > last_timestamp_)
+    last_timestamp_ = lace_last_timestamp_;
+  if (lace_last_timestamp_ > last_track_timestamp_[index])
+    last_track_timestamp_[index] = lace_last_timestamp_;
+  return true;
+}
+
+bool Segment::InitFrame(const uint8_t* data, uint64_t length,
+                        uint64_t track_number, Frame* frame) {
+  if (!frame_encryptor_ || !frame_encryptor_->IsEncrypted(track_number))
+    return frame->Init(data, length);
+
+  return frame_encryptor_->PrepareFrame(data, length, track_number, frame) &&
+         frame_encryptor_->EncryptFrames(&frame, 1);
+}
+
 void Segment::OutputCues(bool output_cues) { output_cues_ = output_cues; }
 
 void Segment::AccurateClusterDuration(bool accurate_cluster_duration) {
@@ -3858,6 +4123,8 @@ int Segment::TestFrame(uint64_t track_number, uint64_t frame_timestamp_ns,
 }
 
 bool Segment::MakeNewCluster(uint64_t frame_timestamp_ns) {
+  LIBWEBM_TRACE_SCOPE_ARG("mkvmuxer", "Segment::MakeNewCluster", "index",
+                          cluster_list_size_);
   const int32_t new_size = cluster_list_size_ + 1;
 
   if (new_size > cluster_list_capacity_) {
@@ -3888,6 +4155,8 @@ bool Segment::MakeNewCluster(uint64_t frame_timestamp_ns) {
 
     if (!old_cluster || !old_cluster->Finalize(true, frame_timestamp_ns))
       return false;
+    LIBWEBM_TRACE_ASYNC_END("mkvmuxer", "Cluster", this,
+                            old_cluster->position_for_cues());
   }
 
   if (output_cues_)
@@ -3928,12 +4197,16 @@ bool Segment::MakeNewCluster(uint64_t frame_timestamp_ns) {
   if (!cluster->Init(writer_cluster_))
     return false;
 
+  // Each Cluster is a span from here to its Finalize(), keyed by the segment
+  // and its offset.
+  LIBWEBM_TRACE_ASYNC_BEGIN("mkvmuxer", "Cluster", this, offset);
   cluster_list_size_ = new_size;
   return true;
 }
 
 bool Segment::DoNewClusterProcessing(uint64_t track_number,
                                      uint64_t frame_timestamp_ns, bool is_key) {
+  LIBWEBM_TRACE_SCOPE("mkvmuxer", "Segment::DoNewClusterProcessing");
   for (;;) {
     // Based on the characteristics of the current frame and current
     // cluster, decide whether to create a new cluster.
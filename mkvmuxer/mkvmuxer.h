@@ -27,11 +27,24 @@ class IMkvReader;
 
 namespace mkvmuxer {
 
+class FrameEncryptor;
 class MkvWriter;
 class Segment;
 
 const uint64_t kMaxTrackNumber = 126;
 
+// Lacing of several frames into one Block. The values are those of the lacing
+// bits of the Block flags.
+enum Lacing {
+  kNoLacing = 0,
+  kXiphLacing = 1,
+  kFixedSizeLacing = 2,
+  kEbmlLacing = 3
+};
+
+// Maximum number of frames in one lace.
+const int kMaxLaceFrames = 256;
+
 ///////////////////////////////////////////////////////////////
 // Interface used by the mkvmuxer to write out the Mkv data.
 class IMkvWriter {
@@ -100,6 +113,13 @@ class Frame {
   bool AddAdditionalData(const uint8_t* additional, uint64_t length,
                          uint64_t add_id);
 
+  // Sets the partitions of the frame data for encryption with subsamples:
+  // |count| offsets into the data, in increasing order, at which the data
+  // alternates between clear and encrypted, starting with clear data. At
+  // most 255 offsets. A |count| of 0 removes the partitions. Only used by
+  // FrameEncryptor. Returns true on success.
+  bool SetEncryptionPartitions(const uint32_t* offsets, uint64_t count);
+
   // Returns true if the frame has valid parameters.
   bool IsValid() const;
 
@@ -132,8 +152,21 @@ class Frame {
   bool reference_block_timestamp_set() const {
     return reference_block_timestamp_set_;
   }
+  const uint32_t* encryption_partitions() const {
+    return encryption_partitions_;
+  }
+  uint64_t encryption_partition_count() const {
+    return encryption_partition_count_;
+  }
+  // |frame_| holds a lace of frames, including the lace header, when this is
+  // not kNoLacing. Set by Segment, which builds the laces.
+  void set_lacing(Lacing lacing) { lacing_ = lacing; }
+  Lacing lacing() const { return lacing_; }
 
  private:
+  // FrameEncryptor writes the encryption header and the data in place.
+  friend class FrameEncryptor;
+
   // Id of the Additional data.
   uint64_t add_id_;
 
@@ -175,6 +208,15 @@ class Frame {
   // Flag indicating if |reference_block_timestamp_| has been set.
   bool reference_block_timestamp_set_;
 
+  // Encryption partition offsets. Owned by this class.
+  uint32_t* encryption_partitions_;
+
+  // Number of encryption partition offsets.
+  uint64_t encryption_partition_count_;
+
+  // Lacing of the data.
+  Lacing lacing_;
+
   LIBWEBM_DISALLOW_COPY_AND_ASSIGN(Frame);
 };
 
@@ -705,6 +747,20 @@ class Track {
     default_duration_ = default_duration;
   }
   uint64_t default_duration() const { return default_duration_; }
+  // Consecutive key frames of the track that need no BlockGroup are laced
+  // together when |lacing| is not kNoLacing, at most |max_lace_frames| of them
+  // and spanning at most |max_lace_duration| nanoseconds (0 for no limit).
+  // Frames of encrypted tracks are never laced. Also sets FlagLacing.
+  void set_lacing(Lacing lacing) { lacing_ = lacing; }
+  Lacing lacing() const { return lacing_; }
+  void set_max_lace_frames(int max_lace_frames) {
+    max_lace_frames_ = max_lace_frames;
+  }
+  int max_lace_frames() const { return max_lace_frames_; }
+  void set_max_lace_duration(uint64_t max_lace_duration) {
+    max_lace_duration_ = max_lace_duration;
+  }
+  uint64_t max_lace_duration() const { return max_lace_duration_; }
 
   uint64_t codec_private_length() const { return codec_private_length_; }
   uint32_t content_encoding_entries_size() const {
@@ -725,6 +781,11 @@ class Track {
   uint64_t seek_pre_roll_;
   uint64_t default_duration_;
 
+  // Lacing settings.
+  Lacing lacing_;
+  int max_lace_frames_;
+  uint64_t max_lace_duration_;
+
   // Size of the CodecPrivate data in bytes.
   uint64_t codec_private_length_;
 
@@ -1608,7 +1669,9 @@ class Segment {
                                   bool is_key);
 
   // Writes a Frame to the output medium. Chooses the correct way of writing
-  // the frame (Block vs SimpleBlock) based on the parameters passed.
+  // the frame (Block vs SimpleBlock) based on the parameters passed. Frames
+  // of tracks encrypted by the frame encryptor are encrypted, with the
+  // encryption partitions of |frame|.
   // Inputs:
   //   frame: frame object
   bool AddGenericFrame(const Frame* frame);
@@ -1700,10 +1763,20 @@ class Segment {
   void set_duration(double duration) { duration_ = duration; }
   double duration() const { return duration_; }
 
+  // Sets the encryptor for the frames of its encrypted tracks, or NULL for
+  // none. Not owned by this class.
+  void set_frame_encryptor(FrameEncryptor* frame_encryptor) {
+    frame_encryptor_ = frame_encryptor;
+  }
+  FrameEncryptor* frame_encryptor() const { return frame_encryptor_; }
+
   // Returns true when codec IDs are valid for WebM.
   bool DocTypeIsWebm() const;
 
  private:
+  // BatchMuxer plans and writes the clusters of the segment itself.
+  friend class BatchMuxer;
+
   // Checks if header information has been output and initialized. If not it
   // will output the Segment element and initialize the SeekHead elment and
   // Cues elements.
@@ -1758,6 +1831,31 @@ class Segment {
   bool DoNewClusterProcessing(uint64_t track_num, uint64_t timestamp_ns,
                               bool key);
 
+  // Copies |data| into |frame|, encrypted when |track_number| is encrypted.
+  // Returns true on success.
+  bool InitFrame(const uint8_t* data, uint64_t length, uint64_t track_number,
+                 Frame* frame);
+
+  // Adds a frame whose data is in its final form, as AddGenericFrame() does
+  // after encrypting the data. Returns true on success.
+  bool AddEncodedFrame(const Frame* frame);
+
+  // Writes |frame| to the current or a new cluster. Returns true on success.
+  bool WriteEncodedFrame(const Frame* frame);
+
+  // Returns true if |frame| may be added to a lace of its track.
+  bool CanLaceFrame(const Frame& frame) const;
+
+  // Returns true if |frame| can be added to the lace being built.
+  bool FitsInLace(const Frame& frame) const;
+
+  // Adds the data of |frame| to the lace being built, starting a new lace
+  // when there is none. Returns true on success.
+  bool AppendToLace(const Frame& frame);
+
+  // Writes out the lace being built, if any. Returns true on success.
+  bool FlushLace();
+
   // Adjusts Cue Point values (to place Cues before Clusters) so that they
   // reflect the correct offsets.
   void MoveCuesBeforeClusters();
@@ -1842,6 +1940,18 @@ class Segment {
   // Number of frames in the frame list.
   int32_t frames_size_;
 
+  // The lace being built: the data of |lace_frame_count_| frames of track
+  // |lace_track_|, without the lace header. |lace_timestamp_| is the
+  // timestamp of the first frame and |lace_last_timestamp_| that of the last.
+  uint8_t* lace_data_;
+  uint64_t lace_data_length_;
+  uint64_t lace_data_capacity_;
+  uint64_t lace_frame_sizes_[kMaxLaceFrames];
+  int lace_frame_count_;
+  uint64_t lace_track_;
+  uint64_t lace_timestamp_;
+  uint64_t lace_last_timestamp_;
+
   // Flag telling if a video track has been added to the segment.
   bool has_video_;
 
@@ -1916,6 +2026,9 @@ class Segment {
   IMkvWriter* writer_cues_;
   IMkvWriter* writer_header_;
 
+  // Encrypts the frames of encrypted tracks. Not owned by this class.
+  FrameEncryptor* frame_encryptor_;
+
   LIBWEBM_DISALLOW_COPY_AND_ASSIGN(Segment);
 };
 
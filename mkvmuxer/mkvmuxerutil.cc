@@ -103,8 +103,8 @@ uint64 WriteBlock(IMkvWriter* writer, const Frame* const frame, int64 timecode,
   if (SerializeInt(writer, timecode, 2))
     return 0;
 
-  // For a Block, flags is always 0.
-  if (SerializeInt(writer, 0, 1))
+  // For a Block, only the lacing bits of the flags are used.
+  if (SerializeInt(writer, static_cast<uint64>(frame->lacing()) << 1, 1))
     return 0;
 
   if (writer->Write(frame->frame(), static_cast<uint32>(frame->length())))
@@ -168,6 +168,7 @@ uint64 WriteSimpleBlock(IMkvWriter* writer, const Frame* const frame,
   uint64 flags = 0;
   if (frame->is_key())
     flags |= 0x80;
+  flags |= static_cast<uint64>(frame->lacing()) << 1;
 
   if (SerializeInt(writer, flags, 1))
     return 0;
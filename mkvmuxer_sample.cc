@@ -17,6 +17,7 @@
 // libwebm common includes.
 #include "common/file_util.h"
 #include "common/hdr_util.h"
+#include "common/trace.h"
 
 // libwebm mkvparser includes
 #include "mkvparser/mkvparser.h"
@@ -55,6 +56,8 @@ void Usage() {
   printf("  -fixed_size_cluster_timecode <int> ");
   printf(">0 Writes the cluster timecode using exactly 8 bytes\n");
   printf("  -copy_input_duration        >0 Copies the input duration\n");
+  printf("  -audio_lacing <int>         Laces audio frames: 1 Xiph, 2 fixed\n");
+  printf("                              size, 3 EBML. Default 0, no lacing\n");
   printf("\n");
   printf("Video options:\n");
   printf("  -display_width <int>           Display width in pixels\n");
@@ -81,6 +84,10 @@ void Usage() {
   printf("  -output_cues_block_number <int> >0 outputs cue block number\n");
   printf("  -cues_before_clusters <int> >0 puts Cues before Clusters\n");
   printf("\n");
+  printf("Diagnostics:\n");
+  printf("  -trace <file>               Chrome trace of parsing and muxing\n");
+  printf("                              (needs ENABLE_TRACING)\n");
+  printf("\n");
   printf("Metadata options:\n");
   printf("  -webvtt-subtitles <vttfile>    ");
   printf("add WebVTT subtitles as metadata track\n");
@@ -210,6 +217,7 @@ int main(int argc, char* argv[]) {
   bool accurate_cluster_duration = false;
   bool fixed_size_cluster_timecode = false;
   bool copy_input_duration = false;
+  int audio_lacing = mkvmuxer::kNoLacing;
 
   bool output_cues_block_number = true;
 
@@ -225,6 +233,7 @@ int main(int argc, char* argv[]) {
   float projection_pose_yaw = mkvparser::Projection::kValueNotPresent;
   int vp9_profile = -1;  // No profile set.
   int vp9_level = -1;  // No level set.
+  const char* trace_file = NULL;
 
   metadata_files_t metadata_files;
 
@@ -264,6 +273,8 @@ int main(int argc, char* argv[]) {
       max_cluster_size = strtol(argv[++i], &end, 10);
     } else if (!strcmp("-switch_tracks", argv[i]) && i < argc_check) {
       switch_tracks = strtol(argv[++i], &end, 10) == 0 ? false : true;
+    } else if (!strcmp("-audio_lacing", argv[i]) && i < argc_check) {
+      audio_lacing = static_cast<int>(strtol(argv[++i], &end, 10));
     } else if (!strcmp("-audio_track_number", argv[i]) && i < argc_check) {
       audio_track_number = static_cast<int>(strtol(argv[++i], &end, 10));
     } else if (!strcmp("-video_track_number", argv[i]) && i < argc_check) {
@@ -307,6 +318,8 @@ int main(int argc, char* argv[]) {
       vp9_profile = static_cast<int>(strtol(argv[++i], &end, 10));
     } else if (!strcmp("-level", argv[i]) && i < argc_check) {
       vp9_level = static_cast<int>(strtol(argv[++i], &end, 10));
+    } else if (!strcmp("-trace", argv[i]) && i < argc_check) {
+      trace_file = argv[++i];
     } else if (!strcmp("-output_cues_block_number", argv[i]) &&
                i < argc_check) {
       output_cues_block_number =
@@ -322,6 +335,12 @@ int main(int argc, char* argv[]) {
     return EXIT_FAILURE;
   }
 
+  if (trace_file) {
+    if (!libwebm::Tracer::CompiledIn())
+      printf("\n Warning: built without ENABLE_TRACING, the trace is empty.\n");
+    libwebm::Tracer::Get()->Start();
+  }
+
   // Get parser header info
   mkvparser::MkvReader reader;
 
@@ -648,6 +667,10 @@ int main(int argc, char* argv[]) {
         audio->set_codec_delay(pAudioTrack->GetCodecDelay());
       if (pAudioTrack->GetSeekPreRoll())
         audio->set_seek_pre_roll(pAudioTrack->GetSeekPreRoll());
+      if (audio_lacing > mkvmuxer::kNoLacing &&
+          audio_lacing <= mkvmuxer::kEbmlLacing) {
+        audio->set_lacing(static_cast<mkvmuxer::Lacing>(audio_lacing));
+      }
     }
   }
 
@@ -798,5 +821,10 @@ int main(int argc, char* argv[]) {
 
   delete[] data;
 
+  if (trace_file && !libwebm::Tracer::Get()->WriteChromeTrace(trace_file)) {
+    printf("\n Unable to write trace file %s.\n", trace_file);
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
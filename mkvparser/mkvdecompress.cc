@@ -0,0 +1,297 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "mkvparser/mkvdecompress.h"
+
+#include <climits>
+#include <cstring>
+#include <new>
+
+#ifdef LIBWEBM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace mkvparser {
+
+namespace {
+
+const unsigned long long kContentEncodingTypeCompression = 0;
+const unsigned long long kContentEncodingScopeFrames = 1;
+const unsigned long long kContentCompAlgoZlib = 0;
+const unsigned long long kContentCompAlgoHeaderStripping = 3;
+
+// Returns the ContentCompression applied to the frames of |pTrack|, or NULL.
+const ContentEncoding::ContentCompression* GetCompression(
+    const Track* pTrack) {
+  if (pTrack == NULL)
+    return NULL;
+
+  for (unsigned long i = 0; i < pTrack->GetContentEncodingCount(); ++i) {
+    const ContentEncoding* const pEncoding =
+        pTrack->GetContentEncodingByIndex(i);
+
+    if (pEncoding == NULL ||
+        pEncoding->encoding_type() != kContentEncodingTypeCompression ||
+        (pEncoding->encoding_scope() & kContentEncodingScopeFrames) == 0 ||
+        pEncoding->GetCompressionCount() == 0) {
+      continue;
+    }
+
+    return pEncoding->GetCompressionByIndex(0);
+  }
+
+  return NULL;
+}
+
+}  // namespace
+
+struct FrameDecompressor::Inflater {
+  long long track_number;
+#ifdef LIBWEBM_HAVE_ZLIB
+  z_stream stream;
+#endif
+};
+
+FrameDecompressor::FrameDecompressor()
+    : m_inflaters(NULL),
+      m_inflater_count(0),
+      m_input(NULL),
+      m_input_capacity(0) {}
+
+FrameDecompressor::~FrameDecompressor() {
+  for (long i = 0; i < m_inflater_count; ++i) {
+#ifdef LIBWEBM_HAVE_ZLIB
+    inflateEnd(&m_inflaters[i]->stream);
+#endif
+    delete m_inflaters[i];
+  }
+
+  delete[] m_inflaters;
+  delete[] m_input;
+}
+
+bool FrameDecompressor::IsCompressed(const Track* pTrack) {
+  return GetCompression(pTrack) != NULL;
+}
+
+bool FrameDecompressor::IsSupported(const Track* pTrack) {
+  const ContentEncoding::ContentCompression* const pCompression =
+      GetCompression(pTrack);
+
+  if (pCompression == NULL ||
+      pCompression->algo == kContentCompAlgoHeaderStripping) {
+    return true;
+  }
+
+#ifdef LIBWEBM_HAVE_ZLIB
+  return pCompression->algo == kContentCompAlgoZlib;
+#else
+  return false;
+#endif
+}
+
+long FrameDecompressor::ReadFrame(IMkvReader* pReader, const Track* pTrack,
+                                  const Block::Frame& frame, unsigned char* buf,
+                                  long buf_len, long& size) {
+  size = 0;
+
+  if (pReader == NULL || frame.len < 0 || buf_len < 0 ||
+      (buf == NULL && buf_len > 0)) {
+    return E_PARSE_FAILED;
+  }
+
+  const ContentEncoding::ContentCompression* const pCompression =
+      GetCompression(pTrack);
+
+  if (pCompression == NULL ||
+      pCompression->algo == kContentCompAlgoHeaderStripping) {
+    // The stripped bytes, then the frame, straight into |buf|.
+    const long prefix_len =
+        (pCompression == NULL) ? 0
+                               : static_cast<long>(pCompression->settings_len);
+
+    size = prefix_len + frame.len;
+
+    if (size > buf_len)
+      return 1;
+
+    if (prefix_len > 0)
+      memcpy(buf, pCompression->settings, prefix_len);
+
+    return frame.Read(pReader, buf + prefix_len);
+  }
+
+  if (frame.len > m_input_capacity) {
+    unsigned char* const input = new (std::nothrow) unsigned char[frame.len];
+
+    if (input == NULL)
+      return -1;
+
+    delete[] m_input;
+    m_input = input;
+    m_input_capacity = frame.len;
+  }
+
+  const long status = frame.Read(pReader, m_input);
+
+  if (status)
+    return status;
+
+  return Decompress(pTrack, m_input, frame.len, buf, buf_len, size);
+}
+
+long FrameDecompressor::Decompress(const Track* pTrack,
+                                   const unsigned char* data, long len,
+                                   unsigned char* buf, long buf_len,
+                                   long& size) {
+  size = 0;
+
+  if ((data == NULL && len > 0) || len < 0 || buf_len < 0 ||
+      (buf == NULL && buf_len > 0)) {
+    return E_PARSE_FAILED;
+  }
+
+  const ContentEncoding::ContentCompression* const pCompression =
+      GetCompression(pTrack);
+
+  if (pCompression == NULL ||
+      pCompression->algo == kContentCompAlgoHeaderStripping) {
+    const long prefix_len =
+        (pCompression == NULL) ? 0
+                               : static_cast<long>(pCompression->settings_len);
+
+    size = prefix_len + len;
+
+    if (size > buf_len)
+      return 1;
+
+    if (prefix_len > 0)
+      memcpy(buf, pCompression->settings, prefix_len);
+
+    if (len > 0)
+      memcpy(buf + prefix_len, data, len);
+
+    return 0;
+  }
+
+  if (pCompression->algo != kContentCompAlgoZlib)
+    return E_PARSE_FAILED;
+
+  Inflater* const pInflater = GetInflater(pTrack);
+
+  if (pInflater == NULL)
+    return E_PARSE_FAILED;
+
+  return Inflate(pInflater, data, len, buf, buf_len, size);
+}
+
+FrameDecompressor::Inflater* FrameDecompressor::GetInflater(
+    const Track* pTrack) {
+#ifdef LIBWEBM_HAVE_ZLIB
+  const long long track_number = pTrack->GetNumber();
+
+  for (long i = 0; i < m_inflater_count; ++i) {
+    if (m_inflaters[i]->track_number == track_number)
+      return m_inflaters[i];
+  }
+
+  Inflater* const pInflater = new (std::nothrow) Inflater;
+
+  if (pInflater == NULL)
+    return NULL;
+
+  pInflater->track_number = track_number;
+  memset(&pInflater->stream, 0, sizeof(pInflater->stream));
+
+  if (inflateInit(&pInflater->stream) != Z_OK) {
+    delete pInflater;
+    return NULL;
+  }
+
+  Inflater** const inflaters =
+      new (std::nothrow) Inflater*[m_inflater_count + 1];
+
+  if (inflaters == NULL) {
+    inflateEnd(&pInflater->stream);
+    delete pInflater;
+    return NULL;
+  }
+
+  for (long i = 0; i < m_inflater_count; ++i)
+    inflaters[i] = m_inflaters[i];
+
+  inflaters[m_inflater_count++] = pInflater;
+
+  delete[] m_inflaters;
+  m_inflaters = inflaters;
+
+  return pInflater;
+#else
+  (void)pTrack;
+  return NULL;
+#endif
+}
+
+long FrameDecompressor::Inflate(Inflater* pInflater, const unsigned char* data,
+                                long len, unsigned char* buf, long buf_len,
+                                long& size) {
+#ifdef LIBWEBM_HAVE_ZLIB
+  if (len > static_cast<long>(UINT_MAX / 2) ||
+      buf_len > static_cast<long>(UINT_MAX / 2)) {
+    return E_PARSE_FAILED;
+  }
+
+  z_stream& stream = pInflater->stream;
+
+  if (inflateReset(&stream) != Z_OK)
+    return E_FILE_FORMAT_INVALID;
+
+  // When |buf| fills up, the rest of the frame is inflated into |scratch|
+  // to find its size.
+  unsigned char scratch[4096];
+  bool overflow = buf_len == 0;
+
+  stream.next_in = const_cast<Bytef*>(data);
+  stream.avail_in = static_cast<uInt>(len);
+  stream.next_out = overflow ? scratch : buf;
+  stream.avail_out = overflow ? sizeof(scratch) : static_cast<uInt>(buf_len);
+
+  for (;;) {
+    const int status = inflate(&stream, Z_NO_FLUSH);
+
+    if (status == Z_STREAM_END)
+      break;
+
+    if (status != Z_OK && status != Z_BUF_ERROR)
+      return E_FILE_FORMAT_INVALID;
+
+    if (stream.avail_out > 0)  // truncated
+      return E_FILE_FORMAT_INVALID;
+
+    overflow = true;
+    stream.next_out = scratch;
+    stream.avail_out = sizeof(scratch);
+  }
+
+  if (stream.total_out > static_cast<uLong>(LONG_MAX))
+    return E_FILE_FORMAT_INVALID;
+
+  size = static_cast<long>(stream.total_out);
+
+  return overflow ? 1 : 0;
+#else
+  (void)pInflater;
+  (void)data;
+  (void)len;
+  (void)buf;
+  (void)buf_len;
+  (void)size;
+  return E_PARSE_FAILED;
+#endif
+}
+
+}  // namespace mkvparser
@@ -0,0 +1,87 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef MKVPARSER_MKVDECOMPRESS_H_
+#define MKVPARSER_MKVDECOMPRESS_H_
+
+#include "mkvparser/mkvparser.h"
+
+namespace mkvparser {
+
+// Reads the frames of tracks with a ContentCompression that applies to the
+// frame contents, undoing the compression.
+//
+// Header stripping (ContentCompAlgo 3) is undone by writing the stripped
+// bytes and then reading the frame straight into the caller's buffer. zlib
+// (ContentCompAlgo 0) is inflated into the caller's buffer with one inflate
+// context per track, which is reset rather than reallocated between frames;
+// it is only available when libwebm is built with zlib (LIBWEBM_HAVE_ZLIB).
+// Once the buffers have grown to the largest frame, reading a frame
+// allocates nothing.
+//
+// Frames of tracks without compression are read unchanged.
+//
+// Decompression is opt-in rather than built into Block::Frame::Read() and
+// Cluster::ReadFrames(): those keep returning the stored bytes, and
+// Block::Frame::len stays the stored size. The decompressed size of a zlib
+// frame is not recorded in the file, so reporting it through Frame::len
+// would mean inflating every frame while the block is parsed, and the
+// inflate state would have to live in the otherwise read-only Segment,
+// breaking Segment::Freeze() sharing. Callers that may see compressed tracks
+// check IsCompressed() once per track and route those frames through
+// ReadFrame() or Decompress(); the per-track state then belongs to the
+// caller, one FrameDecompressor per thread.
+class FrameDecompressor {
+  FrameDecompressor(const FrameDecompressor&);
+  FrameDecompressor& operator=(const FrameDecompressor&);
+
+ public:
+  FrameDecompressor();
+  ~FrameDecompressor();
+
+  // Returns true when the frames of |pTrack| are compressed.
+  static bool IsCompressed(const Track* pTrack);
+
+  // Returns true when the frames of |pTrack| can be read: they are not
+  // compressed, or compressed with a supported algorithm.
+  static bool IsSupported(const Track* pTrack);
+
+  // Reads |frame| of |pTrack| from |pReader| into the |buf_len| bytes of
+  // |buf|, and sets |size| to the size of the decompressed frame. Returns 0
+  // on success. When |buf_len| is too small returns 1, with |size| set to
+  // the size needed. Returns E_FILE_FORMAT_INVALID when the frame can't be
+  // decompressed, E_PARSE_FAILED when the compression is not supported, or
+  // the status of a failed read.
+  long ReadFrame(IMkvReader* pReader, const Track* pTrack,
+                 const Block::Frame& frame, unsigned char* buf, long buf_len,
+                 long& size);
+
+  // As ReadFrame(), for the |len| bytes of a frame of |pTrack| already in
+  // memory at |data|, such as a frame read by Cluster::ReadFrames().
+  long Decompress(const Track* pTrack, const unsigned char* data, long len,
+                  unsigned char* buf, long buf_len, long& size);
+
+ private:
+  struct Inflater;
+
+  // Returns the inflater for |pTrack|, creating it on first use, or NULL.
+  Inflater* GetInflater(const Track* pTrack);
+
+  long Inflate(Inflater* pInflater, const unsigned char* data, long len,
+               unsigned char* buf, long buf_len, long& size);
+
+  Inflater** m_inflaters;
+  long m_inflater_count;
+
+  // Compressed frame data read by ReadFrame().
+  unsigned char* m_input;
+  long m_input_capacity;
+};
+
+}  // namespace mkvparser
+
+#endif  // MKVPARSER_MKVDECOMPRESS_H_
@@ -0,0 +1,442 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "mkvparser/mkvdecrypt.h"
+
+#include <cstring>
+#include <new>
+
+namespace mkvparser {
+
+namespace {
+
+const unsigned char kEncryptedBit = 0x01;
+const unsigned char kPartitionedBit = 0x02;
+const long kSignalByteSize = 1;
+const long kIvSize = 8;
+const long kPartitionCountSize = 1;
+const long kPartitionOffsetSize = 4;
+const unsigned long long kContentEncodingTypeEncryption = 1;
+const unsigned long long kContentEncAlgoAes = 5;
+
+// Returns the ContentEncryption of |pTrack| that uses AES-CTR, or NULL.
+const ContentEncoding::ContentEncryption* GetAesEncryption(
+    const Track* pTrack) {
+  if (pTrack == NULL)
+    return NULL;
+
+  for (unsigned long i = 0; i < pTrack->GetContentEncodingCount(); ++i) {
+    const ContentEncoding* const pEncoding =
+        pTrack->GetContentEncodingByIndex(i);
+
+    if (pEncoding == NULL ||
+        pEncoding->encoding_type() != kContentEncodingTypeEncryption) {
+      continue;
+    }
+
+    for (unsigned long j = 0; j < pEncoding->GetEncryptionCount(); ++j) {
+      const ContentEncoding::ContentEncryption* const pEncryption =
+          pEncoding->GetEncryptionByIndex(j);
+
+      if (pEncryption != NULL && pEncryption->algo == kContentEncAlgoAes &&
+          pEncryption->aes_settings.cipher_mode == ContentEncoding::kCTR) {
+        return pEncryption;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+unsigned long ReadBigEndian32(const unsigned char* p) {
+  return (static_cast<unsigned long>(p[0]) << 24) |
+         (static_cast<unsigned long>(p[1]) << 16) |
+         (static_cast<unsigned long>(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+FrameDecryptor::FrameDecryptor(const Segment* pSegment)
+    : m_pSegment(pSegment),
+      m_keys(NULL),
+      m_key_count(0),
+      m_ranges(NULL),
+      m_range_keys(NULL),
+      m_range_count(0),
+      m_range_capacity(0),
+      m_counters(NULL),
+      m_plain(NULL),
+      m_counter_capacity(0),
+      m_frames(0),
+      m_decrypted(0) {}
+
+FrameDecryptor::~FrameDecryptor() {
+  for (long i = 0; i < m_key_count; ++i) {
+    delete[] m_keys[i]->id;
+    delete m_keys[i];
+  }
+
+  delete[] m_keys;
+  delete[] m_ranges;
+  delete[] m_range_keys;
+  delete[] m_counters;
+  delete[] m_plain;
+}
+
+long FrameDecryptor::AddKey(const unsigned char* key_id, long long key_id_len,
+                            const unsigned char* key, long key_len) {
+  if (key_id == NULL || key_id_len <= 0 || key == NULL)
+    return -1;
+
+  for (long i = 0; i < m_key_count; ++i) {
+    const Key* const pKey = m_keys[i];
+
+    if (pKey->id_len == key_id_len &&
+        memcmp(pKey->id, key_id, static_cast<size_t>(key_id_len)) == 0) {
+      return -1;
+    }
+  }
+
+  Key* const pKey = new (std::nothrow) Key;
+
+  if (pKey == NULL)
+    return -1;
+
+  pKey->id = new (std::nothrow) unsigned char[key_id_len];
+  pKey->id_len = key_id_len;
+
+  if (pKey->id == NULL ||
+      !pKey->aes.Init(key, static_cast<size_t>(key_len < 0 ? 0 : key_len))) {
+    delete[] pKey->id;
+    delete pKey;
+    return -1;
+  }
+
+  memcpy(pKey->id, key_id, static_cast<size_t>(key_id_len));
+
+  Key** const keys = new (std::nothrow) Key*[m_key_count + 1];
+
+  if (keys == NULL) {
+    delete[] pKey->id;
+    delete pKey;
+    return -1;
+  }
+
+  for (long i = 0; i < m_key_count; ++i)
+    keys[i] = m_keys[i];
+
+  keys[m_key_count++] = pKey;
+
+  delete[] m_keys;
+  m_keys = keys;
+
+  return 0;
+}
+
+bool FrameDecryptor::IsEncrypted(const Track* pTrack) {
+  return GetAesEncryption(pTrack) != NULL;
+}
+
+long FrameDecryptor::FindKey(const Track* pTrack, long& key) const {
+  const ContentEncoding::ContentEncryption* const pEncryption =
+      GetAesEncryption(pTrack);
+
+  key = -1;
+
+  if (pEncryption == NULL)
+    return 0;  // not encrypted
+
+  for (long i = 0; i < m_key_count; ++i) {
+    const Key* const pKey = m_keys[i];
+
+    if (pKey->id_len == pEncryption->key_id_len &&
+        memcmp(pKey->id, pEncryption->key_id,
+               static_cast<size_t>(pKey->id_len)) == 0) {
+      key = i;
+      return 0;
+    }
+  }
+
+  return E_PARSE_FAILED;  // no key
+}
+
+long FrameDecryptor::DecryptFrame(const Track* pTrack, unsigned char* buf,
+                                  long len, long& offset, long& size) {
+  offset = 0;
+  size = len;
+
+  if (buf == NULL || len < 0)
+    return E_PARSE_FAILED;
+
+  long key;
+  long status = FindKey(pTrack, key);
+
+  if (status < 0 || key < 0)  // no key, or not encrypted
+    return status;
+
+  unsigned char counter[libwebm::AesCtr::kBlockSize];
+
+  m_range_count = 0;
+
+  status = QueueFrame(key, buf, len, counter, offset, size);
+
+  if (status < 0)
+    return status;
+
+  ApplyRanges();
+  ++m_frames;
+
+  return 0;
+}
+
+long FrameDecryptor::DecryptFrames(unsigned char* buf,
+                                   Cluster::FrameDescriptor* frames,
+                                   long frame_count) {
+  if (frame_count <= 0)
+    return 0;
+
+  if (m_pSegment == NULL || buf == NULL || frames == NULL)
+    return E_PARSE_FAILED;
+
+  const Tracks* const pTracks = m_pSegment->GetTracks();
+
+  if (pTracks == NULL)
+    return E_PARSE_FAILED;
+
+  if (!ReserveCounters(frame_count))
+    return -1;
+
+  m_range_count = 0;
+
+  // Consecutive frames usually belong to the same few tracks.
+  const Track* pTrack = NULL;
+  long key = -1;
+  long status = 0;
+
+  // All frames are parsed before any descriptor or byte of |buf| changes, so
+  // that an error leaves both as they were.
+  for (long i = 0; i < frame_count; ++i) {
+    const Cluster::FrameDescriptor& d = frames[i];
+    const Block* const pBlock = d.entry->GetBlock();
+    long* const plain = m_plain + 2 * i;
+    plain[0] = -1;
+
+    if (pTrack == NULL || pTrack->GetNumber() != pBlock->GetTrackNumber()) {
+      pTrack = pTracks->GetTrackByNumber(pBlock->GetTrackNumber());
+      status = FindKey(pTrack, key);
+    }
+
+    if (status < 0)  // no key
+      return status;
+
+    if (key < 0)  // not encrypted
+      continue;
+
+    status = QueueFrame(key, buf + d.offset, d.len,
+                        m_counters + i * libwebm::AesCtr::kBlockSize, plain[0],
+                        plain[1]);
+
+    if (status < 0)
+      return status;
+  }
+
+  for (long i = 0; i < frame_count; ++i) {
+    const long* const plain = m_plain + 2 * i;
+
+    if (plain[0] < 0)  // not encrypted
+      continue;
+
+    Cluster::FrameDescriptor& d = frames[i];
+    d.offset += plain[0];
+    d.len = plain[1];
+    ++m_frames;
+  }
+
+  ApplyRanges();
+
+  return 0;
+}
+
+long FrameDecryptor::QueueFrame(long key, unsigned char* buf, long len,
+                                unsigned char* counter, long& offset,
+                                long& size) {
+  if (len < kSignalByteSize)
+    return E_FILE_FORMAT_INVALID;
+
+  const unsigned char signal = buf[0];
+
+  if ((signal & kEncryptedBit) == 0) {
+    offset = kSignalByteSize;
+    size = len - kSignalByteSize;
+    return 0;
+  }
+
+  long pos = kSignalByteSize;
+
+  if (len < pos + kIvSize)
+    return E_FILE_FORMAT_INVALID;
+
+  // The counter block is the IV followed by a block counter starting at 0.
+  memcpy(counter, buf + pos, kIvSize);
+  memset(counter + kIvSize, 0, libwebm::AesCtr::kBlockSize - kIvSize);
+  pos += kIvSize;
+
+  long partition_count = 0;
+  const unsigned char* partitions = NULL;
+
+  if (signal & kPartitionedBit) {
+    if (len < pos + kPartitionCountSize)
+      return E_FILE_FORMAT_INVALID;
+
+    partition_count = buf[pos];
+    pos += kPartitionCountSize;
+
+    if (partition_count == 0)
+      return E_FILE_FORMAT_INVALID;
+
+    if (len - pos < partition_count * kPartitionOffsetSize)
+      return E_FILE_FORMAT_INVALID;
+
+    partitions = buf + pos;
+    pos += partition_count * kPartitionOffsetSize;
+  }
+
+  unsigned char* const data = buf + pos;
+  const long data_len = len - pos;
+
+  if (!ReserveRanges(m_range_count + partition_count / 2 + 1))
+    return -1;
+
+  // Partition boundaries alternate between the start of a clear and of an
+  // encrypted partition; the data before the first boundary is clear.
+  unsigned long long stream_offset = 0;
+  long start = 0;
+  bool encrypted = partitions == NULL;
+
+  for (long i = 0; i <= partition_count; ++i) {
+    long stop = data_len;
+
+    if (i < partition_count) {
+      const unsigned long boundary =
+          ReadBigEndian32(partitions + i * kPartitionOffsetSize);
+
+      if (boundary < static_cast<unsigned long>(start) ||
+          boundary > static_cast<unsigned long>(data_len)) {
+        return E_FILE_FORMAT_INVALID;
+      }
+
+      stop = static_cast<long>(boundary);
+    }
+
+    if (encrypted && stop > start) {
+      libwebm::AesCtr::Range& range = m_ranges[m_range_count];
+      range.counter_block = counter;
+      range.offset = stream_offset;
+      range.data = data + start;
+      range.size = static_cast<size_t>(stop - start);
+      m_range_keys[m_range_count++] = key;
+
+      stream_offset += stop - start;
+    }
+
+    start = stop;
+    encrypted = !encrypted;
+  }
+
+  offset = pos;
+  size = data_len;
+
+  return 0;
+}
+
+bool FrameDecryptor::ReserveRanges(long count) {
+  if (count <= m_range_capacity)
+    return true;
+
+  long capacity = (m_range_capacity <= 0) ? 64 : 2 * m_range_capacity;
+
+  while (capacity < count)
+    capacity *= 2;
+
+  // The second half of |ranges| is scratch space for ApplyRanges().
+  libwebm::AesCtr::Range* const ranges =
+      new (std::nothrow) libwebm::AesCtr::Range[2 * capacity];
+  long* const range_keys = new (std::nothrow) long[capacity];
+
+  if (ranges == NULL || range_keys == NULL) {
+    delete[] ranges;
+    delete[] range_keys;
+    return false;
+  }
+
+  for (long i = 0; i < m_range_count; ++i) {
+    ranges[i] = m_ranges[i];
+    range_keys[i] = m_range_keys[i];
+  }
+
+  delete[] m_ranges;
+  delete[] m_range_keys;
+
+  m_ranges = ranges;
+  m_range_keys = range_keys;
+  m_range_capacity = capacity;
+
+  return true;
+}
+
+bool FrameDecryptor::ReserveCounters(long count) {
+  if (count <= m_counter_capacity)
+    return true;
+
+  unsigned char* const counters = new (std::nothrow)
+      unsigned char[count * libwebm::AesCtr::kBlockSize];
+  long* const plain = new (std::nothrow) long[2 * count];
+
+  if (counters == NULL || plain == NULL) {
+    delete[] counters;
+    delete[] plain;
+    return false;
+  }
+
+  delete[] m_counters;
+  delete[] m_plain;
+  m_counters = counters;
+  m_plain = plain;
+  m_counter_capacity = count;
+
+  return true;
+}
+
+void FrameDecryptor::ApplyRanges() {
+  // Ranges are applied per key, so that all the ranges sharing a key go
+  // through the cipher together.
+  libwebm::AesCtr::Range* const scratch = m_ranges + m_range_capacity;
+
+  for (long key = 0; key < m_key_count && m_range_count > 0; ++key) {
+    long count = 0;
+    long remaining = 0;
+
+    for (long i = 0; i < m_range_count; ++i) {
+      if (m_range_keys[i] == key) {
+        m_decrypted += static_cast<long long>(m_ranges[i].size);
+        scratch[count++] = m_ranges[i];
+      } else {
+        m_ranges[remaining] = m_ranges[i];
+        m_range_keys[remaining++] = m_range_keys[i];
+      }
+    }
+
+    if (count > 0)
+      m_keys[key]->aes.Apply(scratch, static_cast<size_t>(count));
+
+    m_range_count = remaining;
+  }
+
+  m_range_count = 0;
+}
+
+}  // namespace mkvparser
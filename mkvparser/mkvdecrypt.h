@@ -0,0 +1,114 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef MKVPARSER_MKVDECRYPT_H_
+#define MKVPARSER_MKVDECRYPT_H_
+
+#include "common/aes_ctr.h"
+#include "mkvparser/mkvparser.h"
+
+namespace mkvparser {
+
+// Decrypts the frames of tracks protected with WebM encryption: a
+// ContentEncryption element with AES (ContentEncAlgo 5) in CTR mode.
+//
+// Each frame of such a track starts with a signal byte. When its encryption
+// bit (0x01) is clear the rest of the frame is plain. Otherwise an 8 byte IV
+// follows, and when the partition bit (0x02) is set as well, a partition
+// count and that many 32-bit big-endian partition offsets. The offsets split
+// the data into alternately clear and encrypted partitions, starting with a
+// clear one; the encrypted partitions form one continuous key stream.
+// Without partitions all the data is encrypted.
+//
+// DecryptFrames() works on the buffer filled by Cluster::ReadFrames(), so a
+// whole cluster can be read with one call and decrypted with one batched
+// AES-CTR pass, using AES-NI where available.
+class FrameDecryptor {
+  FrameDecryptor(const FrameDecryptor&);
+  FrameDecryptor& operator=(const FrameDecryptor&);
+
+ public:
+  explicit FrameDecryptor(const Segment* pSegment);
+  ~FrameDecryptor();
+
+  // Registers the content key |key| (16, 24 or 32 bytes) for the
+  // ContentEncKeyID |key_id|. Returns 0 on success, or -1 when the key size
+  // is invalid, the key ID is already registered or memory is exhausted.
+  long AddKey(const unsigned char* key_id, long long key_id_len,
+              const unsigned char* key, long key_len);
+
+  // Returns true when the frames of |pTrack| carry the encryption header,
+  // i.e. the track has an AES-CTR ContentEncryption.
+  static bool IsEncrypted(const Track* pTrack);
+
+  // Decrypts, in place, the |len| bytes of a frame of |pTrack| at |buf|.
+  // On success |offset| and |size| locate the plain frame within |buf|;
+  // frames of unencrypted tracks are returned unchanged. Returns 0 on
+  // success, E_FILE_FORMAT_INVALID when the encryption header is malformed,
+  // or E_PARSE_FAILED when no key was registered for the track.
+  long DecryptFrame(const Track* pTrack, unsigned char* buf, long len,
+                    long& offset, long& size);
+
+  // Decrypts, in place, the |frame_count| frames that Cluster::ReadFrames()
+  // read into |buf| and described with |frames|. The descriptors of frames
+  // of encrypted tracks are updated to locate the plain frames. Return
+  // values are as for DecryptFrame(); on error neither |buf| nor |frames|
+  // is modified.
+  long DecryptFrames(unsigned char* buf, Cluster::FrameDescriptor* frames,
+                     long frame_count);
+
+  // Frames decrypted, and bytes passed through the cipher, over all calls.
+  long long GetFrameCount() const { return m_frames; }
+  long long GetDecryptedSize() const { return m_decrypted; }
+
+ private:
+  struct Key {
+    unsigned char* id;
+    long long id_len;
+    libwebm::AesCtr aes;
+  };
+
+  // Sets |key| to the key index for |pTrack|, or to -1 when the track is not
+  // encrypted. Returns 0, or E_PARSE_FAILED when the key is unknown.
+  long FindKey(const Track* pTrack, long& key) const;
+
+  // Parses the encryption header of a frame, sets the plain frame location,
+  // and queues the encrypted ranges, keyed with |key|, with the counter
+  // block at |counter|.
+  long QueueFrame(long key, unsigned char* buf, long len,
+                  unsigned char* counter, long& offset, long& size);
+
+  bool ReserveRanges(long count);
+
+  // Reserves |m_counters| and |m_plain| for |count| frames.
+  bool ReserveCounters(long count);
+  void ApplyRanges();
+
+  const Segment* const m_pSegment;
+
+  Key** m_keys;
+  long m_key_count;
+
+  // Queued ranges, and the key of each.
+  libwebm::AesCtr::Range* m_ranges;
+  long* m_range_keys;
+  long m_range_count;
+  long m_range_capacity;
+
+  // Counter blocks of the frames being decrypted, and the offset and size
+  // of each plain frame, with an offset of -1 when it is not encrypted.
+  unsigned char* m_counters;
+  long* m_plain;
+  long m_counter_capacity;
+
+  long long m_frames;
+  long long m_decrypted;
+};
+
+}  // namespace mkvparser
+
+#endif  // MKVPARSER_MKVDECRYPT_H_
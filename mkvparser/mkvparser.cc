@@ -20,6 +20,7 @@
 #include <memory>
 #include <new>
 
+#include "common/trace.h"
 #include "common/webmids.h"
 
 namespace mkvparser {
@@ -675,7 +676,10 @@ Segment::Segment(IMkvReader* pReader, long long elem_start,
       m_clusters(NULL),
       m_clusterCount(0),
       m_clusterPreloadCount(0),
-      m_clusterSize(0) {}
+      m_clusterSize(0),
+      m_lazy_frame_parsing(false),
+      m_track_subscription(BlockIterator::kAllTracks),
+      m_frozen(false) {}
 
 Segment::~Segment() {
   const long count = m_clusterCount + m_clusterPreloadCount;
@@ -816,6 +820,8 @@ long long Segment::CreateInstance(IMkvReader* pReader, long long pos,
 }
 
 long long Segment::ParseHeaders() {
+  LIBWEBM_TRACE_SCOPE("mkvparser", "Segment::ParseHeaders");
+
   // Outermost (level 0) segment object has been constructed,
   // and pos designates start of payload.  We need to find the
   // inner (level 1) elements.
@@ -1022,6 +1028,12 @@ long long Segment::ParseHeaders() {
 }
 
 long Segment::LoadCluster(long long& pos, long& len) {
+  if (m_frozen)
+    return 1;  // all clusters are already loaded
+
+  LIBWEBM_TRACE_SCOPE_ARG("mkvparser", "Segment::LoadCluster", "position",
+                          m_pos);
+
   for (;;) {
     const long result = DoLoadCluster(pos, len);
 
@@ -1449,6 +1461,8 @@ long Segment::Load() {
   if (m_clusters != NULL || m_clusterSize != 0 || m_clusterCount != 0)
     return E_PARSE_FAILED;
 
+  LIBWEBM_TRACE_SCOPE("mkvparser", "Segment::Load");
+
   // Outermost (level 0) segment object has been constructed,
   // and pos designates start of payload.  We need to find the
   // inner (level 1) elements.
@@ -1628,6 +1642,8 @@ long Segment::ParseCues(long long off, long long& pos, long& len) {
   if (m_pCues)
     return 0;  // success
 
+  LIBWEBM_TRACE_SCOPE("mkvparser", "Segment::ParseCues");
+
   if (off < 0)
     return -1;
 
@@ -1867,6 +1883,8 @@ bool Cues::Init() const {
   if (m_cue_points)
     return true;
 
+  LIBWEBM_TRACE_SCOPE("mkvparser", "Cues::Init");
+
   if (m_count != 0 || m_preload_count != 0)
     return false;
 
@@ -1948,6 +1966,8 @@ bool Cues::LoadCuePoint() const {
   if (m_pos >= stop)
     return false;  // nothing else to do
 
+  LIBWEBM_TRACE_SCOPE("mkvparser", "Cues::LoadCuePoint");
+
   if (!Init()) {
     m_pos = stop;
     return false;
@@ -2178,6 +2198,9 @@ const BlockEntry* Segment::GetBlock(const CuePoint& cp,
   assert(i == j);
   // assert(Cluster::HasBlockEntries(this, tp.m_pos));
 
+  if (m_frozen)  // not a cluster of this segment
+    return NULL;
+
   Cluster* const pCluster = Cluster::Create(this, -1, tp.m_pos);  //, -1);
   if (pCluster == NULL)
     return NULL;
@@ -2237,6 +2260,9 @@ const Cluster* Segment::FindOrPreloadCluster(long long requested_pos) {
   assert(i == j);
   // assert(Cluster::HasBlockEntries(this, tp.m_pos));
 
+  if (m_frozen)  // not a cluster of this segment
+    return NULL;
+
   Cluster* const pCluster = Cluster::Create(this, -1, requested_pos);
   if (pCluster == NULL)
     return NULL;
@@ -3216,6 +3242,141 @@ const Cluster* Segment::FindCluster(long long time_ns) const {
   return pCluster;
 }
 
+bool Segment::IsTrackSubscribed(long long track_number) const {
+  if (m_track_subscription == BlockIterator::kAllTracks)
+    return true;
+
+  const unsigned long long bit = BlockIterator::GetTrackBit(track_number);
+  return (m_track_subscription & bit) != 0;
+}
+
+long Segment::Freeze() {
+  if (m_frozen)
+    return 0;
+
+  long status;
+
+  if (m_clusters == NULL && m_clusterSize == 0 && m_clusterCount == 0) {
+    status = Load();
+
+    if (status < 0)
+      return status;
+  } else {
+    for (;;) {
+      status = LoadCluster();
+
+      if (status < 0)  // error or underflow
+        return status;
+
+      if (status > 0)  // no more clusters
+        break;
+    }
+  }
+
+  const long count = m_clusterCount + m_clusterPreloadCount;
+
+  for (long i = 0; i < count; ++i) {
+    const Cluster* const pCluster = m_clusters[i];
+    assert(pCluster);
+
+    status = pCluster->BuildKeyEntries();  // parses all entries
+
+    if (status < 0)
+      return status;
+
+    for (long j = 0; j < pCluster->m_entries_count; ++j) {
+      const Block* const pBlock = pCluster->m_entries[j]->GetBlock();
+      assert(pBlock);
+
+      pBlock->GetFrameCount();  // decodes a lazily parsed lace table
+    }
+  }
+
+  if (m_pCues) {
+    while (m_pCues->LoadCuePoint()) {
+    }
+
+    // LoadCuePoint() can stop early on malformed Cues. Mark them as fully
+    // parsed so that later lookups never resume parsing a shared segment.
+    if (!m_pCues->DoneParsing())
+      m_pCues->m_pos = m_pCues->m_start + m_pCues->m_size;
+  }
+
+  m_frozen = true;
+  return 0;
+}
+
+long Segment::Resync(long long pos) {
+  if (m_frozen)
+    return E_PARSE_FAILED;
+
+  const long long segment_stop = (m_size < 0) ? -1 : m_start + m_size;
+
+  if (pos < m_start || (segment_stop >= 0 && pos >= segment_stop))
+    return E_FILE_FORMAT_INVALID;
+
+  long len;
+  if (ReadID(m_pReader, pos, len) != libwebm::kMkvCluster)
+    return E_FILE_FORMAT_INVALID;
+
+  if (m_clusterCount > 0) {
+    Cluster* const pLast = m_clusters[m_clusterCount - 1];
+    assert(pLast);
+
+    const long long start = pLast->m_element_start;
+
+    if (pos <= start || pLast->m_pos > pos)
+      return E_FILE_FORMAT_INVALID;
+
+    long long parse_pos;
+    long parse_len;
+    long status = pLast->Load(parse_pos, parse_len);
+
+    if (status < 0) {
+      // Not even the cluster header survived.
+      delete pLast;
+
+      const long count = m_clusterCount + m_clusterPreloadCount;
+
+      for (long i = m_clusterCount; i < count; ++i)
+        m_clusters[i - 1] = m_clusters[i];
+
+      --m_clusterCount;
+    } else {
+      // Parse what is left of the cluster, but not beyond |pos|, and end it
+      // after the last entry parsed successfully.
+      if (pLast->m_element_size < 0 || start + pLast->m_element_size > pos)
+        pLast->m_element_size = pos - start;
+
+      do {
+        status = pLast->Parse(parse_pos, parse_len);
+      } while (status == 0);
+
+      if (status < 0)
+        pLast->m_element_size = pLast->m_pos - start;
+    }
+  }
+
+  // Preloaded clusters are sorted by position and follow the loaded ones.
+  long count = m_clusterCount + m_clusterPreloadCount;
+
+  while (m_clusterPreloadCount > 0 &&
+         m_clusters[m_clusterCount]->m_element_start < pos) {
+    delete m_clusters[m_clusterCount];
+
+    for (long i = m_clusterCount + 1; i < count; ++i)
+      m_clusters[i - 1] = m_clusters[i];
+
+    --m_clusterPreloadCount;
+    --count;
+  }
+
+  m_pUnknownSize = NULL;
+  m_pos = pos;
+
+  return 0;
+}
+
 const Tracks* Segment::GetTracks() const { return m_pTracks; }
 const SegmentInfo* Segment::GetInfo() const { return m_pInfo; }
 const Cues* Segment::GetCues() const { return m_pCues; }
@@ -3228,6 +3389,286 @@ long long Segment::GetDuration() const {
   return m_pInfo->GetDuration();
 }
 
+const unsigned long long BlockIterator::kAllTracks;
+
+BlockIterator::BlockIterator(Segment* pSegment)
+    : m_pSegment(pSegment),
+      m_track_mask(kAllTracks),
+      m_pCluster(NULL),
+      m_pPrevCluster(NULL),
+      m_pCurr(NULL) {}
+
+unsigned long long BlockIterator::GetTrackBit(long long track_number) {
+  if (track_number <= 0 || track_number > 64)
+    return 0;
+
+  return 1ULL << (track_number - 1);
+}
+
+bool BlockIterator::IsTrackSelected(long long track_number) const {
+  if (m_track_mask == kAllTracks)
+    return true;
+
+  return (m_track_mask & GetTrackBit(track_number)) != 0;
+}
+
+void BlockIterator::Reset() {
+  m_pCluster = NULL;
+  m_pPrevCluster = NULL;
+  m_pCurr = NULL;
+}
+
+long BlockIterator::Next(const BlockEntry*& pEntry) {
+  pEntry = NULL;
+
+  if (m_pSegment == NULL)
+    return -1;
+
+  for (;;) {
+    const BlockEntry* pNext;
+    long status;
+
+    if (m_pCluster == NULL) {
+      const Cluster* const pCluster = (m_pPrevCluster == NULL)
+                                          ? m_pSegment->GetFirst()
+                                          : m_pSegment->GetNext(m_pPrevCluster);
+
+      if (pCluster == NULL)
+        return 1;
+
+      if (pCluster->EOS()) {
+        if (m_pSegment->DoneParsing())
+          return 1;
+
+        return E_BUFFER_NOT_FULL;
+      }
+
+      status = pCluster->GetFirst(pNext);
+
+      if (status < 0)  // error
+        return status;
+
+      m_pCluster = pCluster;
+    } else {
+      assert(m_pCurr);
+
+      status = m_pCluster->GetNext(m_pCurr, pNext);
+
+      if (status < 0)  // error
+        return status;
+    }
+
+    if (pNext == NULL) {  // done with this cluster
+      m_pPrevCluster = m_pCluster;
+      m_pCluster = NULL;
+      m_pCurr = NULL;
+      continue;
+    }
+
+    m_pCurr = pNext;
+
+    const Block* const pBlock = pNext->GetBlock();
+    assert(pBlock);
+
+    if (IsTrackSelected(pBlock->GetTrackNumber())) {
+      pEntry = pNext;
+      return 0;
+    }
+  }
+}
+
+KeyframeIterator::KeyframeIterator(Segment* pSegment, const Track* pTrack)
+    : m_pSegment(pSegment),
+      m_pTrack(pTrack),
+      m_initialized(false),
+      m_use_cues(false),
+      m_pCuePoint(NULL),
+      m_pCluster(NULL),
+      m_pPrevCluster(NULL),
+      m_index(0) {}
+
+void KeyframeIterator::Init() {
+  m_initialized = true;
+  m_use_cues = false;
+
+  const Cues* const pCues = m_pSegment->GetCues();
+
+  if (pCues == NULL)
+    return;
+
+  while (pCues->LoadCuePoint()) {
+  }
+
+  for (const CuePoint* pCP = pCues->GetFirst(); pCP != NULL;
+       pCP = pCues->GetNext(pCP)) {
+    if (pCP->Find(m_pTrack) != NULL) {
+      m_use_cues = true;
+      return;
+    }
+  }
+}
+
+void KeyframeIterator::Reset() {
+  m_pCuePoint = NULL;
+  m_pCluster = NULL;
+  m_pPrevCluster = NULL;
+  m_index = 0;
+}
+
+long KeyframeIterator::Next(const BlockEntry*& pEntry) {
+  pEntry = NULL;
+
+  if (m_pSegment == NULL || m_pTrack == NULL)
+    return -1;
+
+  if (!m_initialized)
+    Init();
+
+  if (m_use_cues)
+    return NextFromCues(pEntry);
+
+  return NextFromClusters(pEntry);
+}
+
+long KeyframeIterator::NextFromCues(const BlockEntry*& pEntry) {
+  const Cues* const pCues = m_pSegment->GetCues();
+  assert(pCues);
+
+  for (;;) {
+    m_pCuePoint = (m_pCuePoint == NULL) ? pCues->GetFirst()
+                                        : pCues->GetNext(m_pCuePoint);
+
+    if (m_pCuePoint == NULL)
+      return 1;
+
+    const CuePoint::TrackPosition* const pTP = m_pCuePoint->Find(m_pTrack);
+
+    if (pTP == NULL)
+      continue;
+
+    const BlockEntry* const pBlockEntry = pCues->GetBlock(m_pCuePoint, pTP);
+
+    if (pBlockEntry == NULL || pBlockEntry->EOS())  // stale cue point
+      continue;
+
+    pEntry = pBlockEntry;
+    return 0;
+  }
+}
+
+long KeyframeIterator::NextFromClusters(const BlockEntry*& pEntry) {
+  const long long track_number = m_pTrack->GetNumber();
+
+  for (;;) {
+    if (m_pCluster == NULL) {
+      const Cluster* const pCluster = (m_pPrevCluster == NULL)
+                                          ? m_pSegment->GetFirst()
+                                          : m_pSegment->GetNext(m_pPrevCluster);
+
+      if (pCluster == NULL)
+        return 1;
+
+      if (pCluster->EOS()) {
+        if (m_pSegment->DoneParsing())
+          return 1;
+
+        return E_BUFFER_NOT_FULL;
+      }
+
+      m_pCluster = pCluster;
+      m_index = 0;
+    }
+
+    const long status =
+        m_pCluster->GetNextKeyEntry(track_number, m_index, pEntry);
+
+    if (status < 0)  // error
+      return status;
+
+    if (pEntry == NULL) {  // done with this cluster
+      m_pPrevCluster = m_pCluster;
+      m_pCluster = NULL;
+      continue;
+    }
+
+    m_index = pEntry->GetIndex() + 1;
+    return 0;
+  }
+}
+
+long KeyframeIterator::Seek(long long time_ns, const BlockEntry*& pEntry) {
+  pEntry = NULL;
+
+  if (m_pSegment == NULL || m_pTrack == NULL)
+    return -1;
+
+  if (!m_initialized)
+    Init();
+
+  Reset();
+
+  if (m_use_cues) {
+    const Cues* const pCues = m_pSegment->GetCues();
+    assert(pCues);
+
+    const CuePoint* pCP;
+    const CuePoint::TrackPosition* pTP;
+
+    if (!pCues->Find(time_ns, m_pTrack, pCP, pTP))
+      return NextFromCues(pEntry);  // before the first cue point
+
+    m_pCuePoint = pCP;
+
+    const BlockEntry* const pBlockEntry = pCues->GetBlock(pCP, pTP);
+
+    if (pBlockEntry == NULL || pBlockEntry->EOS())
+      return NextFromCues(pEntry);
+
+    pEntry = pBlockEntry;
+    return 0;
+  }
+
+  const BlockEntry* pResult;
+
+  const long status = m_pTrack->Seek(time_ns, pResult);
+
+  if (status < 0)
+    return status;
+
+  if (pResult == NULL || pResult->EOS())
+    return 1;
+
+  // Track::Seek() finds the right cluster, but for non-video tracks it
+  // returns that cluster's first block. Refine using the keyframe bitmap.
+  m_pCluster = pResult->GetCluster();
+  m_index = pResult->GetIndex();
+
+  const long long track_number = m_pTrack->GetNumber();
+  const BlockEntry* pBest = NULL;
+
+  for (;;) {
+    const BlockEntry* pKey;
+
+    const long status =
+        m_pCluster->GetNextKeyEntry(track_number, m_index, pKey);
+
+    if (status < 0)  // error
+      return status;
+
+    if (pKey == NULL || pKey->GetBlock()->GetTime(m_pCluster) > time_ns)
+      break;
+
+    pBest = pKey;
+    m_index = pKey->GetIndex() + 1;
+  }
+
+  if (pBest == NULL)  // |time_ns| precedes the first keyframe
+    return NextFromClusters(pEntry);
+
+  pEntry = pBest;
+  return 0;
+}
+
 Chapters::Chapters(Segment* pSegment, long long payload_start,
                    long long payload_size, long long element_start,
                    long long element_size)
@@ -6059,6 +6500,9 @@ long Cluster::Load(long long& pos, long& len) const {
   if (m_pos != m_element_start || m_element_size >= 0)
     return E_PARSE_FAILED;
 
+  LIBWEBM_TRACE_SCOPE_ARG("mkvparser", "Cluster::Load", "position",
+                          m_element_start);
+
   IMkvReader* const pReader = m_pSegment->m_pReader;
   long long total, avail;
   const int status = pReader->Length(&total, &avail);
@@ -6268,6 +6712,10 @@ long Cluster::Load(long long& pos, long& len) const {
   m_pos = new_pos;  // designates position just beyond timecode payload
   m_timecode = timecode;  // m_timecode >= 0 means we're partially loaded
 
+  // The Cluster span lasts until Parse() reaches the end of the cluster.
+  LIBWEBM_TRACE_ASYNC_BEGIN("mkvparser", "Cluster", m_pSegment,
+                            m_element_start);
+
   if (cluster_size >= 0)
     m_element_size = cluster_stop - m_element_start;
 
@@ -6289,6 +6737,9 @@ long Cluster::Parse(long long& pos, long& len) const {
   if ((cluster_stop >= 0) && (m_pos >= cluster_stop))
     return 1;  // nothing else to do
 
+  LIBWEBM_TRACE_SCOPE_ARG("mkvparser", "Cluster::Parse", "position",
+                          m_element_start);
+
   IMkvReader* const pReader = m_pSegment->m_pReader;
 
   long long total, avail;
@@ -6417,11 +6868,24 @@ long Cluster::Parse(long long& pos, long& len) const {
 
     Cluster* const this_ = const_cast<Cluster*>(this);
 
-    if (id == libwebm::kMkvBlockGroup)
-      return this_->ParseBlockGroup(size, pos, len);
+    if (id == libwebm::kMkvBlockGroup || id == libwebm::kMkvSimpleBlock) {
+      status = (id == libwebm::kMkvBlockGroup)
+                   ? this_->ParseBlockGroup(size, pos, len)
+                   : this_->ParseSimpleBlock(size, pos, len);
 
-    if (id == libwebm::kMkvSimpleBlock)
-      return this_->ParseSimpleBlock(size, pos, len);
+      if (status != 1) {
+        if (status == 0 && cluster_stop >= 0 && m_pos >= cluster_stop)
+          LIBWEBM_TRACE_ASYNC_END("mkvparser", "Cluster", m_pSegment,
+                                  m_element_start);
+        return status;
+      }
+
+      // The block belongs to a track the segment is not subscribed to; it
+      // has been consumed without creating an entry.
+      assert(m_pos == block_stop);
+      pos = m_pos;
+      continue;
+    }
 
     pos += size;  // consume payload
     if (cluster_stop >= 0 && pos > cluster_stop)
@@ -6461,6 +6925,8 @@ long Cluster::Parse(long long& pos, long& len) const {
       return E_PARSE_FAILED;  // defend against trucated stream
   }
 
+  LIBWEBM_TRACE_ASYNC_END("mkvparser", "Cluster", m_pSegment,
+                          m_element_start);
   return 1;  // no more entries
 }
 
@@ -6509,6 +6975,11 @@ long Cluster::ParseSimpleBlock(long long block_size, long long& pos,
   if (track == 0)
     return E_FILE_FORMAT_INVALID;
 
+  if (!m_pSegment->IsTrackSubscribed(track)) {
+    m_pos = block_stop;
+    return 1;  // skipped
+  }
+
   pos += len;  // consume track number
 
   if ((pos + 2) > block_stop)
@@ -6587,6 +7058,7 @@ long Cluster::ParseBlockGroup(long long payload_size, long long& pos,
   }
 
   long long discard_padding = 0;
+  long long block_track = 0;
 
   while (pos < payload_stop) {
     // parse sub-block element ID
@@ -6711,6 +7183,9 @@ long Cluster::ParseBlockGroup(long long payload_size, long long& pos,
     if (track == 0)
       return E_FILE_FORMAT_INVALID;
 
+    if (block_track == 0)
+      block_track = track;
+
     pos += len;  // consume track number
 
     if ((pos + 2) > block_stop)
@@ -6761,6 +7236,11 @@ long Cluster::ParseBlockGroup(long long payload_size, long long& pos,
   if (pos != payload_stop)
     return E_FILE_FORMAT_INVALID;
 
+  if (block_track > 0 && !m_pSegment->IsTrackSubscribed(block_track)) {
+    m_pos = payload_stop;
+    return 1;  // skipped
+  }
+
   status = CreateBlock(libwebm::kMkvBlockGroup, payload_start, payload_size,
                        discard_padding);
   if (status != 0)
@@ -6804,6 +7284,194 @@ long Cluster::GetEntry(long index, const mkvparser::BlockEntry*& pEntry) const {
   return E_BUFFER_NOT_FULL;  // underflow, since more remains to be parsed
 }
 
+long Cluster::ReadFrames(long index, long max_frames, unsigned char* buf,
+                         long buf_len, FrameDescriptor* frames,
+                         long& frame_count, long& len) const {
+  frame_count = 0;
+  len = 0;
+
+  if (m_pSegment == NULL || index < 0 || max_frames <= 0 || buf == NULL ||
+      buf_len <= 0 || frames == NULL) {
+    return -1;  // generic error
+  }
+
+  long long start = -1;  // absolute pos of the first payload
+  long long stop = -1;  // absolute pos just past the last payload
+
+  for (;;) {
+    while (index >= m_entries_count) {
+      long long pos;
+      long len;
+
+      const long status = Parse(pos, len);
+
+      if (status < 0) {
+        if (frame_count > 0)  // read what we have so far
+          break;
+
+        return status;
+      }
+
+      if (status > 0)  // no more entries
+        break;
+    }
+
+    if (index >= m_entries_count)
+      break;
+
+    const BlockEntry* const pEntry = m_entries[index];
+    assert(pEntry);
+
+    const Block* const pBlock = pEntry->GetBlock();
+    assert(pBlock);
+
+    const int count = pBlock->GetFrameCount();
+
+    if (count <= 0)
+      return E_FILE_FORMAT_INVALID;
+
+    const Block::Frame& first = pBlock->GetFrame(0);
+    const Block::Frame& last = pBlock->GetFrame(count - 1);
+
+    const long long block_start = (start < 0) ? first.pos : start;
+    const long long block_stop = last.pos + last.len;
+
+    if (frame_count + count > max_frames || first.pos < block_start ||
+        (block_stop - block_start) > buf_len) {
+      if (frame_count > 0)  // read what we have so far
+        break;
+
+      // The first entry alone does not fit: report what it needs.
+      const long long needed = block_stop - block_start;
+
+      if (needed > LONG_MAX)
+        return E_FILE_FORMAT_INVALID;
+
+      frame_count = count;
+      len = static_cast<long>(needed);
+      return E_BUFFER_NOT_FULL;
+    }
+
+    for (int i = 0; i < count; ++i) {
+      const Block::Frame& f = pBlock->GetFrame(i);
+
+      FrameDescriptor& d = frames[frame_count++];
+      d.entry = pEntry;
+      d.frame_index = i;
+      d.offset = static_cast<long>(f.pos - block_start);
+      d.len = f.len;
+    }
+
+    start = block_start;
+    stop = block_stop;
+
+    ++index;
+  }
+
+  if (frame_count <= 0)
+    return 0;
+
+  IMkvReader* const pReader = m_pSegment->m_pReader;
+
+  const long status =
+      pReader->Read(start, static_cast<long>(stop - start), buf);
+
+  if (status < 0) {
+    frame_count = 0;
+    return status;
+  }
+
+  len = static_cast<long>(stop - start);
+  return 0;
+}
+
+long Cluster::BuildKeyEntries() const {
+  if (m_key_entries != NULL)
+    return 0;
+
+  for (;;) {
+    long long pos;
+    long len;
+
+    const long status = Parse(pos, len);
+
+    if (status < 0)  // error, or cluster not yet fully available
+      return status;
+
+    if (status > 0)  // no more entries
+      break;
+  }
+
+  if (m_entries_count <= 0)
+    return 0;
+
+  const long words = (m_entries_count + 63) / 64;
+
+  m_key_entries = new (std::nothrow) unsigned long long[words];
+  if (m_key_entries == NULL)
+    return -1;
+
+  for (long i = 0; i < words; ++i)
+    m_key_entries[i] = 0;
+
+  for (long i = 0; i < m_entries_count; ++i) {
+    const Block* const pBlock = m_entries[i]->GetBlock();
+    assert(pBlock);
+
+    if (pBlock->IsKey())
+      m_key_entries[i / 64] |= 1ULL << (i % 64);
+  }
+
+  return 0;
+}
+
+long Cluster::GetNextKeyEntry(long long track_number, long index,
+                              const BlockEntry*& pEntry) const {
+  pEntry = NULL;
+
+  if (m_pSegment == NULL)  // EOS cluster
+    return 0;
+
+  if (index < 0)
+    return -1;  // generic error
+
+  const long status = BuildKeyEntries();
+
+  if (status < 0)
+    return status;
+
+  if (m_key_entries == NULL)  // no entries
+    return 0;
+
+  const long words = (m_entries_count + 63) / 64;
+
+  for (long word = index / 64; word < words; ++word) {
+    unsigned long long bits = m_key_entries[word];
+
+    if (word == index / 64)  // ignore entries before |index|
+      bits &= ~0ULL << (index % 64);
+
+    while (bits != 0) {
+      long bit = 0;
+
+      while ((bits & (1ULL << bit)) == 0)
+        ++bit;
+
+      bits &= ~(1ULL << bit);
+
+      const long i = word * 64 + bit;
+      const BlockEntry* const pCandidate = m_entries[i];
+
+      if (pCandidate->GetBlock()->GetTrackNumber() == track_number) {
+        pEntry = pCandidate;
+        return 0;
+      }
+    }
+  }
+
+  return 0;  // no more keyframes of this track
+}
+
 Cluster* Cluster::Create(Segment* pSegment, long idx, long long off) {
   if (!pSegment || off < 0)
     return NULL;
@@ -6825,8 +7493,8 @@ Cluster::Cluster()
       m_timecode(0),
       m_entries(NULL),
       m_entries_size(0),
-      m_entries_count(0)  // means "no entries"
-{}
+      m_entries_count(0),  // means "no entries"
+      m_key_entries(NULL) {}
 
 Cluster::Cluster(Segment* pSegment, long idx, long long element_start
                  /* long long element_size */)
@@ -6838,10 +7506,12 @@ Cluster::Cluster(Segment* pSegment, long idx, long long element_start
       m_timecode(-1),
       m_entries(NULL),
       m_entries_size(0),
-      m_entries_count(-1)  // means "has not been parsed yet"
-{}
+      m_entries_count(-1),  // means "has not been parsed yet"
+      m_key_entries(NULL) {}
 
 Cluster::~Cluster() {
+  delete[] m_key_entries;
+
   if (m_entries_count <= 0) {
     delete[] m_entries;
     return;
@@ -7638,8 +8308,10 @@ Block::Block(long long start, long long size_, long long discard_padding)
       m_track(0),
       m_timecode(-1),
       m_flags(0),
+      m_header_size(0),
       m_frames(NULL),
       m_frame_count(-1),
+      m_pLazyReader(NULL),
       m_discard_padding(discard_padding) {}
 
 Block::~Block() { delete[] m_frames; }
@@ -7703,10 +8375,26 @@ long Block::Parse(const Cluster* pCluster) {
   if (status)
     return E_FILE_FORMAT_INVALID;
 
-  const int lacing = int(m_flags & 0x06) >> 1;
-
   ++pos;  // consume flags byte
 
+  if (pCluster->m_pSegment->GetLazyFrameParsing()) {
+    // Defer the lace table until the frames are asked for.
+    m_header_size = static_cast<unsigned char>(pos - m_start);
+    m_pLazyReader = pReader;
+    return 0;
+  }
+
+  return ParseFrames(pReader, pos);
+}
+
+long Block::ParseFrames(IMkvReader* pReader, long long pos) const {
+  const long long stop = m_start + m_size;
+
+  long len;
+  long status;
+
+  const int lacing = int(m_flags & 0x06) >> 1;
+
   if (lacing == 0) {  // no lacing
     if (pos > stop)
       return E_FILE_FORMAT_INVALID;
@@ -8072,12 +8760,41 @@ Block::Lacing Block::GetLacing() const {
   return static_cast<Lacing>(value);
 }
 
-int Block::GetFrameCount() const { return m_frame_count; }
+void Block::ParseFramesLazily() const {
+  assert(m_pLazyReader);
+  assert(m_frames == NULL);
+
+  IMkvReader* const pReader = m_pLazyReader;
+  m_pLazyReader = NULL;
+
+  const long status = ParseFrames(pReader, m_start + m_header_size);
+
+  if (status != 0) {
+    delete[] m_frames;
+    m_frames = NULL;
+    m_frame_count = 0;
+  }
+}
+
+int Block::GetFrameCount() const {
+  if (m_pLazyReader)
+    ParseFramesLazily();
+
+  return m_frame_count;
+}
 
 const Block::Frame& Block::GetFrame(int idx) const {
+  if (m_pLazyReader)
+    ParseFramesLazily();
+
   assert(idx >= 0);
   assert(idx < m_frame_count);
 
+  if (m_frames == NULL) {  // lace table was invalid
+    static const Frame empty_frame = {0, 0};
+    return empty_frame;
+  }
+
   const Frame& f = m_frames[idx];
   assert(f.pos > 0);
   assert(f.len > 0);
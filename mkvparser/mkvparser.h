@@ -91,12 +91,18 @@ class Block {
   enum Lacing { kLacingNone, kLacingXiph, kLacingFixed, kLacingEbml };
   Lacing GetLacing() const;
 
+  // Returns the number of frames in the block. When the block was parsed with
+  // lazy frame parsing enabled (see Segment::SetLazyFrameParsing()) the lace
+  // table is decoded on the first call, and 0 is returned when it is invalid.
   int GetFrameCount() const;  // to index frames: [0, count)
 
   struct Frame {
     long long pos;  // absolute offset
     long len;
 
+    // Reads the |len| bytes of the frame as stored. Frames of tracks with a
+    // ContentCompression are returned compressed; use FrameDecompressor
+    // (mkvdecompress.h) to read them decompressed.
     long Read(IMkvReader*, unsigned char*) const;
   };
 
@@ -105,12 +111,19 @@ class Block {
   long long GetDiscardPadding() const;
 
  private:
+  long ParseFrames(IMkvReader*, long long pos) const;
+  void ParseFramesLazily() const;
+
   long long m_track;  // Track::Number()
   short m_timecode;  // relative to cluster
   unsigned char m_flags;
+  unsigned char m_header_size;  // track number, timecode and flags
+
+  mutable Frame* m_frames;
+  mutable int m_frame_count;
 
-  Frame* m_frames;
-  int m_frame_count;
+  // Non-NULL while the lace table has not been decoded yet.
+  mutable IMkvReader* m_pLazyReader;
 
  protected:
   const long long m_discard_padding;
@@ -1013,6 +1026,40 @@ class Cluster {
   long Parse(long long& pos, long& size) const;
   long GetEntry(long index, const mkvparser::BlockEntry*&) const;
 
+  struct FrameDescriptor {
+    const BlockEntry* entry;  // block the frame belongs to
+    int frame_index;  // index of the frame within the block
+    long offset;  // of the payload, relative to the start of the read buffer
+    long len;
+  };
+
+  // Reads the payloads of the frames of consecutive block entries, starting
+  // with the entry at |index|, into |buf| using a single IMkvReader::Read()
+  // call covering all of them. Whole blocks are taken until |max_frames|
+  // frames or |buf_len| bytes would be exceeded. Bytes between payloads
+  // (block and lacing headers) are read as well, and |frames| receives one
+  // descriptor per frame locating its payload within |buf|. On success
+  // |frame_count| is set to the number of descriptors written and |len| to
+  // the number of bytes read; both are 0 when the entry at |index| does not
+  // exist. When the entry at |index| alone exceeds |max_frames| or |buf_len|,
+  // nothing is read and E_BUFFER_NOT_FULL is returned with |frame_count| and
+  // |len| set to the frames and bytes that entry needs; E_BUFFER_NOT_FULL
+  // with |frame_count| 0 means the cluster is not yet fully available.
+  // Payloads are read as stored: frames of compressed tracks are passed to
+  // FrameDecompressor::Decompress() (mkvdecompress.h) by the caller. Returns
+  // 0 on success, otherwise a negative error code.
+  long ReadFrames(long index, long max_frames, unsigned char* buf,
+                  long buf_len, FrameDescriptor* frames, long& frame_count,
+                  long& len) const;
+
+  // Sets |pEntry| to the first entry at or after |index| whose block is a
+  // keyframe of track |track_number|, or to NULL when there is none. On first
+  // use the cluster is parsed completely and a bitmap of its keyframe entries
+  // is kept, so lookups only visit key blocks. Returns 0 on success,
+  // otherwise a negative error code.
+  long GetNextKeyEntry(long long track_number, long index,
+                       const BlockEntry*& pEntry) const;
+
  protected:
   Cluster(Segment*, long index, long long element_start);
   // long long element_size);
@@ -1036,6 +1083,9 @@ class Cluster {
   mutable BlockEntry** m_entries;
   mutable long m_entries_size;
   mutable long m_entries_count;
+  mutable unsigned long long* m_key_entries;  // bitmap, one bit per entry
+
+  long BuildKeyEntries() const;
 
   long ParseSimpleBlock(long long, long long&, long&);
   long ParseBlockGroup(long long, long long&, long&);
@@ -1093,6 +1143,56 @@ class Segment {
 
   long long GetDuration() const;
 
+  // When enabled, blocks of clusters loaded afterwards only record their
+  // header fields (track, timecode, flags). Lace tables are decoded on the
+  // first call to Block::GetFrameCount() or Block::GetFrame(). Disabled by
+  // default.
+  void SetLazyFrameParsing(bool lazy) { m_lazy_frame_parsing = lazy; }
+  bool GetLazyFrameParsing() const { return m_lazy_frame_parsing; }
+
+  // Restricts the block entries created when clusters are parsed to the
+  // tracks selected by |track_mask|, using the same bit layout as
+  // BlockIterator::SetTrackMask(). Blocks of other tracks are skipped over
+  // without being stored. Applies to clusters parsed afterwards, so it should
+  // be set before loading clusters. Defaults to BlockIterator::kAllTracks.
+  void SetTrackSubscription(unsigned long long track_mask) {
+    m_track_subscription = track_mask;
+  }
+  unsigned long long GetTrackSubscription() const {
+    return m_track_subscription;
+  }
+  bool IsTrackSubscribed(long long track_number) const;
+
+  // Loads every cluster and cue point and finishes all of the lazy work that
+  // reads would otherwise do on demand: cluster entries are parsed, lace
+  // tables decoded and keyframe bitmaps built. A cue point that cannot be
+  // parsed is dropped along with the ones that follow it, and the Cues are
+  // treated as fully parsed. Afterwards the segment is frozen: LoadCluster()
+  // reports that there are no more clusters, and GetBlock() and
+  // FindOrPreloadCluster() return NULL for positions that are not among the
+  // loaded clusters rather than preloading them. A frozen segment is never
+  // modified by the const accessors, the cluster and track iteration
+  // functions or BlockIterator/KeyframeIterator, so one instance can be
+  // shared by any number of threads without locking, each thread using its
+  // own iterators. Reading frame payloads is left to the caller; the
+  // IMkvReader passed to Block::Frame::Read() (or used by
+  // Cluster::ReadFrames()) must itself be safe for concurrent use, or each
+  // thread must pass its own reader. Returns 0 on success, otherwise a
+  // negative error code, in which case the segment is not frozen.
+  long Freeze();
+  bool IsFrozen() const { return m_frozen; }
+
+  // Resumes cluster loading at |pos|, the absolute position of a Cluster
+  // element following a damaged region (see ResyncScanner). Meant to be
+  // called after LoadCluster() or Load() failed; later LoadCluster() calls
+  // continue from |pos|. The last loaded cluster keeps the entries parsed
+  // before the damage and ends there, or is discarded when not even its
+  // Timecode could be read. Preloaded clusters located before |pos| are
+  // discarded. Returns 0 on success, E_FILE_FORMAT_INVALID when |pos| does
+  // not hold a Cluster ID past the start of the last loaded cluster, and
+  // E_PARSE_FAILED for a frozen segment.
+  long Resync(long long pos);
+
   unsigned long GetCount() const;
   const Cluster* GetFirst() const;
   const Cluster* GetLast() const;
@@ -1120,6 +1220,9 @@ class Segment {
   long m_clusterCount;  // number of entries for which m_index >= 0
   long m_clusterPreloadCount;  // number of entries for which m_index < 0
   long m_clusterSize;  // array size
+  bool m_lazy_frame_parsing;
+  unsigned long long m_track_subscription;
+  bool m_frozen;
 
   long DoLoadCluster(long long&, long&);
   long DoLoadClusterUnknownSize(long long&, long&);
@@ -1135,6 +1238,87 @@ class Segment {
   const BlockEntry* GetBlock(const CuePoint&, const CuePoint::TrackPosition&);
 };
 
+// Visits the blocks of a segment once each, in file order, returning those
+// that belong to the selected tracks. Reading several tracks this way avoids
+// the repeated cluster walks of per-track Track::GetFirst()/GetNext() loops.
+class BlockIterator {
+  BlockIterator(const BlockIterator&);
+  BlockIterator& operator=(const BlockIterator&);
+
+ public:
+  static const unsigned long long kAllTracks = ~0ULL;
+
+  explicit BlockIterator(Segment*);
+
+  // Bit (n - 1) of |mask| selects track number n. Track numbers above 64 are
+  // selected only by kAllTracks, which is the default.
+  void SetTrackMask(unsigned long long mask) { m_track_mask = mask; }
+  unsigned long long GetTrackMask() const { return m_track_mask; }
+  static unsigned long long GetTrackBit(long long track_number);
+  bool IsTrackSelected(long long track_number) const;
+
+  // Advances to the next block of a selected track. Returns 0 and sets
+  // |pEntry| when one was found, 1 at the end of the segment, and
+  // E_BUFFER_NOT_FULL when the next cluster has not been loaded yet (load it
+  // with Segment::LoadCluster() and call again). Other negative values are
+  // errors.
+  long Next(const BlockEntry*& pEntry);
+
+  // Restarts iteration from the first cluster of the segment.
+  void Reset();
+
+ private:
+  Segment* const m_pSegment;
+  unsigned long long m_track_mask;
+
+  const Cluster* m_pCluster;  // cluster being visited, if any
+  const Cluster* m_pPrevCluster;  // last cluster fully visited
+  const BlockEntry* m_pCurr;  // last entry visited in m_pCluster
+};
+
+// Visits the keyframes of one track without walking every block. When the
+// segment has Cues with entries for the track, the cue points are followed
+// and only the clusters they reference are parsed, up to the cued block.
+// Otherwise clusters are visited in order and Cluster::GetNextKeyEntry() is
+// used to skip non-key blocks. Callers then read only keyframe payloads.
+class KeyframeIterator {
+  KeyframeIterator(const KeyframeIterator&);
+  KeyframeIterator& operator=(const KeyframeIterator&);
+
+ public:
+  KeyframeIterator(Segment*, const Track*);
+
+  // Advances to the next keyframe. Returns 0 and sets |pEntry| when one was
+  // found, 1 when there are no more, and E_BUFFER_NOT_FULL when the next
+  // cluster has not been loaded yet. Other negative values are errors.
+  long Next(const BlockEntry*& pEntry);
+
+  // Positions the iterator on the last keyframe at or before |time_ns| and
+  // returns it in |pEntry|, using the same return values as Next().
+  long Seek(long long time_ns, const BlockEntry*& pEntry);
+
+  void Reset();
+
+  bool UsingCues() const { return m_use_cues; }
+
+ private:
+  void Init();
+  long NextFromCues(const BlockEntry*& pEntry);
+  long NextFromClusters(const BlockEntry*& pEntry);
+
+  Segment* const m_pSegment;
+  const Track* const m_pTrack;
+
+  bool m_initialized;
+  bool m_use_cues;
+
+  const CuePoint* m_pCuePoint;  // last cue point visited
+
+  const Cluster* m_pCluster;  // cluster being visited, if any
+  const Cluster* m_pPrevCluster;  // last cluster fully visited
+  long m_index;  // next entry to examine in m_pCluster
+};
+
 }  // namespace mkvparser
 
 inline long mkvparser::Segment::LoadCluster() {
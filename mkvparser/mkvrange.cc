@@ -0,0 +1,425 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "mkvparser/mkvrange.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace mkvparser {
+
+// Start of a cluster referenced by Cues, with the earliest cue time seen for
+// it over all tracks and over the selected tracks only.
+struct RangePlanner::Boundary {
+  long long pos;  // relative to segment payload
+  long long time_all;
+  long long time_selected;  // LLONG_MAX when no selected track is cued
+};
+
+namespace {
+
+bool ComparePos(const ByteRange& lhs, const ByteRange& rhs) {
+  return lhs.pos < rhs.pos;
+}
+
+}  // namespace
+
+RangePlanner::RangePlanner(const Segment* pSegment)
+    : m_pSegment(pSegment),
+      m_merge_gap(0),
+      m_include_headers(true),
+      m_ranges(NULL),
+      m_count(0),
+      m_size(0) {}
+
+RangePlanner::~RangePlanner() { delete[] m_ranges; }
+
+const ByteRange* RangePlanner::GetRange(long index) const {
+  if (index < 0 || index >= m_count)
+    return NULL;
+
+  return m_ranges + index;
+}
+
+long long RangePlanner::GetTotalSize() const {
+  long long total = 0;
+
+  for (long i = 0; i < m_count; ++i)
+    total += m_ranges[i].len;
+
+  return total;
+}
+
+long RangePlanner::CollectBoundaries(unsigned long long track_mask,
+                                     Boundary*& boundaries,
+                                     long& count) const {
+  boundaries = NULL;
+  count = 0;
+
+  const Cues* const pCues = m_pSegment->GetCues();
+  const Tracks* const pTracks = m_pSegment->GetTracks();
+
+  if (pCues == NULL || pTracks == NULL)
+    return E_FILE_FORMAT_INVALID;
+
+  while (pCues->LoadCuePoint()) {
+  }
+
+  const unsigned long track_count = pTracks->GetTracksCount();
+  const long long max_count =
+      static_cast<long long>(pCues->GetCount()) * track_count;
+
+  if (max_count <= 0)
+    return E_FILE_FORMAT_INVALID;
+
+  if (max_count > LONG_MAX)
+    return -1;  // generic error
+
+  boundaries = new (std::nothrow) Boundary[static_cast<size_t>(max_count)];
+  if (boundaries == NULL)
+    return -1;
+
+  for (const CuePoint* pCP = pCues->GetFirst(); pCP != NULL;
+       pCP = pCues->GetNext(pCP)) {
+    const long long time = pCP->GetTime(m_pSegment);
+
+    for (unsigned long i = 0; i < track_count; ++i) {
+      const Track* const pTrack = pTracks->GetTrackByIndex(i);
+
+      if (pTrack == NULL)
+        continue;
+
+      const CuePoint::TrackPosition* const pTP = pCP->Find(pTrack);
+
+      if (pTP == NULL || pTP->m_pos < 0)
+        continue;
+
+      const unsigned long long bit =
+          BlockIterator::GetTrackBit(pTrack->GetNumber());
+
+      // Insertion sort by position; cue points are nearly sorted already.
+      long j = count;
+
+      while (j > 0 && boundaries[j - 1].pos > pTP->m_pos)
+        --j;
+
+      Boundary* pB = boundaries + j;
+
+      if (j > 0 && boundaries[j - 1].pos == pTP->m_pos) {
+        pB = boundaries + j - 1;
+      } else {
+        for (long k = count; k > j; --k)
+          boundaries[k] = boundaries[k - 1];
+
+        ++count;
+        pB->pos = pTP->m_pos;
+        pB->time_all = LLONG_MAX;
+        pB->time_selected = LLONG_MAX;
+      }
+
+      if (time < pB->time_all)
+        pB->time_all = time;
+
+      if ((track_mask & bit) != 0 && time < pB->time_selected)
+        pB->time_selected = time;
+    }
+  }
+
+  if (count <= 0) {
+    delete[] boundaries;
+    boundaries = NULL;
+    return E_FILE_FORMAT_INVALID;
+  }
+
+  return 0;
+}
+
+bool RangePlanner::AddRange(long long pos, long long stop) {
+  if (stop <= pos)
+    return true;  // nothing to add
+
+  if (m_count >= m_size) {
+    const long size = (m_size == 0) ? 4 : 2 * m_size;
+
+    ByteRange* const ranges = new (std::nothrow) ByteRange[size];
+    if (ranges == NULL)
+      return false;
+
+    for (long i = 0; i < m_count; ++i)
+      ranges[i] = m_ranges[i];
+
+    delete[] m_ranges;
+
+    m_ranges = ranges;
+    m_size = size;
+  }
+
+  ByteRange& range = m_ranges[m_count++];
+  range.pos = pos;
+  range.len = stop - pos;
+
+  return true;
+}
+
+void RangePlanner::Coalesce() {
+  if (m_count <= 1)
+    return;
+
+  std::sort(m_ranges, m_ranges + m_count, ComparePos);
+
+  long count = 1;
+
+  for (long i = 1; i < m_count; ++i) {
+    ByteRange& last = m_ranges[count - 1];
+    const ByteRange& curr = m_ranges[i];
+
+    const long long last_stop = last.pos + last.len;
+
+    if (curr.pos - last_stop <= m_merge_gap) {
+      const long long curr_stop = curr.pos + curr.len;
+
+      if (curr_stop > last_stop)
+        last.len = curr_stop - last.pos;
+    } else {
+      m_ranges[count++] = curr;
+    }
+  }
+
+  m_count = count;
+}
+
+long RangePlanner::Plan(long long start_ns, long long stop_ns,
+                        unsigned long long track_mask) {
+  m_count = 0;
+
+  if (m_pSegment == NULL || start_ns < 0 || stop_ns <= start_ns)
+    return -1;  // generic error
+
+  Boundary* boundaries;
+  long count;
+
+  long status = CollectBoundaries(track_mask, boundaries, count);
+
+  if (status < 0)
+    return status;
+
+  bool any_selected = false;
+
+  for (long i = 0; i < count; ++i) {
+    if (boundaries[i].time_selected != LLONG_MAX) {
+      any_selected = true;
+      break;
+    }
+  }
+
+  if (!any_selected) {  // fall back to the cue points of all tracks
+    for (long i = 0; i < count; ++i)
+      boundaries[i].time_selected = boundaries[i].time_all;
+  }
+
+  // The first cluster is the last cued one starting at or before |start_ns|,
+  // or the earliest cued one when the range starts before all of them.
+  long first = -1;
+
+  for (long i = 0; i < count; ++i) {
+    const long long time = boundaries[i].time_selected;
+
+    if (time == LLONG_MAX)
+      continue;
+
+    if (first < 0 || time <= start_ns)
+      first = i;
+  }
+
+  assert(first >= 0);
+
+  // Clusters end at the first later cued cluster starting at or after
+  // |stop_ns|, or with the cluster data.
+  long last = first + 1;
+
+  while (last < count && boundaries[last].time_all < stop_ns)
+    ++last;
+
+  const long long start = m_pSegment->m_start;
+
+  long long data_stop;
+
+  if (m_pSegment->m_size >= 0) {
+    data_stop = start + m_pSegment->m_size;
+  } else {
+    long long total, avail;
+
+    status = m_pSegment->m_pReader->Length(&total, &avail);
+
+    if (status < 0) {
+      delete[] boundaries;
+      return status;
+    }
+
+    data_stop = (total >= 0) ? total : avail;
+  }
+
+  const Cues* const pCues = m_pSegment->GetCues();
+  const long long cues_start = pCues->m_element_start;
+  const long long cues_stop = cues_start + pCues->m_element_size;
+
+  const long long clusters_start = start + boundaries[first].pos;
+  long long clusters_stop = data_stop;
+
+  if (last < count)
+    clusters_stop = start + boundaries[last].pos;
+  else if (cues_start >= clusters_start && cues_start < clusters_stop)
+    clusters_stop = cues_start;
+
+  bool ok = AddRange(clusters_start, clusters_stop);
+
+  if (ok && m_include_headers) {
+    const Cluster* const pFirst = m_pSegment->GetFirst();
+
+    long long headers_stop = start + boundaries[0].pos;
+
+    if (pFirst != NULL && !pFirst->EOS() &&
+        pFirst->m_element_start < headers_stop)
+      headers_stop = pFirst->m_element_start;
+
+    ok = AddRange(0, headers_stop) && AddRange(cues_start, cues_stop);
+  }
+
+  delete[] boundaries;
+
+  if (!ok) {
+    m_count = 0;
+    return -1;
+  }
+
+  Coalesce();
+  return 0;
+}
+
+RangeReader::RangeReader(IMkvReader* pSource)
+    : m_pSource(pSource),
+      m_chunks(NULL),
+      m_count(0),
+      m_fetch_count(0),
+      m_fetched_size(0) {}
+
+RangeReader::~RangeReader() { Clear(); }
+
+void RangeReader::Clear() {
+  for (long i = 0; i < m_count; ++i)
+    delete[] m_chunks[i].buf;
+
+  delete[] m_chunks;
+
+  m_chunks = NULL;
+  m_count = 0;
+}
+
+int RangeReader::Fetch(const RangePlanner& planner) {
+  const long count = planner.GetCount();
+
+  if (count <= 0)
+    return Fetch(NULL, 0);
+
+  return Fetch(planner.GetRange(0), count);
+}
+
+int RangeReader::Fetch(const ByteRange* ranges, long count) {
+  Clear();
+
+  if (m_pSource == NULL || count < 0 || (count > 0 && ranges == NULL))
+    return -1;
+
+  if (count == 0)
+    return 0;
+
+  m_chunks = new (std::nothrow) Chunk[count];
+  if (m_chunks == NULL)
+    return -1;
+
+  for (long i = 0; i < count; ++i) {
+    const ByteRange& range = ranges[i];
+
+    if (range.pos < 0 || range.len <= 0 || range.len > LONG_MAX) {
+      Clear();
+      return -1;
+    }
+
+    if (i > 0 && range.pos < ranges[i - 1].pos + ranges[i - 1].len) {
+      Clear();
+      return -1;  // unsorted or overlapping
+    }
+
+    unsigned char* const buf =
+        new (std::nothrow) unsigned char[static_cast<size_t>(range.len)];
+    if (buf == NULL) {
+      Clear();
+      return -1;
+    }
+
+    Chunk& chunk = m_chunks[m_count++];
+    chunk.pos = range.pos;
+    chunk.len = range.len;
+    chunk.buf = buf;
+
+    ++m_fetch_count;
+
+    if (m_pSource->Read(range.pos, static_cast<long>(range.len), buf)) {
+      Clear();
+      return -1;
+    }
+
+    m_fetched_size += range.len;
+  }
+
+  return 0;
+}
+
+int RangeReader::Read(long long position, long length,
+                      unsigned char* buffer) {
+  if (position < 0 || length < 0)
+    return -1;
+
+  if (length == 0)
+    return 0;
+
+  // Binary search for the last chunk starting at or before |position|.
+  long i = 0;
+  long j = m_count;
+
+  while (i < j) {
+    const long k = i + (j - i) / 2;
+
+    if (m_chunks[k].pos <= position)
+      i = k + 1;
+    else
+      j = k;
+  }
+
+  if (i == 0)
+    return -1;
+
+  const Chunk& chunk = m_chunks[i - 1];
+
+  if (position + length > chunk.pos + chunk.len)
+    return -1;  // not fetched
+
+  memcpy(buffer, chunk.buf + (position - chunk.pos), length);
+  return 0;
+}
+
+int RangeReader::Length(long long* total, long long* available) {
+  if (m_pSource == NULL)
+    return -1;
+
+  return m_pSource->Length(total, available);
+}
+
+}  // namespace mkvparser
@@ -0,0 +1,121 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef MKVPARSER_MKVRANGE_H_
+#define MKVPARSER_MKVRANGE_H_
+
+#include "mkvparser/mkvparser.h"
+
+namespace mkvparser {
+
+// A span of bytes of the file, in absolute file positions.
+struct ByteRange {
+  long long pos;
+  long long len;
+};
+
+// Computes the byte ranges of a file that have to be fetched to play the
+// time range [start_ns, stop_ns) of a set of tracks: the headers in front of
+// the first cluster, the Cues element and the clusters covering the range.
+// Clusters are located using Cues only, so the clusters of the segment need
+// not be loaded. A cue point time is taken as the start time of the cluster
+// it references, which holds for files whose clusters begin with the cued
+// keyframes (as written by mkvmuxer).
+class RangePlanner {
+ public:
+  explicit RangePlanner(const Segment* pSegment);
+  ~RangePlanner();
+
+  // Ranges separated by at most |gap| bytes are merged into one range, so a
+  // few small unneeded spans are fetched in exchange for fewer requests.
+  // Defaults to 0, which merges only adjacent or overlapping ranges.
+  void SetMergeGap(long long gap) { m_merge_gap = gap < 0 ? 0 : gap; }
+  long long GetMergeGap() const { return m_merge_gap; }
+
+  // Controls whether the headers and the Cues element are part of the plan.
+  // Defaults to true; a client that already holds them can disable it.
+  void SetIncludeHeaders(bool include) { m_include_headers = include; }
+  bool GetIncludeHeaders() const { return m_include_headers; }
+
+  // Computes the ranges for [start_ns, stop_ns) of the tracks selected by
+  // |track_mask|, using the bit layout of BlockIterator::SetTrackMask().
+  // When none of the selected tracks has cue points, cue points of all tracks
+  // are used. The result is sorted by position and replaces the previous
+  // one. Returns 0 on success, E_FILE_FORMAT_INVALID when the segment has no
+  // usable Cues, or another negative error code.
+  long Plan(long long start_ns, long long stop_ns,
+            unsigned long long track_mask);
+
+  long GetCount() const { return m_count; }
+  const ByteRange* GetRange(long index) const;
+
+  // Total number of bytes covered by the current plan.
+  long long GetTotalSize() const;
+
+ private:
+  RangePlanner(const RangePlanner&);
+  RangePlanner& operator=(const RangePlanner&);
+
+  struct Boundary;
+
+  long CollectBoundaries(unsigned long long track_mask, Boundary*& boundaries,
+                         long& count) const;
+  bool AddRange(long long pos, long long stop);
+  void Coalesce();
+
+  const Segment* const m_pSegment;
+  long long m_merge_gap;
+  bool m_include_headers;
+  ByteRange* m_ranges;
+  long m_count;
+  long m_size;
+};
+
+// IMkvReader that serves reads from a set of byte ranges fetched from
+// another reader, one read per range. Reads that are not entirely inside a
+// fetched range fail. With the ranges of a RangePlanner it can stand in for
+// a remote file of which only the planned ranges were downloaded.
+class RangeReader : public IMkvReader {
+ public:
+  explicit RangeReader(IMkvReader* pSource);
+  virtual ~RangeReader();
+
+  // Reads |count| ranges from the source reader and keeps them in memory.
+  // Ranges must be sorted by position and must not overlap. Previously
+  // fetched ranges are released. Returns 0 on success, otherwise -1.
+  int Fetch(const ByteRange* ranges, long count);
+  int Fetch(const RangePlanner& planner);
+
+  // Number of source reads and bytes fetched so far.
+  long GetFetchCount() const { return m_fetch_count; }
+  long long GetFetchedSize() const { return m_fetched_size; }
+
+  virtual int Read(long long position, long length, unsigned char* buffer);
+  virtual int Length(long long* total, long long* available);
+
+ private:
+  RangeReader(const RangeReader&);
+  RangeReader& operator=(const RangeReader&);
+
+  struct Chunk {
+    long long pos;
+    long long len;
+    unsigned char* buf;
+  };
+
+  void Clear();
+
+  IMkvReader* const m_pSource;
+  Chunk* m_chunks;
+  long m_count;
+  long m_fetch_count;
+  long long m_fetched_size;
+};
+
+}  // namespace mkvparser
+
+#endif  // MKVPARSER_MKVRANGE_H_
@@ -0,0 +1,341 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "mkvparser/mkvresync.h"
+
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MKVPARSER_RESYNC_SSE2
+#endif
+
+#include "common/webmids.h"
+
+namespace mkvparser {
+
+namespace {
+
+const long kDefaultBufferSize = 64 * 1024;
+const long kMinBufferSize = 64;
+
+// The Cluster ID spans 4 bytes; candidates closer than this to the end of a
+// chunk are examined again at the start of the next chunk.
+const long kClusterIdSize = 4;
+
+// Reads the ID and size of the element header at |pos|. Returns false when
+// the header is not valid or its bytes are not available.
+bool ReadHeader(IMkvReader* pReader, long long pos, long long& id,
+                long long& size, bool& unknown_size, long& header_len) {
+  long id_len;
+  id = ReadID(pReader, pos, id_len);
+  if (id < 0)
+    return false;
+
+  long size_len;
+  size = ReadUInt(pReader, pos + id_len, size_len);
+  if (size < 0)
+    return false;
+
+  unknown_size = size == (1LL << (7 * size_len)) - 1;
+  header_len = id_len + size_len;
+  return true;
+}
+
+bool IsMatch(const unsigned char* buf, long i, long n, int kinds) {
+  if ((kinds & ResyncScanner::kCluster) && i + kClusterIdSize <= n &&
+      buf[i] == 0x1F && buf[i + 1] == 0x43 && buf[i + 2] == 0xB6 &&
+      buf[i + 3] == 0x75) {
+    return true;
+  }
+
+  return (kinds & ResyncScanner::kSimpleBlock) && buf[i] == 0xA3;
+}
+
+// Returns the index of the first byte in [i, limit) of |buf| (holding |n|
+// bytes) that starts a candidate of |kinds|, or |limit| when there is none.
+long FindCandidate(const unsigned char* buf, long i, long n, long limit,
+                   int kinds) {
+#ifdef MKVPARSER_RESYNC_SSE2
+  const __m128i cluster0 = _mm_set1_epi8(0x1F);
+  const __m128i cluster1 = _mm_set1_epi8(0x43);
+  const __m128i block = _mm_set1_epi8(static_cast<char>(0xA3));
+
+  // Each step compares 16 positions; the Cluster test also looks at the
+  // byte following each position.
+  while (i < limit && i + 17 <= n) {
+    const __m128i v0 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i));
+    __m128i hits = _mm_setzero_si128();
+
+    if (kinds & ResyncScanner::kCluster) {
+      const __m128i v1 =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + i + 1));
+      hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpeq_epi8(v0, cluster0),
+                                              _mm_cmpeq_epi8(v1, cluster1)));
+    }
+
+    if (kinds & ResyncScanner::kSimpleBlock)
+      hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v0, block));
+
+    int mask = _mm_movemask_epi8(hits);
+
+    while (mask != 0) {
+      long k = 0;
+
+      while (!(mask & (1 << k)))
+        ++k;
+
+      if (i + k >= limit)
+        return limit;
+
+      if (IsMatch(buf, i + k, n, kinds))
+        return i + k;
+
+      mask &= mask - 1;
+    }
+
+    i += 16;
+  }
+#endif
+
+  for (; i < limit; ++i) {
+    if (IsMatch(buf, i, n, kinds))
+      return i;
+  }
+
+  return limit;
+}
+
+}  // namespace
+
+ResyncScanner::ResyncScanner(const Segment* pSegment)
+    : m_pSegment(pSegment),
+      m_buf(NULL),
+      m_buf_size(kDefaultBufferSize),
+      m_scanned(0),
+      m_rejected(0) {}
+
+ResyncScanner::~ResyncScanner() { delete[] m_buf; }
+
+void ResyncScanner::SetBufferSize(long size) {
+  if (size < kMinBufferSize)
+    size = kMinBufferSize;
+
+  if (size == m_buf_size)
+    return;
+
+  delete[] m_buf;
+  m_buf = NULL;
+  m_buf_size = size;
+}
+
+long ResyncScanner::Find(long long start, long long stop, int kinds,
+                         long long& pos, Kind& kind) {
+  if (m_pSegment == NULL || (kinds & (kCluster | kSimpleBlock)) == 0)
+    return E_PARSE_FAILED;
+
+  IMkvReader* const pReader = m_pSegment->m_pReader;
+
+  long long total, avail;
+
+  const long status = pReader->Length(&total, &avail);
+
+  if (status < 0)  // error
+    return status;
+
+  if (total >= 0 && avail > total)
+    return E_FILE_FORMAT_INVALID;
+
+  // Candidates are validated against the end of the segment or of the
+  // available data, whichever comes first.
+  long long end = avail;
+
+  if (m_pSegment->m_size >= 0 &&
+      m_pSegment->m_start + m_pSegment->m_size < end) {
+    end = m_pSegment->m_start + m_pSegment->m_size;
+  }
+
+  if (stop < 0 || stop > end)
+    stop = end;
+
+  if (start < m_pSegment->m_start)
+    start = m_pSegment->m_start;
+
+  if (m_buf == NULL) {
+    m_buf = new (std::nothrow) unsigned char[m_buf_size];
+    if (m_buf == NULL)
+      return -1;
+  }
+
+  long long chunk_pos = start;
+
+  while (chunk_pos < stop) {
+    const long n = FillBuffer(chunk_pos, stop);
+
+    if (n < 0)  // error
+      return n;
+
+    // Positions whose Cluster ID would cross the end of a chunk are left to
+    // the next chunk.
+    const bool last = chunk_pos + n >= stop;
+    const long limit = last ? n : n - (kClusterIdSize - 1);
+
+    long i = 0;
+
+    for (;;) {
+      i = FindCandidate(m_buf, i, n, limit, kinds);
+
+      if (i >= limit)
+        break;
+
+      const long long candidate = chunk_pos + i;
+
+      if (m_buf[i] == 0x1F && (kinds & kCluster) &&
+          IsCluster(candidate, end)) {
+        m_scanned += i;
+        pos = candidate;
+        kind = kCluster;
+        return 0;
+      }
+
+      if (m_buf[i] == 0xA3 && (kinds & kSimpleBlock) &&
+          IsSimpleBlock(candidate, end)) {
+        m_scanned += i;
+        pos = candidate;
+        kind = kSimpleBlock;
+        return 0;
+      }
+
+      ++m_rejected;
+      ++i;
+    }
+
+    m_scanned += limit;
+    chunk_pos += limit;
+  }
+
+  return 1;  // nothing found
+}
+
+long ResyncScanner::FillBuffer(long long pos, long long stop) {
+  long n = m_buf_size;
+
+  if (stop - pos < n)
+    n = static_cast<long>(stop - pos);
+
+  const int status = m_pSegment->m_pReader->Read(pos, n, m_buf);
+
+  if (status < 0)  // error
+    return status;
+
+  if (status > 0)
+    return E_BUFFER_NOT_FULL;
+
+  return n;
+}
+
+bool ResyncScanner::IsCluster(long long pos, long long end) const {
+  IMkvReader* const pReader = m_pSegment->m_pReader;
+
+  long long id, size;
+  bool unknown_size;
+  long len;
+
+  if (!ReadHeader(pReader, pos, id, size, unknown_size, len) ||
+      id != libwebm::kMkvCluster || size == 0) {
+    return false;
+  }
+
+  const long long payload = pos + len;
+  const long long cluster_stop = unknown_size ? end : payload + size;
+
+  if (cluster_stop > end)
+    return false;
+
+  // The first child is the Timecode element, possibly behind a CRC-32.
+  long long child = payload;
+
+  for (int i = 0; i < 2; ++i) {
+    if (child >= cluster_stop ||
+        !ReadHeader(pReader, child, id, size, unknown_size, len) ||
+        unknown_size || child + len + size > cluster_stop) {
+      return false;
+    }
+
+    if (id == libwebm::kMkvTimecode)
+      return size >= 1 && size <= 8;
+
+    if (id != libwebm::kMkvCRC32 || size != 4)
+      return false;
+
+    child += len + size;
+  }
+
+  return false;
+}
+
+bool ResyncScanner::IsSimpleBlock(long long pos, long long end) const {
+  IMkvReader* const pReader = m_pSegment->m_pReader;
+
+  long long id, size;
+  bool unknown_size;
+  long len;
+
+  if (!ReadHeader(pReader, pos, id, size, unknown_size, len) ||
+      id != libwebm::kMkvSimpleBlock || unknown_size || size < 4) {
+    return false;
+  }
+
+  const long long payload = pos + len;
+  const long long block_stop = payload + size;
+
+  if (block_stop > end)
+    return false;
+
+  long track_len;
+  const long long track = ReadUInt(pReader, payload, track_len);
+
+  if (track <= 0 || track_len + 3 > size)
+    return false;
+
+  const Tracks* const pTracks = m_pSegment->GetTracks();
+
+  if (pTracks != NULL &&
+      pTracks->GetTrackByNumber(static_cast<long>(track)) == NULL) {
+    return false;
+  }
+
+  unsigned char flags;
+
+  if (pReader->Read(payload + track_len + 2, 1, &flags) != 0)
+    return false;
+
+  if (flags & 0x70)  // reserved bits
+    return false;
+
+  return IsBlockSuccessor(block_stop, end);
+}
+
+bool ResyncScanner::IsBlockSuccessor(long long pos, long long end) const {
+  if (pos >= end)
+    return true;
+
+  long long id, size;
+  bool unknown_size;
+  long len;
+
+  if (!ReadHeader(m_pSegment->m_pReader, pos, id, size, unknown_size, len))
+    return false;
+
+  return id == libwebm::kMkvCluster || id == libwebm::kMkvCues ||
+         id == libwebm::kMkvSimpleBlock || id == libwebm::kMkvBlockGroup ||
+         id == libwebm::kMkvVoid;
+}
+
+}  // namespace mkvparser
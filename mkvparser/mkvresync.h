@@ -0,0 +1,70 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef MKVPARSER_MKVRESYNC_H_
+#define MKVPARSER_MKVRESYNC_H_
+
+#include "mkvparser/mkvparser.h"
+
+namespace mkvparser {
+
+// Locates the next Cluster or SimpleBlock element after a damaged region of
+// a segment, so that parsing can resume with Segment::Resync(). The file is
+// read in large chunks and searched for the element IDs with SSE2 where
+// available, or a scalar loop otherwise. Each candidate is then validated
+// structurally before it is reported:
+//
+// - a Cluster must have a valid size that fits in the segment, and its
+//   first child must be a Timecode element (optionally preceded by CRC-32);
+// - a SimpleBlock must belong to a track of the segment, have no reserved
+//   flag bits set, fit in the segment, and be followed by the end of the
+//   segment (or of the available data) or by a Cluster, Cues, SimpleBlock,
+//   BlockGroup or Void element.
+class ResyncScanner {
+  ResyncScanner(const ResyncScanner&);
+  ResyncScanner& operator=(const ResyncScanner&);
+
+ public:
+  enum Kind { kCluster = 1, kSimpleBlock = 2 };
+
+  explicit ResyncScanner(const Segment* pSegment);
+  ~ResyncScanner();
+
+  // Size of the chunks read from the segment's reader. Defaults to 64 KiB;
+  // values below 64 bytes are raised to 64.
+  void SetBufferSize(long size);
+  long GetBufferSize() const { return m_buf_size; }
+
+  // Searches [start, stop) for the first element of the kinds selected by
+  // the |kinds| bit mask whose header validates. A negative |stop| scans to
+  // the end of the segment, or of the available data. Returns 0 and sets
+  // |pos| to the absolute position of the element ID and |kind| to its kind
+  // when one was found, 1 when there is none, and a negative error code
+  // otherwise.
+  long Find(long long start, long long stop, int kinds, long long& pos,
+            Kind& kind);
+
+  // Bytes searched and candidates rejected by validation, over all calls.
+  long long GetScannedSize() const { return m_scanned; }
+  long long GetRejectedCount() const { return m_rejected; }
+
+ private:
+  long FillBuffer(long long pos, long long stop);
+  bool IsCluster(long long pos, long long end) const;
+  bool IsSimpleBlock(long long pos, long long end) const;
+  bool IsBlockSuccessor(long long pos, long long end) const;
+
+  const Segment* const m_pSegment;
+  unsigned char* m_buf;
+  long m_buf_size;
+  long long m_scanned;
+  long long m_rejected;
+};
+
+}  // namespace mkvparser
+
+#endif  // MKVPARSER_MKVRESYNC_H_
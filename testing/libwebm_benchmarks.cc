@@ -0,0 +1,796 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+//
+// Microbenchmarks for the parser, muxer and PES paths. Every input is
+// synthesized in memory from a fixed seed, so runs are reproducible and need
+// no test data; the parser benchmarks can also read a file, such as one
+// written by webm_synth. Each benchmark reports its median time per iteration
+// over several repetitions, and its throughput in MB/s and frames (or
+// elements) per second.
+#include <inttypes.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/file_util.h"
+#include "common/vp9_header_parser.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvparser.h"
+#include "testing/synthetic_webm.h"
+
+#ifdef LIBWEBM_BENCHMARK_WEBMTS
+#include "m2ts/webm2pes.h"
+#endif
+
+#ifdef LIBWEBM_BENCHMARK_WEBM_PARSER
+#include "webm/callback.h"
+#include "webm/reader.h"
+#include "webm/status.h"
+#include "webm/webm_parser.h"
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Options {
+  std::string filter;
+  double min_time = 0.5;
+  int repetitions = 5;
+  uint32_t seed = 1;
+  double duration = 60;
+  std::string input;
+  bool list = false;
+};
+
+//
+// Synthetic input.
+//
+
+// An in-memory mkvmuxer writer.
+class MemoryWriter : public mkvmuxer::IMkvWriter {
+ public:
+  MemoryWriter() : position_(0) {}
+
+  mkvmuxer::int32 Write(const void* buf, mkvmuxer::uint32 len) override {
+    const uint8_t* const data = static_cast<const uint8_t*>(buf);
+    const size_t end = static_cast<size_t>(position_) + len;
+    if (end > data_.size())
+      data_.resize(end);
+    std::copy(data, data + len, data_.begin() + position_);
+    position_ = end;
+    return 0;
+  }
+  mkvmuxer::int64 Position() const override { return position_; }
+  mkvmuxer::int32 Position(mkvmuxer::int64 position) override {
+    if (position < 0 || static_cast<size_t>(position) > data_.size())
+      return -1;
+    position_ = position;
+    return 0;
+  }
+  bool Seekable() const override { return true; }
+  void ElementStartNotify(mkvmuxer::uint64, mkvmuxer::int64) override {}
+
+  const std::vector<uint8_t>& data() const { return data_; }
+  void Clear() {
+    data_.clear();
+    position_ = 0;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+  mkvmuxer::int64 position_;
+};
+
+// An mkvparser reader of a buffer that is fully available.
+class MemoryReader : public mkvparser::IMkvReader {
+ public:
+  explicit MemoryReader(const std::vector<uint8_t>& data) : data_(data) {}
+
+  int Read(long long pos, long len, unsigned char* buf) override {
+    if (pos < 0 || len < 0 ||
+        static_cast<unsigned long long>(pos) + len > data_.size())
+      return -1;
+    if (len > 0)
+      memcpy(buf, data_.data() + pos, len);
+    return 0;
+  }
+  int Length(long long* total, long long* available) override {
+    if (total)
+      *total = static_cast<long long>(data_.size());
+    if (available)
+      *available = static_cast<long long>(data_.size());
+    return 0;
+  }
+
+ private:
+  const std::vector<uint8_t>& data_;
+};
+
+// The synthetic file used by the benchmarks: one VP9 and one Opus track.
+libwebm::SyntheticWebmConfig SyntheticConfig(const Options& options) {
+  libwebm::SyntheticWebmConfig config;
+  config.seed = options.seed;
+  config.duration_seconds = options.duration;
+  return config;
+}
+
+// Sets |data| to the contents of |options.input|, or else to the synthetic
+// file.
+bool GetInput(const Options& options, std::vector<uint8_t>* data) {
+  if (!options.input.empty()) {
+    std::string contents;
+    if (!libwebm::GetFileContents(options.input, &contents))
+      return false;
+    data->assign(contents.begin(), contents.end());
+    return true;
+  }
+  MemoryWriter writer;
+  if (!libwebm::WriteSyntheticWebm(SyntheticConfig(options), &writer))
+    return false;
+  *data = writer.data();
+  return true;
+}
+
+// Owns an mkvparser Segment loaded from a buffer.
+struct ParsedFile {
+  explicit ParsedFile(const std::vector<uint8_t>& data) : reader(data) {}
+
+  bool Load() {
+    long long pos = 0;
+    mkvparser::EBMLHeader ebml_header;
+    if (ebml_header.Parse(&reader, pos) < 0)
+      return false;
+    mkvparser::Segment* temp_segment = nullptr;
+    if (mkvparser::Segment::CreateInstance(&reader, pos, temp_segment))
+      return false;
+    segment.reset(temp_segment);
+    if (segment->Load() < 0)
+      return false;
+    const mkvparser::Cues* const cues = segment->GetCues();
+    if (cues != nullptr) {
+      while (!cues->DoneParsing())
+        cues->LoadCuePoint();
+    }
+    return true;
+  }
+
+  MemoryReader reader;
+  std::unique_ptr<mkvparser::Segment> segment;
+};
+
+//
+// Harness.
+//
+
+// Passed to Benchmark::Run(): the work done by one iteration, and timing
+// control for work that should not be measured.
+class State {
+ public:
+  State() : bytes(0), frames(0), paused_(Clock::duration::zero()) {}
+
+  void PauseTiming() { pause_start_ = Clock::now(); }
+  void ResumeTiming() { paused_ += Clock::now() - pause_start_; }
+  Clock::duration paused() const { return paused_; }
+
+  int64_t bytes;
+  int64_t frames;
+
+ private:
+  Clock::time_point pause_start_;
+  Clock::duration paused_;
+};
+
+class Benchmark {
+ public:
+  explicit Benchmark(const std::string& name) : name_(name) {}
+  virtual ~Benchmark() {}
+
+  const std::string& name() const { return name_; }
+
+  // Label of the State::frames counter in the report.
+  virtual const char* frames_label() const { return "frames/s"; }
+
+  // Builds the input. Called once, untimed.
+  virtual bool SetUp(const Options& /* options */) { return true; }
+
+  // One timed iteration.
+  virtual bool Run(State* state) = 0;
+
+ private:
+  const std::string name_;
+};
+
+//
+// mkvparser.
+//
+
+class ReadUIntBenchmark : public Benchmark {
+ public:
+  explicit ReadUIntBenchmark(bool ids)
+      : Benchmark(ids ? "mkvparser/ReadID" : "mkvparser/ReadUInt"),
+        ids_(ids),
+        reader_(data_) {}
+
+  const char* frames_label() const override { return "elements/s"; }
+
+  bool SetUp(const Options& options) override {
+    std::mt19937 random(options.seed);
+    const int kCount = 1 << 20;
+    for (int i = 0; i < kCount; ++i) {
+      // IDs are 1 to 4 bytes long and sizes 1 to 8; neither is all ones.
+      const int length = 1 + random() % (ids_ ? 4 : 8);
+      const uint64_t max = (1ULL << (7 * length)) - 2;
+      uint64_t value = random() % (max + 1);
+      if (ids_ && value == 0)
+        value = 1;
+      value |= 1ULL << (7 * length);
+      for (int j = length - 1; j >= 0; --j)
+        data_.push_back(static_cast<uint8_t>(value >> (8 * j)));
+      ++count_;
+    }
+    return true;
+  }
+
+  bool Run(State* state) override {
+    long long pos = 0;
+    const long long size = static_cast<long long>(data_.size());
+    while (pos < size) {
+      long len = 0;
+      const long long value = ids_ ? mkvparser::ReadID(&reader_, pos, len)
+                                   : mkvparser::ReadUInt(&reader_, pos, len);
+      if (value < 0)
+        return false;
+      pos += len;
+    }
+    state->bytes = size;
+    state->frames = count_;
+    return true;
+  }
+
+ private:
+  const bool ids_;
+  std::vector<uint8_t> data_;
+  MemoryReader reader_;
+  int64_t count_ = 0;
+};
+
+// Segment::Load() of a file, which loads every Cluster, then a walk of the
+// blocks in them.
+class ClusterLoadBenchmark : public Benchmark {
+ public:
+  ClusterLoadBenchmark() : Benchmark("mkvparser/Cluster::Load") {}
+
+  bool SetUp(const Options& options) override {
+    return GetInput(options, &data_);
+  }
+
+  bool Run(State* state) override {
+    MemoryReader reader(data_);
+    long long pos = 0;
+    mkvparser::EBMLHeader ebml_header;
+    if (ebml_header.Parse(&reader, pos) < 0)
+      return false;
+    mkvparser::Segment* temp_segment = nullptr;
+    if (mkvparser::Segment::CreateInstance(&reader, pos, temp_segment))
+      return false;
+    std::unique_ptr<mkvparser::Segment> segment(temp_segment);
+    if (segment->Load() < 0)
+      return false;
+
+    int64_t frames = 0;
+    const mkvparser::Cluster* cluster = segment->GetFirst();
+    while (cluster != nullptr && !cluster->EOS()) {
+      const mkvparser::BlockEntry* entry = nullptr;
+      long status = cluster->GetFirst(entry);
+      while (status == 0 && entry != nullptr && !entry->EOS()) {
+        frames += entry->GetBlock()->GetFrameCount();
+        status = cluster->GetNext(entry, entry);
+      }
+      if (status < 0)
+        return false;
+      cluster = segment->GetNext(cluster);
+    }
+    state->bytes = static_cast<int64_t>(data_.size());
+    state->frames = frames;
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Seeks a loaded file to random times, with Track::Seek() or Cues::Find().
+class SeekBenchmark : public Benchmark {
+ public:
+  explicit SeekBenchmark(bool cues)
+      : Benchmark(cues ? "mkvparser/Cues::Find" : "mkvparser/Track::Seek"),
+        cues_(cues) {}
+
+  const char* frames_label() const override { return "seeks/s"; }
+
+  bool SetUp(const Options& options) override {
+    if (!GetInput(options, &data_))
+      return false;
+    file_.reset(new ParsedFile(data_));
+    if (!file_->Load())
+      return false;
+    const mkvparser::Segment* const segment = file_->segment.get();
+    track_ = segment->GetTracks()->GetTrackByIndex(0);
+    if (track_ == nullptr || (cues_ && segment->GetCues() == nullptr))
+      return false;
+
+    std::mt19937 random(options.seed);
+    const long long duration = segment->GetInfo()->GetDuration();
+    for (int i = 0; i < 4096; ++i)
+      times_.push_back(static_cast<long long>(random() % duration));
+    return true;
+  }
+
+  bool Run(State* state) override {
+    const mkvparser::Cues* const cues = file_->segment->GetCues();
+    for (const long long time_ns : times_) {
+      if (cues_) {
+        const mkvparser::CuePoint* cue_point = nullptr;
+        const mkvparser::CuePoint::TrackPosition* track_position = nullptr;
+        if (!cues->Find(time_ns, track_, cue_point, track_position))
+          return false;
+      } else {
+        const mkvparser::BlockEntry* entry = nullptr;
+        if (track_->Seek(time_ns, entry) < 0 || entry == nullptr)
+          return false;
+      }
+    }
+    state->frames = static_cast<int64_t>(times_.size());
+    return true;
+  }
+
+ private:
+  const bool cues_;
+  std::vector<uint8_t> data_;
+  std::unique_ptr<ParsedFile> file_;
+  const mkvparser::Track* track_ = nullptr;
+  std::vector<long long> times_;
+};
+
+//
+// webm_parser.
+//
+
+#ifdef LIBWEBM_BENCHMARK_WEBM_PARSER
+
+// A webm::Reader of a buffer that copies nothing until Read().
+class SpanReader : public webm::Reader {
+ public:
+  SpanReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size), position_(0) {}
+
+  webm::Status Read(std::size_t num_to_read, std::uint8_t* buffer,
+                    std::uint64_t* num_actually_read) override {
+    const size_t remaining = size_ - position_;
+    if (remaining == 0) {
+      *num_actually_read = 0;
+      return webm::Status(webm::Status::kEndOfFile);
+    }
+    const size_t count = std::min(num_to_read, remaining);
+    memcpy(buffer, data_ + position_, count);
+    position_ += count;
+    *num_actually_read = count;
+    return webm::Status(count == num_to_read ? webm::Status::kOkCompleted
+                                             : webm::Status::kOkPartial);
+  }
+
+  webm::Status Skip(std::uint64_t num_to_skip,
+                    std::uint64_t* num_actually_skipped) override {
+    const size_t remaining = size_ - position_;
+    if (remaining == 0) {
+      *num_actually_skipped = 0;
+      return webm::Status(webm::Status::kEndOfFile);
+    }
+    const size_t count =
+        static_cast<size_t>(std::min<std::uint64_t>(num_to_skip, remaining));
+    position_ += count;
+    *num_actually_skipped = count;
+    return webm::Status(count == num_to_skip ? webm::Status::kOkCompleted
+                                             : webm::Status::kOkPartial);
+  }
+
+  std::uint64_t Position() const override { return position_; }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t position_;
+};
+
+class FrameCountingCallback : public webm::Callback {
+ public:
+  webm::Status OnFrame(const webm::FrameMetadata& metadata,
+                       webm::Reader* reader,
+                       std::uint64_t* bytes_remaining) override {
+    if (*bytes_remaining == metadata.size)
+      ++frames;
+    return webm::Callback::OnFrame(metadata, reader, bytes_remaining);
+  }
+
+  int64_t frames = 0;
+};
+
+// WebmParser::Feed() over a whole file in memory, skipping frame data.
+class WebmParserFeedBenchmark : public Benchmark {
+ public:
+  WebmParserFeedBenchmark() : Benchmark("webm_parser/Feed") {}
+
+  bool SetUp(const Options& options) override {
+    return GetInput(options, &data_);
+  }
+
+  bool Run(State* state) override {
+    SpanReader reader(data_.data(), data_.size());
+    FrameCountingCallback callback;
+    webm::WebmParser parser;
+    if (!parser.Feed(&callback, &reader).completed_ok())
+      return false;
+    state->bytes = static_cast<int64_t>(data_.size());
+    state->frames = callback.frames;
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+#endif  // LIBWEBM_BENCHMARK_WEBM_PARSER
+
+//
+// mkvmuxer.
+//
+
+// Segment::AddFrame() of video frames of |frame_size| bytes on average.
+class AddFrameBenchmark : public Benchmark {
+ public:
+  explicit AddFrameBenchmark(size_t frame_size)
+      : Benchmark("mkvmuxer/Segment::AddFrame/" + std::to_string(frame_size)),
+        frame_size_(frame_size) {}
+
+  bool SetUp(const Options& options) override {
+    config_.seed = options.seed;
+    config_.audio_tracks = 0;
+    config_.keyframe_size = frame_size_;
+    config_.frame_size = frame_size_;
+
+    // About 64 MB per iteration, in 64 to 65536 frames, cycling through 64
+    // distinct frames.
+    const size_t count = (64 << 20) / frame_size_;
+    frame_count_ = static_cast<int>(
+        std::min<size_t>(std::max<size_t>(count, 64), 1 << 16));
+    config_.duration_seconds = frame_count_ / config_.frame_rate;
+    libwebm::SyntheticFrameGenerator generator(config_);
+    libwebm::SyntheticFrame frame;
+    while (frames_.size() < 64 && generator.Next(&frame))
+      frames_.push_back(frame);
+    return frames_.size() == 64;
+  }
+
+  bool Run(State* state) override {
+    state->PauseTiming();
+    writer_.Clear();
+    mkvmuxer::Segment segment;
+    if (!libwebm::InitSyntheticSegment(config_, &writer_, &segment))
+      return false;
+    state->ResumeTiming();
+
+    int64_t bytes = 0;
+    const uint64_t frame_ns =
+        static_cast<uint64_t>(1e9 / config_.frame_rate);
+    for (int i = 0; i < frame_count_; ++i) {
+      // Keyframes where the generator put them.
+      const libwebm::SyntheticFrame& frame = frames_[i % frames_.size()];
+      const bool is_key = i % config_.keyframe_interval == 0;
+      if (!segment.AddFrame(frame.data.data(), frame.data.size(),
+                            frame.track_number, i * frame_ns, is_key)) {
+        return false;
+      }
+      bytes += static_cast<int64_t>(frame.data.size());
+    }
+    state->bytes = bytes;
+    state->frames = frame_count_;
+    return true;
+  }
+
+ private:
+  const size_t frame_size_;
+  libwebm::SyntheticWebmConfig config_;
+  int frame_count_ = 0;
+  std::vector<libwebm::SyntheticFrame> frames_;
+  MemoryWriter writer_;
+};
+
+// Segment::Finalize() then CopyAndMoveCuesBeforeClusters() of the synthetic
+// file, with a Cluster and CuePoint per video keyframe. Muxing the frames is
+// not timed.
+class FinalizeBenchmark : public Benchmark {
+ public:
+  FinalizeBenchmark()
+      : Benchmark("mkvmuxer/Segment::Finalize+CopyAndMoveCues") {}
+
+  bool SetUp(const Options& options) override {
+    config_ = SyntheticConfig(options);
+    libwebm::SyntheticFrameGenerator generator(config_);
+    libwebm::SyntheticFrame frame;
+    while (generator.Next(&frame))
+      ++frame_count_;
+    return true;
+  }
+
+  bool Run(State* state) override {
+    state->PauseTiming();
+    writer_.Clear();
+    output_.Clear();
+    mkvmuxer::Segment segment;
+    if (!libwebm::InitSyntheticSegment(config_, &writer_, &segment) ||
+        !libwebm::AddSyntheticFrames(config_, &segment)) {
+      return false;
+    }
+    state->ResumeTiming();
+
+    if (!segment.Finalize())
+      return false;
+    MemoryReader reader(writer_.data());
+    if (!segment.CopyAndMoveCuesBeforeClusters(&reader, &output_))
+      return false;
+    state->bytes = static_cast<int64_t>(output_.data().size());
+    state->frames = frame_count_;
+    return true;
+  }
+
+ private:
+  libwebm::SyntheticWebmConfig config_;
+  int64_t frame_count_ = 0;
+  MemoryWriter writer_;
+  MemoryWriter output_;
+};
+
+//
+// PES and codec parsing.
+//
+
+#ifdef LIBWEBM_BENCHMARK_WEBMTS
+
+class CountingPacketReceiver : public libwebm::PacketReceiverInterface {
+ public:
+  bool ReceivePacket(const libwebm::PacketDataBuffer& /* packet */) override {
+    ++packets;
+    return true;
+  }
+
+  int64_t packets = 0;
+};
+
+// Webm2Pes of the video track of a file, to a receiver that drops packets.
+// Webm2Pes reads files, so the synthetic input is written to a temporary
+// file. Throughput is of the whole input file.
+class Webm2PesBenchmark : public Benchmark {
+ public:
+  Webm2PesBenchmark() : Benchmark("m2ts/Webm2Pes") {}
+
+  bool SetUp(const Options& options) override {
+    path_ = options.input;
+    if (path_.empty()) {
+      path_ = file_.name();
+      mkvmuxer::MkvWriter writer;
+      if (!writer.Open(path_.c_str()) ||
+          !libwebm::WriteSyntheticWebm(SyntheticConfig(options), &writer)) {
+        return false;
+      }
+      writer.Close();
+    }
+    file_size_ = static_cast<int64_t>(libwebm::GetFileSize(path_));
+    return file_size_ > 0;
+  }
+
+  bool Run(State* state) override {
+    CountingPacketReceiver receiver;
+    libwebm::Webm2Pes converter(path_, &receiver);
+    if (!converter.ConvertToPacketReceiver())
+      return false;
+    state->bytes = file_size_;
+    state->frames = receiver.packets;
+    return true;
+  }
+
+ private:
+  libwebm::TempFileDeleter file_;
+  std::string path_;
+  int64_t file_size_ = 0;
+};
+
+#endif  // LIBWEBM_BENCHMARK_WEBMTS
+
+class Vp9HeaderParserBenchmark : public Benchmark {
+ public:
+  Vp9HeaderParserBenchmark() : Benchmark("common/Vp9HeaderParser") {}
+
+  bool SetUp(const Options& options) override {
+    libwebm::SyntheticWebmConfig config = SyntheticConfig(options);
+    config.duration_seconds = 10;
+    config.audio_tracks = 0;
+    libwebm::SyntheticFrameGenerator generator(config);
+    libwebm::SyntheticFrame frame;
+    while (generator.Next(&frame))
+      frames_.push_back(frame.data);
+    return !frames_.empty();
+  }
+
+  bool Run(State* state) override {
+    vp9_parser::Vp9HeaderParser parser;
+    for (const std::vector<uint8_t>& frame : frames_) {
+      if (!parser.ParseUncompressedHeader(frame.data(), frame.size()))
+        return false;
+    }
+    // Only the headers are read, so no throughput is reported.
+    state->frames = static_cast<int64_t>(frames_.size());
+    return true;
+  }
+
+ private:
+  std::vector<std::vector<uint8_t>> frames_;
+};
+
+//
+// Runner.
+//
+
+std::vector<std::unique_ptr<Benchmark>> CreateBenchmarks() {
+  std::vector<std::unique_ptr<Benchmark>> benchmarks;
+  benchmarks.emplace_back(new ReadUIntBenchmark(false));
+  benchmarks.emplace_back(new ReadUIntBenchmark(true));
+  benchmarks.emplace_back(new ClusterLoadBenchmark());
+  benchmarks.emplace_back(new SeekBenchmark(false));
+  benchmarks.emplace_back(new SeekBenchmark(true));
+#ifdef LIBWEBM_BENCHMARK_WEBM_PARSER
+  benchmarks.emplace_back(new WebmParserFeedBenchmark());
+#endif
+  for (const size_t frame_size : {100, 4000, 100000, 1000000})
+    benchmarks.emplace_back(new AddFrameBenchmark(frame_size));
+  benchmarks.emplace_back(new FinalizeBenchmark());
+#ifdef LIBWEBM_BENCHMARK_WEBMTS
+  benchmarks.emplace_back(new Webm2PesBenchmark());
+#endif
+  benchmarks.emplace_back(new Vp9HeaderParserBenchmark());
+  return benchmarks;
+}
+
+// Runs |benchmark| for |options.repetitions| repetitions of at least
+// |options.min_time| seconds each, and prints the median repetition.
+bool RunBenchmark(Benchmark* benchmark, const Options& options) {
+  if (!benchmark->SetUp(options)) {
+    fprintf(stderr, "%s: SetUp failed.\n", benchmark->name().c_str());
+    return false;
+  }
+
+  // Warm up caches and allocators.
+  State warm_up;
+  if (!benchmark->Run(&warm_up)) {
+    fprintf(stderr, "%s: Run failed.\n", benchmark->name().c_str());
+    return false;
+  }
+
+  struct Repetition {
+    double seconds_per_iteration;
+    int64_t iterations;
+  };
+  std::vector<Repetition> repetitions;
+  const std::chrono::duration<double> min_time(options.min_time);
+  for (int r = 0; r < options.repetitions; ++r) {
+    Repetition repetition = {0, 0};
+    Clock::duration elapsed = Clock::duration::zero();
+    do {
+      State state;
+      const Clock::time_point start = Clock::now();
+      if (!benchmark->Run(&state))
+        return false;
+      elapsed += Clock::now() - start - state.paused();
+      ++repetition.iterations;
+    } while (elapsed < min_time);
+    repetition.seconds_per_iteration =
+        std::chrono::duration<double>(elapsed).count() /
+        repetition.iterations;
+    repetitions.push_back(repetition);
+  }
+
+  std::sort(repetitions.begin(), repetitions.end(),
+            [](const Repetition& a, const Repetition& b) {
+              return a.seconds_per_iteration < b.seconds_per_iteration;
+            });
+  const Repetition& median = repetitions[repetitions.size() / 2];
+  const double seconds = median.seconds_per_iteration;
+
+  printf("%-46s %8" PRId64 " %12.1f", benchmark->name().c_str(),
+         median.iterations, seconds * 1e6);
+  if (warm_up.bytes > 0)
+    printf(" %10.1f MB/s", warm_up.bytes / seconds / 1e6);
+  else
+    printf(" %15s", "");
+  if (warm_up.frames > 0)
+    printf(" %12.0f %s", warm_up.frames / seconds, benchmark->frames_label());
+  printf("\n");
+  fflush(stdout);
+  return true;
+}
+
+void Usage() {
+  printf("Usage: libwebm_benchmarks [options]\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("  -h | -?               show help\n");
+  printf("  -list                 List the benchmarks\n");
+  printf("  -filter <substring>   Run the benchmarks whose name contains\n");
+  printf("                        <substring>\n");
+  printf("  -min_time <seconds>   Minimum time of a repetition (0.5)\n");
+  printf("  -repetitions <n>      Repetitions, the median is reported (5)\n");
+  printf("  -duration <seconds>   Duration of the synthetic files (60)\n");
+  printf("  -input <file>         Use <file> instead of the synthetic file\n");
+  printf("                        in the parser and PES benchmarks\n");
+  printf("  -seed <n>             Seed of the synthetic content (1)\n");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+
+  const int argc_check = argc - 1;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp("-h", argv[i]) || !strcmp("-?", argv[i])) {
+      Usage();
+      return EXIT_SUCCESS;
+    } else if (!strcmp("-list", argv[i])) {
+      options.list = true;
+    } else if (!strcmp("-filter", argv[i]) && i < argc_check) {
+      options.filter = argv[++i];
+    } else if (!strcmp("-min_time", argv[i]) && i < argc_check) {
+      options.min_time = strtod(argv[++i], NULL);
+    } else if (!strcmp("-repetitions", argv[i]) && i < argc_check) {
+      options.repetitions = std::max(1, atoi(argv[++i]));
+    } else if (!strcmp("-duration", argv[i]) && i < argc_check) {
+      options.duration = std::max(1.0, strtod(argv[++i], NULL));
+    } else if (!strcmp("-input", argv[i]) && i < argc_check) {
+      options.input = argv[++i];
+    } else if (!strcmp("-seed", argv[i]) && i < argc_check) {
+      options.seed = static_cast<uint32_t>(strtoul(argv[++i], NULL, 10));
+    } else {
+      Usage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  bool ok = true;
+  if (!options.list) {
+    printf("%-46s %8s %12s %15s %12s\n", "Benchmark", "Iters", "us/iter",
+           "Throughput", "Rate");
+  }
+  for (const std::unique_ptr<Benchmark>& benchmark : CreateBenchmarks()) {
+    if (benchmark->name().find(options.filter) == std::string::npos)
+      continue;
+    if (options.list)
+      printf("%s\n", benchmark->name().c_str());
+    else
+      ok = RunBenchmark(benchmark.get(), options) && ok;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
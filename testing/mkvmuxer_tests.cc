@@ -14,19 +14,27 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
 #include "common/file_util.h"
+#include "common/io_stats.h"
 #include "common/libwebm_util.h"
+#include "mkvmuxer/mkvbatchmuxer.h"
+#include "mkvmuxer/mkvencrypt.h"
 #include "mkvmuxer/mkvmuxer.h"
 #include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvdecrypt.h"
 #include "mkvparser/mkvreader.h"
+#include "testing/synthetic_webm.h"
 #include "testing/test_util.h"
 
 using mkvmuxer::AudioTrack;
+using mkvmuxer::BatchMuxer;
 using mkvmuxer::Chapter;
 using mkvmuxer::Frame;
+using mkvmuxer::FrameEncryptor;
 using mkvmuxer::MkvWriter;
 using mkvmuxer::Segment;
 using mkvmuxer::SegmentInfo;
@@ -469,6 +477,42 @@ TEST_F(MuxerTest, OutputCues) {
   EXPECT_TRUE(CompareFiles(GetTestFilePath("output_cues.webm"), filename_));
 }
 
+TEST_F(MuxerTest, InstrumentedWriter) {
+  libwebm::InstrumentedMkvWriter instrumented_writer(writer_.get());
+  Segment segment;
+  ASSERT_TRUE(segment.Init(&instrumented_writer));
+  segment.GetSegmentInfo()->set_writing_app(kAppString);
+  segment.GetSegmentInfo()->set_muxing_app(kAppString);
+  ASSERT_EQ(kVideoTrackNumber,
+            static_cast<int>(segment.AddVideoTrack(kWidth, kHeight,
+                                                   kVideoTrackNumber)));
+  segment.GetTrackByNumber(kVideoTrackNumber)->set_uid(kVideoTrackNumber);
+
+  EXPECT_TRUE(
+      segment.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber, 0, true));
+  EXPECT_TRUE(segment.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                               2000000, false));
+  EXPECT_TRUE(segment.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                               4000000, false));
+  EXPECT_TRUE(segment.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                               6000000, true));
+  EXPECT_TRUE(segment.AddCuePoint(4000000, kVideoTrackNumber));
+  EXPECT_GT(instrumented_writer.stats().writes, 0);
+  EXPECT_GE(instrumented_writer.stats().bytes_written, writer_->Position());
+
+  instrumented_writer.mutable_stats()->Reset();
+  EXPECT_TRUE(segment.Finalize());
+  CloseWriter();
+
+  // Finalize() goes back to write the sizes, SeekHead and duration.
+  const libwebm::IoStats& stats = instrumented_writer.stats();
+  EXPECT_GT(stats.writes, 0);
+  EXPECT_GT(stats.back_seeks, 0);
+  EXPECT_GE(stats.seeks, stats.back_seeks);
+  EXPECT_EQ(0, stats.errors);
+  EXPECT_TRUE(CompareFiles(GetTestFilePath("output_cues.webm"), filename_));
+}
+
 TEST_F(MuxerTest, CuesBeforeClusters) {
   EXPECT_TRUE(SegmentInit(true, false, false));
   AddVideoTrack();
@@ -561,6 +605,409 @@ TEST_F(MuxerTest, MaxClusterDuration) {
       CompareFiles(GetTestFilePath("max_cluster_duration.webm"), filename_));
 }
 
+TEST_F(MuxerTest, BatchMaxClusterSize) {
+  EXPECT_TRUE(SegmentInit(false, false, false));
+  AddVideoTrack();
+  segment_.set_max_cluster_size(20);
+
+  BatchMuxer batch(&segment_);
+  batch.set_num_threads(2);
+  EXPECT_TRUE(batch.AddFrame(dummy_data_, 1, kVideoTrackNumber, 0, false));
+  EXPECT_TRUE(
+      batch.AddFrame(dummy_data_, 1, kVideoTrackNumber, 2000000, false));
+  EXPECT_TRUE(
+      batch.AddFrame(dummy_data_, 1, kVideoTrackNumber, 4000000, false));
+  EXPECT_TRUE(batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                             6000000, false));
+  EXPECT_TRUE(batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                             8000000, false));
+  EXPECT_TRUE(batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                             9000000, false));
+  EXPECT_FALSE(batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                              8000000, false));
+  EXPECT_TRUE(batch.Finalize());
+  EXPECT_EQ(3, batch.clusters_written());
+
+  CloseWriter();
+
+  EXPECT_TRUE(
+      CompareFiles(GetTestFilePath("max_cluster_size.webm"), filename_));
+}
+
+TEST_F(MuxerTest, BatchMaxClusterDuration) {
+  EXPECT_TRUE(SegmentInit(false, false, false));
+  AddVideoTrack();
+  segment_.set_max_cluster_duration(4000000);
+
+  BatchMuxer batch(&segment_);
+  const std::array<std::uint64_t, 6> timestamps = {
+      {0, 2000000, 4000000, 6000000, 8000000, 9000000}};
+  for (const std::uint64_t timestamp : timestamps) {
+    EXPECT_TRUE(batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber,
+                               timestamp, false));
+  }
+  EXPECT_TRUE(batch.Finalize());
+
+  CloseWriter();
+
+  EXPECT_TRUE(
+      CompareFiles(GetTestFilePath("max_cluster_duration.webm"), filename_));
+}
+
+TEST_F(MuxerTest, BatchLacedTrack) {
+  EXPECT_TRUE(SegmentInit(false, false, false));
+  AddVideoTrack();
+  AddAudioTrack();
+  segment_.GetTrackByNumber(kAudioTrackNumber)
+      ->set_lacing(mkvmuxer::kXiphLacing);
+
+  // BatchMuxer does not build laces, so it refuses laced tracks rather than
+  // writing output that differs from the Segment's.
+  BatchMuxer batch(&segment_);
+  EXPECT_TRUE(
+      batch.AddFrame(dummy_data_, kFrameLength, kVideoTrackNumber, 0, true));
+  EXPECT_TRUE(
+      batch.AddFrame(dummy_data_, kFrameLength, kAudioTrackNumber, 0, true));
+  EXPECT_TRUE(batch.AddFrame(dummy_data_, kFrameLength, kAudioTrackNumber,
+                             2000000, true));
+  EXPECT_FALSE(batch.Finalize());
+  EXPECT_EQ(0, batch.clusters_written());
+
+  segment_.GetTrackByNumber(kAudioTrackNumber)
+      ->set_lacing(mkvmuxer::kNoLacing);
+  EXPECT_TRUE(batch.Finalize());
+  EXPECT_EQ(1, batch.clusters_written());
+}
+
+const std::uint8_t kKeyId[] = {'k', 'e', 'y'};
+const std::uint8_t kKey[16] = {1, 2,  3,  4,  5,  6,  7,  8,
+                               9, 10, 11, 12, 13, 14, 15, 16};
+
+// Muxes interleaved audio and video with Segment, or with BatchMuxer when
+// |num_threads| is positive, to |filename|. With |encrypt| the video track
+// is encrypted, every other frame with partitions.
+bool MuxAudioVideo(const std::string& filename, int num_threads,
+                   bool accurate_cluster_duration, bool encrypt = false) {
+  MkvWriter writer;
+  Segment segment;
+  if (!writer.Open(filename.c_str()) || !segment.Init(&writer))
+    return false;
+
+  segment.GetSegmentInfo()->set_writing_app(kAppString);
+  segment.GetSegmentInfo()->set_muxing_app(kAppString);
+  segment.AccurateClusterDuration(accurate_cluster_duration);
+  segment.set_max_cluster_size(4000);
+  if (segment.AddVideoTrack(kWidth, kHeight, kVideoTrackNumber) == 0 ||
+      segment.AddAudioTrack(kSampleRate, kChannels, kAudioTrackNumber) == 0) {
+    return false;
+  }
+  segment.GetTrackByNumber(kVideoTrackNumber)->set_uid(kVideoTrackNumber);
+  segment.GetTrackByNumber(kAudioTrackNumber)->set_uid(kAudioTrackNumber);
+
+  FrameEncryptor encryptor;
+  encryptor.set_next_iv(0x0123456789abcdefULL);
+  if (encrypt) {
+    if (!encryptor.AddTrack(segment.GetTrackByNumber(kVideoTrackNumber),
+                            kKeyId, sizeof(kKeyId), kKey, sizeof(kKey))) {
+      return false;
+    }
+    segment.set_frame_encryptor(&encryptor);
+  }
+
+  BatchMuxer batch(&segment);
+  batch.set_num_threads(num_threads);
+
+  // 30 fps video with a key frame every second, and 20 ms audio frames.
+  const int kVideoFrames = 100;
+  const int kAudioFrames = 165;
+  std::uint8_t data[600];
+  int video_index = 0;
+  int audio_index = 0;
+  while (video_index < kVideoFrames || audio_index < kAudioFrames) {
+    const std::uint64_t video_timestamp = video_index * 33333333ULL;
+    const std::uint64_t audio_timestamp = audio_index * 20000000ULL;
+    const bool video =
+        audio_index == kAudioFrames ||
+        (video_index < kVideoFrames && video_timestamp <= audio_timestamp);
+    const int index = video ? video_index++ : audio_index++;
+    const int size = video ? 100 + (index * 7) % 500 : 40 + index % 13;
+    memset(data, index & 0xff, size);
+
+    Frame frame;
+    if (!frame.Init(data, size))
+      return false;
+    frame.set_track_number(video ? kVideoTrackNumber : kAudioTrackNumber);
+    frame.set_timestamp(video ? video_timestamp : audio_timestamp);
+    frame.set_is_key(!video || index % 30 == 0);
+    if (!video && audio_index == kAudioFrames)
+      frame.set_duration(20000000);
+    const std::uint32_t partitions[] = {16, 32, 50};
+    if (video && index % 2 == 1 &&
+        !frame.SetEncryptionPartitions(partitions, 3)) {
+      return false;
+    }
+
+    const bool added = num_threads > 0 ? batch.AddGenericFrame(&frame)
+                                       : segment.AddGenericFrame(&frame);
+    if (!added)
+      return false;
+  }
+
+  const bool finalized =
+      num_threads > 0 ? batch.Finalize() : segment.Finalize();
+  writer.Close();
+  return finalized;
+}
+
+TEST_F(MuxerTest, BatchMatchesSegment) {
+  CloseWriter();
+
+  const libwebm::TempFileDeleter batch_file;
+  const std::string& batch_filename = batch_file.name();
+
+  for (const bool accurate_cluster_duration : {false, true}) {
+    ASSERT_TRUE(MuxAudioVideo(filename_, 0, accurate_cluster_duration));
+    for (const int num_threads : {1, 3}) {
+      ASSERT_TRUE(MuxAudioVideo(batch_filename, num_threads,
+                                accurate_cluster_duration));
+      EXPECT_TRUE(CompareFiles(filename_, batch_filename))
+          << "accurate_cluster_duration: " << accurate_cluster_duration
+          << " num_threads: " << num_threads;
+    }
+  }
+
+  MkvParser parser;
+  ASSERT_TRUE(ParseMkvFileReleaseParser(batch_filename, &parser));
+  EXPECT_TRUE(ValidateCues(parser.segment, parser.reader));
+  EXPECT_GT(parser.segment->GetCount(), 5);
+}
+
+// Size of audio frame |index| muxed by MuxLacedAudio().
+int LacedAudioFrameSize(mkvmuxer::Lacing lacing, int index) {
+  if (lacing == mkvmuxer::kFixedSizeLacing)
+    return 40;
+  return index % 7 == 3 ? 600 : 40 + index % 13;
+}
+
+// Muxes 20 ms audio frames laced with |lacing|, at most 4 to a lace. Frame 20
+// has discard padding and the last frame a duration, so they are not laced.
+// With |estimate_duration| the last frame has no duration and may be laced,
+// and the Segment estimates its duration from the frames written.
+bool MuxLacedAudio(const std::string& filename, mkvmuxer::Lacing lacing,
+                   int frame_count, bool estimate_duration) {
+  MkvWriter writer;
+  Segment segment;
+  if (!writer.Open(filename.c_str()) || !segment.Init(&writer))
+    return false;
+
+  segment.GetSegmentInfo()->set_writing_app(kAppString);
+  segment.GetSegmentInfo()->set_muxing_app(kAppString);
+  segment.set_estimate_file_duration(estimate_duration);
+  if (segment.AddAudioTrack(kSampleRate, kChannels, kAudioTrackNumber) == 0)
+    return false;
+  Track* const track = segment.GetTrackByNumber(kAudioTrackNumber);
+  track->set_uid(kAudioTrackNumber);
+  track->set_lacing(lacing);
+  track->set_max_lace_frames(5);
+  track->set_max_lace_duration(60000000);
+
+  std::uint8_t data[600];
+  for (int index = 0; index < frame_count; ++index) {
+    const int size = LacedAudioFrameSize(lacing, index);
+    memset(data, index & 0xff, size);
+
+    Frame frame;
+    if (!frame.Init(data, size))
+      return false;
+    frame.set_track_number(kAudioTrackNumber);
+    frame.set_timestamp(index * 20000000ULL);
+    frame.set_is_key(true);
+    if (index == 20)
+      frame.set_discard_padding(1000);
+    if (index == frame_count - 1 && !estimate_duration)
+      frame.set_duration(20000000);
+    if (!segment.AddGenericFrame(&frame))
+      return false;
+  }
+
+  const bool finalized = segment.Finalize();
+  writer.Close();
+  return finalized;
+}
+
+TEST_F(MuxerTest, Lacing) {
+  CloseWriter();
+
+  const int kFrameCount = 50;
+
+  for (const mkvmuxer::Lacing lacing :
+       {mkvmuxer::kXiphLacing, mkvmuxer::kFixedSizeLacing,
+        mkvmuxer::kEbmlLacing}) {
+    ASSERT_TRUE(MuxLacedAudio(filename_, lacing, kFrameCount, false));
+
+    MkvParser parser;
+    ASSERT_TRUE(ParseMkvFileReleaseParser(filename_, &parser));
+    const mkvparser::Track* const track =
+        parser.segment->GetTracks()->GetTrackByNumber(kAudioTrackNumber);
+    ASSERT_TRUE(track != NULL);
+    EXPECT_TRUE(track->GetLacing());
+
+    // Every frame comes back in order, and the laces hold up to 4 frames.
+    int index = 0;
+    int laces = 0;
+    std::vector<unsigned char> data;
+    for (const mkvparser::Cluster* cluster = parser.segment->GetFirst();
+         cluster != NULL && !cluster->EOS();
+         cluster = parser.segment->GetNext(cluster)) {
+      const mkvparser::BlockEntry* entry = NULL;
+      ASSERT_EQ(0, cluster->GetFirst(entry));
+      for (; entry != NULL && !entry->EOS(); cluster->GetNext(entry, entry)) {
+        const mkvparser::Block* const block = entry->GetBlock();
+        const int count = block->GetFrameCount();
+        ASSERT_LE(count, 4);
+        if (count > 1) {
+          ++laces;
+          EXPECT_EQ(static_cast<int>(lacing), block->GetLacing());
+        }
+        EXPECT_EQ(index * 20000000LL, block->GetTime(cluster));
+        for (int i = 0; i < count; ++i, ++index) {
+          const mkvparser::Block::Frame& frame = block->GetFrame(i);
+          ASSERT_EQ(LacedAudioFrameSize(lacing, index), frame.len) << index;
+          data.resize(frame.len);
+          ASSERT_EQ(0, frame.Read(parser.reader, &data[0]));
+          for (long j = 0; j < frame.len; ++j)
+            ASSERT_EQ(index & 0xff, data[j]) << index;
+        }
+      }
+    }
+    EXPECT_EQ(kFrameCount, index);
+    EXPECT_GE(laces, 10) << "lacing: " << lacing;
+  }
+
+  // Laced frames count towards the Segment duration, including its estimate
+  // for a last frame without a duration, exactly as unlaced frames do. With
+  // one more frame the last lace holds two frames.
+  for (const bool estimate_duration : {false, true}) {
+    ASSERT_TRUE(MuxLacedAudio(filename_, mkvmuxer::kNoLacing, kFrameCount + 1,
+                              estimate_duration));
+    MkvParser unlaced_parser;
+    ASSERT_TRUE(ParseMkvFileReleaseParser(filename_, &unlaced_parser));
+    const long long unlaced_duration = unlaced_parser.segment->GetDuration();
+    EXPECT_GE(unlaced_duration, kFrameCount * 20000000LL);
+
+    for (const mkvmuxer::Lacing lacing :
+         {mkvmuxer::kXiphLacing, mkvmuxer::kFixedSizeLacing,
+          mkvmuxer::kEbmlLacing}) {
+      ASSERT_TRUE(MuxLacedAudio(filename_, lacing, kFrameCount + 1,
+                                estimate_duration));
+      MkvParser parser;
+      ASSERT_TRUE(ParseMkvFileReleaseParser(filename_, &parser));
+      EXPECT_EQ(unlaced_duration, parser.segment->GetDuration())
+          << "lacing: " << lacing << " estimate: " << estimate_duration;
+    }
+  }
+}
+
+TEST_F(MuxerTest, SyntheticWebmDeterministic) {
+  CloseWriter();
+
+  libwebm::SyntheticWebmConfig config;
+  config.seed = 7;
+  config.duration_seconds = 2;
+  config.keyframe_interval = 15;
+  config.keyframe_size = 2000;
+  config.frame_size = 500;
+  config.audio_frame_ms = 10;
+  config.lacing = {mkvmuxer::kNoLacing, mkvmuxer::kEbmlLacing};
+
+  // The same config and seed give the same bytes.
+  const libwebm::TempFileDeleter second_file;
+  for (const std::string& name : {filename_, second_file.name()}) {
+    MkvWriter writer;
+    ASSERT_TRUE(writer.Open(name.c_str()));
+    ASSERT_TRUE(libwebm::WriteSyntheticWebm(config, &writer));
+    writer.Close();
+  }
+  EXPECT_TRUE(CompareFiles(filename_, second_file.name()));
+
+  // The audio frames between video frames are laced, the video is not.
+  MkvParser parser;
+  ASSERT_TRUE(ParseMkvFileReleaseParser(filename_, &parser));
+  int laces[3] = {0, 0, 0};
+  for (const mkvparser::Cluster* cluster = parser.segment->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = parser.segment->GetNext(cluster)) {
+    const mkvparser::BlockEntry* entry = NULL;
+    ASSERT_EQ(0, cluster->GetFirst(entry));
+    for (; entry != NULL && !entry->EOS(); cluster->GetNext(entry, entry)) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      if (block->GetFrameCount() > 1) {
+        EXPECT_EQ(static_cast<int>(mkvmuxer::kEbmlLacing), block->GetLacing());
+        ++laces[block->GetTrackNumber()];
+      }
+    }
+  }
+  EXPECT_EQ(0, laces[1]);
+  EXPECT_GT(laces[2], 0);
+
+  // A different seed gives a different file.
+  config.seed = 8;
+  MkvWriter writer;
+  ASSERT_TRUE(writer.Open(second_file.name().c_str()));
+  ASSERT_TRUE(libwebm::WriteSyntheticWebm(config, &writer));
+  writer.Close();
+  EXPECT_FALSE(CompareFiles(filename_, second_file.name()));
+}
+
+TEST_F(MuxerTest, EncryptedFrames) {
+  CloseWriter();
+
+  const libwebm::TempFileDeleter batch_file;
+  const std::string& batch_filename = batch_file.name();
+  ASSERT_TRUE(MuxAudioVideo(filename_, 0, false, true));
+  ASSERT_TRUE(MuxAudioVideo(batch_filename, 2, false, true));
+  EXPECT_TRUE(CompareFiles(filename_, batch_filename));
+
+  MkvParser parser;
+  ASSERT_TRUE(ParseMkvFileReleaseParser(filename_, &parser));
+  const mkvparser::Tracks* const tracks = parser.segment->GetTracks();
+  const mkvparser::Track* const video_track =
+      tracks->GetTrackByNumber(kVideoTrackNumber);
+  ASSERT_TRUE(mkvparser::FrameDecryptor::IsEncrypted(video_track));
+  EXPECT_FALSE(mkvparser::FrameDecryptor::IsEncrypted(
+      tracks->GetTrackByNumber(kAudioTrackNumber)));
+
+  mkvparser::FrameDecryptor decryptor(parser.segment);
+  ASSERT_EQ(0, decryptor.AddKey(kKeyId, sizeof(kKeyId), kKey, sizeof(kKey)));
+
+  // Every video frame is encrypted, and decrypts to the frame muxed.
+  int video_index = 0;
+  std::vector<unsigned char> data;
+  for (const mkvparser::Cluster* cluster = parser.segment->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = parser.segment->GetNext(cluster)) {
+    const mkvparser::BlockEntry* entry = NULL;
+    ASSERT_EQ(0, cluster->GetFirst(entry));
+    for (; entry != NULL && !entry->EOS(); cluster->GetNext(entry, entry)) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      if (block->GetTrackNumber() != kVideoTrackNumber)
+        continue;
+      const mkvparser::Block::Frame& frame = block->GetFrame(0);
+      data.resize(frame.len);
+      ASSERT_EQ(0, frame.Read(parser.reader, &data[0]));
+      EXPECT_EQ(video_index % 2 == 1 ? 0x03 : 0x01, data[0]);
+      long offset = 0, size = 0;
+      ASSERT_EQ(0, decryptor.DecryptFrame(video_track, &data[0], frame.len,
+                                          offset, size));
+      ASSERT_EQ(100 + (video_index * 7) % 500, size);
+      for (long i = 0; i < size; ++i)
+        ASSERT_EQ(video_index & 0xff, data[offset + i]) << video_index;
+      ++video_index;
+    }
+  }
+  EXPECT_EQ(100, video_index);
+}
+
 TEST_F(MuxerTest, SetCuesTrackNumber) {
   const uint64_t kTrackNumber = 10;
   EXPECT_TRUE(SegmentInit(true, false, false));
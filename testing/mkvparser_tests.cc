@@ -7,18 +7,34 @@
 // be found in the AUTHORS file in the root of the source tree.
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <iomanip>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "common/aes_ctr.h"
+#include "common/file_util.h"
 #include "common/hdr_util.h"
+#include "mkvmuxer/mkvmuxer.h"
+#include "mkvmuxer/mkvwriter.h"
+#include "mkvparser/mkvdecompress.h"
+#include "mkvparser/mkvdecrypt.h"
 #include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvrange.h"
 #include "mkvparser/mkvreader.h"
+#include "mkvparser/mkvresync.h"
 #include "testing/test_util.h"
 
+#ifdef LIBWEBM_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 using mkvparser::AudioTrack;
 using mkvparser::Block;
 using mkvparser::BlockEntry;
@@ -26,6 +42,8 @@ using mkvparser::BlockGroup;
 using mkvparser::Cluster;
 using mkvparser::CuePoint;
 using mkvparser::Cues;
+using mkvparser::FrameDecompressor;
+using mkvparser::FrameDecryptor;
 using mkvparser::MkvReader;
 using mkvparser::Segment;
 using mkvparser::SegmentInfo;
@@ -261,6 +279,27 @@ TEST_F(ParserTest, MultipleClusters) {
   EXPECT_TRUE(cluster->EOS());
 }
 
+TEST_F(ParserTest, LazyFrameParsing) {
+  ASSERT_NO_FATAL_FAILURE(CreateSegmentNoHeaderChecks("simple_block.webm"));
+  segment_->SetLazyFrameParsing(true);
+  ASSERT_EQ(0, segment_->Load());
+
+  const Cluster* cluster = segment_->GetFirst();
+  ASSERT_TRUE(cluster != NULL);
+  EXPECT_FALSE(cluster->EOS());
+
+  const BlockEntry* block_entry;
+  EXPECT_EQ(0, cluster->GetFirst(block_entry));
+  ASSERT_TRUE(block_entry != NULL);
+  CompareBlockContents(cluster, block_entry->GetBlock(), 0, kVideoTrackNumber,
+                       false, 1);
+
+  EXPECT_EQ(0, cluster->GetNext(block_entry, block_entry));
+  ASSERT_TRUE(block_entry != NULL);
+  CompareBlockContents(cluster, block_entry->GetBlock(), 2000000,
+                       kVideoTrackNumber, false, 1);
+}
+
 TEST_F(ParserTest, BlockGroup) {
   ASSERT_TRUE(CreateAndLoadSegment("metadata_block.webm"));
   const unsigned int kTracksCount = 1;
@@ -500,6 +539,850 @@ TEST_F(ParserTest, Opus) {
   EXPECT_TRUE(cluster->EOS());
 }
 
+TEST_F(ParserTest, ReadFramesBatched) {
+  ASSERT_TRUE(CreateAndLoadSegment("bbb_480p_vp9_opus_1second.webm", 4));
+
+  const long kMaxFrames = 8;
+  const long kBufferLength = 64 * 1024;
+  std::vector<unsigned char> buffer(kBufferLength);
+  std::vector<unsigned char> frame_data;
+  Cluster::FrameDescriptor frames[kMaxFrames];
+
+  int total_frames = 0;
+  for (const Cluster* cluster = segment_->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = segment_->GetNext(cluster)) {
+    long index = 0;
+    for (;;) {
+      long frame_count = 0;
+      long len = 0;
+      ASSERT_EQ(0,
+                cluster->ReadFrames(index, kMaxFrames, &buffer[0],
+                                    kBufferLength, frames, frame_count, len));
+      if (frame_count == 0)
+        break;
+      ASSERT_LE(frame_count, kMaxFrames);
+      ASSERT_LE(len, kBufferLength);
+      EXPECT_EQ(frames[frame_count - 1].offset + frames[frame_count - 1].len,
+                len);
+
+      for (long i = 0; i < frame_count; ++i) {
+        const Cluster::FrameDescriptor& d = frames[i];
+        ASSERT_TRUE(d.entry != NULL);
+        const Block::Frame& frame = d.entry->GetBlock()->GetFrame(
+            d.frame_index);
+        ASSERT_EQ(frame.len, d.len);
+        ASSERT_LE(d.offset + d.len, kBufferLength);
+        frame_data.resize(frame.len);
+        ASSERT_EQ(0, frame.Read(&reader_, &frame_data[0]));
+        EXPECT_EQ(0, std::memcmp(&frame_data[0], &buffer[d.offset], d.len));
+      }
+      total_frames += frame_count;
+      index = frames[frame_count - 1].entry->GetIndex() + 1;
+    }
+    EXPECT_EQ(cluster->GetEntryCount(), index);
+  }
+  EXPECT_GT(total_frames, 0);
+}
+
+TEST_F(ParserTest, ReadFramesBufferTooSmall) {
+  ASSERT_TRUE(CreateAndLoadSegment("bbb_480p_vp9_opus_1second.webm", 4));
+  const Cluster* const cluster = segment_->GetFirst();
+  ASSERT_TRUE(cluster != NULL && !cluster->EOS());
+
+  // The first entry does not fit: nothing is read, and the sizes it needs
+  // are reported rather than an empty read that looks like the end.
+  const long kMaxFrames = 8;
+  std::vector<unsigned char> buffer(1);
+  Cluster::FrameDescriptor frames[kMaxFrames];
+  long frame_count = 0;
+  long len = 0;
+  ASSERT_EQ(mkvparser::E_BUFFER_NOT_FULL,
+            cluster->ReadFrames(0, kMaxFrames, &buffer[0], 1, frames,
+                                frame_count, len));
+  ASSERT_GT(frame_count, 0);
+  ASSERT_GT(len, 1);
+
+  // Reading again with exactly what was reported takes that entry alone.
+  const long needed_frames = frame_count;
+  const long needed_len = len;
+  buffer.resize(needed_len);
+  ASSERT_EQ(0, cluster->ReadFrames(0, needed_frames, &buffer[0], needed_len,
+                                   frames, frame_count, len));
+  EXPECT_EQ(needed_frames, frame_count);
+  EXPECT_EQ(needed_len, len);
+  const BlockEntry* first = NULL;
+  ASSERT_EQ(0, cluster->GetFirst(first));
+  EXPECT_EQ(first, frames[0].entry);
+  EXPECT_EQ(first, frames[frame_count - 1].entry);
+}
+
+TEST_F(ParserTest, DecryptFrames) {
+  const std::uint8_t kKeyId[] = {'k', 'e', 'y', '1'};
+  const std::uint8_t kKey[16] = {1, 2,  3,  4,  5,  6,  7,  8,
+                                 9, 10, 11, 12, 13, 14, 15, 16};
+  libwebm::AesCtr aes;
+  ASSERT_TRUE(aes.Init(kKey, sizeof(kKey)));
+
+  // Encrypted video frames: plain, fully encrypted and partitioned, along
+  // with unencrypted audio frames.
+  const int kFrameCount = 12;
+  std::vector<std::vector<std::uint8_t>> plain_frames;
+  const libwebm::TempFileDeleter temp_file;
+  {
+    mkvmuxer::MkvWriter writer;
+    ASSERT_TRUE(writer.Open(temp_file.name().c_str()));
+    mkvmuxer::Segment muxer_segment;
+    ASSERT_TRUE(muxer_segment.Init(&writer));
+    const std::uint64_t video = muxer_segment.AddVideoTrack(64, 64, 1);
+    const std::uint64_t audio = muxer_segment.AddAudioTrack(48000, 2, 2);
+    ASSERT_NE(0u, video);
+    ASSERT_NE(0u, audio);
+    mkvmuxer::Track* const video_track = muxer_segment.GetTrackByNumber(video);
+    ASSERT_TRUE(video_track->AddContentEncoding());
+    ASSERT_TRUE(video_track->GetContentEncodingByIndex(0)->SetEncryptionID(
+        kKeyId, sizeof(kKeyId)));
+
+    for (int i = 0; i < kFrameCount; ++i) {
+      std::vector<std::uint8_t> plain(100 + i * 37);
+      for (size_t j = 0; j < plain.size(); ++j)
+        plain[j] = static_cast<std::uint8_t>(i + j * 7);
+      plain_frames.push_back(plain);
+
+      std::vector<std::uint8_t> frame;
+      if (i % 2 == 1) {
+        frame = plain;  // audio
+      } else if (i % 3 == 0) {
+        frame.push_back(0x00);
+        frame.insert(frame.end(), plain.begin(), plain.end());
+      } else {
+        std::uint8_t counter[libwebm::AesCtr::kBlockSize] = {};
+        for (int j = 0; j < 8; ++j)
+          counter[j] = static_cast<std::uint8_t>(i * 16 + j);
+        std::vector<std::uint8_t> data = plain;
+        const bool partitioned = i % 4 == 0;
+        frame.push_back(partitioned ? 0x03 : 0x01);
+        frame.insert(frame.end(), counter, counter + 8);
+        if (partitioned) {
+          // Clear [0, 10), encrypted [10, 50), clear [50, 60), encrypted
+          // from 60 on.
+          const std::uint8_t boundaries[] = {10, 50, 60};
+          frame.push_back(3);
+          for (const std::uint8_t boundary : boundaries) {
+            const std::uint8_t offset[4] = {0, 0, 0, boundary};
+            frame.insert(frame.end(), offset, offset + 4);
+          }
+          const libwebm::AesCtr::Range ranges[] = {
+              {counter, 0, &data[10], 40},
+              {counter, 40, &data[60], data.size() - 60},
+          };
+          aes.Apply(ranges, 2);
+        } else {
+          aes.Apply(counter, data.data(), data.size());
+        }
+        frame.insert(frame.end(), data.begin(), data.end());
+      }
+
+      ASSERT_TRUE(muxer_segment.AddFrame(
+          frame.data(), frame.size(), i % 2 == 1 ? audio : video,
+          i * 10000000ULL, i % 2 == 1 || i == 0));
+    }
+    ASSERT_TRUE(muxer_segment.Finalize());
+    writer.Close();
+  }
+
+  MkvReader reader;
+  ASSERT_EQ(0, reader.Open(temp_file.name().c_str()));
+  long long pos = 0;
+  mkvparser::EBMLHeader ebml_header;
+  ASSERT_EQ(0, ebml_header.Parse(&reader, pos));
+  Segment* segment = NULL;
+  ASSERT_EQ(0, Segment::CreateInstance(&reader, pos, segment));
+  std::unique_ptr<Segment> segment_deleter(segment);
+  ASSERT_EQ(0, segment->Load());
+
+  const Tracks* const tracks = segment->GetTracks();
+  EXPECT_TRUE(FrameDecryptor::IsEncrypted(tracks->GetTrackByNumber(1)));
+  EXPECT_FALSE(FrameDecryptor::IsEncrypted(tracks->GetTrackByNumber(2)));
+
+  const long kBufferLength = 64 * 1024;
+  std::vector<unsigned char> buffer(kBufferLength);
+  Cluster::FrameDescriptor frames[kFrameCount];
+  const Cluster* const cluster = segment->GetFirst();
+  ASSERT_TRUE(cluster != NULL && !cluster->EOS());
+  long frame_count = 0;
+  long len = 0;
+  ASSERT_EQ(0, cluster->ReadFrames(0, kFrameCount, &buffer[0], kBufferLength,
+                                   frames, frame_count, len));
+  ASSERT_EQ(kFrameCount, frame_count);
+
+  // Without the key, encrypted frames can't be decrypted.
+  FrameDecryptor decryptor(segment);
+  EXPECT_EQ(mkvparser::E_PARSE_FAILED,
+            decryptor.DecryptFrames(&buffer[0], frames, frame_count));
+  ASSERT_EQ(0, decryptor.AddKey(kKeyId, sizeof(kKeyId), kKey, sizeof(kKey)));
+  EXPECT_EQ(-1, decryptor.AddKey(kKeyId, sizeof(kKeyId), kKey, sizeof(kKey)));
+
+  // Decrypt an encrypted frame alone, on a copy.
+  const Cluster::FrameDescriptor& d = frames[2];
+  std::vector<unsigned char> copy(&buffer[d.offset],
+                                  &buffer[d.offset] + d.len);
+  long offset = 0, size = 0;
+  ASSERT_EQ(0, decryptor.DecryptFrame(tracks->GetTrackByNumber(1), &copy[0],
+                                      d.len, offset, size));
+  ASSERT_EQ(plain_frames[2].size(), static_cast<size_t>(size));
+  EXPECT_EQ(0, std::memcmp(&plain_frames[2][0], &copy[offset], size));
+
+  // A malformed frame fails the batch before any frame is decrypted or any
+  // descriptor updated.
+  const long full_len = frames[10].len;
+  const long long frames_decrypted = decryptor.GetFrameCount();
+  frames[10].len = 4;
+  const std::vector<unsigned char> buffer_before(buffer);
+  Cluster::FrameDescriptor frames_before[kFrameCount];
+  std::copy(frames, frames + kFrameCount, frames_before);
+  EXPECT_EQ(mkvparser::E_FILE_FORMAT_INVALID,
+            decryptor.DecryptFrames(&buffer[0], frames, frame_count));
+  EXPECT_TRUE(buffer == buffer_before);
+  for (int i = 0; i < kFrameCount; ++i) {
+    EXPECT_EQ(frames_before[i].offset, frames[i].offset) << "frame " << i;
+    EXPECT_EQ(frames_before[i].len, frames[i].len) << "frame " << i;
+  }
+  EXPECT_EQ(frames_decrypted, decryptor.GetFrameCount());
+  frames[10].len = full_len;
+
+  ASSERT_EQ(0, decryptor.DecryptFrames(&buffer[0], frames, frame_count));
+  for (int i = 0; i < kFrameCount; ++i) {
+    ASSERT_EQ(plain_frames[i].size(), static_cast<size_t>(frames[i].len));
+    EXPECT_EQ(0, std::memcmp(&plain_frames[i][0], &buffer[frames[i].offset],
+                             frames[i].len))
+        << "frame " << i;
+  }
+  EXPECT_EQ(kFrameCount / 2 + 1, decryptor.GetFrameCount());
+
+  // A truncated encryption header is rejected.
+  unsigned char truncated[] = {0x01, 0, 0, 0};
+  EXPECT_EQ(mkvparser::E_FILE_FORMAT_INVALID,
+            decryptor.DecryptFrame(tracks->GetTrackByNumber(1), truncated,
+                                   sizeof(truncated), offset, size));
+}
+
+// Returns the EBML element |id| with |payload|, with an 8 byte size.
+std::vector<unsigned char> EbmlElement(
+    std::uint32_t id, const std::vector<unsigned char>& payload) {
+  std::vector<unsigned char> element;
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    if ((id >> shift) != 0)
+      element.push_back(static_cast<unsigned char>(id >> shift));
+  }
+  element.push_back(0x01);
+  for (int shift = 48; shift >= 0; shift -= 8)
+    element.push_back(static_cast<unsigned char>(payload.size() >> shift));
+  element.insert(element.end(), payload.begin(), payload.end());
+  return element;
+}
+
+std::vector<unsigned char> EbmlUInt(std::uint32_t id, unsigned char value) {
+  return EbmlElement(id, std::vector<unsigned char>(1, value));
+}
+
+std::vector<unsigned char>& operator+=(std::vector<unsigned char>& a,
+                                       const std::vector<unsigned char>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+// Returns a TrackEntry whose frames are compressed with |algo|.
+std::vector<unsigned char> CompressedTrack(
+    unsigned char number, unsigned char algo,
+    const std::vector<unsigned char>& settings) {
+  std::vector<unsigned char> compression = EbmlUInt(0x4254, algo);
+  if (!settings.empty())
+    compression += EbmlElement(0x4255, settings);
+  std::vector<unsigned char> encoding = EbmlUInt(0x5031, 0);
+  encoding += EbmlUInt(0x5032, 1);
+  encoding += EbmlUInt(0x5033, 0);
+  encoding += EbmlElement(0x5034, compression);
+
+  std::vector<unsigned char> track = EbmlUInt(0xD7, number);
+  track += EbmlUInt(0x73C5, number);
+  track += EbmlUInt(0x83, 1);
+  const std::string codec_id = "V_VP8";
+  track += EbmlElement(0x86, std::vector<unsigned char>(codec_id.begin(),
+                                                        codec_id.end()));
+  std::vector<unsigned char> video = EbmlUInt(0xB0, 16);
+  video += EbmlUInt(0xBA, 16);
+  track += EbmlElement(0xE0, video);
+  track += EbmlElement(0x6D80, EbmlElement(0x6240, encoding));
+  return EbmlElement(0xAE, track);
+}
+
+TEST_F(ParserTest, DecompressFrames) {
+  // Track 1 is header stripped, track 2 zlib compressed.
+  const std::vector<unsigned char> kPrefix = {0x9d, 0x01, 0x2a};
+  const int kFrameCount = 6;
+  std::vector<std::vector<unsigned char>> plain_frames;
+  std::vector<unsigned char> cluster = EbmlUInt(0xE7, 0);
+  for (int i = 0; i < kFrameCount; ++i) {
+    const unsigned char track_number = 1 + i % 2;
+    std::vector<unsigned char> plain(200 + i * 1000);
+    for (size_t j = 0; j < plain.size(); ++j)
+      plain[j] = static_cast<unsigned char>((j / 50) * i);
+    std::vector<unsigned char> stored;
+    if (track_number == 1) {
+      std::copy(kPrefix.begin(), kPrefix.end(), plain.begin());
+      stored.assign(plain.begin() + kPrefix.size(), plain.end());
+    } else {
+#ifdef LIBWEBM_HAVE_ZLIB
+      uLongf stored_len = compressBound(plain.size());
+      stored.resize(stored_len);
+      ASSERT_EQ(Z_OK, compress(&stored[0], &stored_len, &plain[0],
+                               plain.size()));
+      stored.resize(stored_len);
+#else
+      stored = plain;
+#endif
+    }
+    plain_frames.push_back(plain);
+
+    std::vector<unsigned char> block = {
+        static_cast<unsigned char>(0x80 | track_number), 0, 0, 0x80};
+    block += stored;
+    cluster += EbmlElement(0xA3, block);
+  }
+
+  std::vector<unsigned char> tracks = CompressedTrack(1, 3, kPrefix);
+  tracks += CompressedTrack(2, 0, std::vector<unsigned char>());
+  std::vector<unsigned char> segment_payload =
+      EbmlElement(0x1549A966, EbmlElement(0x2AD7B1, {0x0F, 0x42, 0x40}));
+  segment_payload += EbmlElement(0x1654AE6B, tracks);
+  segment_payload += EbmlElement(0x1F43B675, cluster);
+  std::vector<unsigned char> file =
+      EbmlElement(0x1A45DFA3, EbmlElement(0x4282, {'w', 'e', 'b', 'm'}));
+  file += EbmlElement(0x18538067, segment_payload);
+
+  const libwebm::TempFileDeleter temp_file;
+  FILE* const out = std::fopen(temp_file.name().c_str(), "wb");
+  ASSERT_TRUE(out != NULL);
+  ASSERT_EQ(file.size(), std::fwrite(&file[0], 1, file.size(), out));
+  std::fclose(out);
+
+  MkvReader reader;
+  ASSERT_EQ(0, reader.Open(temp_file.name().c_str()));
+  long long pos = 0;
+  mkvparser::EBMLHeader ebml_header;
+  ASSERT_EQ(0, ebml_header.Parse(&reader, pos));
+  Segment* segment = NULL;
+  ASSERT_EQ(0, Segment::CreateInstance(&reader, pos, segment));
+  std::unique_ptr<Segment> segment_deleter(segment);
+  ASSERT_EQ(0, segment->Load());
+
+  const Track* const stripped = segment->GetTracks()->GetTrackByNumber(1);
+  const Track* const deflated = segment->GetTracks()->GetTrackByNumber(2);
+  EXPECT_TRUE(FrameDecompressor::IsCompressed(stripped));
+  EXPECT_TRUE(FrameDecompressor::IsCompressed(deflated));
+  EXPECT_TRUE(FrameDecompressor::IsSupported(stripped));
+#ifdef LIBWEBM_HAVE_ZLIB
+  EXPECT_TRUE(FrameDecompressor::IsSupported(deflated));
+#else
+  EXPECT_FALSE(FrameDecompressor::IsSupported(deflated));
+#endif
+
+  FrameDecompressor decompressor;
+  std::vector<unsigned char> buffer(8 * 1024);
+  std::vector<unsigned char> raw;
+  const mkvparser::Cluster* const first = segment->GetFirst();
+  const mkvparser::BlockEntry* entry = NULL;
+  ASSERT_EQ(0, first->GetFirst(entry));
+  for (int i = 0; i < kFrameCount; ++i, first->GetNext(entry, entry)) {
+    ASSERT_TRUE(entry != NULL && !entry->EOS());
+    const Block* const block = entry->GetBlock();
+    const Track* const track =
+        segment->GetTracks()->GetTrackByNumber(block->GetTrackNumber());
+    const Block::Frame& frame = block->GetFrame(0);
+    const std::vector<unsigned char>& plain = plain_frames[i];
+    const long plain_size = static_cast<long>(plain.size());
+    long size = 0;
+
+#ifndef LIBWEBM_HAVE_ZLIB
+    if (track == deflated) {
+      EXPECT_EQ(mkvparser::E_PARSE_FAILED,
+                decompressor.ReadFrame(&reader, track, frame, &buffer[0],
+                                       buffer.size(), size));
+      continue;
+    }
+#endif
+
+    // Too small a buffer gives the size needed.
+    EXPECT_EQ(1, decompressor.ReadFrame(&reader, track, frame, &buffer[0],
+                                        plain_size - 1, size));
+    EXPECT_EQ(plain_size, size);
+
+    ASSERT_EQ(0, decompressor.ReadFrame(&reader, track, frame, &buffer[0],
+                                        buffer.size(), size));
+    ASSERT_EQ(plain_size, size);
+    EXPECT_EQ(0, std::memcmp(&plain[0], &buffer[0], size)) << "frame " << i;
+
+    // The same, from memory.
+    raw.resize(frame.len);
+    ASSERT_EQ(0, frame.Read(&reader, &raw[0]));
+    std::fill(buffer.begin(), buffer.end(), 0);
+    ASSERT_EQ(0, decompressor.Decompress(track, &raw[0], frame.len, &buffer[0],
+                                         buffer.size(), size));
+    ASSERT_EQ(plain_size, size);
+    EXPECT_EQ(0, std::memcmp(&plain[0], &buffer[0], size)) << "frame " << i;
+
+#ifdef LIBWEBM_HAVE_ZLIB
+    if (track == deflated) {
+      raw.resize(raw.size() / 2);
+      EXPECT_EQ(mkvparser::E_FILE_FORMAT_INVALID,
+                decompressor.Decompress(track, &raw[0], raw.size(), &buffer[0],
+                                        buffer.size(), size));
+    }
+#endif
+  }
+}
+
+TEST_F(ParserTest, BlockIterator) {
+  ASSERT_TRUE(CreateAndLoadSegment("bbb_480p_vp9_opus_1second.webm", 4));
+  const Tracks* const tracks = segment_->GetTracks();
+
+  // Count the blocks of each track with the per-track iterators.
+  int track_block_counts[2] = {0, 0};
+  for (int i = 0; i < 2; ++i) {
+    const Track* const track = tracks->GetTrackByIndex(i);
+    ASSERT_TRUE(track != NULL);
+    const BlockEntry* block_entry = NULL;
+    long status = track->GetFirst(block_entry);
+    while (status == 0 && block_entry != NULL && !block_entry->EOS()) {
+      ++track_block_counts[i];
+      status = track->GetNext(block_entry, block_entry);
+    }
+  }
+
+  // All tracks: blocks come back in file order.
+  mkvparser::BlockIterator iterator(segment_);
+  const BlockEntry* block_entry = NULL;
+  const BlockEntry* prev_entry = NULL;
+  int block_count = 0;
+  while (iterator.Next(block_entry) == 0) {
+    ASSERT_TRUE(block_entry != NULL);
+    if (prev_entry != NULL) {
+      EXPECT_LT(prev_entry->GetBlock()->m_start,
+                block_entry->GetBlock()->m_start);
+    }
+    prev_entry = block_entry;
+    ++block_count;
+  }
+  EXPECT_EQ(track_block_counts[0] + track_block_counts[1], block_count);
+
+  // Single track selected through the mask.
+  const long long audio_track = tracks->GetTrackByIndex(1)->GetNumber();
+  iterator.Reset();
+  iterator.SetTrackMask(mkvparser::BlockIterator::GetTrackBit(audio_track));
+  block_count = 0;
+  while (iterator.Next(block_entry) == 0) {
+    EXPECT_EQ(audio_track, block_entry->GetBlock()->GetTrackNumber());
+    ++block_count;
+  }
+  EXPECT_EQ(track_block_counts[1], block_count);
+}
+
+TEST_F(ParserTest, TrackSubscription) {
+  ASSERT_NO_FATAL_FAILURE(
+      CreateSegmentNoHeaderChecks("bbb_480p_vp9_opus_1second.webm"));
+  const long long kAudioTrack = kAudioTrackNumber;
+  segment_->SetTrackSubscription(
+      mkvparser::BlockIterator::GetTrackBit(kAudioTrack));
+  ASSERT_EQ(0, segment_->Load());
+  EXPECT_TRUE(segment_->IsTrackSubscribed(kAudioTrack));
+  EXPECT_FALSE(segment_->IsTrackSubscribed(kVideoTrackNumber));
+
+  int audio_blocks = 0;
+  for (const Cluster* cluster = segment_->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = segment_->GetNext(cluster)) {
+    const BlockEntry* block_entry = NULL;
+    ASSERT_EQ(0, cluster->GetFirst(block_entry));
+    while (block_entry != NULL) {
+      EXPECT_EQ(kAudioTrack, block_entry->GetBlock()->GetTrackNumber());
+      ++audio_blocks;
+      ASSERT_EQ(0, cluster->GetNext(block_entry, block_entry));
+    }
+  }
+  EXPECT_GT(audio_blocks, 0);
+
+  // The video track has no entries left to visit.
+  const Track* const video_track =
+      segment_->GetTracks()->GetTrackByNumber(kVideoTrackNumber);
+  ASSERT_TRUE(video_track != NULL);
+  const BlockEntry* block_entry = NULL;
+  EXPECT_EQ(1, video_track->GetFirst(block_entry));
+  EXPECT_TRUE(block_entry->EOS());
+}
+
+TEST_F(ParserTest, KeyframeIterator) {
+  ASSERT_TRUE(CreateAndLoadSegment("bbb_480p_vp9_opus_1second.webm", 4));
+  const Track* const track =
+      segment_->GetTracks()->GetTrackByNumber(kVideoTrackNumber);
+  ASSERT_TRUE(track != NULL);
+
+  // Collect the keyframes of the track by walking every block.
+  std::vector<const BlockEntry*> keyframes;
+  const BlockEntry* block_entry = NULL;
+  long status = track->GetFirst(block_entry);
+  while (status == 0 && block_entry != NULL && !block_entry->EOS()) {
+    if (block_entry->GetBlock()->IsKey())
+      keyframes.push_back(block_entry);
+    status = track->GetNext(block_entry, block_entry);
+  }
+  ASSERT_FALSE(keyframes.empty());
+
+  mkvparser::KeyframeIterator iterator(segment_, track);
+  std::vector<const BlockEntry*> visited;
+  while (iterator.Next(block_entry) == 0) {
+    ASSERT_TRUE(block_entry != NULL);
+    EXPECT_TRUE(block_entry->GetBlock()->IsKey());
+    EXPECT_EQ(kVideoTrackNumber, block_entry->GetBlock()->GetTrackNumber());
+    visited.push_back(block_entry);
+  }
+  if (iterator.UsingCues()) {
+    EXPECT_FALSE(visited.empty());
+    EXPECT_LE(visited.size(), keyframes.size());
+  } else {
+    EXPECT_TRUE(visited == keyframes);
+  }
+
+  const BlockEntry* const last_key = keyframes.back();
+  const long long last_key_time =
+      last_key->GetBlock()->GetTime(last_key->GetCluster());
+  ASSERT_EQ(0, iterator.Seek(last_key_time, block_entry));
+  EXPECT_TRUE(block_entry->GetBlock()->IsKey());
+  EXPECT_LE(block_entry->GetBlock()->GetTime(block_entry->GetCluster()),
+            last_key_time);
+}
+
+TEST_F(ParserTest, KeyframeIteratorWithoutCues) {
+  ASSERT_TRUE(CreateAndLoadSegment("metadata_block.webm"));
+  const Track* const track = segment_->GetTracks()->GetTrackByIndex(0);
+  ASSERT_TRUE(track != NULL);
+  EXPECT_EQ(NULL, segment_->GetCues());
+
+  mkvparser::KeyframeIterator iterator(segment_, track);
+  const BlockEntry* block_entry = NULL;
+  int keyframe_count = 0;
+  while (iterator.Next(block_entry) == 0) {
+    EXPECT_TRUE(block_entry->GetBlock()->IsKey());
+    ++keyframe_count;
+  }
+  EXPECT_FALSE(iterator.UsingCues());
+  EXPECT_EQ(2, keyframe_count);
+
+  ASSERT_EQ(0, iterator.Seek(2000000, block_entry));
+  EXPECT_EQ(2000000,
+            block_entry->GetBlock()->GetTime(block_entry->GetCluster()));
+  EXPECT_EQ(1, iterator.Next(block_entry));
+}
+
+TEST_F(ParserTest, FrozenSegmentSharedAcrossThreads) {
+  ASSERT_TRUE(CreateAndLoadSegment("bbb_480p_vp9_opus_1second.webm", 4));
+  ASSERT_EQ(0, segment_->Freeze());
+  EXPECT_TRUE(segment_->IsFrozen());
+  EXPECT_EQ(1, segment_->LoadCluster());
+  EXPECT_EQ(NULL, segment_->FindOrPreloadCluster(1));
+
+  const long cluster_count = segment_->GetCount();
+  const Track* const track =
+      segment_->GetTracks()->GetTrackByNumber(kVideoTrackNumber);
+  ASSERT_TRUE(track != NULL);
+
+  std::vector<const BlockEntry*> expected;
+  mkvparser::BlockIterator iterator(segment_);
+  const BlockEntry* block_entry = NULL;
+  while (iterator.Next(block_entry) == 0)
+    expected.push_back(block_entry);
+  ASSERT_FALSE(expected.empty());
+
+  const int kThreadCount = 4;
+  std::vector<const BlockEntry*> visited[kThreadCount];
+  int keyframe_count[kThreadCount] = {0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.push_back(std::thread([&, i]() {
+      mkvparser::BlockIterator blocks(segment_);
+      const BlockEntry* entry = NULL;
+      while (blocks.Next(entry) == 0) {
+        entry->GetBlock()->GetFrameCount();
+        visited[i].push_back(entry);
+      }
+      mkvparser::KeyframeIterator keyframes(segment_, track);
+      while (keyframes.Next(entry) == 0)
+        ++keyframe_count[i];
+    }));
+  }
+  for (int i = 0; i < kThreadCount; ++i)
+    threads[i].join();
+
+  for (int i = 0; i < kThreadCount; ++i) {
+    EXPECT_TRUE(visited[i] == expected);
+    EXPECT_GT(keyframe_count[i], 0);
+    EXPECT_EQ(keyframe_count[0], keyframe_count[i]);
+  }
+  EXPECT_EQ(cluster_count, segment_->GetCount());
+}
+
+// Reads through MkvReader, returning zeros for [damage_begin, damage_end)
+// once Damage() has been called.
+class DamagingReader : public mkvparser::IMkvReader {
+ public:
+  explicit DamagingReader(MkvReader* reader)
+      : reader_(reader), damage_begin_(0), damage_end_(0) {}
+
+  void Damage(long long begin, long long end) {
+    damage_begin_ = begin;
+    damage_end_ = end;
+  }
+
+  int Read(long long pos, long len, unsigned char* buf) override {
+    const int status = reader_->Read(pos, len, buf);
+    for (long i = 0; status == 0 && i < len; ++i) {
+      if (pos + i >= damage_begin_ && pos + i < damage_end_)
+        buf[i] = 0;
+    }
+    return status;
+  }
+
+  int Length(long long* total, long long* available) override {
+    return reader_->Length(total, available);
+  }
+
+ private:
+  MkvReader* const reader_;
+  long long damage_begin_;
+  long long damage_end_;
+};
+
+TEST_F(ParserTest, FreezeWithCorruptedCuePoint) {
+  filename_ = GetTestFilePath("output_cues.webm");
+  ASSERT_EQ(0, reader_.Open(filename_.c_str()));
+  is_reader_open_ = true;
+  DamagingReader reader(&reader_);
+  long long pos = 0;
+  mkvparser::EBMLHeader ebml_header;
+  ASSERT_EQ(0, ebml_header.Parse(&reader, pos));
+  ASSERT_EQ(0, Segment::CreateInstance(&reader, pos, segment_));
+  ASSERT_GE(segment_->Load(), 0);
+
+  // Index the cue points and load the first one, then corrupt the ID of the
+  // second one so that LoadCuePoint() gives up without finishing the Cues.
+  const Cues* const cues = segment_->GetCues();
+  ASSERT_TRUE(cues != NULL);
+  ASSERT_TRUE(cues->LoadCuePoint());
+  const CuePoint* const first = cues->GetFirst();
+  ASSERT_TRUE(first != NULL);
+  const long long damage_pos = first->m_element_start + first->m_element_size;
+  reader.Damage(damage_pos, damage_pos + 1);
+
+  ASSERT_EQ(0, segment_->Freeze());
+  EXPECT_TRUE(cues->DoneParsing());
+  EXPECT_EQ(1, cues->GetCount());
+  EXPECT_FALSE(cues->LoadCuePoint());
+
+  // Iterating the frozen segment does not resume parsing the Cues.
+  const Track* const track = segment_->GetTracks()->GetTrackByIndex(0);
+  ASSERT_TRUE(track != NULL);
+  mkvparser::KeyframeIterator iterator(segment_, track);
+  const BlockEntry* block_entry = NULL;
+  EXPECT_EQ(0, iterator.Next(block_entry));
+  EXPECT_TRUE(iterator.UsingCues());
+  EXPECT_EQ(1, cues->GetCount());
+}
+
+TEST_F(ParserTest, RangePlanner) {
+  ASSERT_TRUE(CreateAndLoadSegment("output_cues.webm"));
+  ASSERT_TRUE(segment_->GetCues() != NULL);
+  ASSERT_EQ(2, segment_->GetCount());
+  const Cluster* const first = segment_->GetFirst();
+  const Cluster* const second = segment_->GetNext(first);
+  const Cues* const cues = segment_->GetCues();
+  // The clusters are followed by the Cues element.
+  const long long first_stop = second->m_element_start;
+  const long long second_stop = cues->m_element_start;
+  const long long cues_stop = cues->m_element_start + cues->m_element_size;
+
+  mkvparser::RangePlanner planner(segment_);
+  const unsigned long long kAllTracks = mkvparser::BlockIterator::kAllTracks;
+
+  // The headers and the first cluster are contiguous.
+  ASSERT_EQ(0, planner.Plan(0, 1000000, kAllTracks));
+  ASSERT_EQ(2, planner.GetCount());
+  EXPECT_EQ(0, planner.GetRange(0)->pos);
+  EXPECT_EQ(first_stop, planner.GetRange(0)->len);
+  EXPECT_EQ(cues->m_element_start, planner.GetRange(1)->pos);
+  EXPECT_EQ(cues->m_element_size, planner.GetRange(1)->len);
+  EXPECT_EQ(first_stop + cues->m_element_size, planner.GetTotalSize());
+
+  planner.SetMergeGap(second_stop - first_stop);
+  ASSERT_EQ(0, planner.Plan(0, 1000000, kAllTracks));
+  ASSERT_EQ(1, planner.GetCount());
+  EXPECT_EQ(cues_stop, planner.GetRange(0)->len);
+
+  planner.SetMergeGap(0);
+  planner.SetIncludeHeaders(false);
+  ASSERT_EQ(0, planner.Plan(6000000, 7000000, kAllTracks));
+  ASSERT_EQ(1, planner.GetCount());
+  EXPECT_EQ(second->m_element_start, planner.GetRange(0)->pos);
+  EXPECT_EQ(second_stop - second->m_element_start, planner.GetRange(0)->len);
+
+  EXPECT_EQ(-1, planner.Plan(1000000, 1000000, kAllTracks));
+  EXPECT_EQ(0, planner.GetCount());
+}
+
+TEST_F(ParserTest, RangeReader) {
+  ASSERT_TRUE(CreateAndLoadSegment("output_cues.webm"));
+  mkvparser::RangePlanner planner(segment_);
+  ASSERT_EQ(0, planner.Plan(0, 1000000, mkvparser::BlockIterator::kAllTracks));
+
+  mkvparser::RangeReader range_reader(&reader_);
+  ASSERT_EQ(0, range_reader.Fetch(planner));
+  EXPECT_EQ(planner.GetCount(), range_reader.GetFetchCount());
+  EXPECT_EQ(planner.GetTotalSize(), range_reader.GetFetchedSize());
+
+  // Parse the planned ranges as if they were the whole file.
+  long long pos = 0;
+  mkvparser::EBMLHeader ebml_header;
+  ASSERT_EQ(0, ebml_header.Parse(&range_reader, pos));
+  Segment* segment = NULL;
+  ASSERT_EQ(0, Segment::CreateInstance(&range_reader, pos, segment));
+  ASSERT_EQ(0, segment->ParseHeaders());
+  ASSERT_EQ(0, segment->LoadCluster());
+  const Cluster* const cluster = segment->GetFirst();
+  ASSERT_FALSE(cluster->EOS());
+
+  const Cluster* const expected = segment_->GetFirst();
+  const BlockEntry* block_entry = NULL;
+  const BlockEntry* expected_entry = NULL;
+  ASSERT_EQ(0, cluster->GetFirst(block_entry));
+  ASSERT_EQ(0, expected->GetFirst(expected_entry));
+  while (block_entry != NULL && expected_entry != NULL) {
+    const Block::Frame& frame = block_entry->GetBlock()->GetFrame(0);
+    const Block::Frame& expected_frame =
+        expected_entry->GetBlock()->GetFrame(0);
+    ASSERT_EQ(expected_frame.len, frame.len);
+    std::vector<unsigned char> data(frame.len), expected_data(frame.len);
+    ASSERT_EQ(0, frame.Read(&range_reader, data.data()));
+    ASSERT_EQ(0, expected_frame.Read(&reader_, expected_data.data()));
+    EXPECT_TRUE(data == expected_data);
+    ASSERT_EQ(0, cluster->GetNext(block_entry, block_entry));
+    ASSERT_EQ(0, expected->GetNext(expected_entry, expected_entry));
+  }
+  EXPECT_TRUE(block_entry == NULL && expected_entry == NULL);
+
+  // The second cluster was not fetched.
+  unsigned char byte;
+  EXPECT_EQ(-1, range_reader.Read(segment_->GetLast()->m_element_start, 1,
+                                  &byte));
+  delete segment;
+}
+
+TEST_F(ParserTest, ResyncScannerFindsClusters) {
+  ASSERT_TRUE(CreateAndLoadSegment("max_cluster_duration.webm"));
+  std::vector<long long> expected;
+  for (const Cluster* cluster = segment_->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = segment_->GetNext(cluster)) {
+    expected.push_back(cluster->m_element_start);
+  }
+  ASSERT_EQ(3u, expected.size());
+
+  // A small buffer puts cluster IDs across chunk boundaries.
+  mkvparser::ResyncScanner scanner(segment_);
+  scanner.SetBufferSize(16);
+  EXPECT_EQ(64, scanner.GetBufferSize());
+
+  std::vector<long long> found;
+  long long pos = segment_->m_start;
+  mkvparser::ResyncScanner::Kind kind;
+  while (scanner.Find(pos, -1, mkvparser::ResyncScanner::kCluster, pos,
+                      kind) == 0) {
+    EXPECT_EQ(mkvparser::ResyncScanner::kCluster, kind);
+    found.push_back(pos);
+    ++pos;
+  }
+  EXPECT_TRUE(found == expected);
+}
+
+TEST_F(ParserTest, ResyncAfterDamagedCluster) {
+  ASSERT_TRUE(CreateAndLoadSegment("max_cluster_duration.webm"));
+  const Cluster* const first = segment_->GetFirst();
+  const Cluster* const second = segment_->GetNext(first);
+  const Cluster* const third = segment_->GetNext(second);
+  ASSERT_TRUE(third != NULL && !third->EOS());
+  const long long damage_pos = second->m_element_start;
+  const long long resume_pos = third->m_element_start;
+  const long long third_time = third->GetTime();
+  const BlockEntry* block_entry = NULL;
+  ASSERT_EQ(0, first->GetLast(block_entry));  // parses the whole cluster
+  const long first_entries = first->GetEntryCount();
+  ASSERT_GT(first_entries, 0);
+
+  // Overwrite the ID of the second cluster.
+  FILE* const file = std::fopen(filename_.c_str(), "rb");
+  ASSERT_TRUE(file != NULL);
+  std::vector<unsigned char> data;
+  int c;
+  while ((c = std::fgetc(file)) != EOF)
+    data.push_back(static_cast<unsigned char>(c));
+  std::fclose(file);
+  std::memset(&data[damage_pos], 0, 4);
+
+  const libwebm::TempFileDeleter damaged;
+  FILE* const out = std::fopen(damaged.name().c_str(), "wb");
+  ASSERT_TRUE(out != NULL);
+  ASSERT_EQ(data.size(), std::fwrite(&data[0], 1, data.size(), out));
+  std::fclose(out);
+
+  MkvReader reader;
+  ASSERT_EQ(0, reader.Open(damaged.name().c_str()));
+  long long pos = 0;
+  mkvparser::EBMLHeader ebml_header;
+  ASSERT_EQ(0, ebml_header.Parse(&reader, pos));
+  Segment* segment = NULL;
+  ASSERT_EQ(0, Segment::CreateInstance(&reader, pos, segment));
+  EXPECT_LT(segment->Load(), 0);
+  EXPECT_EQ(1, segment->GetCount());
+
+  // The blocks of the damaged cluster are still found, and the scan for
+  // clusters continues with the next one.
+  mkvparser::ResyncScanner scanner(segment);
+  mkvparser::ResyncScanner::Kind kind;
+  ASSERT_EQ(0, scanner.Find(damage_pos, -1,
+                            mkvparser::ResyncScanner::kCluster |
+                                mkvparser::ResyncScanner::kSimpleBlock,
+                            pos, kind));
+  EXPECT_EQ(mkvparser::ResyncScanner::kSimpleBlock, kind);
+  EXPECT_GT(pos, damage_pos);
+  EXPECT_LT(pos, resume_pos);
+
+  ASSERT_EQ(0, scanner.Find(damage_pos, -1,
+                            mkvparser::ResyncScanner::kCluster, pos, kind));
+  EXPECT_EQ(resume_pos, pos);
+
+  EXPECT_EQ(mkvparser::E_FILE_FORMAT_INVALID, segment->Resync(damage_pos));
+  ASSERT_EQ(0, segment->Resync(pos));
+  long status;
+  while ((status = segment->LoadCluster()) == 0) {
+  }
+  EXPECT_EQ(1, status);
+
+  ASSERT_EQ(2, segment->GetCount());
+  EXPECT_EQ(first_entries, segment->GetFirst()->GetEntryCount());
+  const Cluster* const last = segment->GetLast();
+  EXPECT_EQ(resume_pos, last->m_element_start);
+  EXPECT_EQ(third_time, last->GetTime());
+  delete segment;
+}
+
 TEST_F(ParserTest, DiscardPadding) {
   // Test an artificial file with some extreme DiscardPadding values.
   const std::string file = "discard_padding.webm";
@@ -783,6 +1666,17 @@ TEST_F(ParserTest, InvalidFixedLacingSize) {
             segment_->GetFirst()->GetFirst(block_entry));
 }
 
+TEST_F(ParserTest, InvalidFixedLacingSizeLazy) {
+  ASSERT_NO_FATAL_FAILURE(
+      CreateSegmentNoHeaderChecks("invalid/fixed_lacing_bad_lace_size.mkv"));
+  segment_->SetLazyFrameParsing(true);
+  ASSERT_EQ(0, segment_->Load());
+  const mkvparser::BlockEntry* block_entry = NULL;
+  ASSERT_EQ(0, segment_->GetFirst()->GetFirst(block_entry));
+  ASSERT_TRUE(block_entry != NULL);
+  EXPECT_EQ(0, block_entry->GetBlock()->GetFrameCount());
+}
+
 TEST_F(ParserTest, InvalidBlockEndsBeyondCluster) {
   ASSERT_NO_FATAL_FAILURE(
       CreateSegmentNoHeaderChecks("invalid/block_ends_beyond_cluster.mkv"));
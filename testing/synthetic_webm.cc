@@ -0,0 +1,223 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "testing/synthetic_webm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "mkvmuxer/mkvmuxer.h"
+
+namespace libwebm {
+
+namespace {
+
+const char kWritingApp[] = "libwebm synthetic";
+const std::uint64_t kBlockAddId = 1;
+const std::size_t kMinVideoFrameSize = 16;
+
+// Forwards to another writer, but reports that it is not seekable so the
+// muxer leaves the sizes of Clusters and the Segment unknown.
+class NonSeekableWriter : public mkvmuxer::IMkvWriter {
+ public:
+  explicit NonSeekableWriter(mkvmuxer::IMkvWriter* writer) : writer_(writer) {}
+
+  mkvmuxer::int32 Write(const void* buf, mkvmuxer::uint32 len) override {
+    return writer_->Write(buf, len);
+  }
+  mkvmuxer::int64 Position() const override { return writer_->Position(); }
+  mkvmuxer::int32 Position(mkvmuxer::int64) override { return -1; }
+  bool Seekable() const override { return false; }
+  void ElementStartNotify(mkvmuxer::uint64 element_id,
+                          mkvmuxer::int64 position) override {
+    writer_->ElementStartNotify(element_id, position);
+  }
+
+ private:
+  mkvmuxer::IMkvWriter* const writer_;
+};
+
+// Writes a VP9 uncompressed header at the start of |frame|: frame_marker 2,
+// profile 0, a shown frame without error resilience. Keyframes add the sync
+// code, BT.601 color and the frame size.
+void WriteVp9Header(bool is_key, int width, int height,
+                    std::vector<std::uint8_t>* frame) {
+  (*frame)[0] = is_key ? 0x82 : 0x86;
+  if (is_key) {
+    // 60 bits, left-aligned: the sync code, color_space 1 and color_range 0,
+    // then the frame size minus one.
+    const std::uint64_t bits =
+        (std::uint64_t{0x498342} << 40) | (std::uint64_t{0x2} << 36) |
+        (static_cast<std::uint64_t>(width - 1) << 20) |
+        (static_cast<std::uint64_t>(height - 1) << 4);
+    for (int i = 0; i < 8; ++i)
+      (*frame)[1 + i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+  }
+  // The last byte must not look like a superframe index marker.
+  frame->back() = 0;
+}
+
+}  // namespace
+
+SyntheticFrameGenerator::SyntheticFrameGenerator(
+    const SyntheticWebmConfig& config)
+    : config_(config),
+      end_ns_(static_cast<std::uint64_t>(
+          std::max(0.0, config.duration_seconds) * 1e9)),
+      random_(config.seed) {
+  std::uint64_t number = 1;
+  for (int i = 0; i < config.video_tracks; ++i)
+    tracks_.push_back(TrackState{number++, true, 0});
+  for (int i = 0; i < config.audio_tracks; ++i)
+    tracks_.push_back(TrackState{number++, false, 0});
+}
+
+std::uint64_t SyntheticFrameGenerator::Timestamp(
+    const TrackState& track) const {
+  const double frame_ns = track.video ? 1e9 / config_.frame_rate
+                                      : config_.audio_frame_ms * 1e6;
+  return static_cast<std::uint64_t>(
+      std::llround(static_cast<double>(track.frame_index) * frame_ns));
+}
+
+std::size_t SyntheticFrameGenerator::RandomSize(std::size_t mean) {
+  return mean / 2 + static_cast<std::size_t>(random_() % (mean + 1));
+}
+
+void SyntheticFrameGenerator::Fill(std::vector<std::uint8_t>* data,
+                                   std::size_t size) {
+  data->resize(size);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const std::uint64_t value = random_();
+    std::memcpy(&(*data)[i], &value, 8);
+  }
+  if (i < size) {
+    const std::uint64_t value = random_();
+    std::memcpy(&(*data)[i], &value, size - i);
+  }
+}
+
+bool SyntheticFrameGenerator::Next(SyntheticFrame* frame) {
+  TrackState* next = nullptr;
+  std::uint64_t next_timestamp = 0;
+  for (TrackState& track : tracks_) {
+    const std::uint64_t timestamp = Timestamp(track);
+    if (timestamp < end_ns_ &&
+        (next == nullptr || timestamp < next_timestamp)) {
+      next = &track;
+      next_timestamp = timestamp;
+    }
+  }
+  if (next == nullptr)
+    return false;
+
+  frame->track_number = next->number;
+  frame->timestamp_ns = next_timestamp;
+  if (next->video) {
+    frame->is_key = config_.keyframe_interval <= 1 ||
+                    next->frame_index % config_.keyframe_interval == 0;
+    const std::size_t size = std::max(
+        kMinVideoFrameSize,
+        RandomSize(frame->is_key ? config_.keyframe_size : config_.frame_size));
+    Fill(&frame->data, size);
+    WriteVp9Header(frame->is_key, config_.width, config_.height, &frame->data);
+    Fill(&frame->additional, config_.block_additional_size);
+  } else {
+    frame->is_key = true;
+    Fill(&frame->data, std::max<std::size_t>(
+                           1, RandomSize(config_.audio_frame_size)));
+    frame->additional.clear();
+  }
+  ++next->frame_index;
+  return true;
+}
+
+bool InitSyntheticSegment(const SyntheticWebmConfig& config,
+                          mkvmuxer::IMkvWriter* writer,
+                          mkvmuxer::Segment* segment) {
+  if (!writer || !segment || config.video_tracks < 0 ||
+      config.audio_tracks < 0 || config.frame_rate <= 0 ||
+      config.audio_frame_ms <= 0 || !segment->Init(writer)) {
+    return false;
+  }
+
+  segment->set_mode(mkvmuxer::Segment::kFile);
+  segment->GetSegmentInfo()->set_writing_app(kWritingApp);
+  if (config.max_cluster_duration_ns > 0)
+    segment->set_max_cluster_duration(config.max_cluster_duration_ns);
+  if (config.max_cluster_size > 0)
+    segment->set_max_cluster_size(config.max_cluster_size);
+
+  int32_t number = 1;
+  for (int i = 0; i < config.video_tracks; ++i, ++number) {
+    if (segment->AddVideoTrack(config.width, config.height, number) == 0)
+      return false;
+    mkvmuxer::Track* const track = segment->GetTrackByNumber(number);
+    track->set_codec_id(mkvmuxer::Tracks::kVp9CodecId);
+    if (config.block_additional_size > 0)
+      track->set_max_block_additional_id(kBlockAddId);
+  }
+  for (int i = 0; i < config.audio_tracks; ++i, ++number) {
+    if (segment->AddAudioTrack(config.sample_rate, config.channels, number) ==
+        0) {
+      return false;
+    }
+    segment->GetTrackByNumber(number)->set_codec_id(
+        mkvmuxer::Tracks::kOpusCodecId);
+  }
+
+  if (config.lacing.size() > static_cast<std::size_t>(number - 1))
+    return false;
+  for (std::size_t i = 0; i < config.lacing.size(); ++i) {
+    mkvmuxer::Track* const track = segment->GetTrackByNumber(i + 1);
+    track->set_lacing(config.lacing[i]);
+    if (config.max_lace_frames > 0)
+      track->set_max_lace_frames(config.max_lace_frames);
+    if (config.max_lace_duration_ns > 0)
+      track->set_max_lace_duration(config.max_lace_duration_ns);
+  }
+
+  segment->OutputCues(config.cues);
+  if (config.cues && number > 1 && !segment->CuesTrack(1))
+    return false;
+  return true;
+}
+
+bool AddSyntheticFrames(const SyntheticWebmConfig& config,
+                        mkvmuxer::Segment* segment) {
+  SyntheticFrameGenerator generator(config);
+  SyntheticFrame frame;
+  while (generator.Next(&frame)) {
+    const bool added =
+        frame.additional.empty()
+            ? segment->AddFrame(frame.data.data(), frame.data.size(),
+                                frame.track_number, frame.timestamp_ns,
+                                frame.is_key)
+            : segment->AddFrameWithAdditional(
+                  frame.data.data(), frame.data.size(),
+                  frame.additional.data(), frame.additional.size(),
+                  kBlockAddId, frame.track_number, frame.timestamp_ns,
+                  frame.is_key);
+    if (!added)
+      return false;
+  }
+  return true;
+}
+
+bool WriteSyntheticWebm(const SyntheticWebmConfig& config,
+                        mkvmuxer::IMkvWriter* writer) {
+  NonSeekableWriter non_seekable_writer(writer);
+  mkvmuxer::Segment segment;
+  return InitSyntheticSegment(
+             config, config.unknown_sizes ? &non_seekable_writer : writer,
+             &segment) &&
+         AddSyntheticFrames(config, &segment) && segment.Finalize();
+}
+
+}  // namespace libwebm
@@ -0,0 +1,120 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_TESTING_SYNTHETIC_WEBM_H_
+#define LIBWEBM_TESTING_SYNTHETIC_WEBM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "mkvmuxer/mkvmuxer.h"
+
+namespace libwebm {
+
+// Describes a synthetic WebM file. The payloads are fake, but video frames
+// start with a VP9 uncompressed header that Vp9HeaderParser accepts, so the
+// files also work with the VP9 and PES tools. The same configuration always
+// produces the same file.
+struct SyntheticWebmConfig {
+  std::uint32_t seed = 1;
+  double duration_seconds = 60;
+
+  // Video tracks are numbered from 1, followed by the audio tracks.
+  int video_tracks = 1;
+  int audio_tracks = 1;
+
+  int width = 640;
+  int height = 360;
+  double frame_rate = 30;
+  // Frames per keyframe. Each video keyframe starts a new Cluster.
+  int keyframe_interval = 60;
+  // Mean frame sizes; each frame is within 50% of its mean.
+  std::size_t keyframe_size = 50000;
+  std::size_t frame_size = 6000;
+  // BlockAdditional data added to each video frame, with BlockAddID 1.
+  std::size_t block_additional_size = 0;
+
+  int sample_rate = 48000;
+  int channels = 2;
+  double audio_frame_ms = 20;
+  std::size_t audio_frame_size = 200;
+
+  // Limits on Clusters, 0 for the muxer's defaults.
+  std::uint64_t max_cluster_duration_ns = 0;
+  std::uint64_t max_cluster_size = 0;
+
+  // Cues with a CuePoint per Cluster on the first video track, or the first
+  // audio track when there is no video.
+  bool cues = true;
+
+  // Lacing of each track, indexed by track number minus one. Tracks without
+  // an entry are not laced.
+  std::vector<mkvmuxer::Lacing> lacing;
+  // Limits on the laces of laced tracks, 0 for the muxer's defaults.
+  int max_lace_frames = 0;
+  std::uint64_t max_lace_duration_ns = 0;
+
+  // Writes the file as to a non-seekable output: Clusters and the Segment
+  // have unknown sizes, and there is no SeekHead.
+  bool unknown_sizes = false;
+};
+
+struct SyntheticFrame {
+  std::vector<std::uint8_t> data;
+  std::vector<std::uint8_t> additional;
+  std::uint64_t track_number = 0;
+  std::uint64_t timestamp_ns = 0;
+  bool is_key = false;
+};
+
+// Produces the frames of a SyntheticWebmConfig in timestamp order, one at a
+// time, so that long files need not be held in memory.
+class SyntheticFrameGenerator {
+ public:
+  explicit SyntheticFrameGenerator(const SyntheticWebmConfig& config);
+
+  // Sets |frame| to the next frame, reusing its buffers. Returns false when
+  // there are no more frames.
+  bool Next(SyntheticFrame* frame);
+
+ private:
+  struct TrackState {
+    std::uint64_t number;
+    bool video;
+    std::uint64_t frame_index;
+  };
+
+  std::uint64_t Timestamp(const TrackState& track) const;
+  std::size_t RandomSize(std::size_t mean);
+  void Fill(std::vector<std::uint8_t>* data, std::size_t size);
+
+  const SyntheticWebmConfig config_;
+  const std::uint64_t end_ns_;
+  std::mt19937_64 random_;
+  std::vector<TrackState> tracks_;
+};
+
+// Inits |segment| to write to |writer| and adds the tracks of |config|.
+bool InitSyntheticSegment(const SyntheticWebmConfig& config,
+                          mkvmuxer::IMkvWriter* writer,
+                          mkvmuxer::Segment* segment);
+
+// Adds every frame of |config| to |segment|, set up by
+// InitSyntheticSegment(). The segment is not finalized.
+bool AddSyntheticFrames(const SyntheticWebmConfig& config,
+                        mkvmuxer::Segment* segment);
+
+// Writes the file described by |config| to |writer|. With
+// |config.unknown_sizes| |writer| is used as if it were not seekable.
+bool WriteSyntheticWebm(const SyntheticWebmConfig& config,
+                        mkvmuxer::IMkvWriter* writer);
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_TESTING_SYNTHETIC_WEBM_H_
@@ -0,0 +1,138 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "testing/test_util.h"
+#include "webm_info_stats.h"
+
+namespace {
+
+// The golden files hold the output of webm_info for inputs in
+// testing/testdata, with paths relative to that directory.
+std::string ReadGolden(const std::string& name) {
+  std::string contents;
+  FILE* const file =
+      std::fopen(test::GetTestFilePath("webm_info/" + name).c_str(), "rb");
+  if (file == NULL)
+    return contents;
+  char buffer[4096];
+  size_t read;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    contents.append(buffer, read);
+  std::fclose(file);
+  return contents;
+}
+
+// Returns what WriteSummaries() writes for |names|, with the test data
+// directory stripped from the paths. |ok| is set to its return value.
+std::string Summaries(const std::vector<std::string>& names, bool ndjson,
+                      bool use_webm_parser, unsigned jobs, bool* ok) {
+  std::vector<std::string> inputs;
+  for (const std::string& name : names)
+    inputs.push_back(test::GetTestFilePath(name));
+
+  std::string output;
+  FILE* const out = std::tmpfile();
+  if (out == NULL)
+    return output;
+  *ok = libwebm::WriteSummaries(inputs, ndjson, use_webm_parser, false, jobs,
+                                out);
+  std::rewind(out);
+  char buffer[4096];
+  size_t read;
+  while ((read = std::fread(buffer, 1, sizeof(buffer), out)) > 0)
+    output.append(buffer, read);
+  std::fclose(out);
+
+  const std::string prefix = test::GetTestFilePath("");
+  for (size_t pos = output.find(prefix); pos != std::string::npos;
+       pos = output.find(prefix, pos)) {
+    output.erase(pos, prefix.size());
+  }
+  return output;
+}
+
+class WebmInfoTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_FALSE(test::GetTestDataDir().empty())
+        << "LIBWEBM_TEST_DATA_PATH is not set";
+  }
+
+  static std::vector<bool> Parsers() {
+    std::vector<bool> parsers(1, false);
+    if (libwebm::HasWebmParser())
+      parsers.push_back(true);
+    return parsers;
+  }
+};
+
+TEST_F(WebmInfoTest, Json) {
+  const std::string golden = ReadGolden("output_cues.json");
+  ASSERT_FALSE(golden.empty());
+  for (const bool use_webm_parser : Parsers()) {
+    bool ok = false;
+    EXPECT_EQ(golden, Summaries({"output_cues.webm"}, false, use_webm_parser,
+                                1, &ok))
+        << "webm_parser: " << use_webm_parser;
+    EXPECT_TRUE(ok);
+  }
+}
+
+TEST_F(WebmInfoTest, Ndjson) {
+  const std::string golden = ReadGolden("output_cues.ndjson");
+  ASSERT_FALSE(golden.empty());
+  for (const bool use_webm_parser : Parsers()) {
+    bool ok = false;
+    EXPECT_EQ(golden, Summaries({"output_cues.webm"}, true, use_webm_parser,
+                                1, &ok))
+        << "webm_parser: " << use_webm_parser;
+    EXPECT_TRUE(ok);
+  }
+}
+
+// Both parsers report the extent of unknown-size Clusters, which end where
+// the next element starts.
+TEST_F(WebmInfoTest, UnknownSizeClusters) {
+  const std::string golden = ReadGolden("unknown_sizes.ndjson");
+  ASSERT_FALSE(golden.empty());
+  for (const bool use_webm_parser : Parsers()) {
+    bool ok = false;
+    EXPECT_EQ(golden, Summaries({"unknown_sizes.webm"}, true, use_webm_parser,
+                                1, &ok))
+        << "webm_parser: " << use_webm_parser;
+    EXPECT_TRUE(ok);
+  }
+}
+
+// The records come out in input order however many jobs run, and a file
+// that fails gets a record with an error in its place.
+TEST_F(WebmInfoTest, JobsKeepInputOrder) {
+  const std::string golden = ReadGolden("jobs.json");
+  ASSERT_FALSE(golden.empty());
+  const std::vector<std::string> names = {
+      "bbb_480p_vp9_opus_1second.webm", "tracks.webm", "missing.webm",
+      "max_cluster_size.webm", "output_cues.webm"};
+  for (const unsigned jobs : {1u, 2u, 5u, 16u}) {
+    bool ok = true;
+    EXPECT_EQ(golden, Summaries(names, false, false, jobs, &ok))
+        << "jobs: " << jobs;
+    EXPECT_FALSE(ok);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
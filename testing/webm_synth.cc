@@ -0,0 +1,171 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "mkvmuxer/mkvwriter.h"
+#include "testing/synthetic_webm.h"
+
+namespace {
+
+void Usage(const char* argv[]) {
+  printf("Usage: %s [options] -o <output WebM file>\n", argv[0]);
+  printf("\n");
+  printf("Writes a synthetic WebM file with fake VP9 and Opus payloads. The\n");
+  printf("same options and seed always produce the same file.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("  -seed <n>                   Seed of the payloads (1)\n");
+  printf("  -duration <seconds>         Duration (60)\n");
+  printf("  -video_tracks <n>           Number of video tracks (1)\n");
+  printf("  -audio_tracks <n>           Number of audio tracks (1)\n");
+  printf("  -width <n> -height <n>      Video frame size (640x360)\n");
+  printf("  -frame_rate <fps>           Video frame rate (30)\n");
+  printf("  -keyframe_interval <n>      Frames per keyframe; each keyframe\n");
+  printf("                              starts a Cluster (60)\n");
+  printf("  -keyframe_size <bytes>      Mean keyframe size (50000)\n");
+  printf("  -frame_size <bytes>         Mean video frame size (6000)\n");
+  printf("  -block_additional <bytes>   BlockAdditional size per video\n");
+  printf("                              frame (0)\n");
+  printf("  -audio_frame_ms <ms>        Audio frame duration (20)\n");
+  printf("  -audio_frame_size <bytes>   Mean audio frame size (200)\n");
+  printf("  -max_cluster_duration <ms>  Maximum Cluster duration\n");
+  printf("  -max_cluster_size <bytes>   Maximum Cluster size\n");
+  printf("  -lacing <track>:<mode>      Lacing of track number <track>:\n");
+  printf("                              none, xiph, ebml or fixed (none).\n");
+  printf("                              May be repeated\n");
+  printf("  -max_lace_frames <n>        Maximum frames per lace (8)\n");
+  printf("  -max_lace_duration <ms>     Maximum lace duration\n");
+  printf("  -no_cues                    Do not write Cues\n");
+  printf("  -unknown_sizes              Write Clusters and the Segment with\n");
+  printf("                              unknown sizes, as a live stream\n");
+  printf("\n");
+  printf("There is a CuePoint per Cluster, so -keyframe_interval 1 writes a\n");
+  printf("CuePoint per video frame. Only keyframes are laced, so lace audio\n");
+  printf("tracks, as in -lacing 2:xiph.\n");
+}
+
+// Parses a -lacing value, <track>:<mode>, into |config|. Returns false when
+// the value is invalid.
+bool ParseLacing(const char* value, libwebm::SyntheticWebmConfig* config) {
+  char* end = NULL;
+  const long track = strtol(value, &end, 10);
+  if (end == value || *end != ':' || track < 1 || track > 64)
+    return false;
+  const char* const mode = end + 1;
+
+  mkvmuxer::Lacing lacing;
+  if (!strcmp("none", mode))
+    lacing = mkvmuxer::kNoLacing;
+  else if (!strcmp("xiph", mode))
+    lacing = mkvmuxer::kXiphLacing;
+  else if (!strcmp("ebml", mode))
+    lacing = mkvmuxer::kEbmlLacing;
+  else if (!strcmp("fixed", mode))
+    lacing = mkvmuxer::kFixedSizeLacing;
+  else
+    return false;
+
+  if (config->lacing.size() < static_cast<std::size_t>(track))
+    config->lacing.resize(track, mkvmuxer::kNoLacing);
+  config->lacing[track - 1] = lacing;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+  libwebm::SyntheticWebmConfig config;
+  std::string output;
+
+  const int argc_check = argc - 1;
+  for (int i = 1; i < argc; ++i) {
+    const char* const arg = argv[i];
+    const char* const value = i < argc_check ? argv[i + 1] : NULL;
+    if (!strcmp("-h", arg) || !strcmp("-?", arg)) {
+      Usage(argv);
+      return EXIT_SUCCESS;
+    } else if (!strcmp("-no_cues", arg)) {
+      config.cues = false;
+      continue;
+    } else if (!strcmp("-unknown_sizes", arg)) {
+      config.unknown_sizes = true;
+      continue;
+    } else if (value == NULL) {
+      Usage(argv);
+      return EXIT_FAILURE;
+    }
+
+    if (!strcmp("-o", arg)) {
+      output = value;
+    } else if (!strcmp("-seed", arg)) {
+      config.seed = static_cast<uint32_t>(strtoul(value, NULL, 10));
+    } else if (!strcmp("-duration", arg)) {
+      config.duration_seconds = strtod(value, NULL);
+    } else if (!strcmp("-video_tracks", arg)) {
+      config.video_tracks = atoi(value);
+    } else if (!strcmp("-audio_tracks", arg)) {
+      config.audio_tracks = atoi(value);
+    } else if (!strcmp("-width", arg)) {
+      config.width = atoi(value);
+    } else if (!strcmp("-height", arg)) {
+      config.height = atoi(value);
+    } else if (!strcmp("-frame_rate", arg)) {
+      config.frame_rate = strtod(value, NULL);
+    } else if (!strcmp("-keyframe_interval", arg)) {
+      config.keyframe_interval = atoi(value);
+    } else if (!strcmp("-keyframe_size", arg)) {
+      config.keyframe_size = strtoul(value, NULL, 10);
+    } else if (!strcmp("-frame_size", arg)) {
+      config.frame_size = strtoul(value, NULL, 10);
+    } else if (!strcmp("-block_additional", arg)) {
+      config.block_additional_size = strtoul(value, NULL, 10);
+    } else if (!strcmp("-audio_frame_ms", arg)) {
+      config.audio_frame_ms = strtod(value, NULL);
+    } else if (!strcmp("-audio_frame_size", arg)) {
+      config.audio_frame_size = strtoul(value, NULL, 10);
+    } else if (!strcmp("-max_cluster_duration", arg)) {
+      config.max_cluster_duration_ns = strtoull(value, NULL, 10) * 1000000;
+    } else if (!strcmp("-max_cluster_size", arg)) {
+      config.max_cluster_size = strtoull(value, NULL, 10);
+    } else if (!strcmp("-lacing", arg)) {
+      if (!ParseLacing(value, &config)) {
+        Usage(argv);
+        return EXIT_FAILURE;
+      }
+    } else if (!strcmp("-max_lace_frames", arg)) {
+      config.max_lace_frames = atoi(value);
+    } else if (!strcmp("-max_lace_duration", arg)) {
+      config.max_lace_duration_ns = strtoull(value, NULL, 10) * 1000000;
+    } else {
+      Usage(argv);
+      return EXIT_FAILURE;
+    }
+    ++i;
+  }
+
+  if (output.empty() || config.width <= 0 || config.height <= 0 ||
+      config.width > 65536 || config.height > 65536) {
+    Usage(argv);
+    return EXIT_FAILURE;
+  }
+
+  mkvmuxer::MkvWriter writer;
+  if (!writer.Open(output.c_str())) {
+    fprintf(stderr, "Cannot open %s.\n", output.c_str());
+    return EXIT_FAILURE;
+  }
+  if (!libwebm::WriteSyntheticWebm(config, &writer)) {
+    fprintf(stderr, "Writing %s failed.\n", output.c_str());
+    return EXIT_FAILURE;
+  }
+  writer.Close();
+  return EXIT_SUCCESS;
+}
@@ -8,16 +8,21 @@
 #include <inttypes.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <queue>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "common/hdr_util.h"
 #include "common/indent.h"
+#include "common/io_stats.h"
+#include "common/trace.h"
 #include "common/vp9_header_parser.h"
 #include "common/vp9_level_stats.h"
 #include "common/webm_constants.h"
@@ -26,6 +31,8 @@
 #include "mkvparser/mkvparser.h"
 #include "mkvparser/mkvreader.h"
 
+#include "webm_info_stats.h"
+
 namespace {
 
 using libwebm::Indent;
@@ -37,6 +44,8 @@ using std::wstring;
 
 const char VERSION_STRING[] = "1.0.4.5";
 
+enum class OutputFormat { kText, kJson, kNdjson };
+
 struct Options {
   Options();
 
@@ -137,7 +146,7 @@ struct FrameStats {
 };
 
 void Usage() {
-  printf("Usage: webm_info [options] -i input\n");
+  printf("Usage: webm_info [options] -i input [input ...]\n");
   printf("\n");
   printf("Main options:\n");
   printf("  -h | -?               show help\n");
@@ -161,6 +170,19 @@ void Usage() {
   printf("  -cues                 Output Cues entries (false)\n");
   printf("  -frame_stats          Output frame stats (VP9)(false)\n");
   printf("  -vp9_level            Output VP9 level(false)\n");
+  printf("\nMachine-readable options:\n");
+  printf("  -json                 Output a JSON summary of each input with\n");
+  printf("                        per-track and per-cluster statistics\n");
+  printf("  -ndjson               As -json, one record per line: a file\n");
+  printf("                        record, then one per cluster\n");
+  printf("  -parser <name>        mkvparser (default) or webm_parser\n");
+  printf("  -jobs <n>             Number of inputs summarized in parallel\n");
+  printf("                        (number of CPUs)\n");
+  printf("\nDiagnostics:\n");
+  printf("  -io_stats             Output the reads, read sizes and seeks of\n");
+  printf("                        the parser\n");
+  printf("  -trace <file>         Write a Chrome trace of the parsing\n");
+  printf("                        (needs a build with ENABLE_TRACING)\n");
   printf("\nOutput options may be negated by prefixing 'no'.\n");
 }
 
@@ -832,7 +854,7 @@ int PrintSubSampleEncryption(const uint8_t* data, int size, FILE* o) {
 
 bool OutputCluster(const mkvparser::Cluster& cluster,
                    const mkvparser::Tracks& tracks, const Options& options,
-                   FILE* o, mkvparser::MkvReader* reader, Indent* indent,
+                   FILE* o, mkvparser::IMkvReader* reader, Indent* indent,
                    int64_t* clusters_size, FrameStats* stats,
                    vp9_parser::Vp9HeaderParser* parser,
                    vp9_parser::Vp9LevelStats* level_stats) {
@@ -1131,90 +1153,36 @@ bool OutputCues(const mkvparser::Segment& segment,
   return true;
 }
 
-}  // namespace
-
-int main(int argc, char* argv[]) {
-  string input;
-  Options options;
-
-  const int argc_check = argc - 1;
-  for (int i = 1; i < argc; ++i) {
-    if (!strcmp("-h", argv[i]) || !strcmp("-?", argv[i])) {
-      Usage();
-      return EXIT_SUCCESS;
-    } else if (!strcmp("-v", argv[i])) {
-      printf("version: %s\n", VERSION_STRING);
-    } else if (!strcmp("-i", argv[i]) && i < argc_check) {
-      input = argv[++i];
-    } else if (!strcmp("-all", argv[i])) {
-      options.SetAll(true);
-    } else if (Options::MatchesBooleanOption("video", argv[i])) {
-      options.output_video = !strcmp("-video", argv[i]);
-    } else if (Options::MatchesBooleanOption("audio", argv[i])) {
-      options.output_audio = !strcmp("-audio", argv[i]);
-    } else if (Options::MatchesBooleanOption("size", argv[i])) {
-      options.output_size = !strcmp("-size", argv[i]);
-    } else if (Options::MatchesBooleanOption("offset", argv[i])) {
-      options.output_offset = !strcmp("-offset", argv[i]);
-    } else if (Options::MatchesBooleanOption("times_seconds", argv[i])) {
-      options.output_seconds = !strcmp("-times_seconds", argv[i]);
-    } else if (Options::MatchesBooleanOption("ebml_header", argv[i])) {
-      options.output_ebml_header = !strcmp("-ebml_header", argv[i]);
-    } else if (Options::MatchesBooleanOption("segment", argv[i])) {
-      options.output_segment = !strcmp("-segment", argv[i]);
-    } else if (Options::MatchesBooleanOption("seekhead", argv[i])) {
-      options.output_seekhead = !strcmp("-seekhead", argv[i]);
-    } else if (Options::MatchesBooleanOption("segment_info", argv[i])) {
-      options.output_segment_info = !strcmp("-segment_info", argv[i]);
-    } else if (Options::MatchesBooleanOption("tracks", argv[i])) {
-      options.output_tracks = !strcmp("-tracks", argv[i]);
-    } else if (Options::MatchesBooleanOption("clusters", argv[i])) {
-      options.output_clusters = !strcmp("-clusters", argv[i]);
-    } else if (Options::MatchesBooleanOption("blocks", argv[i])) {
-      options.output_blocks = !strcmp("-blocks", argv[i]);
-    } else if (Options::MatchesBooleanOption("codec_info", argv[i])) {
-      options.output_codec_info = !strcmp("-codec_info", argv[i]);
-    } else if (Options::MatchesBooleanOption("clusters_size", argv[i])) {
-      options.output_clusters_size = !strcmp("-clusters_size", argv[i]);
-    } else if (Options::MatchesBooleanOption("encrypted_info", argv[i])) {
-      options.output_encrypted_info = !strcmp("-encrypted_info", argv[i]);
-    } else if (Options::MatchesBooleanOption("cues", argv[i])) {
-      options.output_cues = !strcmp("-cues", argv[i]);
-    } else if (Options::MatchesBooleanOption("frame_stats", argv[i])) {
-      options.output_frame_stats = !strcmp("-frame_stats", argv[i]);
-    } else if (Options::MatchesBooleanOption("vp9_level", argv[i])) {
-      options.output_vp9_level = !strcmp("-vp9_level", argv[i]);
-    }
-  }
-
-  if (argc < 3 || input.empty()) {
-    Usage();
-    return EXIT_FAILURE;
-  }
-
-  std::unique_ptr<mkvparser::MkvReader> reader(
+// Writes the text report of |input| to |out|. With |io_stats| a report of
+// the reads made by mkvparser follows.
+int OutputFile(const string& input, Options options, bool io_stats,
+               FILE* out) {
+  std::unique_ptr<mkvparser::MkvReader> file_reader(
       new (std::nothrow) mkvparser::MkvReader());  // NOLINT
-  if (reader->Open(input.c_str())) {
+  if (file_reader->Open(input.c_str())) {
     fprintf(stderr, "Error opening file:%s\n", input.c_str());
     return EXIT_FAILURE;
   }
+  libwebm::InstrumentedMkvReader instrumented_reader(file_reader.get());
+  mkvparser::IMkvReader* const reader =
+      io_stats ? static_cast<mkvparser::IMkvReader*>(&instrumented_reader)
+               : file_reader.get();
 
   long long int pos = 0;
   std::unique_ptr<mkvparser::EBMLHeader> ebml_header(
       new (std::nothrow) mkvparser::EBMLHeader());  // NOLINT
-  if (ebml_header->Parse(reader.get(), pos) < 0) {
+  if (ebml_header->Parse(reader, pos) < 0) {
     fprintf(stderr, "Error parsing EBML header.\n");
     return EXIT_FAILURE;
   }
 
   Indent indent(0);
-  FILE* out = stdout;
 
   if (options.output_ebml_header)
     OutputEBMLHeader(*ebml_header.get(), out, &indent);
 
   mkvparser::Segment* temp_segment;
-  if (mkvparser::Segment::CreateInstance(reader.get(), pos, temp_segment)) {
+  if (mkvparser::Segment::CreateInstance(reader, pos, temp_segment)) {
     fprintf(stderr, "Segment::CreateInstance() failed.\n");
     return EXIT_FAILURE;
   }
@@ -1272,7 +1240,7 @@ int main(int argc, char* argv[]) {
   vp9_parser::Vp9LevelStats level_stats;
   const mkvparser::Cluster* cluster = segment->GetFirst();
   while (cluster != NULL && !cluster->EOS()) {
-    if (!OutputCluster(*cluster, *tracks, options, out, reader.get(), &indent,
+    if (!OutputCluster(*cluster, *tracks, options, out, reader, &indent,
                        &clusters_size, &stats, &parser, &level_stats))
       return EXIT_FAILURE;
     cluster = segment->GetNext(cluster);
@@ -1325,5 +1293,140 @@ int main(int argc, char* argv[]) {
         level_stats.GetMaxColumnTiles(), level_stats.GetMinimumAltrefDistance(),
         level_stats.GetMaxReferenceFrames());
   }
+
+  if (io_stats)
+    fprintf(out, "\nI/O:\n%s", instrumented_reader.stats().Report().c_str());
   return EXIT_SUCCESS;
 }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // setvbuf() must come before anything is written to the stream.
+  FILE* const out = stdout;
+  static char out_buffer[1 << 16];
+  setvbuf(out, out_buffer, _IOFBF, sizeof(out_buffer));
+
+  std::vector<string> inputs;
+  Options options;
+  OutputFormat format = OutputFormat::kText;
+  bool use_webm_parser = false;
+  bool io_stats = false;
+  const char* trace_file = NULL;
+  unsigned jobs = std::thread::hardware_concurrency();
+
+  const int argc_check = argc - 1;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp("-h", argv[i]) || !strcmp("-?", argv[i])) {
+      Usage();
+      return EXIT_SUCCESS;
+    } else if (!strcmp("-v", argv[i])) {
+      printf("version: %s\n", VERSION_STRING);
+    } else if (!strcmp("-i", argv[i]) && i < argc_check) {
+      inputs.push_back(argv[++i]);
+    } else if (!strcmp("-json", argv[i])) {
+      format = OutputFormat::kJson;
+    } else if (!strcmp("-ndjson", argv[i])) {
+      format = OutputFormat::kNdjson;
+    } else if (!strcmp("-parser", argv[i]) && i < argc_check) {
+      const string parser = argv[++i];
+      if (parser == "webm_parser") {
+        use_webm_parser = true;
+      } else if (parser == "mkvparser") {
+        use_webm_parser = false;
+      } else {
+        fprintf(stderr, "Unknown parser:%s\n", parser.c_str());
+        return EXIT_FAILURE;
+      }
+    } else if (!strcmp("-io_stats", argv[i])) {
+      io_stats = true;
+    } else if (!strcmp("-trace", argv[i]) && i < argc_check) {
+      trace_file = argv[++i];
+    } else if (!strcmp("-jobs", argv[i]) && i < argc_check) {
+      jobs = static_cast<unsigned>(strtoul(argv[++i], NULL, 10));
+    } else if (!strcmp("-all", argv[i])) {
+      options.SetAll(true);
+    } else if (Options::MatchesBooleanOption("video", argv[i])) {
+      options.output_video = !strcmp("-video", argv[i]);
+    } else if (Options::MatchesBooleanOption("audio", argv[i])) {
+      options.output_audio = !strcmp("-audio", argv[i]);
+    } else if (Options::MatchesBooleanOption("size", argv[i])) {
+      options.output_size = !strcmp("-size", argv[i]);
+    } else if (Options::MatchesBooleanOption("offset", argv[i])) {
+      options.output_offset = !strcmp("-offset", argv[i]);
+    } else if (Options::MatchesBooleanOption("times_seconds", argv[i])) {
+      options.output_seconds = !strcmp("-times_seconds", argv[i]);
+    } else if (Options::MatchesBooleanOption("ebml_header", argv[i])) {
+      options.output_ebml_header = !strcmp("-ebml_header", argv[i]);
+    } else if (Options::MatchesBooleanOption("segment", argv[i])) {
+      options.output_segment = !strcmp("-segment", argv[i]);
+    } else if (Options::MatchesBooleanOption("seekhead", argv[i])) {
+      options.output_seekhead = !strcmp("-seekhead", argv[i]);
+    } else if (Options::MatchesBooleanOption("segment_info", argv[i])) {
+      options.output_segment_info = !strcmp("-segment_info", argv[i]);
+    } else if (Options::MatchesBooleanOption("tracks", argv[i])) {
+      options.output_tracks = !strcmp("-tracks", argv[i]);
+    } else if (Options::MatchesBooleanOption("clusters", argv[i])) {
+      options.output_clusters = !strcmp("-clusters", argv[i]);
+    } else if (Options::MatchesBooleanOption("blocks", argv[i])) {
+      options.output_blocks = !strcmp("-blocks", argv[i]);
+    } else if (Options::MatchesBooleanOption("codec_info", argv[i])) {
+      options.output_codec_info = !strcmp("-codec_info", argv[i]);
+    } else if (Options::MatchesBooleanOption("clusters_size", argv[i])) {
+      options.output_clusters_size = !strcmp("-clusters_size", argv[i]);
+    } else if (Options::MatchesBooleanOption("encrypted_info", argv[i])) {
+      options.output_encrypted_info = !strcmp("-encrypted_info", argv[i]);
+    } else if (Options::MatchesBooleanOption("cues", argv[i])) {
+      options.output_cues = !strcmp("-cues", argv[i]);
+    } else if (Options::MatchesBooleanOption("frame_stats", argv[i])) {
+      options.output_frame_stats = !strcmp("-frame_stats", argv[i]);
+    } else if (Options::MatchesBooleanOption("vp9_level", argv[i])) {
+      options.output_vp9_level = !strcmp("-vp9_level", argv[i]);
+    } else if (argv[i][0] != '-') {
+      inputs.push_back(argv[i]);
+    }
+  }
+
+  if (inputs.empty()) {
+    Usage();
+    return EXIT_FAILURE;
+  }
+
+  if (use_webm_parser && format == OutputFormat::kText) {
+    fprintf(stderr, "-parser webm_parser requires -json or -ndjson.\n");
+    return EXIT_FAILURE;
+  }
+  if (use_webm_parser && !libwebm::HasWebmParser()) {
+    fprintf(stderr, "webm_info was built without webm_parser.\n");
+    return EXIT_FAILURE;
+  }
+
+  if (trace_file != NULL) {
+    if (!libwebm::Tracer::CompiledIn()) {
+      fprintf(stderr,
+              "webm_info was built without ENABLE_TRACING; the trace is "
+              "empty.\n");
+    }
+    libwebm::Tracer::Get()->Start();
+  }
+
+  bool ok = true;
+  if (format != OutputFormat::kText) {
+    ok = libwebm::WriteSummaries(inputs, format == OutputFormat::kNdjson,
+                                 use_webm_parser, io_stats, jobs, out);
+  } else {
+    for (size_t i = 0; i < inputs.size() && ok; ++i) {
+      if (inputs.size() > 1)
+        fprintf(out, "%s%s:\n", i > 0 ? "\n" : "", inputs[i].c_str());
+      ok = OutputFile(inputs[i], options, io_stats, out) == EXIT_SUCCESS;
+    }
+  }
+
+  if (trace_file != NULL &&
+      !libwebm::Tracer::Get()->WriteChromeTrace(trace_file)) {
+    fprintf(stderr, "Error writing trace file:%s\n", trace_file);
+    return EXIT_FAILURE;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
@@ -0,0 +1,677 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm_info_stats.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "mkvparser/mkvparser.h"
+#include "mkvparser/mkvreader.h"
+
+#ifdef WEBM_INFO_HAVE_WEBM_PARSER
+#include "common/instrumented_webm_reader.h"
+#include "webm/callback.h"
+#include "webm/file_reader.h"
+#include "webm/status.h"
+#include "webm/webm_parser.h"
+#endif
+
+namespace libwebm {
+
+namespace {
+
+bool Fail(const std::string& error, FileSummary* summary) {
+  summary->error = error;
+  return false;
+}
+
+std::string ToString(const char* str) { return str ? str : ""; }
+
+// Both parsers name track types the same way.
+const char* TrackTypeName(long type) {  // NOLINT
+  switch (type) {
+    case mkvparser::Track::kVideo:
+      return "video";
+    case mkvparser::Track::kAudio:
+      return "audio";
+    case mkvparser::Track::kSubtitle:
+      return "subtitle";
+    case mkvparser::Track::kMetadata:
+      return "metadata";
+    default:
+      return "other";
+  }
+}
+
+void AppendString(const std::string& value, std::string* out) {
+  out->push_back('"');
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        out->append("\\\"");
+        break;
+      case '\\':
+        out->append("\\\\");
+        break;
+      case '\n':
+        out->append("\\n");
+        break;
+      case '\r':
+        out->append("\\r");
+        break;
+      case '\t':
+        out->append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out->append(escaped);
+        } else {
+          out->push_back(c);
+        }
+    }
+  }
+  out->push_back('"');
+}
+
+// Appends "name": to |out|, preceded by a comma unless |first|.
+void AppendName(const char* name, bool first, std::string* out) {
+  if (!first)
+    out->push_back(',');
+  AppendString(name, out);
+  out->push_back(':');
+}
+
+void AppendInt(const char* name, int64_t value, bool first,
+               std::string* out) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%" PRId64, value);
+  AppendName(name, first, out);
+  out->append(buffer);
+}
+
+void AppendDouble(const char* name, double value, std::string* out) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%.17g", value);
+  AppendName(name, false, out);
+  out->append(buffer);
+}
+
+void AppendStringMember(const char* name, const std::string& value,
+                        bool first, std::string* out) {
+  AppendName(name, first, out);
+  AppendString(value, out);
+}
+
+void AppendTotals(const FrameTotals& totals, std::string* out) {
+  AppendInt("blocks", totals.blocks, false, out);
+  AppendInt("frames", totals.frames, false, out);
+  AppendInt("key_frames", totals.key_frames, false, out);
+  AppendInt("bytes", totals.bytes, false, out);
+  AppendInt("min_frame_size", totals.min_frame_size, false, out);
+  AppendInt("max_frame_size", totals.max_frame_size, false, out);
+  AppendInt("first_time_ns", totals.first_time_ns, false, out);
+  AppendInt("last_time_ns", totals.last_time_ns, false, out);
+}
+
+void AppendTrack(const TrackSummary& track, std::string* out) {
+  out->push_back('{');
+  AppendInt("number", static_cast<int64_t>(track.number), true, out);
+  AppendStringMember("type", track.type, false, out);
+  AppendStringMember("codec_id", track.codec_id, false, out);
+  if (track.width > 0 || track.height > 0) {
+    AppendInt("width", track.width, false, out);
+    AppendInt("height", track.height, false, out);
+  }
+  if (track.sample_rate > 0 || track.channels > 0) {
+    AppendDouble("sample_rate", track.sample_rate, out);
+    AppendInt("channels", track.channels, false, out);
+  }
+  AppendTotals(track.totals, out);
+  out->push_back('}');
+}
+
+// Appends the members of a cluster record, without braces.
+void AppendClusterMembers(const ClusterSummary& cluster, int64_t index,
+                          std::string* out) {
+  AppendInt("index", index, true, out);
+  AppendInt("offset", cluster.offset, false, out);
+  AppendInt("size", cluster.size, false, out);
+  AppendInt("timecode_ns", cluster.timecode_ns, false, out);
+  AppendTotals(cluster.totals, out);
+}
+
+// Appends the non-empty buckets of |histogram| as [lower bound, count] pairs.
+void AppendHistogram(const char* name, const int64_t* histogram,
+                     std::string* out) {
+  AppendName(name, false, out);
+  out->push_back('[');
+  bool first = true;
+  for (int i = 0; i < IoStats::kHistogramBuckets; ++i) {
+    if (histogram[i] == 0)
+      continue;
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%s[%" PRIu64 ",%" PRId64 "]",
+             first ? "" : ",", i == 0 ? 0 : uint64_t{1} << (i - 1),
+             histogram[i]);
+    out->append(buffer);
+    first = false;
+  }
+  out->push_back(']');
+}
+
+void AppendIoStats(const IoStats& stats, std::string* out) {
+  AppendName("io", false, out);
+  out->push_back('{');
+  AppendInt("reads", stats.reads, true, out);
+  AppendInt("bytes_read", stats.bytes_read, false, out);
+  AppendHistogram("read_sizes", stats.read_sizes, out);
+  AppendInt("length_calls", stats.length_calls, false, out);
+  AppendInt("seeks", stats.seeks, false, out);
+  AppendInt("back_seeks", stats.back_seeks, false, out);
+  AppendInt("seek_bytes", stats.seek_bytes, false, out);
+  AppendInt("max_seek", stats.max_seek, false, out);
+  AppendHistogram("seek_distances", stats.seek_distances, out);
+  AppendInt("errors", stats.errors, false, out);
+  out->push_back('}');
+}
+
+}  // namespace
+
+void FrameTotals::Add(int64_t size, int64_t time_ns, bool is_key) {
+  ++frames;
+  if (is_key)
+    ++key_frames;
+  bytes += size;
+  if (min_frame_size < 0 || size < min_frame_size)
+    min_frame_size = size;
+  if (size > max_frame_size)
+    max_frame_size = size;
+  if (first_time_ns < 0)
+    first_time_ns = time_ns;
+  last_time_ns = time_ns;
+}
+
+TrackSummary* FileSummary::GetTrack(uint64_t number) {
+  for (TrackSummary& track : tracks) {
+    if (track.number == number)
+      return &track;
+  }
+  tracks.push_back(TrackSummary());
+  tracks.back().number = number;
+  return &tracks.back();
+}
+
+namespace {
+
+bool SummarizeMkvparserSegment(mkvparser::IMkvReader* reader,
+                               FileSummary* summary) {
+  long long pos = 0;  // NOLINT
+  mkvparser::EBMLHeader ebml_header;
+  if (ebml_header.Parse(reader, pos) < 0)
+    return Fail("error parsing EBML header", summary);
+  summary->doc_type = ToString(ebml_header.m_docType);
+  summary->doc_type_version = ebml_header.m_docTypeVersion;
+
+  mkvparser::Segment* temp_segment = NULL;
+  if (mkvparser::Segment::CreateInstance(reader, pos, temp_segment))
+    return Fail("Segment::CreateInstance() failed", summary);
+  std::unique_ptr<mkvparser::Segment> segment(temp_segment);
+  if (segment->Load() < 0)
+    return Fail("Segment::Load() failed", summary);
+
+  const mkvparser::SegmentInfo* const info = segment->GetInfo();
+  if (info != NULL) {
+    summary->timecode_scale = info->GetTimeCodeScale();
+    summary->duration_ns = static_cast<double>(info->GetDuration());
+    summary->muxing_app = ToString(info->GetMuxingAppAsUTF8());
+    summary->writing_app = ToString(info->GetWritingAppAsUTF8());
+  }
+
+  const mkvparser::Tracks* const tracks = segment->GetTracks();
+  if (tracks == NULL)
+    return Fail("could not get Tracks", summary);
+
+  for (unsigned long i = 0; i < tracks->GetTracksCount(); ++i) {
+    const mkvparser::Track* const track = tracks->GetTrackByIndex(i);
+    if (track == NULL)
+      continue;
+    TrackSummary* const track_summary = summary->GetTrack(track->GetNumber());
+    track_summary->type = TrackTypeName(track->GetType());
+    track_summary->codec_id = ToString(track->GetCodecId());
+    if (track->GetType() == mkvparser::Track::kVideo) {
+      const mkvparser::VideoTrack* const video =
+          static_cast<const mkvparser::VideoTrack*>(track);
+      track_summary->width = video->GetWidth();
+      track_summary->height = video->GetHeight();
+    } else if (track->GetType() == mkvparser::Track::kAudio) {
+      const mkvparser::AudioTrack* const audio =
+          static_cast<const mkvparser::AudioTrack*>(track);
+      track_summary->sample_rate = audio->GetSamplingRate();
+      track_summary->channels = audio->GetChannels();
+    }
+  }
+
+  // Consecutive blocks usually belong to the same track.
+  TrackSummary* track_summary = NULL;
+  for (const mkvparser::Cluster* cluster = segment->GetFirst();
+       cluster != NULL && !cluster->EOS();
+       cluster = segment->GetNext(cluster)) {
+    summary->clusters.push_back(ClusterSummary());
+    ClusterSummary& cluster_summary = summary->clusters.back();
+    cluster_summary.offset = cluster->m_element_start;
+    cluster_summary.timecode_ns = cluster->GetTime();
+
+    const mkvparser::BlockEntry* entry = NULL;
+    long status = cluster->GetFirst(entry);
+    while (status == 0 && entry != NULL && !entry->EOS()) {
+      const mkvparser::Block* const block = entry->GetBlock();
+      const uint64_t track_number =
+          static_cast<uint64_t>(block->GetTrackNumber());
+      if (track_summary == NULL || track_summary->number != track_number)
+        track_summary = summary->GetTrack(track_number);
+
+      const int64_t time_ns = block->GetTime(cluster);
+      const bool is_key = block->IsKey();
+      ++cluster_summary.totals.blocks;
+      ++track_summary->totals.blocks;
+      for (int i = 0; i < block->GetFrameCount(); ++i) {
+        const int64_t size = block->GetFrame(i).len;
+        cluster_summary.totals.Add(size, time_ns, is_key);
+        track_summary->totals.Add(size, time_ns, is_key);
+      }
+      status = cluster->GetNext(entry, entry);
+    }
+    if (status < 0)
+      return Fail("error parsing Cluster", summary);
+
+    // Known once the cluster has been parsed to its end.
+    cluster_summary.size = cluster->GetElementSize();
+  }
+
+  const mkvparser::Cues* const cues = segment->GetCues();
+  if (cues != NULL) {
+    while (!cues->DoneParsing())
+      cues->LoadCuePoint();
+    summary->cue_points = cues->GetCount();
+  }
+
+  return true;
+}
+
+}  // namespace
+
+bool SummarizeWithMkvparser(const std::string& path, bool io_stats,
+                            FileSummary* summary) {
+  summary->path = path;
+
+  mkvparser::MkvReader reader;
+  if (reader.Open(path.c_str()))
+    return Fail("error opening file", summary);
+  if (!io_stats)
+    return SummarizeMkvparserSegment(&reader, summary);
+
+  InstrumentedMkvReader instrumented_reader(&reader);
+  const bool ok = SummarizeMkvparserSegment(&instrumented_reader, summary);
+  summary->has_io_stats = true;
+  summary->io_stats = instrumented_reader.stats();
+  return ok;
+}
+
+#ifdef WEBM_INFO_HAVE_WEBM_PARSER
+
+namespace {
+
+class SummaryCallback : public webm::Callback {
+ public:
+  SummaryCallback(FileSummary* summary, const webm::Reader* reader)
+      : summary_(summary), reader_(reader) {}
+
+  webm::Status OnElementBegin(const webm::ElementMetadata& metadata,
+                              webm::Action* action) override {
+    // An unknown-size Cluster ends where the next element starts.
+    if (unsized_cluster_ >= 0) {
+      ClusterSummary& cluster_summary = summary_->clusters[unsized_cluster_];
+      cluster_summary.size =
+          static_cast<int64_t>(metadata.position) - cluster_summary.offset;
+      unsized_cluster_ = -1;
+    }
+    return webm::Callback::OnElementBegin(metadata, action);
+  }
+
+  webm::Status OnEbml(const webm::ElementMetadata& /* metadata */,
+                      const webm::Ebml& ebml) override {
+    summary_->doc_type = ebml.doc_type.value();
+    summary_->doc_type_version =
+        static_cast<int64_t>(ebml.doc_type_version.value());
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnInfo(const webm::ElementMetadata& /* metadata */,
+                      const webm::Info& info) override {
+    summary_->timecode_scale =
+        static_cast<int64_t>(info.timecode_scale.value());
+    if (info.duration.is_present()) {
+      summary_->duration_ns =
+          info.duration.value() * static_cast<double>(summary_->timecode_scale);
+    }
+    summary_->muxing_app = info.muxing_app.value();
+    summary_->writing_app = info.writing_app.value();
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnTrackEntry(const webm::ElementMetadata& /* metadata */,
+                            const webm::TrackEntry& track_entry) override {
+    TrackSummary* const track =
+        summary_->GetTrack(track_entry.track_number.value());
+    track->type = TrackTypeName(
+        static_cast<long>(track_entry.track_type.value()));  // NOLINT
+    track->codec_id = track_entry.codec_id.value();
+    if (track_entry.video.is_present()) {
+      const webm::Video& video = track_entry.video.value();
+      track->width = static_cast<int64_t>(video.pixel_width.value());
+      track->height = static_cast<int64_t>(video.pixel_height.value());
+    }
+    if (track_entry.audio.is_present()) {
+      const webm::Audio& audio = track_entry.audio.value();
+      track->sample_rate = audio.sampling_frequency.value();
+      track->channels = static_cast<int64_t>(audio.channels.value());
+    }
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnClusterBegin(const webm::ElementMetadata& metadata,
+                              const webm::Cluster& cluster,
+                              webm::Action* action) override {
+    summary_->clusters.push_back(ClusterSummary());
+    ClusterSummary& cluster_summary = summary_->clusters.back();
+    cluster_summary.offset = static_cast<int64_t>(metadata.position);
+    if (metadata.size != webm::kUnknownElementSize)
+      cluster_summary.size =
+          static_cast<int64_t>(metadata.header_size + metadata.size);
+    cluster_summary.timecode_ns =
+        static_cast<int64_t>(cluster.timecode.value()) * TimecodeScale();
+    *action = webm::Action::kRead;
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnClusterEnd(const webm::ElementMetadata& metadata,
+                            const webm::Cluster& /* cluster */) override {
+    // The reader is past the header of the element that ended an
+    // unknown-size Cluster, if any; OnElementBegin() corrects the size then.
+    if (metadata.size == webm::kUnknownElementSize &&
+        !summary_->clusters.empty()) {
+      ClusterSummary& cluster_summary = summary_->clusters.back();
+      cluster_summary.size =
+          static_cast<int64_t>(reader_->Position()) - cluster_summary.offset;
+      unsized_cluster_ =
+          static_cast<int64_t>(summary_->clusters.size()) - 1;
+    }
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnSimpleBlockBegin(const webm::ElementMetadata& /* metadata */,
+                                  const webm::SimpleBlock& simple_block,
+                                  webm::Action* action) override {
+    BeginBlock(simple_block, simple_block.is_key_frame);
+    *action = webm::Action::kRead;
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnBlockBegin(const webm::ElementMetadata& /* metadata */,
+                            const webm::Block& block,
+                            webm::Action* action) override {
+    // Whether the block is a key frame is known once its BlockGroup ends.
+    BeginBlock(block, false);
+    *action = webm::Action::kRead;
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnBlockGroupEnd(const webm::ElementMetadata& /* metadata */,
+                               const webm::BlockGroup& block_group) override {
+    if (block_group.references.empty() && block_frames_ > 0) {
+      summary_->clusters.back().totals.key_frames += block_frames_;
+      track_->totals.key_frames += block_frames_;
+    }
+    block_frames_ = 0;
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+  webm::Status OnFrame(const webm::FrameMetadata& metadata,
+                       webm::Reader* reader,
+                       std::uint64_t* bytes_remaining) override {
+    // Called again with fewer bytes remaining when the frame is skipped in
+    // several steps; count it once.
+    if (*bytes_remaining == metadata.size && !summary_->clusters.empty() &&
+        track_ != NULL) {
+      const int64_t size = static_cast<int64_t>(metadata.size);
+      summary_->clusters.back().totals.Add(size, block_time_ns_, block_key_);
+      track_->totals.Add(size, block_time_ns_, block_key_);
+      ++block_frames_;
+    }
+    return webm::Callback::OnFrame(metadata, reader, bytes_remaining);
+  }
+
+  webm::Status OnCuePoint(const webm::ElementMetadata& /* metadata */,
+                          const webm::CuePoint& /* cue_point */) override {
+    ++summary_->cue_points;
+    return webm::Status(webm::Status::kOkCompleted);
+  }
+
+ private:
+  int64_t TimecodeScale() const {
+    return summary_->timecode_scale > 0 ? summary_->timecode_scale : 1000000;
+  }
+
+  void BeginBlock(const webm::Block& block, bool is_key) {
+    if (track_ == NULL || track_->number != block.track_number)
+      track_ = summary_->GetTrack(block.track_number);
+    if (!summary_->clusters.empty()) {
+      const ClusterSummary& cluster = summary_->clusters.back();
+      ++summary_->clusters.back().totals.blocks;
+      block_time_ns_ =
+          cluster.timecode_ns + int64_t{block.timecode} * TimecodeScale();
+    }
+    ++track_->totals.blocks;
+    block_key_ = is_key;
+    block_frames_ = 0;
+  }
+
+  FileSummary* const summary_;
+  const webm::Reader* const reader_;
+  // Index of the unknown-size Cluster whose end is not yet known, or -1.
+  int64_t unsized_cluster_ = -1;
+  TrackSummary* track_ = NULL;
+  int64_t block_time_ns_ = 0;
+  bool block_key_ = false;
+  int64_t block_frames_ = 0;
+};
+
+}  // namespace
+
+bool HasWebmParser() { return true; }
+
+bool SummarizeWithWebmParser(const std::string& path, bool io_stats,
+                             FileSummary* summary) {
+  summary->path = path;
+
+  FILE* const file = std::fopen(path.c_str(), "rb");
+  if (file == NULL)
+    return Fail("error opening file", summary);
+
+  webm::FileReader file_reader(file);
+  InstrumentedWebmReader instrumented_reader(&file_reader);
+  webm::Reader* const reader =
+      io_stats ? static_cast<webm::Reader*>(&instrumented_reader)
+               : &file_reader;
+  SummaryCallback callback(summary, reader);
+  webm::WebmParser parser;
+  const webm::Status status = parser.Feed(&callback, reader);
+  if (io_stats) {
+    summary->has_io_stats = true;
+    summary->io_stats = instrumented_reader.stats();
+  }
+  if (!status.completed_ok()) {
+    char error[64];
+    snprintf(error, sizeof(error), "webm_parser error %d",
+             static_cast<int>(status.code));
+    return Fail(error, summary);
+  }
+  return true;
+}
+
+#else  // WEBM_INFO_HAVE_WEBM_PARSER
+
+bool HasWebmParser() { return false; }
+
+bool SummarizeWithWebmParser(const std::string& path, bool /* io_stats */,
+                             FileSummary* summary) {
+  summary->path = path;
+  return Fail("webm_info was built without webm_parser", summary);
+}
+
+#endif  // WEBM_INFO_HAVE_WEBM_PARSER
+
+void AppendJson(const FileSummary& summary, bool ndjson, std::string* out) {
+  out->push_back('{');
+  if (ndjson) {
+    AppendStringMember("type", "file", true, out);
+    AppendStringMember("path", summary.path, false, out);
+  } else {
+    AppendStringMember("path", summary.path, true, out);
+  }
+  if (!summary.error.empty())
+    AppendStringMember("error", summary.error, false, out);
+  AppendStringMember("doc_type", summary.doc_type, false, out);
+  AppendInt("doc_type_version", summary.doc_type_version, false, out);
+  AppendInt("timecode_scale", summary.timecode_scale, false, out);
+  AppendDouble("duration_ns", summary.duration_ns, out);
+  AppendStringMember("muxing_app", summary.muxing_app, false, out);
+  AppendStringMember("writing_app", summary.writing_app, false, out);
+  AppendInt("cue_points", summary.cue_points, false, out);
+
+  int64_t clusters_size = 0;
+  for (const ClusterSummary& cluster : summary.clusters)
+    clusters_size += cluster.size > 0 ? cluster.size : 0;
+  AppendInt("cluster_count", static_cast<int64_t>(summary.clusters.size()),
+            false, out);
+  AppendInt("clusters_size", clusters_size, false, out);
+  if (summary.has_io_stats)
+    AppendIoStats(summary.io_stats, out);
+
+  AppendName("tracks", false, out);
+  out->push_back('[');
+  for (size_t i = 0; i < summary.tracks.size(); ++i) {
+    if (i > 0)
+      out->push_back(',');
+    AppendTrack(summary.tracks[i], out);
+  }
+  out->push_back(']');
+
+  if (ndjson) {
+    out->append("}\n");
+    for (size_t i = 0; i < summary.clusters.size(); ++i) {
+      out->push_back('{');
+      AppendStringMember("type", "cluster", true, out);
+      AppendStringMember("path", summary.path, false, out);
+      out->push_back(',');
+      AppendClusterMembers(summary.clusters[i], static_cast<int64_t>(i), out);
+      out->append("}\n");
+    }
+    return;
+  }
+
+  AppendName("clusters", false, out);
+  out->push_back('[');
+  for (size_t i = 0; i < summary.clusters.size(); ++i) {
+    if (i > 0)
+      out->push_back(',');
+    out->push_back('{');
+    AppendClusterMembers(summary.clusters[i], static_cast<int64_t>(i), out);
+    out->push_back('}');
+  }
+  out->append("]}\n");
+}
+
+bool WriteSummaries(const std::vector<std::string>& inputs, bool ndjson,
+                    bool use_webm_parser, bool io_stats, unsigned jobs,
+                    FILE* out) {
+  std::vector<std::string> results(inputs.size());
+  std::vector<char> done(inputs.size(), 0);
+  bool all_ok = true;
+  size_t next = 0;
+  std::mutex mutex;
+  std::condition_variable done_cond;
+
+  const auto worker = [&]() {
+    for (;;) {
+      size_t index;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (next == inputs.size())
+          return;
+        index = next++;
+      }
+
+      FileSummary summary;
+      const bool ok =
+          use_webm_parser
+              ? SummarizeWithWebmParser(inputs[index], io_stats, &summary)
+              : SummarizeWithMkvparser(inputs[index], io_stats, &summary);
+      std::string json;
+      AppendJson(summary, ndjson, &json);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        results[index].swap(json);
+        done[index] = 1;
+        all_ok = all_ok && ok;
+      }
+      done_cond.notify_all();
+    }
+  };
+
+  jobs = std::max(1u, std::min<unsigned>(jobs, inputs.size()));
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < jobs; ++i)
+    threads.emplace_back(worker);
+
+  // Without |ndjson| several files are written as an array of file objects.
+  const bool array = !ndjson && inputs.size() > 1;
+  if (array)
+    fputs("[\n", out);
+
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::string json;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      done_cond.wait(lock, [&]() { return done[i] != 0; });
+      json.swap(results[i]);
+    }
+    if (array && i + 1 < inputs.size())
+      json.insert(json.size() - 1, ",");
+    fwrite(json.data(), 1, json.size(), out);
+  }
+
+  if (array)
+    fputs("]\n", out);
+
+  for (std::thread& thread : threads)
+    thread.join();
+  return all_ok;
+}
+
+}  // namespace libwebm
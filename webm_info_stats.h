@@ -0,0 +1,111 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef LIBWEBM_WEBM_INFO_STATS_H_
+#define LIBWEBM_WEBM_INFO_STATS_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/io_stats.h"
+
+namespace libwebm {
+
+// Aggregate statistics of the frames of one track, or of one cluster.
+struct FrameTotals {
+  void Add(int64_t size, int64_t time_ns, bool is_key);
+
+  int64_t blocks = 0;
+  int64_t frames = 0;
+  int64_t key_frames = 0;
+  int64_t bytes = 0;
+  int64_t min_frame_size = -1;
+  int64_t max_frame_size = -1;
+  int64_t first_time_ns = -1;
+  int64_t last_time_ns = -1;
+};
+
+struct TrackSummary {
+  uint64_t number = 0;
+  std::string type;
+  std::string codec_id;
+  int64_t width = 0;
+  int64_t height = 0;
+  double sample_rate = 0;
+  int64_t channels = 0;
+  FrameTotals totals;
+};
+
+struct ClusterSummary {
+  int64_t offset = -1;
+  int64_t size = -1;
+  int64_t timecode_ns = -1;
+  FrameTotals totals;
+};
+
+// What webm_info reports about a file in its machine-readable modes: the
+// headers, and per-track and per-cluster aggregates instead of a line per
+// block.
+struct FileSummary {
+  std::string path;
+
+  // Set when the file could not be fully parsed; the summary then holds
+  // what was parsed before the error.
+  std::string error;
+
+  std::string doc_type;
+  int64_t doc_type_version = 0;
+  int64_t timecode_scale = 0;
+  double duration_ns = -1;
+  std::string muxing_app;
+  std::string writing_app;
+  std::vector<TrackSummary> tracks;
+  std::vector<ClusterSummary> clusters;
+  int64_t cue_points = 0;
+
+  // The reads made by the parser, when requested.
+  bool has_io_stats = false;
+  IoStats io_stats;
+
+  // Returns the summary of track |number|, adding it when missing.
+  TrackSummary* GetTrack(uint64_t number);
+};
+
+// Summarizes |path| with mkvparser. Frame data is never read. With
+// |io_stats| the reads of the parser are recorded in |summary->io_stats|.
+// Returns false on error, with |summary->error| set.
+bool SummarizeWithMkvparser(const std::string& path, bool io_stats,
+                            FileSummary* summary);
+
+// Returns true when webm_info was built with the webm_parser library.
+bool HasWebmParser();
+
+// Summarizes |path| with the webm_parser Callback API, skipping over frame
+// data. |io_stats| is as for SummarizeWithMkvparser(). Returns false on
+// error, with |summary->error| set.
+bool SummarizeWithWebmParser(const std::string& path, bool io_stats,
+                             FileSummary* summary);
+
+// Appends |summary| to |out| as a single-line JSON object. With |ndjson| it
+// is instead appended as one line per record: a "file" record with the
+// headers, track totals and I/O statistics, then one "cluster" record per
+// cluster.
+void AppendJson(const FileSummary& summary, bool ndjson, std::string* out);
+
+// Summarizes |inputs| on up to |jobs| threads and writes their JSON to |out|
+// in input order, each as soon as it and the files before it are done. With
+// |ndjson| false and several inputs the records form a JSON array. Returns
+// false when any file failed; its record then holds an "error".
+bool WriteSummaries(const std::vector<std::string>& inputs, bool ndjson,
+                    bool use_webm_parser, bool io_stats, unsigned jobs,
+                    FILE* out);
+
+}  // namespace libwebm
+
+#endif  // LIBWEBM_WEBM_INFO_STATS_H_
@@ -277,6 +277,20 @@ std::ostream& operator<<(std::ostream& os, Id id) {
       return os << "CueDuration";
     case Id::kCueBlockNumber:
       return os << "CueBlockNumber";
+    case Id::kAttachments:
+      return os << "Attachments";
+    case Id::kAttachedFile:
+      return os << "AttachedFile";
+    case Id::kFileDescription:
+      return os << "FileDescription";
+    case Id::kFileName:
+      return os << "FileName";
+    case Id::kFileMimeType:
+      return os << "FileMimeType";
+    case Id::kFileData:
+      return os << "FileData";
+    case Id::kFileUid:
+      return os << "FileUID";
     case Id::kChapters:
       return os << "Chapters";
     case Id::kEditionEntry:
@@ -873,6 +887,10 @@ class DemoCallback : public Callback {
         indent = 1;
         PrintElementMetadata("Cues", metadata);
         break;
+      case Id::kAttachments:
+        indent = 1;
+        PrintElementMetadata("Attachments", metadata);
+        break;
       case Id::kChapters:
         indent = 1;
         PrintElementMetadata("Chapters", metadata);
@@ -1107,6 +1125,32 @@ class DemoCallback : public Callback {
     return Status(Status::kOkCompleted);
   }
 
+  Status OnFileData(const ElementMetadata& metadata, Reader* reader,
+                    std::uint64_t* bytes_remaining) override {
+    indent = 3;
+    PrintValue("file data byte range",
+               '[' + std::to_string(metadata.position + metadata.header_size) +
+                   ", " +
+                   std::to_string(metadata.position + metadata.header_size +
+                                  metadata.size) +
+                   ')');
+    // The base class's implementation will just skip the attachment via
+    // Reader::Skip().
+    return Callback::OnFileData(metadata, reader, bytes_remaining);
+  }
+
+  Status OnAttachedFile(const ElementMetadata& metadata,
+                        const AttachedFile& attached_file) override {
+    indent = 2;
+    PrintElementMetadata("AttachedFile", metadata);
+    indent = 3;
+    PrintOptionalElement("FileDescription", attached_file.description);
+    PrintMandatoryElement("FileName", attached_file.name);
+    PrintMandatoryElement("FileMimeType", attached_file.mime_type);
+    PrintMandatoryElement("FileUID", attached_file.uid);
+    return Status(Status::kOkCompleted);
+  }
+
   Status OnEditionEntry(const ElementMetadata& metadata,
                         const EditionEntry& edition_entry) override {
     indent = 2;
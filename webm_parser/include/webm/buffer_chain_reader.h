@@ -0,0 +1,138 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef INCLUDE_WEBM_BUFFER_CHAIN_READER_H_
+#define INCLUDE_WEBM_BUFFER_CHAIN_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include "./reader.h"
+#include "./status.h"
+
+/**
+ \file
+ A `Reader` implementation that reads from a chain of caller-owned buffers.
+ */
+
+namespace webm {
+
+/**
+ \addtogroup PUBLIC_API
+ @{
+ */
+
+/**
+ A non-blocking reader that reads data from a chain of buffers, such as the
+ packets of a network stream, without copying them into one contiguous buffer.
+
+ The buffers are owned by the caller, who appends them as they arrive and must
+ keep each one alive and unmodified until it has been released by
+ `ReleaseConsumed()`. Buffers are consumed, and released, in the order they
+ were appended.
+
+ When all the appended data has been consumed, `Read()` and `Skip()` return
+ `Status::kWouldBlock`, so `WebmParser::Feed()` returns and may be called
+ again after more data has been appended. Once `SetEndOfStream()` has been
+ called they return `Status::kEndOfFile` instead.
+ */
+class BufferChainReader : public Reader {
+ public:
+  /**
+   Constructs a new, empty reader.
+
+   \param start_position The position of the first byte that will be appended,
+   returned by `Position()` before anything has been read.
+   */
+  explicit BufferChainReader(std::uint64_t start_position = 0)
+      : position_(start_position) {}
+
+  BufferChainReader(const BufferChainReader&) = delete;
+  BufferChainReader& operator=(const BufferChainReader&) = delete;
+
+  /**
+   Appends a buffer to the end of the chain. Empty buffers are ignored.
+
+   \param data The buffer to append. It is not copied, and must remain valid
+   until it has been released by `ReleaseConsumed()` or the reader has been
+   destroyed. Must not be null if `size` is not 0.
+   \param size The number of bytes in `data`.
+   */
+  void Append(const std::uint8_t* data, std::size_t size);
+
+  /**
+   Removes the buffers that have been entirely read or skipped from the front
+   of the chain. The caller may then reuse or free them.
+
+   \return The number of buffers released. These are the oldest buffers still
+   in the chain.
+   */
+  std::size_t ReleaseConsumed();
+
+  /**
+   Marks the end of the stream: no more buffers will be appended, and reading
+   past the last one returns `Status::kEndOfFile` instead of
+   `Status::kWouldBlock`.
+   */
+  void SetEndOfStream() { end_of_stream_ = true; }
+
+  Status Read(std::size_t num_to_read, std::uint8_t* buffer,
+              std::uint64_t* num_actually_read) override;
+
+  Status Skip(std::uint64_t num_to_skip,
+              std::uint64_t* num_actually_skipped) override;
+
+  std::uint64_t Position() const override { return position_; }
+
+  /**
+   Gets the number of bytes that have been appended but not yet consumed.
+   */
+  std::uint64_t available() const { return available_; }
+
+  /**
+   Gets the number of buffers in the chain, including those consumed but not
+   yet released.
+   */
+  std::size_t buffer_count() const { return buffers_.size(); }
+
+ private:
+  struct Buffer {
+    const std::uint8_t* data;
+    std::size_t size;
+  };
+
+  // Advances past up to |num_requested| bytes of the chain, copying them to
+  // |buffer| unless it is null, and stores their number in |num_consumed|.
+  Status Consume(std::uint64_t num_requested, std::uint8_t* buffer,
+                 std::uint64_t* num_consumed);
+
+  // The chain of buffers. Those before |current_| have been consumed.
+  std::deque<Buffer> buffers_;
+
+  // The index in |buffers_| of the buffer being read, and the offset of the
+  // next byte to read within it.
+  std::size_t current_ = 0;
+  std::size_t offset_ = 0;
+
+  // The number of bytes appended but not yet consumed.
+  std::uint64_t available_ = 0;
+
+  // The position of the reader in the stream.
+  std::uint64_t position_;
+
+  // True once no more buffers will be appended.
+  bool end_of_stream_ = false;
+};
+
+/**
+ @}
+ */
+
+}  // namespace webm
+
+#endif  // INCLUDE_WEBM_BUFFER_CHAIN_READER_H_
@@ -128,6 +128,39 @@ class Callback {
   virtual Status OnVoid(const ElementMetadata& metadata, Reader* reader,
                         std::uint64_t* bytes_remaining);
 
+  /**
+   Called when the parser starts the body of a binary element that is
+   normally buffered into its parent's DOM type (`Id::kBlockAdditional`,
+   `Id::kCodecPrivate`, `Id::kProjectionPrivate`, `Id::kTagBinary` and
+   `Id::kContentEncKeyId`). Elements larger than the returned size are not
+   buffered; their bodies are given to `OnBinaryData()` instead, and the
+   corresponding DOM member is marked present with an empty value.
+
+   Defaults to the largest `std::uint64_t`, which buffers every element.
+
+   \param metadata Metadata about the element.
+   */
+  virtual std::uint64_t BinaryStreamingThreshold(
+      const ElementMetadata& metadata);
+
+  /**
+   Called for the body of a binary element larger than
+   `BinaryStreamingThreshold()`. The element's parent is still reported as
+   usual once it has been fully parsed.
+
+   Defaults to calling (and returning the result of) `Reader::Skip()`.
+
+   \param metadata Metadata about the element.
+   \param reader The reader that should be used to consume data. Will not be
+   null.
+   \param[in,out] bytes_remaining The number of remaining bytes that need to be
+   consumed for the element. Will not be null.
+   \return `Status::kOkCompleted` when the element has been fully consumed and
+   `bytes_remaining` is now zero.
+   */
+  virtual Status OnBinaryData(const ElementMetadata& metadata, Reader* reader,
+                              std::uint64_t* bytes_remaining);
+
   /**
    Called when the parser starts an `Id::kSegment` element.
 
@@ -303,6 +336,36 @@ class Callback {
   virtual Status OnCuePoint(const ElementMetadata& metadata,
                             const CuePoint& cue_point);
 
+  /**
+   Called when the parser encounters an `Id::kFileData` element. The
+   attachment's body is never buffered by the parser.
+
+   Defaults to calling (and returning the result of) `Reader::Skip()`, so
+   attachments are not read unless this method is overridden.
+
+   \param metadata Metadata about the element.
+   \param reader The reader that should be used to consume data. Will not be
+   null.
+   \param[in,out] bytes_remaining The number of remaining bytes that need to be
+   consumed for the element. Will not be null.
+   \return `Status::kOkCompleted` when the element has been fully consumed and
+   `bytes_remaining` is now zero.
+   */
+  virtual Status OnFileData(const ElementMetadata& metadata, Reader* reader,
+                            std::uint64_t* bytes_remaining);
+
+  /**
+   Called when the parser encounters an `Id::kAttachedFile` element and it has
+   been fully parsed.
+
+   Defaults to returning `Status::kOkCompleted`.
+
+   \param metadata Metadata about the element.
+   \param attached_file The parsed element.
+   */
+  virtual Status OnAttachedFile(const ElementMetadata& metadata,
+                                const AttachedFile& attached_file);
+
   /**
    Called when the parser encounters an `Id::kEditionEntry` element and it has
    been fully parsed.
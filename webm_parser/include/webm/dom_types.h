@@ -1589,6 +1589,49 @@ struct CuePoint {
   }
 };
 
+/**
+ A parsed \WebMID{AttachedFile} element.
+
+ The body of the \WebMID{FileData} element is not stored; it is given to
+ `Callback::OnFileData()` instead.
+ */
+struct AttachedFile {
+  /**
+   A parsed \WebMID{FileDescription} element.
+   */
+  Element<std::string> description;
+
+  /**
+   A parsed \WebMID{FileName} element.
+   */
+  Element<std::string> name;
+
+  /**
+   A parsed \WebMID{FileMimeType} element.
+   */
+  Element<std::string> mime_type;
+
+  /**
+   The metadata of the \WebMID{FileData} element, which may be used to read
+   the attachment later.
+   */
+  Element<ElementMetadata> data;
+
+  /**
+   A parsed \WebMID{FileUID} element.
+   */
+  Element<std::uint64_t> uid;
+
+  /**
+   Returns true if every member within the two objects are equal.
+   */
+  bool operator==(const AttachedFile& other) const {
+    return description == other.description && name == other.name &&
+           mime_type == other.mime_type && data == other.data &&
+           uid == other.uid;
+  }
+};
+
 /**
  A parsed \WebMID{ChapterDisplay} element.
  */
@@ -0,0 +1,85 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef INCLUDE_WEBM_EPOLL_POLLER_H_
+#define INCLUDE_WEBM_EPOLL_POLLER_H_
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "./parser_driver.h"
+
+/**
+ \file
+ A `Poller` implementation built on Linux epoll.
+ */
+
+namespace webm {
+
+/**
+ \addtogroup PUBLIC_API
+ @{
+ */
+
+/**
+ A level-triggered `Poller` built on Linux epoll. Available on Linux only.
+
+ The poller is not thread safe; it is meant to be driven by one thread that
+ calls `Poll()` in a loop.
+ */
+class EpollPoller : public Poller {
+ public:
+  /**
+   Constructs a new poller. Check `is_open()` for success.
+   */
+  EpollPoller();
+
+  EpollPoller(const EpollPoller&) = delete;
+  EpollPoller& operator=(const EpollPoller&) = delete;
+
+  ~EpollPoller() override;
+
+  bool Add(int fd, Listener* listener) override;
+
+  void Remove(int fd) override;
+
+  /**
+   Waits for watched descriptors to become readable, and notifies their
+   listeners.
+
+   \param timeout_ms The maximum time to wait in milliseconds, or -1 to wait
+   until a descriptor is readable.
+   \return The number of listeners notified, which is 0 if the timeout expired,
+   or -1 on error.
+   */
+  int Poll(int timeout_ms);
+
+  /**
+   Returns true if the epoll instance was created.
+   */
+  bool is_open() const { return epoll_fd_ != -1; }
+
+  /**
+   Gets the number of watched descriptors.
+   */
+  std::size_t size() const { return listeners_.size(); }
+
+ private:
+  // The epoll instance.
+  int epoll_fd_;
+
+  // The listener of each watched descriptor.
+  std::unordered_map<int, Listener*> listeners_;
+};
+
+/**
+ @}
+ */
+
+}  // namespace webm
+
+#endif  // INCLUDE_WEBM_EPOLL_POLLER_H_
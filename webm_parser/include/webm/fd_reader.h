@@ -0,0 +1,104 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef INCLUDE_WEBM_FD_READER_H_
+#define INCLUDE_WEBM_FD_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "./reader.h"
+#include "./status.h"
+
+/**
+ \file
+ A `Reader` implementation that reads from a POSIX file descriptor.
+ */
+
+namespace webm {
+
+/**
+ \addtogroup PUBLIC_API
+ @{
+ */
+
+/**
+ A reader that reads data from a POSIX file descriptor, such as a socket or a
+ pipe. Available on POSIX systems only.
+
+ When the descriptor is in non-blocking mode and has no data ready, `Read()`
+ and `Skip()` return `Status::kWouldBlock`, so `WebmParser::Feed()` returns and
+ may be called again once the descriptor is readable (see `ParserDriver`).
+ */
+class FdReader : public Reader {
+ public:
+  /**
+   Constructs a new reader for the given descriptor.
+
+   \param fd The descriptor to read from. It is not owned by the reader, and
+   must remain open for as long as the reader is used.
+   \param start_position The position of the next byte of the descriptor,
+   returned by `Position()` before anything has been read.
+   */
+  explicit FdReader(int fd, std::uint64_t start_position = 0)
+      : fd_(fd), position_(start_position) {}
+
+  /**
+   Puts a descriptor into non-blocking mode.
+
+   \param fd The descriptor to modify.
+   \return True on success.
+   */
+  static bool SetNonBlocking(int fd);
+
+  /**
+   Reads from the descriptor. Interrupted reads are retried.
+
+   \return `Status::kWouldBlock` if no data is ready on a non-blocking
+   descriptor, `Status::kEndOfFile` at the end of the stream, and
+   `Status::kIoError` if reading failed; `error()` is then the `errno` value.
+   */
+  Status Read(std::size_t num_to_read, std::uint8_t* buffer,
+              std::uint64_t* num_actually_read) override;
+
+  /**
+   Skips data by reading and discarding it, as the descriptors this reader is
+   meant for cannot seek. Returns the same statuses as `Read()`.
+   */
+  Status Skip(std::uint64_t num_to_skip,
+              std::uint64_t* num_actually_skipped) override;
+
+  std::uint64_t Position() const override { return position_; }
+
+  /**
+   Gets the descriptor being read.
+   */
+  int fd() const { return fd_; }
+
+  /**
+   Gets the `errno` value of the last failed read, or 0.
+   */
+  int error() const { return error_; }
+
+ private:
+  // The descriptor to read from. Not owned.
+  int fd_;
+
+  // The position of the reader in the stream.
+  std::uint64_t position_;
+
+  // The errno value of the last failed read.
+  int error_ = 0;
+};
+
+/**
+ @}
+ */
+
+}  // namespace webm
+
+#endif  // INCLUDE_WEBM_FD_READER_H_
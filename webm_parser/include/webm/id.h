@@ -914,6 +914,55 @@ enum class Id : std::uint32_t {
    */
   kCueBlockNumber = 0x5378,
 
+  /**
+   \MatroskaID{Attachments} element ID.
+
+   \WebMTable{Master, 1, No, No, No, , }
+   */
+  kAttachments = 0x1941A469,
+
+  /**
+   \MatroskaID{AttachedFile} element ID.
+
+   \WebMTable{Master, 2, Yes, Yes, No, , }
+   */
+  kAttachedFile = 0x61A7,
+
+  /**
+   \MatroskaID{FileDescription} element ID.
+
+   \WebMTable{UTF-8 string, 3, No, No, No, , }
+   */
+  kFileDescription = 0x467E,
+
+  /**
+   \MatroskaID{FileName} element ID.
+
+   \WebMTable{UTF-8 string, 3, Yes, No, No, , }
+   */
+  kFileName = 0x466E,
+
+  /**
+   \MatroskaID{FileMimeType} element ID.
+
+   \WebMTable{ASCII string, 3, Yes, No, No, , }
+   */
+  kFileMimeType = 0x4660,
+
+  /**
+   \MatroskaID{FileData} element ID.
+
+   \WebMTable{Binary, 3, Yes, No, No, , }
+   */
+  kFileData = 0x465C,
+
+  /**
+   \MatroskaID{FileUID} element ID.
+
+   \WebMTable{Unsigned integer, 3, Yes, No, No, Not 0, }
+   */
+  kFileUid = 0x46AE,
+
   /**
    \MatroskaID{Chapters} element ID.
 
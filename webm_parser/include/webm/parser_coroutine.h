@@ -0,0 +1,124 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef INCLUDE_WEBM_PARSER_COROUTINE_H_
+#define INCLUDE_WEBM_PARSER_COROUTINE_H_
+
+/**
+ \file
+ Awaits a `WebmParser` from a C++20 coroutine. Empty unless the header is
+ compiled as C++20 or later with coroutine support; the library itself does
+ not need it.
+ */
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+
+#include "./callback.h"
+#include "./parser_driver.h"
+#include "./reader.h"
+#include "./status.h"
+#include "./webm_parser.h"
+
+namespace webm {
+
+/**
+ \addtogroup PUBLIC_API
+ @{
+ */
+
+/**
+ An awaitable that feeds a parser until it stops for a reason other than
+ `Status::kWouldBlock`, suspending the awaiting coroutine while the input
+ descriptor has no data. The coroutine is resumed from `Poller` dispatch (for
+ example `EpollPoller::Poll()`), and the `co_await` expression evaluates to
+ the final status. Works with any coroutine type.
+
+ \code{.cpp}
+ webm::Status status = co_await webm::FeedWhenReadable(
+     &poller, socket_fd, &parser, &callback, &reader);
+ \endcode
+ */
+class FeedAwaitable : private Poller::Listener {
+ public:
+  /**
+   See `FeedWhenReadable()`.
+   */
+  FeedAwaitable(Poller* poller, int fd, WebmParser* parser, Callback* callback,
+                Reader* reader)
+      : poller_(poller),
+        fd_(fd),
+        parser_(parser),
+        callback_(callback),
+        reader_(reader) {}
+
+  FeedAwaitable(const FeedAwaitable&) = delete;
+  FeedAwaitable& operator=(const FeedAwaitable&) = delete;
+
+  bool await_ready() {
+    status_ = parser_->Feed(callback_, reader_);
+    return status_.code != Status::kWouldBlock;
+  }
+
+  bool await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    if (!poller_->Add(fd_, this)) {
+      status_ = Status(Status::kIoError);
+      return false;
+    }
+    return true;
+  }
+
+  Status await_resume() const { return status_; }
+
+ private:
+  void OnReadable(int /* fd */) override {
+    status_ = parser_->Feed(callback_, reader_);
+    if (status_.code == Status::kWouldBlock) {
+      return;
+    }
+    poller_->Remove(fd_);
+    handle_.resume();
+  }
+
+  Poller* const poller_;
+  const int fd_;
+  WebmParser* const parser_;
+  Callback* const callback_;
+  Reader* const reader_;
+  Status status_{Status::kOkCompleted};
+  std::coroutine_handle<> handle_;
+};
+
+/**
+ Returns an awaitable that feeds `parser` from `reader` until parsing stops for
+ a reason other than `Status::kWouldBlock`, waiting for `fd` with `poller` in
+ between.
+
+ \param poller The poller that watches `fd`. Must not be null.
+ \param fd The descriptor `reader` reads from.
+ \param parser The parser to feed. Must not be null.
+ \param callback The callback given to `WebmParser::Feed()`. Must not be null.
+ \param reader A reader that reads from `fd` and returns `Status::kWouldBlock`
+ when it has no data ready. Must not be null.
+ */
+inline FeedAwaitable FeedWhenReadable(Poller* poller, int fd,
+                                      WebmParser* parser, Callback* callback,
+                                      Reader* reader) {
+  return FeedAwaitable(poller, fd, parser, callback, reader);
+}
+
+/**
+ @}
+ */
+
+}  // namespace webm
+
+#endif  // __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#endif  // INCLUDE_WEBM_PARSER_COROUTINE_H_
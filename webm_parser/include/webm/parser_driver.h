@@ -0,0 +1,177 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef INCLUDE_WEBM_PARSER_DRIVER_H_
+#define INCLUDE_WEBM_PARSER_DRIVER_H_
+
+#include <functional>
+
+#include "./callback.h"
+#include "./reader.h"
+#include "./status.h"
+#include "./webm_parser.h"
+
+/**
+ \file
+ Runs a `WebmParser` from an event loop, resuming it when its input is ready.
+ */
+
+namespace webm {
+
+/**
+ \addtogroup PUBLIC_API
+ @{
+ */
+
+/**
+ An interface to an event loop that reports when file descriptors (or other
+ integer handles) are readable, such as one built on epoll, kqueue, or poll.
+ See `EpollPoller` for an implementation.
+ */
+class Poller {
+ public:
+  /**
+   Receives readiness notifications from a `Poller`.
+   */
+  class Listener {
+   public:
+    virtual ~Listener() = default;
+
+    /**
+     Called by the poller whenever `fd` is readable, or has reached its end or
+     failed, until `Poller::Remove()` is called for it. Reading from `fd` must
+     not block the first time after this is called.
+
+     \param fd The readable descriptor.
+     */
+    virtual void OnReadable(int fd) = 0;
+  };
+
+  virtual ~Poller() = default;
+
+  /**
+   Starts watching a descriptor.
+
+   \param fd The descriptor to watch. Must not already be watched.
+   \param listener The listener to notify when `fd` is readable. Must not be
+   null, and must remain valid until `Remove()` is called for `fd`.
+   \return True on success.
+   */
+  virtual bool Add(int fd, Listener* listener) = 0;
+
+  /**
+   Stops watching a descriptor. May be called from `Listener::OnReadable()`.
+
+   \param fd The descriptor to stop watching. Does nothing if it is not
+   watched.
+   */
+  virtual void Remove(int fd) = 0;
+};
+
+/**
+ Parses a WebM stream read from a non-blocking descriptor, feeding the parser
+ whenever the descriptor is readable. Many drivers can share one `Poller`, so
+ one thread can demux many concurrent streams.
+
+ For example, with `EpollPoller`:
+
+ \code{.cpp}
+ webm::EpollPoller poller;
+ webm::FdReader reader(socket_fd);
+ webm::FdReader::SetNonBlocking(socket_fd);
+ webm::ParserDriver driver(&poller, socket_fd, &reader, &callback,
+                           [](webm::Status status) { ... });
+ driver.Start();
+ while (poller.size() > 0) {
+   poller.Poll(-1);
+ }
+ \endcode
+ */
+class ParserDriver : public Poller::Listener {
+ public:
+  /**
+   Called with the final status of the parser.
+   */
+  using DoneFunction = std::function<void(Status status)>;
+
+  /**
+   Constructs a new driver. Parsing starts with `Start()`.
+
+   \param poller The poller that watches `fd`. Must not be null.
+   \param fd The descriptor the reader reads from.
+   \param reader A reader that reads from `fd`, and returns
+   `Status::kWouldBlock` when `fd` has no data ready. Must not be null.
+   \param callback The callback given to `WebmParser::Feed()`. Must not be
+   null.
+   \param done Called once parsing stops for any reason other than
+   `Status::kWouldBlock`, after `fd` has been removed from the poller. The
+   driver may be destroyed from it. May be empty.
+
+   The poller, reader, and callback must outlive the driver.
+   */
+  ParserDriver(Poller* poller, int fd, Reader* reader, Callback* callback,
+               DoneFunction done);
+
+  ParserDriver(const ParserDriver&) = delete;
+  ParserDriver& operator=(const ParserDriver&) = delete;
+
+  /**
+   Removes `fd` from the poller if it is still watched.
+   */
+  ~ParserDriver() override;
+
+  /**
+   Feeds the parser with the data available now. If the reader would block,
+   starts watching `fd` so that parsing resumes when it is readable.
+
+   Does nothing while `fd` is already watched, as parsing then continues in
+   the event loop.
+
+   \return `Status::kWouldBlock` if parsing continues in the event loop.
+   Otherwise parsing has stopped and the final status is returned; `done` is
+   not called. `Status::kIoError` if `fd` could not be watched.
+   */
+  Status Start();
+
+  void OnReadable(int fd) override;
+
+  /**
+   Gets the parser, for example to call `WebmParser::DidSeek()` or to stop
+   parsing with `Stop()` and feed it elsewhere.
+   */
+  WebmParser* parser() { return &parser_; }
+
+  /**
+   Stops watching `fd` without calling `done`. Parsing may be resumed with
+   `Start()`.
+   */
+  void Stop();
+
+  /**
+   Returns true while `fd` is watched.
+   */
+  bool watching() const { return watching_; }
+
+ private:
+  Poller* const poller_;
+  const int fd_;
+  Reader* const reader_;
+  Callback* const callback_;
+  const DoneFunction done_;
+  WebmParser parser_;
+
+  // True while |fd_| is registered with |poller_|.
+  bool watching_ = false;
+};
+
+/**
+ @}
+ */
+
+}  // namespace webm
+
+#endif  // INCLUDE_WEBM_PARSER_DRIVER_H_
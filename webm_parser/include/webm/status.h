@@ -56,6 +56,11 @@ struct Status {
      */
     kEndOfFile = -3,
 
+    /**
+     Reading from, or waiting for, the data source failed.
+     */
+    kIoError = -4,
+
     // Parsing errors. Range: -1025 to -2048.
     /**
      An element's ID is malformed.
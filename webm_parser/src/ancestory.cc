@@ -96,6 +96,11 @@ bool Ancestory::ById(Id id, Ancestory* ancestory) {
       Id::kCuePoint,
       Id::kCueTrackPositions,
   };
+  static constexpr Id kAttachedFileAncestory[] = {
+      Id::kSegment,
+      Id::kAttachments,
+      Id::kAttachedFile,
+  };
   static constexpr Id kChapterDisplayAncestory[] = {
       Id::kSegment,     Id::kChapters,       Id::kEditionEntry,
       Id::kChapterAtom, Id::kChapterDisplay,
@@ -129,6 +134,7 @@ bool Ancestory::ById(Id id, Ancestory* ancestory) {
     case Id::kCluster:
     case Id::kTracks:
     case Id::kCues:
+    case Id::kAttachments:
     case Id::kChapters:
     case Id::kTags:
       *ancestory = Ancestory(kSeekAncestory, 1);
@@ -273,6 +279,18 @@ bool Ancestory::ById(Id id, Ancestory* ancestory) {
       *ancestory = Ancestory(kCueTrackPositionsAncestory, 4);
       return true;
 
+    case Id::kAttachedFile:
+      *ancestory = Ancestory(kAttachedFileAncestory, 2);
+      return true;
+
+    case Id::kFileDescription:
+    case Id::kFileName:
+    case Id::kFileMimeType:
+    case Id::kFileData:
+    case Id::kFileUid:
+      *ancestory = Ancestory(kAttachedFileAncestory, 3);
+      return true;
+
     case Id::kEditionEntry:
       *ancestory = Ancestory(kChapterDisplayAncestory, 2);
       return true;
@@ -0,0 +1,42 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef SRC_ATTACHED_FILE_PARSER_H_
+#define SRC_ATTACHED_FILE_PARSER_H_
+
+#include "src/byte_parser.h"
+#include "src/file_data_parser.h"
+#include "src/int_parser.h"
+#include "src/master_value_parser.h"
+#include "webm/dom_types.h"
+#include "webm/id.h"
+
+namespace webm {
+
+// Spec reference:
+// http://matroska.org/technical/specs/index.html#AttachedFile
+class AttachedFileParser : public MasterValueParser<AttachedFile> {
+ public:
+  AttachedFileParser()
+      : MasterValueParser<AttachedFile>(
+            MakeChild<StringParser>(Id::kFileDescription,
+                                    &AttachedFile::description),
+            MakeChild<StringParser>(Id::kFileName, &AttachedFile::name),
+            MakeChild<StringParser>(Id::kFileMimeType,
+                                    &AttachedFile::mime_type),
+            MakeChild<FileDataParser>(Id::kFileData, &AttachedFile::data),
+            MakeChild<UnsignedIntParser>(Id::kFileUid, &AttachedFile::uid)) {}
+
+ protected:
+  Status OnParseCompleted(Callback* callback) override {
+    return callback->OnAttachedFile(metadata(Id::kAttachedFile), value());
+  }
+};
+
+}  // namespace webm
+
+#endif  // SRC_ATTACHED_FILE_PARSER_H_
@@ -0,0 +1,27 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef SRC_ATTACHMENTS_PARSER_H_
+#define SRC_ATTACHMENTS_PARSER_H_
+
+#include "src/attached_file_parser.h"
+#include "src/master_parser.h"
+#include "webm/id.h"
+
+namespace webm {
+
+// Spec reference:
+// http://matroska.org/technical/specs/index.html#Attachments
+class AttachmentsParser : public MasterParser {
+ public:
+  AttachmentsParser()
+      : MasterParser(MakeChild<AttachedFileParser>(Id::kAttachedFile)) {}
+};
+
+}  // namespace webm
+
+#endif  // SRC_ATTACHMENTS_PARSER_H_
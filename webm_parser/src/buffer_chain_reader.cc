@@ -0,0 +1,91 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/buffer_chain_reader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "webm/status.h"
+
+namespace webm {
+
+void BufferChainReader::Append(const std::uint8_t* data, std::size_t size) {
+  assert(data != nullptr || size == 0);
+
+  if (size == 0) {
+    return;
+  }
+  buffers_.push_back(Buffer{data, size});
+  available_ += size;
+}
+
+std::size_t BufferChainReader::ReleaseConsumed() {
+  const std::size_t num_released = current_;
+  buffers_.erase(buffers_.begin(), buffers_.begin() + current_);
+  current_ = 0;
+  return num_released;
+}
+
+Status BufferChainReader::Read(std::size_t num_to_read, std::uint8_t* buffer,
+                               std::uint64_t* num_actually_read) {
+  assert(num_to_read > 0);
+  assert(buffer != nullptr);
+  assert(num_actually_read != nullptr);
+
+  return Consume(num_to_read, buffer, num_actually_read);
+}
+
+Status BufferChainReader::Skip(std::uint64_t num_to_skip,
+                               std::uint64_t* num_actually_skipped) {
+  assert(num_to_skip > 0);
+  assert(num_actually_skipped != nullptr);
+
+  return Consume(num_to_skip, nullptr, num_actually_skipped);
+}
+
+Status BufferChainReader::Consume(std::uint64_t num_requested,
+                                  std::uint8_t* buffer,
+                                  std::uint64_t* num_consumed) {
+  *num_consumed = 0;
+
+  if (available_ == 0) {
+    return Status(end_of_stream_ ? Status::kEndOfFile : Status::kWouldBlock);
+  }
+
+  const std::uint64_t num_to_consume = std::min(num_requested, available_);
+  std::uint64_t num_remaining = num_to_consume;
+  while (num_remaining > 0) {
+    const Buffer& current = buffers_[current_];
+    const std::size_t chunk_size = static_cast<std::size_t>(
+        std::min<std::uint64_t>(num_remaining, current.size - offset_));
+    if (buffer != nullptr) {
+      std::copy_n(current.data + offset_, chunk_size, buffer);
+      buffer += chunk_size;
+    }
+    offset_ += chunk_size;
+    num_remaining -= chunk_size;
+    if (offset_ == current.size) {
+      ++current_;
+      offset_ = 0;
+    }
+  }
+
+  available_ -= num_to_consume;
+  position_ += num_to_consume;
+  *num_consumed = num_to_consume;
+
+  if (num_to_consume != num_requested) {
+    return Status(Status::kOkPartial);
+  }
+
+  return Status(Status::kOkCompleted);
+}
+
+}  // namespace webm
@@ -10,7 +10,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -68,12 +70,16 @@ class ByteParser : public ElementParser {
     }
 #endif
 
+    metadata_ = metadata;
+    streaming_ = false;
     if (metadata.size == 0) {
       value_ = default_value_;
       total_read_ = default_value_.size();
+      allocated_ = true;
     } else {
-      value_.resize(static_cast<std::size_t>(metadata.size));
+      value_.clear();
       total_read_ = 0;
+      allocated_ = false;
     }
 
     return Status(Status::kOkCompleted);
@@ -87,6 +93,30 @@ class ByteParser : public ElementParser {
 
     *num_bytes_read = 0;
 
+    // Binary elements above the callback's threshold are handed to the
+    // callback instead of being buffered. The buffer is only allocated once
+    // that decision has been made.
+    if (!allocated_) {
+      if (std::is_same<T, std::vector<std::uint8_t>>::value &&
+          metadata_.size > callback->BinaryStreamingThreshold(metadata_)) {
+        streaming_ = true;
+        bytes_remaining_ = metadata_.size;
+      } else {
+        value_.resize(static_cast<std::size_t>(metadata_.size));
+      }
+      allocated_ = true;
+    }
+
+    if (streaming_) {
+      const std::uint64_t original_bytes_remaining = bytes_remaining_;
+      const Status status =
+          callback->OnBinaryData(metadata_, reader, &bytes_remaining_);
+      assert(bytes_remaining_ <= original_bytes_remaining);
+      assert(!status.completed_ok() || bytes_remaining_ == 0);
+      *num_bytes_read = original_bytes_remaining - bytes_remaining_;
+      return status;
+    }
+
     if (total_read_ == value_.size()) {
       return Status(Status::kOkCompleted);
     }
@@ -116,7 +146,8 @@ class ByteParser : public ElementParser {
     return status;
   }
 
-  // Gets the parsed value. This must not be called until the parse has been
+  // Gets the parsed value, which is empty if the element was streamed to
+  // Callback::OnBinaryData. This must not be called until the parse has been
   // successfully completed.
   const T& value() const {
     assert(total_read_ >= value_.size());
@@ -134,6 +165,10 @@ class ByteParser : public ElementParser {
   T value_;
   T default_value_;
   std::size_t total_read_;
+  ElementMetadata metadata_;
+  bool allocated_;
+  bool streaming_;
+  std::uint64_t bytes_remaining_;
 };
 
 using StringParser = ByteParser<std::string>;
@@ -8,6 +8,7 @@
 #include "webm/callback.h"
 
 #include <cassert>
+#include <limits>
 
 namespace webm {
 
@@ -38,6 +39,18 @@ Status Callback::OnVoid(const ElementMetadata& /* metadata */, Reader* reader,
   return Skip(reader, bytes_remaining);
 }
 
+std::uint64_t Callback::BinaryStreamingThreshold(
+    const ElementMetadata& /* metadata */) {
+  return std::numeric_limits<std::uint64_t>::max();
+}
+
+Status Callback::OnBinaryData(const ElementMetadata& /* metadata */,
+                              Reader* reader, std::uint64_t* bytes_remaining) {
+  assert(reader != nullptr);
+  assert(bytes_remaining != nullptr);
+  return Skip(reader, bytes_remaining);
+}
+
 Status Callback::OnSegmentBegin(const ElementMetadata& /* metadata */,
                                 Action* action) {
   assert(action != nullptr);
@@ -121,6 +134,18 @@ Status Callback::OnCuePoint(const ElementMetadata& /* metadata */,
   return Status(Status::kOkCompleted);
 }
 
+Status Callback::OnFileData(const ElementMetadata& /* metadata */,
+                            Reader* reader, std::uint64_t* bytes_remaining) {
+  assert(reader != nullptr);
+  assert(bytes_remaining != nullptr);
+  return Skip(reader, bytes_remaining);
+}
+
+Status Callback::OnAttachedFile(const ElementMetadata& /* metadata */,
+                                const AttachedFile& /* attached_file */) {
+  return Status(Status::kOkCompleted);
+}
+
 Status Callback::OnEditionEntry(const ElementMetadata& /* metadata */,
                                 const EditionEntry& /* edition_entry */) {
   return Status(Status::kOkCompleted);
@@ -8,6 +8,7 @@
 #ifndef SRC_CLUSTER_PARSER_H_
 #define SRC_CLUSTER_PARSER_H_
 
+#include "common/trace.h"
 #include "src/block_group_parser.h"
 #include "src/block_parser.h"
 #include "src/int_parser.h"
@@ -35,11 +36,25 @@ class ClusterParser : public MasterValueParser<Cluster> {
 
  protected:
   Status OnParseStarted(Callback* callback, Action* action) override {
-    return callback->OnClusterBegin(metadata(Id::kCluster), value(), action);
+    const Status status =
+        callback->OnClusterBegin(metadata(Id::kCluster), value(), action);
+    // The Cluster span starts at the first block, where OnClusterBegin() is
+    // called, and ends with OnClusterEnd().
+    if (status.completed_ok() && *action == Action::kRead) {
+      LIBWEBM_TRACE_ASYNC_BEGIN("webm_parser", "Cluster", this,
+                                metadata(Id::kCluster).position);
+    }
+    return status;
   }
 
   Status OnParseCompleted(Callback* callback) override {
-    return callback->OnClusterEnd(metadata(Id::kCluster), value());
+    const Status status =
+        callback->OnClusterEnd(metadata(Id::kCluster), value());
+    if (status.completed_ok()) {
+      LIBWEBM_TRACE_ASYNC_END("webm_parser", "Cluster", this,
+                              metadata(Id::kCluster).position);
+    }
+    return status;
   }
 };
 
@@ -0,0 +1,81 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/epoll_poller.h"
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <cassert>
+
+namespace webm {
+
+namespace {
+
+// The most events handled by one call to Poll().
+const int kMaxEvents = 64;
+
+}  // namespace
+
+EpollPoller::EpollPoller() : epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {}
+
+EpollPoller::~EpollPoller() {
+  if (epoll_fd_ != -1) {
+    close(epoll_fd_);
+  }
+}
+
+bool EpollPoller::Add(int fd, Listener* listener) {
+  assert(listener != nullptr);
+
+  if (epoll_fd_ == -1 || listeners_.count(fd) != 0) {
+    return false;
+  }
+
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+    return false;
+  }
+  listeners_[fd] = listener;
+  return true;
+}
+
+void EpollPoller::Remove(int fd) {
+  if (listeners_.erase(fd) != 0) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  }
+}
+
+int EpollPoller::Poll(int timeout_ms) {
+  if (epoll_fd_ == -1) {
+    return -1;
+  }
+
+  epoll_event events[kMaxEvents];
+  const int num_events = epoll_wait(epoll_fd_, events, kMaxEvents, timeout_ms);
+  if (num_events < 0) {
+    return errno == EINTR ? 0 : -1;
+  }
+
+  int num_notified = 0;
+  for (int i = 0; i < num_events; ++i) {
+    // Listeners may remove any descriptor, so look each one up when it is
+    // notified rather than beforehand.
+    const auto it = listeners_.find(events[i].data.fd);
+    if (it == listeners_.end()) {
+      continue;
+    }
+    it->second->OnReadable(events[i].data.fd);
+    ++num_notified;
+  }
+  return num_notified;
+}
+
+}  // namespace webm
@@ -0,0 +1,101 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/fd_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "webm/status.h"
+
+namespace webm {
+
+bool FdReader::SetNonBlocking(int fd) {
+  const int flags = fcntl(fd, F_GETFL);
+  return flags != -1 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1;
+}
+
+Status FdReader::Read(std::size_t num_to_read, std::uint8_t* buffer,
+                      std::uint64_t* num_actually_read) {
+  assert(num_to_read > 0);
+  assert(buffer != nullptr);
+  assert(num_actually_read != nullptr);
+
+  *num_actually_read = 0;
+
+  // Large requests may be read in several parts.
+  if (num_to_read >
+      static_cast<std::size_t>(std::numeric_limits<ssize_t>::max())) {
+    num_to_read = static_cast<std::size_t>(std::numeric_limits<ssize_t>::max());
+  }
+
+  ssize_t actual;
+  do {
+    actual = read(fd_, buffer, num_to_read);
+  } while (actual < 0 && errno == EINTR);
+
+  if (actual < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+      return Status(Status::kWouldBlock);
+    }
+    error_ = errno;
+    return Status(Status::kIoError);
+  }
+
+  if (actual == 0) {
+    return Status(Status::kEndOfFile);
+  }
+
+  *num_actually_read = static_cast<std::uint64_t>(actual);
+  position_ += *num_actually_read;
+
+  if (static_cast<std::size_t>(actual) == num_to_read) {
+    return Status(Status::kOkCompleted);
+  } else {
+    return Status(Status::kOkPartial);
+  }
+}
+
+Status FdReader::Skip(std::uint64_t num_to_skip,
+                      std::uint64_t* num_actually_skipped) {
+  assert(num_to_skip > 0);
+  assert(num_actually_skipped != nullptr);
+
+  *num_actually_skipped = 0;
+
+  Status status;
+  do {
+    std::uint8_t junk[4096];
+    std::size_t num_to_read = sizeof(junk);
+    if (num_to_skip < num_to_read) {
+      num_to_read = static_cast<std::size_t>(num_to_skip);
+    }
+
+    std::uint64_t actual;
+    status = Read(num_to_read, junk, &actual);
+    *num_actually_skipped += actual;
+    num_to_skip -= actual;
+  } while (status.completed_ok() && num_to_skip > 0);
+
+  if (*num_actually_skipped == 0) {
+    return status;
+  }
+
+  if (num_to_skip == 0) {
+    return Status(Status::kOkCompleted);
+  } else {
+    return Status(Status::kOkPartial);
+  }
+}
+
+}  // namespace webm
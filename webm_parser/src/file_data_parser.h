@@ -0,0 +1,51 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#ifndef SRC_FILE_DATA_PARSER_H_
+#define SRC_FILE_DATA_PARSER_H_
+
+#include <cstdint>
+
+#include "src/element_parser.h"
+#include "webm/callback.h"
+#include "webm/element.h"
+#include "webm/reader.h"
+#include "webm/status.h"
+
+namespace webm {
+
+// Parses FileData elements by delegating their bodies to
+// Callback::OnFileData. The value of the parser is the element's metadata, so
+// the attachment can be located again without having been buffered.
+// Spec reference:
+// http://matroska.org/technical/specs/index.html#FileData
+class FileDataParser : public ElementParser {
+ public:
+  Status Init(const ElementMetadata& metadata, std::uint64_t max_size) override;
+
+  Status Feed(Callback* callback, Reader* reader,
+              std::uint64_t* num_bytes_read) override;
+
+  // Gets the metadata of the parsed element. This must not be called until the
+  // parse has been successfully completed.
+  const ElementMetadata& value() const { return metadata_; }
+
+  // Gets the metadata of the parsed element. This must not be called until the
+  // parse has been successfully completed.
+  ElementMetadata* mutable_value() { return &metadata_; }
+
+ private:
+  // The metadata for this element.
+  ElementMetadata metadata_;
+
+  // The number of bytes remaining that have not been read in the element.
+  std::uint64_t bytes_remaining_;
+};
+
+}  // namespace webm
+
+#endif  // SRC_FILE_DATA_PARSER_H_
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/parser_driver.h"
+
+#include <cassert>
+#include <utility>
+
+#include "webm/status.h"
+
+namespace webm {
+
+ParserDriver::ParserDriver(Poller* poller, int fd, Reader* reader,
+                           Callback* callback, DoneFunction done)
+    : poller_(poller),
+      fd_(fd),
+      reader_(reader),
+      callback_(callback),
+      done_(std::move(done)) {
+  assert(poller != nullptr);
+  assert(reader != nullptr);
+  assert(callback != nullptr);
+}
+
+ParserDriver::~ParserDriver() { Stop(); }
+
+Status ParserDriver::Start() {
+  // Already started: parsing continues in OnReadable(), which also reports
+  // the final status and removes |fd_|.
+  if (watching_) {
+    return Status(Status::kWouldBlock);
+  }
+
+  const Status status = parser_.Feed(callback_, reader_);
+  if (status.code != Status::kWouldBlock) {
+    return status;
+  }
+
+  if (!poller_->Add(fd_, this)) {
+    return Status(Status::kIoError);
+  }
+  watching_ = true;
+  return status;
+}
+
+void ParserDriver::Stop() {
+  if (watching_) {
+    poller_->Remove(fd_);
+    watching_ = false;
+  }
+}
+
+void ParserDriver::OnReadable(int /* fd */) {
+  const Status status = parser_.Feed(callback_, reader_);
+  if (status.code == Status::kWouldBlock) {
+    return;
+  }
+
+  Stop();
+  if (done_) {
+    // Call a copy, as |done_| may destroy this driver.
+    const DoneFunction done = done_;
+    done(status);
+  }
+}
+
+}  // namespace webm
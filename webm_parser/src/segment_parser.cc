@@ -7,6 +7,7 @@
 // be found in the AUTHORS file in the root of the source tree.
 #include "src/segment_parser.h"
 
+#include "src/attachments_parser.h"
 #include "src/chapters_parser.h"
 #include "src/cluster_parser.h"
 #include "src/cues_parser.h"
@@ -20,7 +21,8 @@
 namespace webm {
 
 SegmentParser::SegmentParser()
-    : MasterParser(MakeChild<ChaptersParser>(Id::kChapters),
+    : MasterParser(MakeChild<AttachmentsParser>(Id::kAttachments),
+                   MakeChild<ChaptersParser>(Id::kChapters),
                    MakeChild<ClusterParser>(Id::kCluster),
                    MakeChild<CuesParser>(Id::kCues),
                    MakeChild<InfoParser>(Id::kInfo),
@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cstdint>
 
+#include "common/trace.h"
 #include "src/ebml_parser.h"
 #include "src/master_parser.h"
 #include "src/segment_parser.h"
@@ -267,6 +268,8 @@ Status WebmParser::Feed(Callback* callback, Reader* reader) {
   if (parsing_status_.is_parsing_error()) {
     return parsing_status_;
   }
+  LIBWEBM_TRACE_SCOPE_ARG("webm_parser", "WebmParser::Feed", "position",
+                          reader->Position());
   parsing_status_ = parser_->Feed(callback, reader);
   return parsing_status_;
 }
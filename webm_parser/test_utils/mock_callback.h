@@ -35,6 +35,11 @@ class MockCallback : public Callback {
         .WillByDefault(Invoke(this, &MockCallback::OnEbmlConcrete));
     ON_CALL(*this, OnVoid(_, _, _))
         .WillByDefault(Invoke(this, &MockCallback::OnVoidConcrete));
+    ON_CALL(*this, BinaryStreamingThreshold(_))
+        .WillByDefault(
+            Invoke(this, &MockCallback::BinaryStreamingThresholdConcrete));
+    ON_CALL(*this, OnBinaryData(_, _, _))
+        .WillByDefault(Invoke(this, &MockCallback::OnBinaryDataConcrete));
     ON_CALL(*this, OnSegmentBegin(_, _))
         .WillByDefault(Invoke(this, &MockCallback::OnSegmentBeginConcrete));
     ON_CALL(*this, OnSeek(_, _))
@@ -63,6 +68,10 @@ class MockCallback : public Callback {
         .WillByDefault(Invoke(this, &MockCallback::OnTrackEntryConcrete));
     ON_CALL(*this, OnCuePoint(_, _))
         .WillByDefault(Invoke(this, &MockCallback::OnCuePointConcrete));
+    ON_CALL(*this, OnFileData(_, _, _))
+        .WillByDefault(Invoke(this, &MockCallback::OnFileDataConcrete));
+    ON_CALL(*this, OnAttachedFile(_, _))
+        .WillByDefault(Invoke(this, &MockCallback::OnAttachedFileConcrete));
     ON_CALL(*this, OnEditionEntry(_, _))
         .WillByDefault(Invoke(this, &MockCallback::OnEditionEntryConcrete));
     ON_CALL(*this, OnTag(_, _))
@@ -85,6 +94,13 @@ class MockCallback : public Callback {
   MOCK_METHOD3(OnVoid, Status(const ElementMetadata& metadata, Reader* reader,
                               std::uint64_t* bytes_remaining));
 
+  MOCK_METHOD1(BinaryStreamingThreshold,
+               std::uint64_t(const ElementMetadata& metadata));
+
+  MOCK_METHOD3(OnBinaryData,
+               Status(const ElementMetadata& metadata, Reader* reader,
+                      std::uint64_t* bytes_remaining));
+
   MOCK_METHOD2(OnSegmentBegin,
                Status(const ElementMetadata& metadata, Action* action));
 
@@ -128,6 +144,13 @@ class MockCallback : public Callback {
   MOCK_METHOD2(OnCuePoint, Status(const ElementMetadata& metadata,
                                   const CuePoint& cue_point));
 
+  MOCK_METHOD3(OnFileData,
+               Status(const ElementMetadata& metadata, Reader* reader,
+                      std::uint64_t* bytes_remaining));
+
+  MOCK_METHOD2(OnAttachedFile, Status(const ElementMetadata& metadata,
+                                      const AttachedFile& attached_file));
+
   MOCK_METHOD2(OnEditionEntry, Status(const ElementMetadata& metadata,
                                       const EditionEntry& edition_entry));
 
@@ -159,6 +182,16 @@ class MockCallback : public Callback {
     return Callback::OnVoid(metadata, reader, bytes_remaining);
   }
 
+  std::uint64_t BinaryStreamingThresholdConcrete(
+      const ElementMetadata& metadata) {
+    return Callback::BinaryStreamingThreshold(metadata);
+  }
+
+  Status OnBinaryDataConcrete(const ElementMetadata& metadata, Reader* reader,
+                              std::uint64_t* bytes_remaining) {
+    return Callback::OnBinaryData(metadata, reader, bytes_remaining);
+  }
+
   Status OnSegmentBeginConcrete(const ElementMetadata& metadata,
                                 Action* action) {
     return Callback::OnSegmentBegin(metadata, action);
@@ -228,6 +261,16 @@ class MockCallback : public Callback {
     return Callback::OnCuePoint(metadata, cue_point);
   }
 
+  Status OnFileDataConcrete(const ElementMetadata& metadata, Reader* reader,
+                            std::uint64_t* bytes_remaining) {
+    return Callback::OnFileData(metadata, reader, bytes_remaining);
+  }
+
+  Status OnAttachedFileConcrete(const ElementMetadata& metadata,
+                                const AttachedFile& attached_file) {
+    return Callback::OnAttachedFile(metadata, attached_file);
+  }
+
   Status OnEditionEntryConcrete(const ElementMetadata& metadata,
                                 const EditionEntry& edition_entry) {
     return Callback::OnEditionEntry(metadata, edition_entry);
@@ -0,0 +1,110 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "src/attached_file_parser.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "test_utils/element_parser_test.h"
+#include "webm/id.h"
+
+using testing::_;
+using testing::NotNull;
+
+using webm::AttachedFile;
+using webm::AttachedFileParser;
+using webm::ElementMetadata;
+using webm::ElementParserTest;
+using webm::Id;
+
+namespace {
+
+class AttachedFileParserTest
+    : public ElementParserTest<AttachedFileParser, Id::kAttachedFile> {};
+
+TEST_F(AttachedFileParserTest, DefaultParse) {
+  EXPECT_CALL(callback_, OnFileData(_, _, _)).Times(0);
+  EXPECT_CALL(callback_, OnAttachedFile(metadata_, AttachedFile{})).Times(1);
+
+  ParseAndVerify();
+}
+
+TEST_F(AttachedFileParserTest, DefaultValues) {
+  SetReaderData({
+      0x46, 0x7E,  // ID = 0x467E (FileDescription).
+      0x80,  // Size = 0.
+
+      0x46, 0x6E,  // ID = 0x466E (FileName).
+      0x80,  // Size = 0.
+
+      0x46, 0x60,  // ID = 0x4660 (FileMimeType).
+      0x80,  // Size = 0.
+
+      0x46, 0x5C,  // ID = 0x465C (FileData).
+      0x80,  // Size = 0.
+
+      0x46, 0xAE,  // ID = 0x46AE (FileUID).
+      0x80,  // Size = 0.
+  });
+
+  const ElementMetadata data_metadata = {Id::kFileData, 3, 0, 9};
+
+  AttachedFile attached_file;
+  attached_file.description.Set("", true);
+  attached_file.name.Set("", true);
+  attached_file.mime_type.Set("", true);
+  attached_file.data.Set(data_metadata, true);
+  attached_file.uid.Set(0, true);
+
+  EXPECT_CALL(callback_, OnFileData(data_metadata, NotNull(), NotNull()))
+      .Times(1);
+  EXPECT_CALL(callback_, OnAttachedFile(metadata_, attached_file)).Times(1);
+
+  ParseAndVerify();
+}
+
+TEST_F(AttachedFileParserTest, CustomValues) {
+  SetReaderData({
+      0x46, 0x7E,  // ID = 0x467E (FileDescription).
+      0x81,  // Size = 1.
+      0x61,  // Body (value = "a").
+
+      0x46, 0x6E,  // ID = 0x466E (FileName).
+      0x81,  // Size = 1.
+      0x62,  // Body (value = "b").
+
+      0x46, 0x60,  // ID = 0x4660 (FileMimeType).
+      0x81,  // Size = 1.
+      0x63,  // Body (value = "c").
+
+      0x46, 0x5C,  // ID = 0x465C (FileData).
+      0x82,  // Size = 2.
+      0x01, 0x02,  // Body.
+
+      0x46, 0xAE,  // ID = 0x46AE (FileUID).
+      0x81,  // Size = 1.
+      0x03,  // Body (value = 3).
+  });
+
+  const ElementMetadata data_metadata = {Id::kFileData, 3, 2, 12};
+
+  AttachedFile attached_file;
+  attached_file.description.Set("a", true);
+  attached_file.name.Set("b", true);
+  attached_file.mime_type.Set("c", true);
+  attached_file.data.Set(data_metadata, true);
+  attached_file.uid.Set(3, true);
+
+  EXPECT_CALL(callback_, OnFileData(data_metadata, NotNull(), NotNull()))
+      .Times(1);
+  EXPECT_CALL(callback_, OnAttachedFile(metadata_, attached_file)).Times(1);
+
+  ParseAndVerify();
+}
+
+}  // namespace
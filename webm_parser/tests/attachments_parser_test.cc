@@ -0,0 +1,107 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "src/attachments_parser.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "test_utils/element_parser_test.h"
+#include "webm/id.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::NotNull;
+using testing::Return;
+using testing::SetArgPointee;
+
+using webm::Action;
+using webm::AttachedFile;
+using webm::AttachmentsParser;
+using webm::ElementMetadata;
+using webm::ElementParserTest;
+using webm::Id;
+using webm::Status;
+
+namespace {
+
+class AttachmentsParserTest
+    : public ElementParserTest<AttachmentsParser, Id::kAttachments> {};
+
+TEST_F(AttachmentsParserTest, DefaultValues) {
+  ParseAndVerify();
+
+  SetReaderData({
+      0x61, 0xA7,  // ID = 0x61A7 (AttachedFile).
+      0x80,  // Size = 0.
+  });
+
+  EXPECT_CALL(callback_, OnAttachedFile(_, AttachedFile{})).Times(1);
+
+  ParseAndVerify();
+}
+
+TEST_F(AttachmentsParserTest, RepeatedValues) {
+  SetReaderData({
+      0x61, 0xA7,  // ID = 0x61A7 (AttachedFile).
+      0x88,  // Size = 8.
+
+      0x46, 0x6E,  //   ID = 0x466E (FileName).
+      0x81,  //   Size = 1.
+      0x61,  //   Body (value = "a").
+
+      0x46, 0x5C,  //   ID = 0x465C (FileData).
+      0x81,  //   Size = 1.
+      0x00,  //   Body.
+
+      0x61, 0xA7,  // ID = 0x61A7 (AttachedFile).
+      0x88,  // Size = 8.
+
+      0x46, 0x6E,  //   ID = 0x466E (FileName).
+      0x81,  //   Size = 1.
+      0x62,  //   Body (value = "b").
+
+      0x46, 0x5C,  //   ID = 0x465C (FileData).
+      0x81,  //   Size = 1.
+      0x00,  //   Body.
+  });
+
+  AttachedFile first;
+  first.name.Set("a", true);
+  first.data.Set({Id::kFileData, 3, 1, 7}, true);
+  AttachedFile second;
+  second.name.Set("b", true);
+  second.data.Set({Id::kFileData, 3, 1, 18}, true);
+
+  EXPECT_CALL(callback_, OnFileData(_, NotNull(), NotNull())).Times(2);
+  EXPECT_CALL(callback_, OnAttachedFile(_, first)).Times(1);
+  EXPECT_CALL(callback_, OnAttachedFile(_, second)).Times(1);
+
+  ParseAndVerify();
+}
+
+TEST_F(AttachmentsParserTest, SkippedAttachedFile) {
+  SetReaderData({
+      0x61, 0xA7,  // ID = 0x61A7 (AttachedFile).
+      0x84,  // Size = 4.
+
+      0x46, 0x5C,  //   ID = 0x465C (FileData).
+      0x81,  //   Size = 1.
+      0x00,  //   Body.
+  });
+
+  const ElementMetadata metadata = {Id::kAttachedFile, 3, 4, 0};
+  EXPECT_CALL(callback_, OnElementBegin(metadata, NotNull()))
+      .WillOnce(DoAll(SetArgPointee<1>(Action::kSkip),
+                      Return(Status(Status::kOkCompleted))));
+  EXPECT_CALL(callback_, OnFileData(_, _, _)).Times(0);
+  EXPECT_CALL(callback_, OnAttachedFile(_, _)).Times(0);
+
+  ParseAndVerify();
+}
+
+}  // namespace
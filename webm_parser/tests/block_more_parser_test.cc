@@ -7,13 +7,18 @@
 // be found in the AUTHORS file in the root of the source tree.
 #include "src/block_more_parser.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include "test_utils/element_parser_test.h"
 #include "webm/id.h"
 
+using testing::NotNull;
+using testing::Return;
+
 using webm::BlockMore;
 using webm::BlockMoreParser;
+using webm::ElementMetadata;
 using webm::ElementParserTest;
 using webm::Id;
 
@@ -76,4 +81,31 @@ TEST_F(BlockMoreParserTest, CustomValues) {
   EXPECT_EQ(std::vector<std::uint8_t>{0x00}, block_more.data.value());
 }
 
+TEST_F(BlockMoreParserTest, StreamedData) {
+  SetReaderData({
+      0xEE,  // ID = 0xEE (BlockAddID).
+      0x81,  // Size = 1.
+      0x02,  // Body (value = 2).
+
+      0xA5,  // ID = 0xA5 (BlockAdditional).
+      0x83,  // Size = 3.
+      0x01, 0x02, 0x03,  // Body.
+  });
+
+  const ElementMetadata metadata = {Id::kBlockAdditional, 2, 3, 3};
+  EXPECT_CALL(callback_, BinaryStreamingThreshold(metadata))
+      .WillOnce(Return(2));
+  EXPECT_CALL(callback_, OnBinaryData(metadata, NotNull(), NotNull()))
+      .Times(1);
+
+  ParseAndVerify();
+
+  const BlockMore block_more = parser_.value();
+
+  EXPECT_EQ(static_cast<std::uint64_t>(2), block_more.id.value());
+
+  EXPECT_TRUE(block_more.data.is_present());
+  EXPECT_EQ(std::vector<std::uint8_t>{}, block_more.data.value());
+}
+
 }  // namespace
@@ -0,0 +1,238 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/buffer_chain_reader.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "test_utils/mock_callback.h"
+#include "webm/status.h"
+#include "webm/webm_parser.h"
+
+using testing::InSequence;
+using testing::NotNull;
+
+using webm::BufferChainReader;
+using webm::Ebml;
+using webm::ElementMetadata;
+using webm::Id;
+using webm::MockCallback;
+using webm::Status;
+using webm::WebmParser;
+
+namespace {
+
+class BufferChainReaderTest : public testing::Test {};
+
+TEST_F(BufferChainReaderTest, Empty) {
+  // Test the reader to make sure it would block, and then reports EOF, on
+  // empty inputs.
+  std::array<std::uint8_t, 1> buffer;
+  std::uint64_t count;
+  Status status;
+
+  BufferChainReader reader;
+
+  status = reader.Read(buffer.size(), buffer.data(), &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  reader.Append(buffer.data(), 0);
+  EXPECT_EQ(static_cast<std::size_t>(0), reader.buffer_count());
+
+  reader.SetEndOfStream();
+
+  status = reader.Read(buffer.size(), buffer.data(), &count);
+  EXPECT_EQ(Status::kEndOfFile, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kEndOfFile, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+}
+
+TEST_F(BufferChainReaderTest, Read) {
+  // Test the Read method to make sure it reads data across buffers.
+  const std::array<std::uint8_t, 3> first = {{0, 1, 2}};
+  const std::array<std::uint8_t, 1> second = {{3}};
+  const std::array<std::uint8_t, 4> third = {{4, 5, 6, 7}};
+  std::array<std::uint8_t, 10> buffer{};
+  std::uint64_t count;
+  Status status;
+
+  BufferChainReader reader;
+  reader.Append(first.data(), first.size());
+  reader.Append(second.data(), second.size());
+  reader.Append(third.data(), third.size());
+  EXPECT_EQ(static_cast<std::uint64_t>(8), reader.available());
+
+  status = reader.Read(2, buffer.data(), &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+
+  status = reader.Read(3, buffer.data() + 2, &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(3), count);
+
+  status = reader.Read(5, buffer.data() + 5, &count);
+  EXPECT_EQ(Status::kOkPartial, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(3), count);
+
+  status = reader.Read(1, buffer.data() + 8, &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  std::array<std::uint8_t, 10> expected = {{0, 1, 2, 3, 4, 5, 6, 7, 0, 0}};
+  EXPECT_EQ(expected, buffer);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), reader.available());
+}
+
+TEST_F(BufferChainReaderTest, Skip) {
+  // Test the Skip method to make sure it skips data across buffers.
+  const std::array<std::uint8_t, 3> first = {{0, 1, 2}};
+  const std::array<std::uint8_t, 3> second = {{3, 4, 5}};
+  std::array<std::uint8_t, 2> buffer{};
+  std::uint64_t count;
+  Status status;
+
+  BufferChainReader reader;
+  reader.Append(first.data(), first.size());
+  reader.Append(second.data(), second.size());
+
+  status = reader.Skip(4, &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(4), count);
+
+  status = reader.Read(1, buffer.data(), &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(1), count);
+  EXPECT_EQ(4, buffer[0]);
+
+  status = reader.Skip(3, &count);
+  EXPECT_EQ(Status::kOkPartial, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(1), count);
+
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+}
+
+TEST_F(BufferChainReaderTest, Position) {
+  // Test the Position method to make sure it counts from the start position.
+  const std::array<std::uint8_t, 4> data = {{0, 1, 2, 3}};
+  std::array<std::uint8_t, 4> buffer;
+  std::uint64_t count;
+
+  BufferChainReader reader(100);
+  EXPECT_EQ(static_cast<std::uint64_t>(100), reader.Position());
+
+  reader.Append(data.data(), data.size());
+  reader.Read(2, buffer.data(), &count);
+  EXPECT_EQ(static_cast<std::uint64_t>(102), reader.Position());
+
+  reader.Skip(1, &count);
+  EXPECT_EQ(static_cast<std::uint64_t>(103), reader.Position());
+
+  reader.Read(4, buffer.data(), &count);
+  EXPECT_EQ(static_cast<std::uint64_t>(104), reader.Position());
+
+  reader.Skip(4, &count);
+  EXPECT_EQ(static_cast<std::uint64_t>(104), reader.Position());
+}
+
+TEST_F(BufferChainReaderTest, ReleaseConsumed) {
+  // Test the ReleaseConsumed method to make sure it releases only the buffers
+  // that have been entirely consumed, oldest first.
+  const std::array<std::uint8_t, 2> first = {{0, 1}};
+  const std::array<std::uint8_t, 2> second = {{2, 3}};
+  const std::array<std::uint8_t, 2> third = {{4, 5}};
+  std::array<std::uint8_t, 2> buffer;
+  std::uint64_t count;
+
+  BufferChainReader reader;
+  reader.Append(first.data(), first.size());
+  reader.Append(second.data(), second.size());
+  EXPECT_EQ(static_cast<std::size_t>(0), reader.ReleaseConsumed());
+
+  reader.Read(1, buffer.data(), &count);
+  EXPECT_EQ(static_cast<std::size_t>(0), reader.ReleaseConsumed());
+
+  reader.Skip(2, &count);
+  EXPECT_EQ(static_cast<std::size_t>(1), reader.ReleaseConsumed());
+  EXPECT_EQ(static_cast<std::size_t>(1), reader.buffer_count());
+
+  reader.Append(third.data(), third.size());
+  reader.Read(2, buffer.data(), &count);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+  std::array<std::uint8_t, 2> expected = {{3, 4}};
+  EXPECT_EQ(expected, buffer);
+  EXPECT_EQ(static_cast<std::size_t>(1), reader.ReleaseConsumed());
+
+  reader.Read(1, buffer.data(), &count);
+  EXPECT_EQ(5, buffer[0]);
+  EXPECT_EQ(static_cast<std::size_t>(1), reader.ReleaseConsumed());
+  EXPECT_EQ(static_cast<std::size_t>(0), reader.buffer_count());
+}
+
+TEST_F(BufferChainReaderTest, ResumeParsing) {
+  // Test that the parser resumes where it stopped as buffers are appended one
+  // byte at a time.
+  const std::vector<std::uint8_t> data = {
+      0x1A, 0x45, 0xDF, 0xA3,  // ID = 0x1A45DFA3 (EBML).
+      0x84,  // Size = 4.
+
+      0x42, 0x86,  // ID = 0x4286 (EBMLVersion).
+      0x81,  // Size = 1.
+      0x02,  // Body (value = 2).
+
+      0x18, 0x53, 0x80, 0x67,  // ID = 0x18538067 (Segment).
+      0x80,  // Size = 0.
+  };
+
+  MockCallback callback;
+  {
+    InSequence dummy;
+
+    ElementMetadata metadata = {Id::kEbml, 5, 4, 0};
+    Ebml ebml{};
+    ebml.ebml_version.Set(2, true);
+    EXPECT_CALL(callback, OnElementBegin(metadata, NotNull())).Times(1);
+    const ElementMetadata child_metadata = {Id::kEbmlVersion, 3, 1, 5};
+    EXPECT_CALL(callback, OnElementBegin(child_metadata, NotNull())).Times(1);
+    EXPECT_CALL(callback, OnEbml(metadata, ebml)).Times(1);
+
+    metadata = {Id::kSegment, 5, 0, 9};
+    EXPECT_CALL(callback, OnElementBegin(metadata, NotNull())).Times(1);
+    EXPECT_CALL(callback, OnSegmentBegin(metadata, NotNull())).Times(1);
+    EXPECT_CALL(callback, OnSegmentEnd(metadata)).Times(1);
+  }
+
+  BufferChainReader reader;
+  WebmParser parser;
+  for (const std::uint8_t& byte : data) {
+    Status status = parser.Feed(&callback, &reader);
+    EXPECT_EQ(Status::kWouldBlock, status.code);
+    reader.Append(&byte, 1);
+    reader.ReleaseConsumed();
+  }
+  reader.SetEndOfStream();
+
+  Status status = parser.Feed(&callback, &reader);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(data.size(), reader.Position());
+}
+
+}  // namespace
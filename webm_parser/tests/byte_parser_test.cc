@@ -7,14 +7,27 @@
 // be found in the AUTHORS file in the root of the source tree.
 #include "src/byte_parser.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 #include "test_utils/element_parser_test.h"
+#include "webm/reader.h"
 #include "webm/status.h"
 
+using testing::_;
+using testing::AtLeast;
+using testing::Invoke;
+using testing::NotNull;
+using testing::Return;
+
 using webm::BinaryParser;
+using webm::ElementMetadata;
 using webm::ElementParserTest;
 using webm::kUnknownElementSize;
+using webm::Reader;
 using webm::Status;
 using webm::StringParser;
 
@@ -66,6 +79,15 @@ TEST_F(StringParserTest, StringIncrementalParse) {
   EXPECT_EQ("Matroska", parser_.value());
 }
 
+TEST_F(StringParserTest, StringNeverStreamed) {
+  EXPECT_CALL(callback_, BinaryStreamingThreshold(_)).Times(0);
+  EXPECT_CALL(callback_, OnBinaryData(_, _, _)).Times(0);
+
+  SetReaderData({'W', 'e', 'b', 'M'});
+  ParseAndVerify();
+  EXPECT_EQ("WebM", parser_.value());
+}
+
 class BinaryParserTest : public ElementParserTest<BinaryParser> {};
 
 TEST_F(BinaryParserTest, BinaryInvalidSize) {
@@ -114,4 +136,45 @@ TEST_F(BinaryParserTest, BinaryIncrementalParse) {
   EXPECT_EQ(expected, parser_.value());
 }
 
+TEST_F(BinaryParserTest, BinaryBelowThreshold) {
+  const std::vector<std::uint8_t> expected = {0x01, 0x02, 0x03, 0x04};
+  EXPECT_CALL(callback_, BinaryStreamingThreshold(_)).WillOnce(Return(4));
+  EXPECT_CALL(callback_, OnBinaryData(_, _, _)).Times(0);
+
+  SetReaderData(expected);
+  ParseAndVerify();
+  EXPECT_EQ(expected, parser_.value());
+}
+
+TEST_F(BinaryParserTest, BinaryStreamed) {
+  const std::vector<std::uint8_t> expected = {0x01, 0x02, 0x03, 0x04, 0x05};
+  std::vector<std::uint8_t> streamed;
+  const auto read_byte = [&streamed](const ElementMetadata&, Reader* reader,
+                                     std::uint64_t* bytes_remaining) {
+    std::uint8_t byte;
+    std::uint64_t num_read;
+    const Status status = reader->Read(1, &byte, &num_read);
+    if (num_read == 1) {
+      streamed.push_back(byte);
+      --*bytes_remaining;
+    }
+    if (status.completed_ok() && *bytes_remaining > 0) {
+      return Status(Status::kOkPartial);
+    }
+    return status;
+  };
+
+  SetReaderData(expected);
+  EXPECT_CALL(callback_, BinaryStreamingThreshold(metadata_))
+      .WillOnce(Return(4));
+  EXPECT_CALL(callback_, OnBinaryData(metadata_, NotNull(), NotNull()))
+      .Times(AtLeast(1))
+      .WillRepeatedly(Invoke(read_byte));
+
+  IncrementalParseAndVerify();
+
+  EXPECT_EQ(expected, streamed);
+  EXPECT_TRUE(parser_.value().empty());
+}
+
 }  // namespace
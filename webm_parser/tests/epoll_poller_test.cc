@@ -0,0 +1,145 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/epoll_poller.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "webm/callback.h"
+#include "webm/fd_reader.h"
+#include "webm/parser_driver.h"
+#include "webm/status.h"
+
+using webm::Callback;
+using webm::ElementMetadata;
+using webm::EpollPoller;
+using webm::FdReader;
+using webm::ParserDriver;
+using webm::Poller;
+using webm::Status;
+
+namespace {
+
+// An EBML element followed by an empty Segment.
+const std::array<std::uint8_t, 10> kData = {{
+    0x1A, 0x45, 0xDF, 0xA3,  // ID = 0x1A45DFA3 (EBML).
+    0x80,  // Size = 0.
+
+    0x18, 0x53, 0x80, 0x67,  // ID = 0x18538067 (Segment).
+    0x80,  // Size = 0.
+}};
+
+// Counts the Segments parsed.
+class SegmentCounter : public Callback {
+ public:
+  Status OnSegmentEnd(const ElementMetadata&) override {
+    ++segments;
+    return Status(Status::kOkCompleted);
+  }
+
+  int segments = 0;
+};
+
+class CountingListener : public Poller::Listener {
+ public:
+  void OnReadable(int) override { ++notifications; }
+
+  int notifications = 0;
+};
+
+class EpollPollerTest : public testing::Test {};
+
+TEST_F(EpollPollerTest, AddRemove) {
+  // Test the poller to make sure it notifies watched descriptors only.
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+
+  EpollPoller poller;
+  ASSERT_TRUE(poller.is_open());
+
+  CountingListener listener;
+  EXPECT_TRUE(poller.Add(fds[0], &listener));
+  EXPECT_FALSE(poller.Add(fds[0], &listener));
+  EXPECT_EQ(static_cast<std::size_t>(1), poller.size());
+
+  EXPECT_EQ(0, poller.Poll(0));
+  EXPECT_EQ(0, listener.notifications);
+
+  ASSERT_EQ(1, write(fds[1], kData.data(), 1));
+  EXPECT_EQ(1, poller.Poll(0));
+  EXPECT_EQ(1, listener.notifications);
+
+  // Level-triggered: the unread byte is reported again.
+  EXPECT_EQ(1, poller.Poll(0));
+  EXPECT_EQ(2, listener.notifications);
+
+  poller.Remove(fds[0]);
+  EXPECT_EQ(static_cast<std::size_t>(0), poller.size());
+  EXPECT_EQ(0, poller.Poll(0));
+  EXPECT_EQ(2, listener.notifications);
+
+  close(fds[0]);
+  close(fds[1]);
+}
+
+TEST_F(EpollPollerTest, ManyStreams) {
+  // Test the poller to make sure one thread can drive several parsers whose
+  // input arrives a few bytes at a time.
+  const int kStreams = 16;
+
+  EpollPoller poller;
+  ASSERT_TRUE(poller.is_open());
+
+  std::vector<std::array<int, 2>> pipes(kStreams);
+  std::vector<std::unique_ptr<FdReader>> readers;
+  std::vector<std::unique_ptr<ParserDriver>> drivers;
+  SegmentCounter callback;
+  std::vector<Status> results(kStreams, Status(Status::kWouldBlock));
+  for (int i = 0; i < kStreams; ++i) {
+    ASSERT_EQ(0, pipe(pipes[i].data()));
+    ASSERT_TRUE(FdReader::SetNonBlocking(pipes[i][0]));
+    readers.emplace_back(new FdReader(pipes[i][0]));
+    drivers.emplace_back(new ParserDriver(
+        &poller, pipes[i][0], readers[i].get(), &callback,
+        [&results, i](Status status) { results[i] = status; }));
+    ASSERT_EQ(Status::kWouldBlock, drivers[i]->Start().code);
+  }
+  EXPECT_EQ(static_cast<std::size_t>(kStreams), poller.size());
+
+  // Write 3 bytes to each stream in turn, closing each after its last byte.
+  for (std::size_t offset = 0; offset < kData.size(); offset += 3) {
+    const std::size_t size = std::min<std::size_t>(3, kData.size() - offset);
+    for (int i = 0; i < kStreams; ++i) {
+      ASSERT_EQ(static_cast<ssize_t>(size),
+                write(pipes[i][1], kData.data() + offset, size));
+      if (offset + size == kData.size()) {
+        close(pipes[i][1]);
+      }
+    }
+    ASSERT_GE(poller.Poll(0), 0);
+  }
+  while (poller.size() > 0) {
+    ASSERT_GT(poller.Poll(1000), 0);
+  }
+
+  EXPECT_EQ(kStreams, callback.segments);
+  for (int i = 0; i < kStreams; ++i) {
+    EXPECT_EQ(Status::kOkCompleted, results[i].code) << i;
+    EXPECT_FALSE(drivers[i]->watching());
+    close(pipes[i][0]);
+  }
+}
+
+}  // namespace
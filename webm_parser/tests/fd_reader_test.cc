@@ -0,0 +1,145 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/fd_reader.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+
+#include "gtest/gtest.h"
+
+using webm::FdReader;
+using webm::Status;
+
+namespace {
+
+class FdReaderTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(0, pipe(fds_));
+    ASSERT_TRUE(FdReader::SetNonBlocking(fds_[0]));
+  }
+
+  void TearDown() override {
+    close(fds_[0]);
+    if (fds_[1] != -1) {
+      close(fds_[1]);
+    }
+  }
+
+  void Write(std::initializer_list<std::uint8_t> bytes) {
+    ASSERT_EQ(static_cast<ssize_t>(bytes.size()),
+              write(fds_[1], bytes.begin(), bytes.size()));
+  }
+
+  void CloseWriteEnd() {
+    close(fds_[1]);
+    fds_[1] = -1;
+  }
+
+  int fds_[2];
+};
+
+TEST_F(FdReaderTest, Read) {
+  // Test the Read method to make sure it reads the data available and would
+  // block when there is none.
+  std::array<std::uint8_t, 6> buffer{};
+  std::uint64_t count;
+  Status status;
+
+  FdReader reader(fds_[0]);
+
+  status = reader.Read(buffer.size(), buffer.data(), &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  Write({0, 1, 2, 3});
+  status = reader.Read(2, buffer.data(), &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+
+  status = reader.Read(4, buffer.data() + 2, &count);
+  EXPECT_EQ(Status::kOkPartial, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+
+  status = reader.Read(1, buffer.data() + 4, &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  Write({4, 5});
+  CloseWriteEnd();
+  status = reader.Read(4, buffer.data() + 4, &count);
+  EXPECT_EQ(Status::kOkPartial, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+
+  status = reader.Read(1, buffer.data(), &count);
+  EXPECT_EQ(Status::kEndOfFile, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  std::array<std::uint8_t, 6> expected = {{0, 1, 2, 3, 4, 5}};
+  EXPECT_EQ(expected, buffer);
+  EXPECT_EQ(static_cast<std::uint64_t>(6), reader.Position());
+  EXPECT_EQ(0, reader.error());
+}
+
+TEST_F(FdReaderTest, Skip) {
+  // Test the Skip method to make sure it skips the data available and would
+  // block when there is none.
+  std::array<std::uint8_t, 1> buffer;
+  std::uint64_t count;
+  Status status;
+
+  FdReader reader(fds_[0], 10);
+
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kWouldBlock, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  Write({0, 1, 2, 3});
+  status = reader.Skip(3, &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(3), count);
+
+  status = reader.Read(1, buffer.data(), &count);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(3, buffer[0]);
+
+  Write({4, 5});
+  status = reader.Skip(10000, &count);
+  EXPECT_EQ(Status::kOkPartial, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(2), count);
+
+  CloseWriteEnd();
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kEndOfFile, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+
+  EXPECT_EQ(static_cast<std::uint64_t>(16), reader.Position());
+}
+
+TEST_F(FdReaderTest, Error) {
+  // Test the reader to make sure it reports read errors.
+  std::array<std::uint8_t, 1> buffer;
+  std::uint64_t count;
+
+  FdReader reader(-1);
+
+  Status status = reader.Read(buffer.size(), buffer.data(), &count);
+  EXPECT_EQ(Status::kIoError, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+  EXPECT_EQ(EBADF, reader.error());
+
+  status = reader.Skip(1, &count);
+  EXPECT_EQ(Status::kIoError, status.code);
+  EXPECT_EQ(static_cast<std::uint64_t>(0), count);
+}
+
+}  // namespace
@@ -0,0 +1,62 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "src/file_data_parser.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "test_utils/element_parser_test.h"
+#include "webm/element.h"
+#include "webm/id.h"
+#include "webm/status.h"
+
+using testing::NotNull;
+
+using webm::ElementParserTest;
+using webm::FileDataParser;
+using webm::Id;
+using webm::kUnknownElementSize;
+using webm::Status;
+
+namespace {
+
+class FileDataParserTest
+    : public ElementParserTest<FileDataParser, Id::kFileData> {};
+
+TEST_F(FileDataParserTest, InvalidSize) {
+  TestInit(kUnknownElementSize, Status::kInvalidElementSize);
+}
+
+TEST_F(FileDataParserTest, Empty) {
+  EXPECT_CALL(callback_, OnFileData(metadata_, NotNull(), NotNull())).Times(1);
+
+  ParseAndVerify();
+
+  EXPECT_EQ(metadata_, parser_.value());
+}
+
+TEST_F(FileDataParserTest, Valid) {
+  SetReaderData({0x00, 0x01, 0x02, 0x04});
+
+  EXPECT_CALL(callback_, OnFileData(metadata_, NotNull(), NotNull())).Times(1);
+
+  ParseAndVerify();
+
+  EXPECT_EQ(metadata_, parser_.value());
+}
+
+TEST_F(FileDataParserTest, IncrementalSkip) {
+  SetReaderData({0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10});
+
+  EXPECT_CALL(callback_, OnFileData(metadata_, NotNull(), NotNull()))
+      .Times(8);
+
+  IncrementalParseAndVerify();
+}
+
+}  // namespace
@@ -0,0 +1,126 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/parser_coroutine.h"
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <array>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+
+#include "gtest/gtest.h"
+
+#include "webm/buffer_chain_reader.h"
+#include "webm/callback.h"
+#include "webm/status.h"
+#include "webm/webm_parser.h"
+
+using webm::BufferChainReader;
+using webm::Callback;
+using webm::FeedWhenReadable;
+using webm::Poller;
+using webm::Status;
+using webm::WebmParser;
+
+namespace {
+
+// A coroutine type that starts eagerly and is never awaited.
+struct Task {
+  struct promise_type {
+    Task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// A poller whose descriptor is made readable by the test.
+class FakePoller : public Poller {
+ public:
+  bool Add(int, Listener* listener) override {
+    listener_ = listener;
+    return true;
+  }
+
+  void Remove(int) override { listener_ = nullptr; }
+
+  void NotifyReadable() {
+    ASSERT_NE(nullptr, listener_);
+    listener_->OnReadable(0);
+  }
+
+  Listener* listener() const { return listener_; }
+
+ private:
+  Listener* listener_ = nullptr;
+};
+
+// An EBML element followed by an empty Segment.
+const std::array<std::uint8_t, 10> kData = {{
+    0x1A, 0x45, 0xDF, 0xA3,  // ID = 0x1A45DFA3 (EBML).
+    0x80,  // Size = 0.
+
+    0x18, 0x53, 0x80, 0x67,  // ID = 0x18538067 (Segment).
+    0x80,  // Size = 0.
+}};
+
+Task Parse(Poller* poller, BufferChainReader* reader, Status* result,
+           bool* finished) {
+  WebmParser parser;
+  Callback callback;
+  *result = co_await FeedWhenReadable(poller, 0, &parser, &callback, reader);
+  *finished = true;
+}
+
+class ParserCoroutineTest : public testing::Test {};
+
+TEST_F(ParserCoroutineTest, ResumesWhenReadable) {
+  // Test the awaitable to make sure the coroutine is suspended until the
+  // parser stops for a reason other than kWouldBlock.
+  FakePoller poller;
+  BufferChainReader reader;
+  Status result(Status::kWouldBlock);
+  bool finished = false;
+
+  Parse(&poller, &reader, &result, &finished);
+  EXPECT_FALSE(finished);
+  EXPECT_NE(nullptr, poller.listener());
+
+  reader.Append(kData.data(), 6);
+  poller.NotifyReadable();
+  EXPECT_FALSE(finished);
+
+  reader.Append(kData.data() + 6, kData.size() - 6);
+  reader.SetEndOfStream();
+  poller.NotifyReadable();
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(Status::kOkCompleted, result.code);
+  EXPECT_EQ(nullptr, poller.listener());
+}
+
+TEST_F(ParserCoroutineTest, ReadyWithoutSuspending) {
+  // Test the awaitable to make sure the coroutine is not suspended when the
+  // input is already complete.
+  FakePoller poller;
+  BufferChainReader reader;
+  reader.Append(kData.data(), kData.size());
+  reader.SetEndOfStream();
+  Status result(Status::kWouldBlock);
+  bool finished = false;
+
+  Parse(&poller, &reader, &result, &finished);
+  EXPECT_TRUE(finished);
+  EXPECT_EQ(Status::kOkCompleted, result.code);
+  EXPECT_EQ(nullptr, poller.listener());
+}
+
+}  // namespace
+
+#endif  // __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
@@ -0,0 +1,203 @@
+// Copyright (c) 2026 The WebM project authors. All Rights Reserved.
+//
+// Use of this source code is governed by a BSD-style license
+// that can be found in the LICENSE file in the root of the source
+// tree. An additional intellectual property rights grant can be found
+// in the file PATENTS.  All contributing project authors may
+// be found in the AUTHORS file in the root of the source tree.
+#include "webm/parser_driver.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "test_utils/mock_callback.h"
+#include "webm/buffer_chain_reader.h"
+#include "webm/status.h"
+
+using testing::_;
+
+using webm::BufferChainReader;
+using webm::MockCallback;
+using webm::ParserDriver;
+using webm::Poller;
+using webm::Status;
+
+namespace {
+
+// A poller whose descriptor is made readable by the test.
+class FakePoller : public Poller {
+ public:
+  bool Add(int fd, Listener* listener) override {
+    if (listener_ != nullptr || fail_add_) {
+      return false;
+    }
+    fd_ = fd;
+    listener_ = listener;
+    return true;
+  }
+
+  void Remove(int fd) override {
+    EXPECT_EQ(fd_, fd);
+    listener_ = nullptr;
+  }
+
+  void NotifyReadable() {
+    ASSERT_NE(nullptr, listener_);
+    listener_->OnReadable(fd_);
+  }
+
+  Listener* listener() const { return listener_; }
+  void set_fail_add(bool fail_add) { fail_add_ = fail_add; }
+
+ private:
+  int fd_ = -1;
+  Listener* listener_ = nullptr;
+  bool fail_add_ = false;
+};
+
+// An EBML element followed by an empty Segment.
+const std::array<std::uint8_t, 10> kData = {{
+    0x1A, 0x45, 0xDF, 0xA3,  // ID = 0x1A45DFA3 (EBML).
+    0x80,  // Size = 0.
+
+    0x18, 0x53, 0x80, 0x67,  // ID = 0x18538067 (Segment).
+    0x80,  // Size = 0.
+}};
+
+class ParserDriverTest : public testing::Test {};
+
+TEST_F(ParserDriverTest, ResumesWhenReadable) {
+  // Test the driver to make sure it feeds the parser each time the descriptor
+  // is readable, and reports the final status once.
+  FakePoller poller;
+  BufferChainReader reader;
+  MockCallback callback;
+  EXPECT_CALL(callback, OnEbml(_, _)).Times(1);
+  EXPECT_CALL(callback, OnSegmentEnd(_)).Times(1);
+
+  int done_count = 0;
+  Status done_status(Status::kOkPartial);
+  ParserDriver driver(&poller, 3, &reader, &callback,
+                      [&done_count, &done_status](Status status) {
+                        ++done_count;
+                        done_status = status;
+                      });
+
+  EXPECT_EQ(Status::kWouldBlock, driver.Start().code);
+  EXPECT_TRUE(driver.watching());
+  EXPECT_EQ(&driver, poller.listener());
+
+  // Nothing to read yet.
+  poller.NotifyReadable();
+  EXPECT_EQ(0, done_count);
+
+  reader.Append(kData.data(), 7);
+  poller.NotifyReadable();
+  EXPECT_EQ(0, done_count);
+  EXPECT_TRUE(driver.watching());
+
+  reader.Append(kData.data() + 7, kData.size() - 7);
+  reader.SetEndOfStream();
+  poller.NotifyReadable();
+  EXPECT_EQ(1, done_count);
+  EXPECT_EQ(Status::kOkCompleted, done_status.code);
+  EXPECT_FALSE(driver.watching());
+  EXPECT_EQ(nullptr, poller.listener());
+}
+
+TEST_F(ParserDriverTest, CompletesInStart) {
+  // Test the driver to make sure it does not watch the descriptor when the
+  // input is already complete.
+  FakePoller poller;
+  BufferChainReader reader;
+  reader.Append(kData.data(), kData.size());
+  reader.SetEndOfStream();
+  MockCallback callback;
+
+  bool done_called = false;
+  ParserDriver driver(&poller, 3, &reader, &callback,
+                      [&done_called](Status) { done_called = true; });
+
+  EXPECT_EQ(Status::kOkCompleted, driver.Start().code);
+  EXPECT_FALSE(driver.watching());
+  EXPECT_EQ(nullptr, poller.listener());
+  EXPECT_FALSE(done_called);
+}
+
+TEST_F(ParserDriverTest, StartWhileWatching) {
+  // Test the driver to make sure a second Start() leaves parsing to the event
+  // loop, so the final status is reported by done and the descriptor removed.
+  FakePoller poller;
+  BufferChainReader reader;
+  MockCallback callback;
+  EXPECT_CALL(callback, OnEbml(_, _)).Times(1);
+  EXPECT_CALL(callback, OnSegmentEnd(_)).Times(1);
+
+  int done_count = 0;
+  ParserDriver driver(&poller, 3, &reader, &callback,
+                      [&done_count](Status) { ++done_count; });
+  EXPECT_EQ(Status::kWouldBlock, driver.Start().code);
+
+  reader.Append(kData.data(), kData.size());
+  reader.SetEndOfStream();
+  EXPECT_EQ(Status::kWouldBlock, driver.Start().code);
+  EXPECT_TRUE(driver.watching());
+  EXPECT_EQ(&driver, poller.listener());
+  EXPECT_EQ(0, done_count);
+
+  poller.NotifyReadable();
+  EXPECT_EQ(1, done_count);
+  EXPECT_FALSE(driver.watching());
+  EXPECT_EQ(nullptr, poller.listener());
+}
+
+TEST_F(ParserDriverTest, AddFails) {
+  // Test the driver to make sure it reports a descriptor that can't be
+  // watched.
+  FakePoller poller;
+  poller.set_fail_add(true);
+  BufferChainReader reader;
+  MockCallback callback;
+
+  ParserDriver driver(&poller, 3, &reader, &callback, nullptr);
+  EXPECT_EQ(Status::kIoError, driver.Start().code);
+  EXPECT_FALSE(driver.watching());
+}
+
+TEST_F(ParserDriverTest, DoneDestroysDriver) {
+  // Test the driver to make sure the done function may destroy it.
+  FakePoller poller;
+  BufferChainReader reader;
+  MockCallback callback;
+
+  std::unique_ptr<ParserDriver> driver;
+  driver.reset(new ParserDriver(&poller, 3, &reader, &callback,
+                                [&driver](Status) { driver.reset(); }));
+  EXPECT_EQ(Status::kWouldBlock, driver->Start().code);
+
+  reader.Append(kData.data(), kData.size());
+  reader.SetEndOfStream();
+  poller.NotifyReadable();
+  EXPECT_EQ(nullptr, driver);
+}
+
+TEST_F(ParserDriverTest, DestructorRemoves) {
+  // Test the driver to make sure it stops watching the descriptor when it is
+  // destroyed.
+  FakePoller poller;
+  BufferChainReader reader;
+  MockCallback callback;
+
+  {
+    ParserDriver driver(&poller, 3, &reader, &callback, nullptr);
+    EXPECT_EQ(Status::kWouldBlock, driver.Start().code);
+    EXPECT_NE(nullptr, poller.listener());
+  }
+  EXPECT_EQ(nullptr, poller.listener());
+}
+
+}  // namespace
@@ -25,6 +25,7 @@ using testing::SetArgPointee;
 
 using webm::Action;
 using webm::Ancestory;
+using webm::AttachedFile;
 using webm::ElementMetadata;
 using webm::ElementParserTest;
 using webm::Id;
@@ -93,6 +94,9 @@ TEST_F(SegmentParserTest, DefaultValues) {
       0x1C, 0x53, 0xBB, 0x6B,  // ID = 0x1C53BB6B (Cues).
       0x80,  // Size = 0.
 
+      0x19, 0x41, 0xA4, 0x69,  // ID = 0x1941A469 (Attachments).
+      0x80,  // Size = 0.
+
       0x10, 0x43, 0xA7, 0x70,  // ID = 0x1043A770 (Chapters).
       0x80,  // Size = 0.
 
@@ -203,6 +207,17 @@ TEST_F(SegmentParserTest, RepeatedValues) {
       0x10, 0x00, 0x00, 0x01,  //     Size = 1.
       0x01,  //     Body (value = 1).
 
+      // Single Attachments element.
+      0x19, 0x41, 0xA4, 0x69,  // ID = 0x1941A469 (Attachments).
+      0x8D,  // Size = 13.
+
+      0x61, 0xA7,  //   ID = 0x61A7 (AttachedFile).
+      0x10, 0x00, 0x00, 0x07,  //   Size = 7.
+
+      0x46, 0xAE,  //     ID = 0x46AE (FileUID).
+      0x10, 0x00, 0x00, 0x01,  //     Size = 1.
+      0x01,  //     Body (value = 1).
+
       // Single Chapters element.
       0x10, 0x43, 0xA7, 0x70,  // ID = 0x1043A770 (Chapters).
       0x8D,  // Size = 13.
@@ -261,6 +276,8 @@ TEST_F(SegmentParserTest, RepeatedValues) {
 
     EXPECT_CALL(callback_, OnCuePoint(_, _)).Times(1);
 
+    EXPECT_CALL(callback_, OnAttachedFile(_, _)).Times(1);
+
     EXPECT_CALL(callback_, OnEditionEntry(_, _)).Times(1);
 
     EXPECT_CALL(callback_, OnTag(_, _)).Times(2);
@@ -366,4 +383,45 @@ TEST_F(SegmentParserTest, Seek) {
   EXPECT_EQ(reader_.size(), num_bytes_read);
 }
 
+TEST_F(SegmentParserTest, SeekAttachedFile) {
+  SetReaderData({
+      // We start the reader at the beginning of a FileName element (skipping
+      // its ID and size, as they're passed into InitAfterSeek), with the
+      // ancestory: Segment -> Attachments -> AttachedFile.
+      0x61,  // Body (value = "a").
+
+      0x46, 0x5C,  // ID = 0x465C (FileData).
+      0x81,  // Size = 1.
+      0x00,  // Body.
+  });
+
+  const ElementMetadata file_name_metadata = {Id::kFileName, 0, 1, 0};
+  const ElementMetadata file_data_metadata = {Id::kFileData, 3, 1, 1};
+
+  AttachedFile attached_file;
+  attached_file.name.Set("a", true);
+  attached_file.data.Set(file_data_metadata, true);
+
+  EXPECT_CALL(callback_, OnSegmentBegin(_, _)).Times(0);
+  {
+    InSequence dummy;
+
+    EXPECT_CALL(callback_, OnFileData(file_data_metadata, NotNull(), NotNull()))
+        .Times(1);
+    EXPECT_CALL(callback_, OnAttachedFile(_, attached_file)).Times(1);
+    EXPECT_CALL(callback_, OnSegmentEnd(_)).Times(1);
+  }
+
+  Ancestory ancestory;
+  ASSERT_TRUE(Ancestory::ById(file_name_metadata.id, &ancestory));
+  ancestory = ancestory.next();  // Skip the Segment ancestor.
+
+  parser_.InitAfterSeek(ancestory, file_name_metadata);
+
+  std::uint64_t num_bytes_read = 0;
+  const Status status = parser_.Feed(&callback_, &reader_, &num_bytes_read);
+  EXPECT_EQ(Status::kOkCompleted, status.code);
+  EXPECT_EQ(reader_.size(), num_bytes_read);
+}
+
 }  // namespace